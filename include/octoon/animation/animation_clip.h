@@ -35,11 +35,20 @@ namespace octoon
 
 		void setTime(float time) noexcept;
 
+		void setBezierSolver(BezierSolver solver) noexcept;
+
+		// Changes whenever curves are added, replaced or cleared, so that bindings to the curves can
+		// tell they have to be resolved again.
+		std::uint32_t getVersion() const noexcept;
+
 	public:
 		std::string name;
 		std::unordered_map<std::string, std::unordered_map<std::string, AnimationCurve<float>>> bindings;
 		bool finish;
 		float timeLength;
+
+	private:
+		std::uint32_t version_;
 	};
 }
 
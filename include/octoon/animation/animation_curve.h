@@ -2,6 +2,7 @@
 #define OCTOON_ANIMATION_CURVE_H_
 
 #include <octoon/animation/keyframe.h>
+#include <octoon/animation/compiled_curve.h>
 #include <algorithm>
 
 namespace octoon
@@ -23,10 +24,13 @@ namespace octoon
 
 		bool finish;
 		bool negative;
+		bool dirty;
 		_Time time;
 		_Time timeLength;
 		math::Variant value;
 		Keyframes frames;
+		CompiledCurve<_Time> compiled;
+		std::size_t cursor;
 		std::shared_ptr<Interpolator<_Time>> interpolator;
 		AnimationMode preWrapMode;
 		AnimationMode postWrapMode;
@@ -34,8 +38,10 @@ namespace octoon
 		AnimationCurve() noexcept
 			: finish(false)
 			, negative(false)
+			, dirty(false)
 			, time(0)
 			, timeLength(0)
+			, cursor(0)
 			, preWrapMode(AnimationMode::Default)
 			, postWrapMode(AnimationMode::Default)
 		{
@@ -45,7 +51,9 @@ namespace octoon
 			: interpolator(std::move(interpolator_))
 			, finish(false)
 			, negative(false)
+			, dirty(false)
 			, timeLength(0)
+			, cursor(0)
 			, preWrapMode(AnimationMode::Default)
 			, postWrapMode(AnimationMode::Default)
 		{
@@ -56,7 +64,9 @@ namespace octoon
 			: interpolator(interpolator_)
 			, finish(false)
 			, negative(false)
+			, dirty(false)
 			, timeLength(0)
+			, cursor(0)
 			, preWrapMode(AnimationMode::Default)
 			, postWrapMode(AnimationMode::Default)
 		{
@@ -82,6 +92,8 @@ namespace octoon
 				this->value.setType(frames.front().value.getType());
 				this->value.assign(frames.front().value);
 			}
+
+			this->compile();
 		}
 
 		void assign(const Keyframes& frames_) noexcept
@@ -103,36 +115,26 @@ namespace octoon
 				this->value.setType(frames.front().value.getType());
 				this->value.assign(frames.front().value);
 			}
+
+			this->compile();
 		}
 
+		// A keyframe goes after the ones with the same time. Compiling waits for the next evaluate, so
+		// building a curve key by key no longer recompiles it on every insert.
 		void insert(Keyframe<_Time>&& frame_) noexcept
 		{
-			frames.emplace_back(std::move(frame_));
-
-			this->sort();
-			this->timeLength = frames.back().time;
+			auto it = std::upper_bound(frames.begin(), frames.end(), frame_.time, [](const _Time& time, const Keyframe<_Time>& a) { return time < a.time; });
+			frames.emplace(it, std::move(frame_));
 
-			if (frames.size() == 1)
-			{
-				this->time = frames.front().time;
-				this->value.setType(frames.front().value.getType());
-				this->value.assign(frames.front().value);
-			}
+			this->onInsert();
 		}
 
 		void insert(const Keyframe<_Time>& frame_) noexcept
 		{
-			frames.emplace_back(frame_);				
+			auto it = std::upper_bound(frames.begin(), frames.end(), frame_.time, [](const _Time& time, const Keyframe<_Time>& a) { return time < a.time; });
+			frames.emplace(it, frame_);
 
-			this->sort();
-			this->timeLength = frames.back().time;
-
-			if (frames.size() == 1)
-			{
-				this->time = frames.front().time;
-				this->value.setType(frames.front().value.getType());
-				this->value.assign(frames.front().value);
-			}
+			this->onInsert();
 		}
 
 		void sort() noexcept
@@ -140,6 +142,14 @@ namespace octoon
 			std::sort(frames.begin(), frames.end(), [](const Keyframe<_Time>& a, const Keyframe<_Time>& b) { return a.time < b.time; });
 		}
 
+		// Must be called again after frames or interpolator are modified directly
+		void compile() noexcept
+		{
+			this->cursor = 0;
+			this->dirty = false;
+			this->compiled.compile(frames, interpolator);
+		}
+
 		bool empty() const noexcept
 		{
 			return frames.empty();
@@ -148,12 +158,16 @@ namespace octoon
 		void setTime(const _Time& _time) noexcept
 		{
 			this->finish = false;
+			this->cursor = 0;
 			this->time = std::clamp(_time, frames.front().time, frames.back().time);
 			this->evaluate(0);
 		}
 
 		const math::Variant& evaluate(const _Time& delta) noexcept
 		{
+			if (this->dirty)
+				this->compile();
+
 			if (negative)
 				this->time -= delta;
 			else
@@ -178,15 +192,25 @@ namespace octoon
 					this->updateAnimationMode(this->postWrapMode);
 				this->value = frames.back().value;
 			}
+			else if (!compiled.empty())
+			{
+				this->finish = false;
+				this->compiled.evaluate(this->time, this->value, this->cursor);
+			}
 			else
 			{
-				auto it = std::upper_bound(frames.begin(), frames.end(), this->time, [](const _Time& time, const Keyframe<_Time>& a)
+				if (cursor == 0 || cursor >= frames.size() || this->time <= frames[cursor - 1].time || this->time > frames[cursor].time)
 				{
-					return time <= a.time;
-				});
+					auto it = std::upper_bound(frames.begin(), frames.end(), this->time, [](const _Time& time, const Keyframe<_Time>& a)
+					{
+						return time <= a.time;
+					});
+
+					cursor = it - frames.begin();
+				}
 
-				auto& a = *(it - 1);
-				auto& b = *(it);
+				auto& a = frames[cursor - 1];
+				auto& b = frames[cursor];
 				auto t = (this->time - a.time) / (b.time - a.time);
 
 				if (b.interpolator)
@@ -201,6 +225,21 @@ namespace octoon
 			return this->value;
 		}
 	private:
+		void onInsert() noexcept
+		{
+			this->timeLength = frames.back().time;
+
+			if (frames.size() == 1)
+			{
+				this->time = frames.front().time;
+				this->value.setType(frames.front().value.getType());
+				this->value.assign(frames.front().value);
+			}
+
+			this->cursor = 0;
+			this->dirty = true;
+		}
+
 		void updateAnimationMode(AnimationMode mode) noexcept
 		{
 			switch (mode)
@@ -0,0 +1,64 @@
+#ifndef OCTOON_BEZIER_TABLE_H_
+#define OCTOON_BEZIER_TABLE_H_
+
+#include <octoon/runtime/platform.h>
+#include <cstdint>
+#include <cstddef>
+
+namespace octoon
+{
+	// Bezier control points quantized to 0..127 the same way VMD stores them
+	struct BezierControl
+	{
+		std::uint8_t xa, xb, ya, yb;
+
+		bool isLinear() const noexcept
+		{
+			return xa == ya && xb == yb;
+		}
+
+		std::uint32_t key() const noexcept
+		{
+			return xa | (xb << 8) | (ya << 16) | (yb << 24);
+		}
+	};
+
+	static_assert(sizeof(BezierControl) == 4);
+
+	// Bisection matches PathInterpolator and is what compiled curves use unless a clip picks another
+	enum class BezierSolver
+	{
+		Bisection,
+		Newton,
+		Table
+	};
+
+	// Baked x->y mapping of one VMD style Bezier curve. Tables are shared by every curve that
+	// uses the same control tuple, so they are built once and never released.
+	class OCTOON_EXPORT BezierTable final
+	{
+	public:
+		static constexpr std::size_t Size = 64;
+
+		explicit BezierTable(const BezierControl& control) noexcept;
+
+		float evalX(float t) const noexcept;
+		float evalY(float t) const noexcept;
+		float derivativeX(float t) const noexcept;
+
+		float solve(float x, BezierSolver solver) const noexcept;
+
+		float bisection(float x) const noexcept;
+		float newton(float x) const noexcept;
+		float lookup(float x) const noexcept;
+
+		static const BezierTable* get(const BezierControl& control) noexcept;
+
+	private:
+		float xa_, xb_, ya_, yb_;
+		float t_[Size + 1];
+		float y_[Size + 1];
+	};
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef OCTOON_COMPILED_CURVE_H_
+#define OCTOON_COMPILED_CURVE_H_
+
+#include <octoon/animation/keyframe.h>
+#include <octoon/animation/path_interpolator.h>
+#include <octoon/animation/bezier_table.h>
+#include <octoon/math/quat.h>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace octoon
+{
+	// Flat SoA form of an AnimationCurve: keyframe times, raw value components and packed
+	// control points live in contiguous arrays so sampling needs no Variant or virtual dispatch.
+	template<typename _Time = float>
+	class CompiledCurve final
+	{
+	public:
+		using Keyframes = std::vector<Keyframe<_Time>>;
+
+		math::Variant::Type type;
+		std::uint8_t components;
+		std::vector<_Time> times;
+		std::vector<float> values;
+		std::vector<BezierControl> controls;
+		std::vector<const BezierTable*> tables;
+		BezierSolver solver;
+
+		CompiledCurve() noexcept
+			: type(math::Variant::Type::Void)
+			, components(0)
+			, solver(BezierSolver::Bisection)
+		{
+		}
+
+		bool empty() const noexcept
+		{
+			return times.empty();
+		}
+
+		std::size_t size() const noexcept
+		{
+			return times.size();
+		}
+
+		void clear() noexcept
+		{
+			type = math::Variant::Type::Void;
+			components = 0;
+			times.clear();
+			values.clear();
+			controls.clear();
+			tables.clear();
+		}
+
+		bool compile(const Keyframes& frames, const std::shared_ptr<Interpolator<_Time>>& interpolator) noexcept
+		{
+			this->clear();
+
+			if (frames.empty())
+				return false;
+
+			auto frameType = frames.front().value.getType();
+
+			switch (frameType)
+			{
+			case math::Variant::Type::Float:
+				components = 1;
+				break;
+			case math::Variant::Type::Float2:
+				components = 2;
+				break;
+			case math::Variant::Type::Float3:
+				components = 3;
+				break;
+			case math::Variant::Type::Float4:
+			case math::Variant::Type::Quaternion:
+				components = 4;
+				break;
+			default:
+				return false;
+			}
+
+			times.reserve(frames.size());
+			values.reserve(frames.size() * components);
+			controls.reserve(frames.size());
+			tables.reserve(frames.size());
+
+			for (auto& frame : frames)
+			{
+				BezierControl control;
+
+				if (frame.value.getType() != frameType || !pack(frame.interpolator ? frame.interpolator : interpolator, control))
+				{
+					this->clear();
+					return false;
+				}
+
+				times.push_back(frame.time);
+				controls.push_back(control);
+				tables.push_back(control.isLinear() ? nullptr : BezierTable::get(control));
+
+				switch (frameType)
+				{
+				case math::Variant::Type::Float:
+					values.push_back(frame.value.getFloat());
+					break;
+				case math::Variant::Type::Float2:
+					values.insert(values.end(), frame.value.getFloat2().ptr(), frame.value.getFloat2().ptr() + 2);
+					break;
+				case math::Variant::Type::Float3:
+					values.insert(values.end(), frame.value.getFloat3().ptr(), frame.value.getFloat3().ptr() + 3);
+					break;
+				case math::Variant::Type::Float4:
+					values.insert(values.end(), frame.value.getFloat4().ptr(), frame.value.getFloat4().ptr() + 4);
+					break;
+				case math::Variant::Type::Quaternion:
+				{
+					auto& q = frame.value.getQuaternion();
+					values.insert(values.end(), { q.x, q.y, q.z, q.w });
+				}
+				break;
+				default:
+					break;
+				}
+			}
+
+			this->type = frameType;
+			return true;
+		}
+
+		// Returns the index of the keyframe ending the segment that contains time, which must lie
+		// strictly inside the curve. The cursor from the previous call is tried first so that
+		// playback advancing by small steps costs O(1); large jumps fall back to binary search.
+		std::size_t search(const _Time& time, std::size_t cursor) const noexcept
+		{
+			assert(time > times.front() && time < times.back());
+
+			if (cursor > 0 && cursor < times.size())
+			{
+				for (std::size_t n = 0; n < 4; n++)
+				{
+					if (time > times[cursor])
+						cursor++;
+					else if (time <= times[cursor - 1])
+						cursor--;
+					else
+						return cursor;
+				}
+			}
+
+			return std::lower_bound(times.begin(), times.end(), time) - times.begin();
+		}
+
+		void evaluate(const _Time& time, float out[4], std::size_t& cursor) const noexcept
+		{
+			assert(!this->empty());
+
+			if (time <= times.front())
+				std::memcpy(out, values.data(), sizeof(float) * components);
+			else if (time >= times.back())
+				std::memcpy(out, values.data() + (times.size() - 1) * components, sizeof(float) * components);
+			else
+			{
+				cursor = this->search(time, cursor);
+				this->interpolate(cursor, time, out);
+			}
+		}
+
+		void evaluate(const _Time& time, float out[4]) const noexcept
+		{
+			std::size_t cursor = 0;
+			this->evaluate(time, out, cursor);
+		}
+
+		void evaluate(const _Time& time, math::Variant& value, std::size_t& cursor) const noexcept
+		{
+			assert(value.getType() == this->type);
+
+			float v[4];
+			this->evaluate(time, v, cursor);
+
+			switch (this->type)
+			{
+			case math::Variant::Type::Float:
+				value.setFloat(v[0]);
+				break;
+			case math::Variant::Type::Float2:
+				value.setFloat2(math::float2(v[0], v[1]));
+				break;
+			case math::Variant::Type::Float3:
+				value.setFloat3(math::float3(v[0], v[1], v[2]));
+				break;
+			case math::Variant::Type::Float4:
+				value.setFloat4(math::float4(v[0], v[1], v[2], v[3]));
+				break;
+			case math::Variant::Type::Quaternion:
+				value.setQuaternion(math::Quaternion(v));
+				break;
+			default:
+				break;
+			}
+		}
+
+		static bool pack(const std::shared_ptr<Interpolator<_Time>>& interpolator, BezierControl& control) noexcept
+		{
+			if (!interpolator)
+			{
+				control = { 0, 127, 0, 127 };
+				return true;
+			}
+
+			auto path = dynamic_cast<const PathInterpolator<_Time>*>(interpolator.get());
+			if (!path)
+				return false;
+
+			auto quantize = [](_Time v, std::uint8_t& q)
+			{
+				auto i = std::lround(v * 127.0f);
+				if (i < 0 || i > 127 || std::abs(i / 127.0f - v) > math::EPSILON_E4)
+					return false;
+				q = static_cast<std::uint8_t>(i);
+				return true;
+			};
+
+			return quantize(path->xa, control.xa) && quantize(path->xb, control.xb) && quantize(path->ya, control.ya) && quantize(path->yb, control.yb);
+		}
+
+	private:
+		void interpolate(std::size_t index, const _Time& time, float out[4]) const noexcept
+		{
+			auto& a = times[index - 1];
+			auto& b = times[index];
+			auto t = (time - a) / (b - a);
+
+			if (tables[index])
+				t = tables[index]->solve(t, solver);
+
+			auto va = values.data() + (index - 1) * components;
+			auto vb = values.data() + index * components;
+
+			if (this->type == math::Variant::Type::Quaternion)
+			{
+				auto q = math::slerp(math::Quaternion(va), math::Quaternion(vb), t);
+				out[0] = q.x;
+				out[1] = q.y;
+				out[2] = q.z;
+				out[3] = q.w;
+			}
+			else
+			{
+				for (std::uint8_t i = 0; i < components; i++)
+					out[i] = va[i] + (vb[i] - va[i]) * t;
+			}
+		}
+	};
+}
+
+#endif
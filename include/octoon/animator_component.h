@@ -2,9 +2,33 @@
 #define OCTOON_ANIMATOR_COMPONENT_H_
 
 #include <octoon/animation_component.h>
+#include <octoon/pose_buffer.h>
 
 namespace octoon
 {
+	enum class AnimatorProperty : std::uint8_t
+	{
+		LocalPosition,
+		LocalPositionX,
+		LocalPositionY,
+		LocalPositionZ,
+		LocalScale,
+		LocalScaleX,
+		LocalScaleY,
+		LocalScaleZ,
+		LocalRotation,
+		LocalRotationX,
+		LocalRotationY,
+		LocalRotationZ,
+		LocalRotationW,
+		LocalForward,
+		LocalEulerAnglesRaw,
+		LocalEulerAnglesRawX,
+		LocalEulerAnglesRawY,
+		LocalEulerAnglesRawZ,
+		Message
+	};
+
 	class OCTOON_EXPORT AnimatorComponent final : public AnimationComponent
 	{
 		OctoonDeclareSubClass(AnimatorComponent, AnimationComponent)
@@ -45,6 +69,22 @@ namespace octoon
 
 		GameComponentPtr clone() const noexcept;
 
+	private:
+		struct AnimatorChannel
+		{
+			AnimatorProperty property;
+			const AnimationCurve<float>* curve;
+			const std::string* name;
+		};
+
+		struct AnimatorTrack
+		{
+			std::size_t index;
+			std::size_t first;
+			std::size_t last;
+			std::shared_ptr<TransformComponent> transform;
+		};
+
 	private:
 		void onActivate() noexcept(false);
 		void onDeactivate() noexcept;
@@ -55,18 +95,28 @@ namespace octoon
 		void updateAvatar(float delta = 0.0f) noexcept;
 		void updateAnimation(float delta = 0.0f) noexcept;
 
+		void updateTrack(const AnimatorTrack& track, const math::float3& bindpose) noexcept;
+
 	private:
 		void updateBindpose(const GameObjects& avatar) noexcept;
 		void updateBindmap() noexcept;
+		bool isBindmapDirty() const noexcept;
+
+		static AnimatorProperty parseProperty(std::string_view name) noexcept;
 
 	private:
 		bool enableAnimation_;
 		bool enableAnimOnVisableOnly_;
 
 		math::float3s bindpose_;
+		PoseBuffer pose_;
 
 		std::shared_ptr<Animation> animation_;
-		std::unordered_map<std::string, std::size_t> bindmap_;
+		std::weak_ptr<AnimationClip> bindClip_;
+		std::uint32_t bindVersion_;
+
+		std::vector<AnimatorTrack> tracks_;
+		std::vector<AnimatorChannel> channels_;
 
 		GameObjects avatar_;
 		AnimatorStateInfo animatorStateInfo_;
@@ -0,0 +1,48 @@
+#ifndef OCTOON_ASSET_ARTIFACT_CACHE_H_
+#define OCTOON_ASSET_ARTIFACT_CACHE_H_
+
+#include <octoon/texture/texture.h>
+#include <octoon/animation/animation.h>
+#include <filesystem>
+
+namespace octoon
+{
+	// Keeps the result of an import next to the project so the source file does not have to be
+	// decoded again. An artifact is only used while the source file and its .meta file are unchanged:
+	// the size and write time are compared first, and the content hash decides when they differ.
+	// Each artifact is a fixed header followed by 16 byte aligned plain arrays, read through a memory
+	// mapping. Only textures and animations are cached: PMX models are parsed from their mapped source
+	// on every open, their mesh arrays are not stored here.
+	class OCTOON_EXPORT AssetArtifactCache final
+	{
+	public:
+		AssetArtifactCache() noexcept;
+		~AssetArtifactCache() noexcept;
+
+		// An empty path disables the cache.
+		void setCachePath(const std::filesystem::path& path) noexcept;
+		const std::filesystem::path& getCachePath() const noexcept;
+
+		// Textures are stored after import processing such as mip generation and compression.
+		std::shared_ptr<Texture> loadTexture(const std::filesystem::path& diskPath) const noexcept;
+		void saveTexture(const std::filesystem::path& diskPath, const Texture& texture) const noexcept;
+
+		// Only curves whose keyframes use path interpolators (or none) can be stored.
+		std::shared_ptr<Animation> loadAnimation(const std::filesystem::path& diskPath) const noexcept;
+		void saveAnimation(const std::filesystem::path& diskPath, const Animation& animation) const noexcept;
+
+		void clear() const noexcept;
+
+	private:
+		std::filesystem::path getArtifactPath(const std::filesystem::path& diskPath, std::uint32_t kind) const noexcept;
+
+	private:
+		AssetArtifactCache(const AssetArtifactCache&) = delete;
+		AssetArtifactCache& operator=(const AssetArtifactCache&) = delete;
+
+	private:
+		std::filesystem::path cachePath_;
+	};
+}
+
+#endif
@@ -3,7 +3,11 @@
 
 #include <octoon/video/renderer.h>
 #include <octoon/asset_pipeline.h>
+#include <octoon/runtime/thread_pool.h>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
 #include <set>
 #include <map>
 
@@ -13,6 +17,9 @@ namespace octoon
 	{
 		OctoonDeclareSingleton(AssetDatabase)
 	public:
+		using AssetFuture = std::shared_future<std::shared_ptr<Object>>;
+		using AssetCallback = std::function<void(const std::shared_ptr<Object>&)>;
+
 		AssetDatabase() noexcept;
 		virtual ~AssetDatabase() noexcept;
 
@@ -41,6 +48,7 @@ namespace octoon
 		std::filesystem::path getAssetPath(const std::string& uuid) const noexcept;
 		std::filesystem::path getAssetPath(const std::shared_ptr<const Object>& asset) const noexcept;
 		std::filesystem::path getAbsolutePath(const std::filesystem::path& assetPath) const noexcept;
+		const AssetArtifactCache* getArtifactCache(const std::filesystem::path& assetPath) const noexcept;
 		std::filesystem::path getAssetExtension(const std::shared_ptr<const Object>& asset, std::string_view defaultExtension = "") const noexcept;
 
 		std::string getAssetGuid(const std::filesystem::path& assetPath) const noexcept;
@@ -56,6 +64,19 @@ namespace octoon
 		std::shared_ptr<Object> loadAsset(const std::string& guid, std::int64_t localId) noexcept(false);
 		std::shared_ptr<Object> loadAssetAtPath(const std::filesystem::path& assetPath) noexcept(false);
 
+		// Reads and parses the file on the worker pool; the object itself is built on the thread calling
+		// update(). Requests for a path that is already in flight share that request. Like getAbsolutePath,
+		// this is callable from any thread, including from AssetImporter::onPrepareAsset. Exceptions thrown
+		// by a callback are logged and do not reach the other callbacks.
+		AssetFuture loadAssetAtPathAsync(const std::filesystem::path& assetPath) noexcept(false);
+		AssetFuture loadAssetAtPathAsync(const std::filesystem::path& assetPath, AssetCallback&& callback) noexcept(false);
+
+		// Finishes every asynchronous request whose file work is done: runs the importer, uploads the
+		// textures and invokes the callbacks. Called once per frame from the render thread.
+		void update() noexcept;
+
+		std::size_t getNumPendingLoads() const noexcept;
+
 		template<typename T>
 		std::shared_ptr<T> loadAsset(const std::string& guid, std::int64_t localId) noexcept(false)
 		{
@@ -78,6 +99,20 @@ namespace octoon
 		bool isDirty(const std::shared_ptr<Object>& object) const noexcept;
 		void setDirty(const std::shared_ptr<Object>& object, bool dirty = true) noexcept(false);
 
+	private:
+		struct AsyncRequest
+		{
+			std::filesystem::path assetPath;
+			std::shared_ptr<AssetPipeline> pipeline;
+			std::shared_ptr<AssetImporter> importer;
+			std::future<void> prepared;
+			std::promise<std::shared_ptr<Object>> promise;
+			AssetFuture future;
+			std::vector<AssetCallback> callbacks;
+		};
+
+		void finishRequest(const std::shared_ptr<AsyncRequest>& request) noexcept;
+
 	private:
 		AssetDatabase(const AssetDatabase&) = delete;
 		AssetDatabase& operator=(const AssetDatabase&) = delete;
@@ -88,6 +123,13 @@ namespace octoon
 		std::vector<std::shared_ptr<AssetPipeline>> assetPipeline_;
 		std::map<std::filesystem::path, std::shared_ptr<Object>> assetCaches_;
 
+		// mount and unmount may race with the workers resolving paths in AssetImporter::onPrepareAsset
+		mutable std::mutex pipelineMutex_;
+
+		mutable std::mutex requestMutex_;
+		std::unique_ptr<ThreadPool> threadPool_;
+		std::map<std::filesystem::path, std::shared_ptr<AsyncRequest>> requests_;
+
 		std::set<std::weak_ptr<const Object>, std::owner_less<std::weak_ptr<const Object>>> dirtyList_;
 		std::map<std::weak_ptr<const Object>, std::vector<std::string>, std::owner_less<std::weak_ptr<const Object>>> labels_;
 	};
@@ -13,6 +13,12 @@ namespace octoon
 		AssetImporter() noexcept;
 		virtual ~AssetImporter() noexcept;
 
+		// Called on a worker thread before onImportAsset when the asset is loaded asynchronously.
+		// It may read files, fill memory owned by the importer and use the thread-safe parts of the
+		// asset database (getAbsolutePath and loadAssetAtPathAsync); everything else that touches
+		// the asset database or the GPU belongs in onImportAsset, which runs on the render thread.
+		virtual void onPrepareAsset(const std::filesystem::path& assetPath) noexcept(false);
+
 		virtual void onImportAsset(AssetImporterContext& context) noexcept(false) = 0;
 
 	private:
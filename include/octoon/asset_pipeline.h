@@ -3,6 +3,7 @@
 
 #include <octoon/game_object.h>
 #include <octoon/asset_importer.h>
+#include <octoon/asset_artifact_cache.h>
 #include <octoon/texture/texture.h>
 #include <octoon/material/mesh_standard_material.h>
 #include <octoon/animation/animation.h>
@@ -39,9 +40,14 @@ namespace octoon
 
 		std::filesystem::path getAbsolutePath(const std::filesystem::path& relativePath) const noexcept;
 
+		const AssetArtifactCache& getArtifactCache() const noexcept;
+
 		void saveAssets() noexcept(false);
 
 		std::shared_ptr<Object> loadAssetAtPath(const std::filesystem::path& assetPath) noexcept(false);
+		std::shared_ptr<Object> loadAssetAtPath(const std::filesystem::path& assetPath, AssetImporter& importer) noexcept(false);
+
+		static std::shared_ptr<AssetImporter> createImporter(const std::filesystem::path& assetPath) noexcept;
 
 		template<typename T>
 		std::shared_ptr<T> loadAssetAtPath(const std::filesystem::path& assetPath) noexcept(false)
@@ -63,6 +69,8 @@ namespace octoon
 		std::u8string name_;
 		std::filesystem::path rootPath_;
 
+		AssetArtifactCache artifactCache_;
+
 		std::set<std::filesystem::path> assetPaths_;
 	};
 }
@@ -41,6 +41,11 @@ namespace octoon
 		virtual bool map(std::ptrdiff_t offset, std::ptrdiff_t count, void** data) noexcept = 0;
 		virtual void unmap() noexcept = 0;
 
+		// Fences the commands submitted so far that read the range, and blocks until those commands
+		// have finished before the range is written again. Only needed for persistently mapped data.
+		virtual void lock(std::ptrdiff_t offset, std::ptrdiff_t count) noexcept;
+		virtual void wait(std::ptrdiff_t offset, std::ptrdiff_t count) noexcept;
+
 		virtual const GraphicsDataDesc& getDataDesc() const noexcept = 0;
 
 	private:
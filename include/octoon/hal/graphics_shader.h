@@ -41,7 +41,7 @@ namespace octoon
 	class OCTOON_EXPORT GraphicsProgramDesc final
 	{
 	public:
-		GraphicsProgramDesc() noexcept = default;
+		GraphicsProgramDesc() noexcept;
 		~GraphicsProgramDesc() = default;
 
 		bool addShader(GraphicsShaderPtr shader) noexcept;
@@ -49,8 +49,17 @@ namespace octoon
 
 		const GraphicsShaders& getShaders() const noexcept;
 
+		// Driver specific linked program previously returned by GraphicsProgram::getProgramBinary.
+		// When set, the shaders are not used and creation fails if the driver rejects the binary.
+		void setProgramBinary(std::uint32_t format, std::vector<std::uint8_t>&& binary) noexcept;
+		std::uint32_t getProgramBinaryFormat() const noexcept;
+		const std::vector<std::uint8_t>& getProgramBinary() const noexcept;
+
 	private:
 		GraphicsShaders _shaders;
+
+		std::uint32_t _binaryFormat;
+		std::vector<std::uint8_t> _binary;
 	};
 
 	class OCTOON_EXPORT GraphicsAttribute : public Object
@@ -142,6 +151,9 @@ namespace octoon
 
 		virtual const GraphicsProgramDesc& getProgramDesc() const noexcept = 0;
 
+		// Returns false when the backend cannot export linked programs.
+		virtual bool getProgramBinary(std::uint32_t& format, std::vector<std::uint8_t>& binary) const noexcept;
+
 	private:
 		GraphicsProgram(const GraphicsProgram&) noexcept = delete;
 		GraphicsProgram& operator=(const GraphicsProgram&) noexcept = delete;
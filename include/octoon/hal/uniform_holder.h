@@ -14,6 +14,9 @@ namespace octoon
 		void setType(UniformAttributeFormat type) noexcept(false);
 		UniformAttributeFormat getType() const noexcept;
 
+		// Bumped by every setter that changes the stored value, so a backend can skip re-uploading it.
+		std::uint32_t getVersion() const noexcept;
+
 		void uniform1b(bool value) noexcept;
 		void uniform1f(float i1) noexcept;
 		void uniform2f(float i1, float i2) noexcept;
@@ -151,6 +154,7 @@ namespace octoon
 		};
 
 		UniformAttributeFormat type_;
+		std::uint32_t version_;
 	};
 }
 
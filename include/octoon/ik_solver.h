@@ -0,0 +1,102 @@
+#ifndef OCTOON_IK_SOLVER_H_
+#define OCTOON_IK_SOLVER_H_
+
+#include <octoon/pose_buffer.h>
+#include <unordered_map>
+
+namespace octoon
+{
+	class CCDSolverComponent;
+
+	// Solves every CCDSolverComponent chain of a model in one pass over a flattened pose. The bones
+	// of all chains and their ancestors are gathered once, parent first, together with the chain
+	// indices and the RotationLimitComponent settings of each link. solve() reads the local pose,
+	// keeps world matrices in a plain array while iterating, and writes the changed bones back
+	// through a PoseBuffer at the end. Knee-like chains of two links whose lower link turns about
+	// a single axis are solved in closed form, other chains run CCD. Between solves the bones are
+	// only held weakly, so a solver may be cached by components of the model it poses. A link that
+	// nothing wrote to since the last solve starts from its rotation before that solve again, so
+	// each frame solves the same way no matter which frame was solved before it.
+	class OCTOON_EXPORT IKSolver final
+	{
+	public:
+		IKSolver() noexcept;
+		explicit IKSolver(const GameObjects& bones) noexcept;
+		~IKSolver() noexcept;
+
+		// Adds a chain for each bone carrying a CCDSolverComponent, in the order of the bones.
+		void setBones(const GameObjects& bones) noexcept;
+		void addSolver(CCDSolverComponent& solver) noexcept;
+		void clear() noexcept;
+
+		std::size_t getNumChains() const noexcept;
+		bool empty() const noexcept;
+
+		void solve() noexcept;
+
+	private:
+		enum class SolveAxis : std::uint8_t
+		{
+			X,
+			Y,
+			Z,
+			None
+		};
+
+		struct Link
+		{
+			std::size_t joint;
+
+			bool limit;
+			bool axisLimit;
+			SolveAxis solveAxis;
+
+			float minimumAngle;
+			float maximumAngle;
+
+			math::float3 minimumAxis;
+			math::float3 maximumAxis;
+		};
+
+		struct Chain
+		{
+			CCDSolverComponent* solver;
+
+			std::size_t goal;
+			std::size_t effector;
+			std::size_t begin;
+			std::size_t end;
+
+			std::uint32_t iterations;
+			float tolerance;
+
+			bool twoBone;
+		};
+
+		std::size_t addJoint(const GameObjectPtr& bone) noexcept;
+
+		void updateWorld(std::size_t first) noexcept;
+		void rotateLink(const Link& link, const math::float3& localEffector, const math::float3& localGoal, std::uint32_t iteration) noexcept;
+
+		void solveCCD(const Chain& chain) noexcept;
+		void solveTwoBone(const Chain& chain) noexcept;
+
+	private:
+		std::vector<std::weak_ptr<GameObject>> joints_;
+		std::unordered_map<const GameObject*, std::size_t> jointMap_;
+		std::vector<std::size_t> parents_;
+		std::vector<std::uint8_t> dirty_;
+		math::float4x4s worlds_;
+
+		std::vector<Link> links_;
+		std::vector<Chain> chains_;
+
+		// per link, the rotation it starts from and the one the last solve left on it
+		math::Quaternions startRotations_;
+		math::Quaternions solvedRotations_;
+
+		PoseBuffer pose_;
+	};
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef OCTOON_IO_MAPPED_FILE_H_
+#define OCTOON_IO_MAPPED_FILE_H_
+
+#include <octoon/runtime/platform.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <ios>
+
+namespace octoon
+{
+	namespace io
+	{
+		// Read-only view of a whole file mapped into memory.
+		class OCTOON_EXPORT MappedFile final
+		{
+		public:
+			MappedFile() noexcept;
+			MappedFile(const std::filesystem::path& path) noexcept;
+			~MappedFile() noexcept;
+
+			bool open(const std::filesystem::path& path) noexcept;
+			void close() noexcept;
+
+			bool is_open() const noexcept;
+
+			const std::uint8_t* data() const noexcept;
+			std::size_t size() const noexcept;
+
+		private:
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+		private:
+			const std::uint8_t* data_;
+			std::size_t size_;
+
+			void* file_;
+			void* mapping_;
+		};
+
+		// Sequential reads from a mapped range. read() has the shape of istream::read so parsers written
+		// against streams carry over unchanged, but every call is a bounds check and a memcpy.
+		class MappedReader final
+		{
+		public:
+			MappedReader(const std::uint8_t* data, std::size_t size) noexcept
+				: data_(data)
+				, size_(size)
+				, offset_(0)
+			{
+			}
+
+			bool read(char* str, std::streamsize cnt) noexcept
+			{
+				if (cnt < 0 || static_cast<std::size_t>(cnt) > size_ - offset_)
+				{
+					offset_ = size_;
+					return false;
+				}
+
+				std::memcpy(str, data_ + offset_, static_cast<std::size_t>(cnt));
+				offset_ += static_cast<std::size_t>(cnt);
+				return true;
+			}
+
+			// Returns the next cnt bytes in place and skips over them, or nullptr if the range is too short.
+			const std::uint8_t* view(std::size_t cnt) noexcept
+			{
+				if (cnt > size_ - offset_)
+				{
+					offset_ = size_;
+					return nullptr;
+				}
+
+				auto ptr = data_ + offset_;
+				offset_ += cnt;
+				return ptr;
+			}
+
+			std::size_t tell() const noexcept { return offset_; }
+			std::size_t remaining() const noexcept { return size_ - offset_; }
+
+		private:
+			const std::uint8_t* data_;
+			std::size_t size_;
+			std::size_t offset_;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef OCTOON_LIGHTMAP_BAKER_H_
+#define OCTOON_LIGHTMAP_BAKER_H_
+
+#include <octoon/mesh/mesh_bvh.h>
+#include <octoon/texture/texture.h>
+#include <octoon/runtime/thread_pool.h>
+
+#include <atomic>
+
+namespace octoon
+{
+	class Geometry;
+	class RenderScene;
+}
+
+namespace octoon::bake
+{
+	// Path traced diffuse lightmaps for every visible geometry of a scene that has a second uv set,
+	// as laid out by Mesh::computeLightMap. All shadow casters share one BVH in world space. The
+	// texels of each lightmap are split into square tiles that run on a thread pool, and samples
+	// accumulate across calls to bake(), so a caller can bake a few samples at a time, show the
+	// intermediate result and stop whenever the noise is low enough.
+	//
+	// A texel stores the irradiance divided by pi, which is what the lightMap uniform of the
+	// forward renderer expects. Only indirect light is stored by default, since the renderer still
+	// shades the punctual lights itself.
+	class OCTOON_EXPORT LightmapBaker final
+	{
+	public:
+		// 0 picks one thread less than the hardware concurrency, but at least one
+		explicit LightmapBaker(std::size_t numThreads = 0) noexcept;
+		~LightmapBaker() noexcept;
+
+		void setResolution(std::uint32_t width, std::uint32_t height) noexcept;
+		std::uint32_t getWidth() const noexcept;
+		std::uint32_t getHeight() const noexcept;
+
+		// Number of surface interactions per path; 1 gathers the light reflected once by the scene.
+		void setNumBounces(std::uint32_t bounces) noexcept;
+		std::uint32_t getNumBounces() const noexcept;
+
+		void setTileSize(std::uint32_t size) noexcept;
+		std::uint32_t getTileSize() const noexcept;
+
+		// Texels left uncovered by the rasterizer get the average of their neighbours this many times
+		// over, so bilinear filtering does not pull black in at chart borders.
+		void setDilation(std::uint32_t texels) noexcept;
+		std::uint32_t getDilation() const noexcept;
+
+		void setDirectLighting(bool enable) noexcept;
+		bool getDirectLighting() const noexcept;
+
+		// Captures geometries, materials and lights. The scene may change afterwards without
+		// affecting the bake. Returns false if no geometry has lightmap uvs.
+		bool setScene(const RenderScene& scene) noexcept(false);
+		void clear() noexcept;
+
+		// Adds the given number of samples to every texel and blocks until done. Returns false if
+		// cancel() was called meanwhile; texels that were already refined keep their samples.
+		bool bake(std::uint32_t samples) noexcept;
+		void cancel() noexcept;
+
+		// Fraction of tiles finished by the running or the last call to bake()
+		float getProgress() const noexcept;
+		std::uint32_t getNumSamples() const noexcept;
+
+		std::size_t getNumLightmaps() const noexcept;
+		const Geometry* getGeometry(std::size_t n) const noexcept;
+
+		// Current estimate of the n-th lightmap as R32G32B32SFloat
+		std::shared_ptr<Texture> getLightmap(std::size_t n) const noexcept(false);
+		std::shared_ptr<Texture> getLightmap(const Geometry& geometry) const noexcept(false);
+
+	private:
+		struct Light
+		{
+			enum Type : std::uint8_t
+			{
+				Directional,
+				Point,
+				Spot
+			};
+
+			Type type;
+			math::float3 radiance;
+			math::float3 position;
+			math::float3 direction;
+			float range;
+			float innerCos;
+			float outerCos;
+		};
+
+		struct Surface
+		{
+			math::float3 albedo;
+			math::float3 emissive;
+		};
+
+		struct Texel
+		{
+			math::float3 position;
+			math::float3 normal;
+			std::uint32_t pixel;
+		};
+
+		struct Tile
+		{
+			std::uint32_t lightmap;
+			std::uint32_t begin;
+			std::uint32_t end;
+		};
+
+		struct Lightmap
+		{
+			const Geometry* geometry;
+
+			std::vector<Texel> texels;
+			std::vector<math::float3> radiance;
+			std::vector<std::uint32_t> samples;
+		};
+
+		void rasterize(const Geometry& geometry, std::vector<Texel>& image) const noexcept;
+		void bakeTile(const Tile& tile, std::uint32_t samples) noexcept;
+
+		math::float3 sampleDirect(const math::float3& position, const math::float3& normal) const noexcept;
+		math::float3 tracePath(const math::float3& position, const math::float3& normal, std::uint32_t texel, std::uint32_t sample) const noexcept;
+
+	private:
+		std::uint32_t width_;
+		std::uint32_t height_;
+		std::uint32_t bounces_;
+		std::uint32_t tileSize_;
+		std::uint32_t dilation_;
+		std::uint32_t numSamples_;
+
+		bool directLighting_;
+
+		float bias_;
+		math::float3 skyRadiance_;
+
+		MeshBVH bvh_;
+		math::float3s vertices_;
+		std::vector<math::uint1s> indices_;
+		std::vector<Surface> surfaces_;
+
+		std::vector<Light> lights_;
+		std::vector<Lightmap> lightmaps_;
+		std::vector<Tile> tiles_;
+
+		std::atomic<bool> cancel_;
+		std::atomic<std::uint32_t> finishedTiles_;
+
+		std::unique_ptr<ThreadPool> threadPool_;
+	};
+}
+
+#endif
@@ -177,6 +177,10 @@ namespace octoon
 		void setDirty(bool dirty) noexcept;
 		bool isDirty() const noexcept;
 
+		// Bumped on every change of the material; unlike the dirty flag it is never reset, so each
+		// consumer can keep the version it last saw.
+		std::size_t getVersion() const noexcept;
+
 		const std::vector<MaterialParam>& getMaterialParams() const noexcept;
 
 		std::size_t hash() const noexcept;
@@ -188,6 +192,7 @@ namespace octoon
 		std::string name_;
 
 		bool dirty_;
+		std::size_t version_;
 
 		bool _enableScissorTest;
 		bool _enableSrgb;
@@ -0,0 +1,87 @@
+#ifndef OCTOON_MATH_FRUSTUM_H_
+#define OCTOON_MATH_FRUSTUM_H_
+
+#include <octoon/math/mat4.h>
+#include <octoon/math/box3.h>
+
+namespace octoon
+{
+	namespace math
+	{
+		namespace detail
+		{
+			template<typename T>
+			class Frustum final
+			{
+			public:
+				typedef typename trait::type_addition<T>::value_type value_type;
+				typedef typename trait::type_addition<T>::pointer pointer;
+				typedef typename trait::type_addition<T>::const_pointer const_pointer;
+				typedef typename trait::type_addition<T>::reference reference;
+				typedef typename trait::type_addition<T>::const_reference const_reference;
+
+				enum Plane { Left, Right, Bottom, Top, Near, Far, NumPlanes };
+
+				// planes are (normal, distance) facing inwards, so dot(normal, p) + distance >= 0 is inside
+				Vector4<T> planes[NumPlanes];
+
+				Frustum() noexcept = default;
+				explicit Frustum(const Matrix4x4<T>& viewProject) noexcept { this->set(viewProject); }
+
+				void set(const Matrix4x4<T>& m) noexcept
+				{
+					Vector4<T> x(m.a1, m.b1, m.c1, m.d1);
+					Vector4<T> y(m.a2, m.b2, m.c2, m.d2);
+					Vector4<T> z(m.a3, m.b3, m.c3, m.d3);
+					Vector4<T> w(m.a4, m.b4, m.c4, m.d4);
+
+					// the near plane assumes a [-w, w] depth range, which stays conservative for [0, w]
+					planes[Left] = w + x;
+					planes[Right] = w - x;
+					planes[Bottom] = w + y;
+					planes[Top] = w - y;
+					planes[Near] = w + z;
+					planes[Far] = w - z;
+
+					for (auto& plane : planes)
+					{
+						T length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+						if (length > static_cast<T>(0.0))
+							plane /= length;
+					}
+				}
+			};
+		}
+
+		template<typename T>
+		inline bool contains(const detail::Frustum<T>& frustum, const detail::Vector3<T>& pt) noexcept
+		{
+			for (auto& plane : frustum.planes)
+			{
+				if (plane.x * pt.x + plane.y * pt.y + plane.z * pt.z + plane.w < static_cast<T>(0.0))
+					return false;
+			}
+
+			return true;
+		}
+
+		template<typename T>
+		inline bool intersects(const detail::Frustum<T>& frustum, const detail::Box3<T>& aabb) noexcept
+		{
+			for (auto& plane : frustum.planes)
+			{
+				// test the corner furthest along the plane normal; if it is outside, so is the box
+				T x = plane.x >= static_cast<T>(0.0) ? aabb.max.x : aabb.min.x;
+				T y = plane.y >= static_cast<T>(0.0) ? aabb.max.y : aabb.min.y;
+				T z = plane.z >= static_cast<T>(0.0) ? aabb.max.z : aabb.min.z;
+
+				if (plane.x * x + plane.y * y + plane.z * z + plane.w < static_cast<T>(0.0))
+					return false;
+			}
+
+			return true;
+		}
+	}
+}
+
+#endif
@@ -13,6 +13,7 @@
 #include <octoon/math/triangle.h>
 #include <octoon/math/raycast.h>
 #include <octoon/math/boundingbox.h>
+#include <octoon/math/frustum.h>
 #include <octoon/math/sh.h>
 
 #endif
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <octoon/model/bone.h>
 #include <octoon/mesh/combine_mesh.h>
 #include <octoon/model/vertex_weight.h>
+#include <octoon/mesh/skinning.h>
+#include <octoon/mesh/mesh_bvh.h>
 #include <octoon/math/math.h>
 #include <octoon/runtime/object.h>
 
@@ -35,6 +37,7 @@ namespace octoon
 		void setTangentArray(const math::float4s& array) noexcept;
 		void setTexcoordArray(const math::float2s& array, std::uint8_t n = 0) noexcept;
 		void setWeightArray(const std::vector<VertexWeight>& array) noexcept;
+		void setSkinningArray(const std::vector<VertexSkinning>& array) noexcept;
 		void setIndicesArray(const math::uint1s& array, std::size_t n = 0) noexcept;
 		void setBindposes(const math::float4x4s& array) noexcept;
 
@@ -44,6 +47,7 @@ namespace octoon
 		void setTangentArray(math::float4s&& array) noexcept;
 		void setTexcoordArray(math::float2s&& array, std::uint8_t n = 0) noexcept;
 		void setWeightArray(std::vector<VertexWeight>&& array) noexcept;
+		void setSkinningArray(std::vector<VertexSkinning>&& array) noexcept;
 		void setIndicesArray(math::uint1s&& array, std::size_t n = 0) noexcept;
 		void setBindposes(math::float4x4s&& array) noexcept;
 
@@ -53,6 +57,7 @@ namespace octoon
 		math::float4s& getColorArray() noexcept;
 		math::float2s& getTexcoordArray(std::uint8_t n = 0) noexcept;
 		std::vector<VertexWeight>& getWeightArray() noexcept;
+		std::vector<VertexSkinning>& getSkinningArray() noexcept;
 		math::uint1s& getIndicesArray(std::size_t n = 0) noexcept;
 		math::float4x4s& getBindposes() noexcept;
 
@@ -62,6 +67,7 @@ namespace octoon
 		const math::float4s& getColorArray() const noexcept;
 		const math::float2s& getTexcoordArray(std::uint8_t n = 0) const noexcept;
 		const std::vector<VertexWeight>& getWeightArray() const noexcept;
+		const std::vector<VertexSkinning>& getSkinningArray() const noexcept;
 		const math::uint1s& getIndicesArray(std::size_t n = 0) const noexcept;
 
 		const math::float4x4s& getBindposes() const noexcept;
@@ -90,9 +96,16 @@ namespace octoon
 		const math::BoundingBox& getBoundingBoxAll() const noexcept;
 		const math::BoundingBox& getBoundingBox(std::size_t n) const noexcept;
 
+		// Marking a mesh dirty also refits its BVH before the next raycast, which is how skinned
+		// meshes keep raycasts in sync with their deformed vertices.
 		void setDirty(bool dirty) noexcept;
 		bool isDirty() const noexcept;
 
+		// Bumped by every call that replaces or merges indices. Edits through getIndicesArray() are not
+		// seen, so they have to be stored back with setIndicesArray().
+		std::size_t getIndicesVersion() const noexcept;
+
+		// Closest hit and all hits along the ray, accelerated by a BVH that is built on first use.
 		bool raycast(const math::Raycast& ray, MeshHit& hit) noexcept;
 		bool raycastAll(const math::Raycast& ray, std::vector<MeshHit>& hits) noexcept;
 
@@ -102,6 +115,8 @@ namespace octoon
 	private:
 		bool dirty_;
 
+		std::size_t indicesVersion_;
+
 		std::string name_;
 
 		math::float3s vertices_;
@@ -113,9 +128,12 @@ namespace octoon
 		math::BoundingBox boundingBox_;
 
 		std::vector<VertexWeight> weights_;
+		std::vector<VertexSkinning> skinnings_;
 
 		std::vector<math::uint1s> triangles_;
 		std::vector<math::BoundingBox> boundingBoxs_;
+
+		MeshBVH bvh_;
 	};
 
 	using MeshPtr = std::shared_ptr<Mesh>;
@@ -0,0 +1,102 @@
+#ifndef OCTOON_MESH_BVH_H_
+#define OCTOON_MESH_BVH_H_
+
+#include <octoon/math/math.h>
+#include <octoon/runtime/platform.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace octoon
+{
+	struct MeshBVHHit
+	{
+		std::size_t subset;
+		std::size_t triangle;
+		float distance;
+	};
+
+	// Four-wide bounding volume hierarchy over the triangles of all subsets of a mesh, built with a
+	// binned surface area heuristic. Each node stores the boxes of its children as SoA lanes and each
+	// leaf stores its triangles in packets of four, so a ray is tested against four boxes or four
+	// triangles at once. Meshes without indices are treated as a triangle list of their vertices.
+	class OCTOON_EXPORT MeshBVH final
+	{
+	public:
+		MeshBVH() noexcept;
+		MeshBVH(const MeshBVH& bvh) noexcept;
+		MeshBVH(MeshBVH&& bvh) noexcept;
+		~MeshBVH() noexcept;
+
+		void build(const math::float3s& vertices, const std::vector<math::uint1s>& indices) noexcept;
+
+		// Recomputes the bounds for moved vertices, keeping the tree. Returns false without changing
+		// anything if the triangles no longer match the ones the tree was built from.
+		bool refit(const math::float3s& vertices, const std::vector<math::uint1s>& indices) noexcept;
+
+		// Lazy variant for meshes that are raycast from several threads: invalidate() marks the tree
+		// for a refit or a full rebuild and update() performs it once, under a lock.
+		void invalidate(bool rebuild) noexcept;
+		void update(const math::float3s& vertices, const std::vector<math::uint1s>& indices) noexcept;
+
+		void clear() noexcept;
+		bool empty() const noexcept;
+
+		std::size_t getNumNodes() const noexcept;
+		std::size_t getNumTriangles() const noexcept;
+		math::AABB getBoundingBox() const noexcept;
+
+		// Triangles are two-sided. Hits are accepted in the open range (0, ray.maxDistance).
+		bool raycast(const math::Raycast& ray, MeshBVHHit& hit) const noexcept;
+		bool raycastAll(const math::Raycast& ray, std::vector<MeshBVHHit>& hits) const noexcept;
+
+		MeshBVH& operator=(const MeshBVH& bvh) noexcept;
+		MeshBVH& operator=(MeshBVH&& bvh) noexcept;
+
+	private:
+		struct alignas(16) Node
+		{
+			float minX[4];
+			float minY[4];
+			float minZ[4];
+			float maxX[4];
+			float maxY[4];
+			float maxZ[4];
+			std::uint32_t child[4];
+			std::uint32_t count[4];
+			std::uint32_t numChildren;
+		};
+
+		struct alignas(16) TrianglePacket
+		{
+			float v0[3][4];
+			float e1[3][4];
+			float e2[3][4];
+			std::uint32_t id[4];
+		};
+
+		friend class MeshBVHBuilder;
+
+		void setPacket(TrianglePacket& packet, std::size_t lane, const math::float3s& vertices, std::uint32_t id) const noexcept;
+		void refitNodes(const math::float3s& vertices) noexcept;
+
+	private:
+		enum State : std::uint8_t
+		{
+			Valid,
+			Refit,
+			Rebuild
+		};
+
+		std::vector<Node> nodes_;
+		std::vector<TrianglePacket> packets_;
+
+		std::vector<std::uint32_t> indices_;
+		std::vector<std::size_t> offsets_;
+
+		std::atomic<std::uint8_t> state_;
+		std::mutex mutex_;
+	};
+}
+
+#endif
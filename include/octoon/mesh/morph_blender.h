@@ -0,0 +1,90 @@
+#ifndef OCTOON_MORPH_BLENDER_H_
+#define OCTOON_MORPH_BLENDER_H_
+
+#include <octoon/math/math.h>
+#include <octoon/runtime/platform.h>
+
+namespace octoon
+{
+	// View of one morph target: the vertices it moves with their position offsets and,
+	// optionally, normal offsets of the same length. The version is the owner's edit counter, so
+	// targets edited in place still compare unequal to the ones a blender was built from.
+	struct MorphTarget
+	{
+		const std::uint32_t* indices;
+		const math::float3* offsets;
+		const math::float3* normals;
+		std::size_t count;
+		std::uint32_t version;
+
+		friend bool operator==(const MorphTarget& a, const MorphTarget& b) noexcept
+		{
+			return a.indices == b.indices && a.offsets == b.offsets && a.normals == b.normals && a.count == b.count && a.version == b.version;
+		}
+
+		friend bool operator!=(const MorphTarget& a, const MorphTarget& b) noexcept
+		{
+			return !(a == b);
+		}
+	};
+
+	// Accumulates weighted morph targets into per-vertex deltas. A weight change only adds the
+	// difference of that target into the rows it touches; rows are unique within a target, so the
+	// threaded scatter needs no atomics. A vertex-major (CSR) copy of the table rebuilds every row
+	// from scratch on invalidation and periodically to bound floating point drift.
+	class OCTOON_EXPORT MorphBlender final
+	{
+	public:
+		MorphBlender() noexcept;
+		~MorphBlender() noexcept;
+
+		// 0 picks half of the available hardware threads.
+		void setThreadCount(std::uint32_t count) noexcept;
+		std::uint32_t getThreadCount() const noexcept;
+
+		void build(std::size_t numVertices, const std::vector<MorphTarget>& targets) noexcept;
+		void clear() noexcept;
+		void invalidate() noexcept;
+
+		bool empty() const noexcept;
+		bool hasNormals() const noexcept;
+
+		std::size_t getNumRows() const noexcept;
+		std::size_t getNumTargets() const noexcept;
+
+		void setWeight(std::size_t target, float weight) noexcept;
+		float getWeight(std::size_t target) const noexcept;
+
+		// Writes base + weighted deltas into the rows affected since the last call. The outputs must
+		// hold a copy of the base streams from the previous build. Returns false if nothing changed.
+		bool update(const math::float3s& baseVertices, const math::float3s& baseNormals, math::float3s& vertices, math::float3s& normals) noexcept;
+
+	private:
+		bool invalid_;
+		bool hasNormals_;
+		std::uint32_t threads_;
+
+		math::uint1s rows_;
+		math::uint1s rowStarts_;
+		math::uint1s entryTargets_;
+		math::float3s entryOffsets_;
+		math::float3s entryNormals_;
+
+		math::uint1s targetStarts_;
+		math::uint1s targetRows_;
+		math::float3s targetOffsets_;
+		math::float3s targetNormals_;
+
+		math::float3s deltas_;
+		math::float3s normalDeltas_;
+
+		std::vector<float> weights_;
+		std::vector<float> applied_;
+		std::size_t incremental_;
+
+		std::vector<std::uint8_t> dirty_;
+		math::uint1s dirtyRows_;
+	};
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef OCTOON_SKINNING_H_
+#define OCTOON_SKINNING_H_
+
+#include <octoon/math/math.h>
+#include <octoon/runtime/platform.h>
+#include <octoon/model/vertex_weight.h>
+
+namespace octoon
+{
+	enum class SkinningType : std::uint8_t
+	{
+		Linear,
+		DualQuaternion,
+		Sdef
+	};
+
+	// Per-vertex skinning method as stored by PMX. The SDEF centre and reference points are
+	// only meaningful for Sdef vertices, which always blend the first two bones.
+	struct VertexSkinning
+	{
+		SkinningType type;
+		math::float3 sdefC;
+		math::float3 sdefR0;
+		math::float3 sdefR1;
+	};
+
+	// Affine joint matrix stored as four padded columns (x, y, z axes and translation) so the
+	// SIMD paths can blend it with plain vector multiply-adds.
+	struct alignas(32) SkinningJoint
+	{
+		float a[4];
+		float b[4];
+		float c[4];
+		float d[4];
+	};
+
+	// Skinning of vertex/normal streams. Linear vertices sum the weighted joint matrices once
+	// and transform the position and normal in a single pass; dual quaternion and SDEF vertices
+	// are picked per vertex from the skinning stream and handled in the same threaded loop.
+	class OCTOON_EXPORT SkinningKernel final
+	{
+	public:
+		SkinningKernel() noexcept;
+		~SkinningKernel() noexcept;
+
+		// 0 picks half of the available hardware threads.
+		void setThreadCount(std::uint32_t count) noexcept;
+		std::uint32_t getThreadCount() const noexcept;
+
+		void setJoints(const math::float4x4s& joints) noexcept;
+		const std::vector<SkinningJoint>& getJoints() const noexcept;
+
+		// The output streams may alias the input ones. A null or empty skinning stream means
+		// every vertex uses linear blending.
+		void skin(const math::float3* vertices, const math::float3* normals, const VertexWeight* weights, const VertexSkinning* skinnings, math::float3* outVertices, math::float3* outNormals, std::size_t count) const noexcept;
+		void skin(math::float3s& vertices, math::float3s& normals, const std::vector<VertexWeight>& weights, const std::vector<VertexSkinning>& skinnings) const noexcept;
+		void skin(const math::float3s& vertices, const math::float3s& normals, const std::vector<VertexWeight>& weights, const std::vector<VertexSkinning>& skinnings, math::float3s& outVertices, math::float3s& outNormals) const noexcept;
+
+	private:
+		std::uint32_t threads_;
+		std::vector<SkinningJoint> joints_;
+		std::vector<math::Quaternion> rotations_;
+		std::vector<math::Quaternion> duals_;
+	};
+}
+
+#endif
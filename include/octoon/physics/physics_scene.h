@@ -15,8 +15,10 @@ namespace octoon
 	{
 	public:
 		math::float3 gravity;
+		bool enableMultiThreading;
 		PhysicsSceneDesc()
-			:gravity(0.f, -9.8f, 0.f) {}
+			:gravity(0.f, -9.8f, 0.f)
+			,enableMultiThreading(false) {}
 	};
 
 	class OCTOON_EXPORT PhysicsScene
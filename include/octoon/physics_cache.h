@@ -0,0 +1,109 @@
+#ifndef OCTOON_PHYSICS_CACHE_H_
+#define OCTOON_PHYSICS_CACHE_H_
+
+#include <octoon/pose_buffer.h>
+#include <octoon/io/mapped_file.h>
+#include <filesystem>
+#include <fstream>
+
+namespace octoon
+{
+	class ClothComponent;
+	class PhysicsFeature;
+	class RigidbodyComponent;
+
+	// Records the result of a simulation once per frame and plays it back without simulating. All
+	// frames have the same size, so a seek is an offset into the mapped file: positions are stored
+	// as 16 bit values inside the bounds of their frame, rotations as their three smallest components,
+	// which keeps a body at 12 bytes and a cloth particle at 6. The first frame of every block of
+	// SnapshotInterval frames is preceded by the full precision state including velocities, so that
+	// recording can resume close to the first changed frame instead of at the start.
+	class OCTOON_EXPORT PhysicsCache final
+	{
+	public:
+		static constexpr std::size_t SnapshotInterval = 30;
+
+		PhysicsCache() noexcept;
+		~PhysicsCache() noexcept;
+
+		// Gathers the dynamic and kinematic rigidbodies and the cloths below the objects. Frames already
+		// stored in the file are kept if they were recorded for the same bodies at the same frame rate.
+		bool open(const std::filesystem::path& path, const GameObjects& objects, float frameRate = 30.0f) noexcept;
+		void close() noexcept;
+
+		bool isOpen() const noexcept;
+
+		float getFrameRate() const noexcept;
+
+		std::size_t getNumFrames() const noexcept;
+		std::size_t getNumBodies() const noexcept;
+		std::size_t getNumParticles() const noexcept;
+
+		// Hashes the simulation settings and the quantized pose of the kinematic bodies, which is everything a
+		// frame depends on besides the frame before it. A stored frame whose key differs has been edited since.
+		std::uint64_t computeInputKey(const PhysicsFeature& feature) const noexcept;
+		std::uint64_t getInputKey(std::size_t frame) const noexcept;
+
+		// Drops the frame and every frame after it.
+		void invalidate(std::size_t frame) noexcept;
+
+		// Appends the current pose of the bodies and cloths as frame getNumFrames().
+		bool record(std::uint64_t inputKey) noexcept;
+
+		// Restores bodies, velocities and cloths from the closest full state at or before the frame, which is
+		// the last recorded frame when it lies in the same block and the block snapshot otherwise. The frames
+		// from getResumeFrame(frame) up to the requested one have to be simulated again.
+		std::size_t getSnapshotFrame(std::size_t frame) const noexcept;
+		std::size_t getResumeFrame(std::size_t frame) const noexcept;
+		bool resume(std::size_t frame) noexcept;
+
+		// Writes the pose at the given time back to the objects, interpolated between the nearest frames.
+		bool sample(float time) noexcept;
+
+	private:
+		std::size_t getSnapshotOffset(std::size_t frame) const noexcept;
+		std::size_t getFrameOffset(std::size_t frame) const noexcept;
+
+		const std::uint8_t* map(std::size_t offset, std::size_t size) const noexcept;
+
+		bool beginWrite() noexcept;
+		void writeHeader() const noexcept;
+
+		void captureState(std::uint8_t* state) const noexcept;
+		void restoreState(const std::uint8_t* state) noexcept;
+
+	private:
+		PhysicsCache(const PhysicsCache&) = delete;
+		PhysicsCache& operator=(const PhysicsCache&) = delete;
+
+	private:
+		std::filesystem::path path_;
+
+		float frameRate_;
+
+		std::size_t numFrames_;
+		std::size_t numParticles_;
+		std::size_t frameSize_;
+		std::size_t snapshotSize_;
+		std::size_t blockSize_;
+
+		GameObjects bodies_;
+		GameObjects kinematics_;
+		std::vector<RigidbodyComponent*> rigidbodies_;
+		std::vector<ClothComponent*> cloths_;
+
+		PoseBuffer pose_;
+
+		mutable std::fstream stream_;
+		mutable io::MappedFile file_;
+
+		std::vector<std::uint8_t> buffer_;
+		math::float4s partices_;
+
+		// the full state after the last recorded frame, playback overwrites the bodies in between
+		std::size_t headFrame_;
+		std::vector<std::uint8_t> head_;
+	};
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define OCTOON_PHYSICS_FEATURE_H_
 
 #include <octoon/game_feature.h>
+#include <octoon/pose_buffer.h>
 #include <octoon/physics/physics_context.h>
 
 namespace octoon
@@ -19,6 +20,11 @@ namespace octoon
 		void setGroundEnable(bool value) noexcept;
 		bool getGroundEnable() const noexcept;
 
+		// Steps the scene with Bullet's multi-threaded world. The scene is created when the feature is
+		// activated, so this has to be set before the game app starts and is ignored afterwards.
+		void setEnableMultiThreading(bool enable) noexcept;
+		bool getEnableMultiThreading() const noexcept;
+
 		void setFixedTimeStep(float fixedTimeStep) noexcept;
 		float getFixedTimeStep() const noexcept;
 
@@ -32,6 +38,10 @@ namespace octoon
 
 		void reset() noexcept;
 
+		// Stages the pose of a simulated body while the results are fetched, all poses are written
+		// back through one PoseBuffer pass afterwards.
+		void addFetchResult(GameObject* object, const math::float3& position, const math::Quaternion& rotation) noexcept;
+
 	public:
 		void onActivate() except override;
 		void onDeactivate() noexcept override;
@@ -48,6 +58,9 @@ namespace octoon
 		std::shared_ptr<PhysicsContext> getContext();
 		std::shared_ptr<PhysicsScene> getScene();
 
+	private:
+		void fetchResults() noexcept;
+
 	private:
 		PhysicsFeature(const PhysicsFeature&) = delete;
 		PhysicsFeature& operator=(const PhysicsFeature&) = delete;
@@ -55,6 +68,7 @@ namespace octoon
 	private:
 		bool enableSimulate_;
 		bool enableGround_;
+		bool enableMultiThreading_;
 
 		int maxSubSteps_;
 		float fixedTimeStep_;
@@ -62,6 +76,12 @@ namespace octoon
 
 		std::shared_ptr<PhysicsContext> physicsContext;
 		std::shared_ptr<PhysicsScene> physicsScene;
+
+		std::vector<GameObject*> fetchObjects_;
+		math::float3s fetchPositions_;
+		math::Quaternions fetchRotations_;
+
+		PoseBuffer poseBuffer_;
 	};
 }
 
@@ -15,6 +15,7 @@ namespace octoon
 		PMXImporter() noexcept;
 		virtual ~PMXImporter() noexcept;
 
+		virtual void onPrepareAsset(const std::filesystem::path& assetPath) noexcept(false) override;
 		virtual void onImportAsset(AssetImporterContext& context) noexcept(false) override;
 
 		static bool save(const GameObject& gameObject, PMX& pmx, const std::filesystem::path& path) noexcept(false);
@@ -29,6 +30,9 @@ namespace octoon
 		void createMorph(AssetImporterContext& context, const PMX& pmx, GameObjectPtr& mesh) noexcept(false);
 		void createMeshes(AssetImporterContext& context, const PMX& pmx, GameObjectPtr& object, const GameObjects& bones) noexcept(false);
 		void createMaterials(AssetImporterContext& context, const PMX& pmx, GameObjectPtr& object, Materials& materials) noexcept(false);
+
+	private:
+		std::unique_ptr<PMX> pmx_;
 	};
 }
 
@@ -0,0 +1,82 @@
+#ifndef OCTOON_POSE_BUFFER_H_
+#define OCTOON_POSE_BUFFER_H_
+
+#include <octoon/game_object.h>
+#include <octoon/transform_component.h>
+
+namespace octoon
+{
+	// Stages local TRS values for a set of bones and writes them back in one pass: locals are
+	// stored without intermediate invalidation, world matrices are rebuilt parent-first, and
+	// move notifications are sent once per changed subtree instead of once per setter.
+	class OCTOON_EXPORT PoseBuffer final
+	{
+	public:
+		PoseBuffer() noexcept;
+		explicit PoseBuffer(const GameObjects& bones) noexcept;
+		~PoseBuffer() noexcept;
+
+		void setBones(const GameObjects& bones) noexcept;
+		const GameObjects& getBones() const noexcept;
+
+		std::size_t size() const noexcept;
+		bool empty() const noexcept;
+
+		void setLocalTranslate(std::size_t i, const math::float3& translate) noexcept;
+		const math::float3& getLocalTranslate(std::size_t i) const noexcept;
+
+		void setLocalScale(std::size_t i, const math::float3& scale) noexcept;
+		const math::float3& getLocalScale(std::size_t i) const noexcept;
+
+		void setLocalQuaternion(std::size_t i, const math::Quaternion& quat) noexcept;
+		const math::Quaternion& getLocalQuaternion(std::size_t i) const noexcept;
+
+		// Keeps the given angles as written instead of deriving them from the quaternion again,
+		// so solvers working on a single euler component see the same value on the next pass.
+		void setLocalEulerAngles(std::size_t i, const math::float3& euler) noexcept;
+		const math::float3& getLocalEulerAngles(std::size_t i) const noexcept;
+
+		void setLocalTransform(std::size_t i, const math::float3& translate, const math::Quaternion& quat, const math::float3& scale = math::float3::One) noexcept;
+
+		// Stages a world space pose. apply() keeps it as given and derives the local values from the
+		// parent once the parents were written, like TransformComponent::setTransform does.
+		void setTransform(std::size_t i, const math::float3& translate, const math::Quaternion& quat, const math::float3& scale = math::float3::One) noexcept;
+
+		const std::shared_ptr<TransformComponent>& getTransform(std::size_t i) const noexcept;
+
+		void fetch() noexcept;
+		void apply() noexcept;
+
+		// release() drops the references to the bones and their transforms but keeps the layout, so a
+		// buffer cached by an owner the bones can reach does not keep them alive. acquire() takes the
+		// references back and fails once one of the bones was destroyed.
+		void release() noexcept;
+		bool acquire() noexcept;
+
+	private:
+		GameObjects bones_;
+		std::vector<std::weak_ptr<GameObject>> releasedBones_;
+		std::vector<std::weak_ptr<TransformComponent>> releasedTransforms_;
+
+		std::vector<std::size_t> order_;
+		std::vector<std::size_t> parents_;
+		std::vector<std::uint8_t> dirty_;
+		std::vector<std::uint8_t> changed_;
+		std::vector<std::uint8_t> covered_;
+		std::vector<std::uint8_t> worldDirty_;
+		mutable std::vector<std::uint8_t> eulerDirty_;
+		std::vector<std::size_t> roots_;
+		std::vector<std::shared_ptr<TransformComponent>> transforms_;
+
+		math::float3s translates_;
+		math::float3s scales_;
+		math::Quaternions rotations_;
+		mutable math::float3s eulerAngles_;
+
+		math::float3s worldTranslates_;
+		math::float3s worldScales_;
+		math::Quaternions worldRotations_;
+	};
+}
+
+#endif
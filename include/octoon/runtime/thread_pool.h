@@ -0,0 +1,56 @@
+#ifndef OCTOON_THREAD_POOL_H_
+#define OCTOON_THREAD_POOL_H_
+
+#include <octoon/runtime/platform.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace octoon
+{
+	// Fixed set of worker threads draining one FIFO queue. Tasks must not block on other tasks of
+	// the same pool; hand the result back to the owning thread instead.
+	class OCTOON_EXPORT ThreadPool final
+	{
+	public:
+		// 0 picks one thread less than the hardware concurrency, but at least one
+		explicit ThreadPool(std::size_t numThreads = 0) noexcept;
+		~ThreadPool() noexcept;
+
+		std::size_t getNumThreads() const noexcept;
+
+		void submit(std::function<void()>&& task) noexcept;
+
+		template<typename F>
+		std::future<std::invoke_result_t<F>> async(F&& func) noexcept
+		{
+			auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(func));
+			auto future = task->get_future();
+			this->submit([task]() { (*task)(); });
+			return future;
+		}
+
+	private:
+		void run() noexcept;
+
+	private:
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+	private:
+		bool quit_;
+
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::deque<std::function<void()>> tasks_;
+		std::vector<std::thread> threads_;
+	};
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include <octoon/mesh_renderer_component.h>
 #include <octoon/skinned_component.h>
 #include <octoon/cloth_component.h>
+#include <octoon/mesh/skinning.h>
+#include <octoon/mesh/morph_blender.h>
 
 namespace octoon
 {
@@ -35,6 +37,10 @@ namespace octoon
 		bool getTextureBlendEnable() const noexcept;
 		bool getUpdateWhenOffscreen() const noexcept;
 
+		// 0 uses half of the hardware threads
+		void setSkinningThreads(std::uint32_t count) noexcept;
+		std::uint32_t getSkinningThreads() const noexcept;
+
 		const MeshPtr& getSkinnedMesh() noexcept;
 
 		void uploadMeshData() noexcept;
@@ -85,6 +91,12 @@ namespace octoon
 		GameObjects bones_;
 
 		math::float4x4s joints_;
+		SkinningKernel skinning_;
+
+		MorphBlender morphBlender_;
+		math::float3s morphVertices_;
+		math::float3s morphNormals_;
+		std::vector<MorphTarget> morphTargets_;
 		GraphicsDataPtr jointData_;
 
 		std::vector<math::Quaternion> quaternions_;
@@ -19,10 +19,18 @@ namespace octoon
 		void setOffsets(const math::float3s& offsets) noexcept;
 		const math::float3s& getOffsets() const noexcept;
 
+		void setNormalOffsets(math::float3s&& offsets) noexcept;
+		void setNormalOffsets(const math::float3s& offsets) noexcept;
+		const math::float3s& getNormalOffsets() const noexcept;
+
 		void setIndices(math::uint1s&& indices) noexcept;
 		void setIndices(const math::uint1s& indices) noexcept;
 		const math::uint1s& getIndices() const noexcept;
 
+		// Changes whenever the indices or offsets are replaced, so that caches built from them can
+		// tell they are stale.
+		std::uint32_t getVersion() const noexcept;
+
 		void load(const nlohmann::json& json) noexcept(false) override;
 		void save(nlohmann::json& json) const noexcept(false) override;
 
@@ -42,6 +50,8 @@ namespace octoon
 	private:
 		math::uint1s indices_;
 		math::float3s offsets_;
+		math::float3s normalOffsets_;
+		std::uint32_t version_;
 	};
 }
 
@@ -40,6 +40,9 @@ namespace octoon
 		const GameObjectPtr& getBone(std::size_t i) const noexcept;
 		const GameObjects& getBones() const noexcept;
 
+		// Solves the chain. Automatically updated chains of one model share a solver and are solved
+		// together as one job, run by the first of them on its time step; the solver is gathered again
+		// only when the bones, target, settings or the set of chains change.
 		void solve() noexcept;
 
 		GameComponentPtr clone() const noexcept override;
@@ -51,9 +54,16 @@ namespace octoon
 		void onFixedUpdate() noexcept override;
 
 	private:
-		void evaluateIK() noexcept;
+		friend class IKSolver;
+
 		void evaluateRotationLink() noexcept;
 
+		struct SharedSolver;
+
+		void buildSolver() noexcept;
+		void invalidateSolver() noexcept;
+		void invalidateModelSolver() noexcept;
+
 	private:
 		CCDSolverComponent(const CCDSolverComponent&) = delete;
 		CCDSolverComponent& operator=(const CCDSolverComponent&) = delete;
@@ -70,6 +80,8 @@ namespace octoon
 
 		GameObjects bones_;
 		GameObjectPtr target_;
+
+		std::shared_ptr<SharedSolver> solver_;
 	};
 }
 
@@ -0,0 +1,34 @@
+#ifndef OCTOON_TEXTURE_PROCESSING_H_
+#define OCTOON_TEXTURE_PROCESSING_H_
+
+#include <octoon/texture/texture.h>
+
+namespace octoon
+{
+	enum class TextureFilter : std::uint8_t
+	{
+		Box,
+		Triangle,
+		Kaiser,
+		Lanczos
+	};
+
+	// Import-time texture processing on the CPU. Filtering accepts 8 bit UNorm/SRGB and 32 bit float
+	// textures with one to four channels; sRGB colour channels are filtered in linear space. Rows and
+	// block rows are spread over OpenMP threads.
+	OCTOON_EXPORT bool isFilterableFormat(const Format& format) noexcept;
+	OCTOON_EXPORT bool isCompressibleFormat(const Format& src, const Format& dst) noexcept;
+
+	// Separable resampling of every layer of the first mip level.
+	OCTOON_EXPORT Texture resampleTexture(const Texture& texture, std::uint32_t width, std::uint32_t height, TextureFilter filter = TextureFilter::Lanczos) noexcept(false);
+
+	// Rebuilds the levels below the first one, each from the previous level kept in float precision.
+	// A mipLevel of 0 builds the full chain down to 1x1.
+	OCTOON_EXPORT Texture generateMipmaps(const Texture& texture, std::uint32_t mipLevel = 0, TextureFilter filter = TextureFilter::Kaiser) noexcept(false);
+
+	// Encodes every level and layer of an 8 bit texture into BC1, BC3, BC4, BC5 or BC7 blocks.
+	// BC7 uses mode 6 only, which keeps the encoder fast at some cost on blocks with unrelated alpha.
+	OCTOON_EXPORT Texture compressTexture(const Texture& texture, Format format) noexcept(false);
+}
+
+#endif
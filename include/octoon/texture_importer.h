@@ -13,11 +13,15 @@ namespace octoon
 		TextureImporter() noexcept;
 		virtual ~TextureImporter() noexcept;
 
+		virtual void onPrepareAsset(const std::filesystem::path& assetPath) noexcept(false) override;
 		virtual void onImportAsset(AssetImporterContext& context) noexcept(false) override;
 
 	private:
 		TextureImporter(const TextureImporter&) = delete;
 		TextureImporter& operator=(const TextureImporter&) = delete;
+
+	private:
+		std::shared_ptr<Texture> texture_;
 	};
 }
 
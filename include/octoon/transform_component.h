@@ -54,6 +54,7 @@ namespace octoon
 		const math::float3& getLocalEulerAngles() const noexcept;
 
 		void setLocalTransform(const math::float4x4& transform) noexcept;
+		void setLocalTransform(const math::float3& translate, const math::Quaternion& quat, const math::float3& scale = math::float3::One) noexcept;
 		void setLocalTransformOnlyRotate(const math::float4x4& transform) noexcept;
 		const math::float4x4& getLocalTransform() const noexcept;
 		const math::float4x4& getLocalTransformInverse() const noexcept;
@@ -85,6 +86,7 @@ namespace octoon
 
 	private:
 		friend GameObject;
+		friend class PoseBuffer;
 		void updateLocalChildren() const noexcept;
 		void updateWorldChildren() const noexcept;
 		void updateLocalTransform() const noexcept;
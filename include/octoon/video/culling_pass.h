@@ -0,0 +1,30 @@
+#ifndef OCTOON_CULLING_PASS_H_
+#define OCTOON_CULLING_PASS_H_
+
+#include <octoon/video/rendering_data.h>
+
+namespace octoon
+{
+	// Builds the visible geometry list of the main camera and of every shadow casting light before
+	// any draw pass runs. World bounding boxes are tested against each view frustum in parallel.
+	class OCTOON_EXPORT CullingPass final
+	{
+	public:
+		CullingPass() noexcept;
+
+		// 0 picks half of the available hardware threads.
+		void setThreadCount(std::uint32_t count) noexcept;
+		std::uint32_t getThreadCount() const noexcept;
+
+		void Execute(RenderingData& renderingData) noexcept;
+
+	private:
+		void cull(const Camera& camera, const std::vector<Geometry*>& geometries, RenderingData::CullingResults& out) noexcept;
+
+	private:
+		std::uint32_t threads_;
+		std::vector<std::uint8_t> visibles_;
+	};
+}
+
+#endif
@@ -14,6 +14,7 @@ namespace octoon
 
 	private:
 		bool opaque_;
+		std::vector<Geometry*> geometries_;
 	};
 }
 
@@ -2,6 +2,7 @@
 #define OCTOON_FORWARD_RENDERER_H_
 
 #include <octoon/video/render_scene.h>
+#include <octoon/video/culling_pass.h>
 #include <octoon/video/lights_shadow_caster_pass.h>
 #include <octoon/video/draw_object_pass.h>
 #include <octoon/video/draw_skybox_pass.h>
@@ -22,6 +23,9 @@ namespace octoon
 		void getFramebufferSize(std::uint32_t& w, std::uint32_t& h) const noexcept;
 		const GraphicsFramebufferPtr& getFramebuffer() const noexcept;
 
+		// state changes and draw calls of the last rendered frame
+		const ScriptableRenderContext::Statistics& getStatistics() const noexcept;
+
 	private:
 		void prepareScene(const std::shared_ptr<RenderScene>& scene) noexcept;
 		void setWorkBufferSize(const std::shared_ptr<ScriptableRenderContext>& context, std::uint32_t w, std::uint32_t h) except;
@@ -45,6 +49,7 @@ namespace octoon
 
 		std::vector<Config> configs_;
 
+		std::unique_ptr<CullingPass> cullingPass_;
 		std::unique_ptr<LightsShadowCasterPass> lightsShadowCasterPass_;
 		std::unique_ptr<DrawObjectPass> drawOpaquePass_;
 		std::unique_ptr<DrawObjectPass> drawTranparentPass_;
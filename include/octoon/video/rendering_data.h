@@ -74,8 +74,19 @@ namespace octoon
 			math::float2 shadowMapSize;
 		};
 
+		// Geometries of one view that passed the layer, visibility and frustum tests, in scene order.
+		struct CullingResults
+		{
+			std::vector<Geometry*> geometries;
+			std::size_t numCulled;
+			std::size_t numDrawn;
+		};
+
 		void reset() noexcept;
 
+		// Falls back to every geometry when the view was not culled this frame.
+		const std::vector<Geometry*>& getVisibleGeometries(const Camera& camera) const noexcept;
+
 		const Camera* camera;
 
 		std::size_t numDirectional;
@@ -110,6 +121,10 @@ namespace octoon
 		std::vector<Geometry*> geometries;
 		std::shared_ptr<Geometry> screenQuad;
 
+		std::size_t numCulled;
+		std::size_t numDrawn;
+		std::unordered_map<const Camera*, CullingResults> cullingResults;
+
 		std::unique_ptr<Bundle> material_bundle;
 		std::unique_ptr<Bundle> volume_bundle;
 		std::unique_ptr<Bundle> texture_bundle;
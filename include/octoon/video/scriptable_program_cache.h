@@ -0,0 +1,59 @@
+#ifndef OCTOON_SCRIPTABLE_PROGRAM_CACHE_H_
+#define OCTOON_SCRIPTABLE_PROGRAM_CACHE_H_
+
+#include <octoon/runtime/singleton.h>
+#include <octoon/hal/graphics_device.h>
+#include <octoon/hal/graphics_shader.h>
+
+#include <filesystem>
+#include <unordered_map>
+
+namespace octoon
+{
+	// Shares linked programs between materials whose preprocessed sources are identical, and keeps
+	// the driver binaries of linked programs on disk so the next run can skip compiling them.
+	// Programs are held weakly; a program lives as long as one material still uses it.
+	class OCTOON_EXPORT ScriptableProgramCache final
+	{
+		OctoonDeclareSingleton(ScriptableProgramCache)
+	public:
+		struct Statistics
+		{
+			std::size_t memoryHits;
+			std::size_t diskHits;
+			std::size_t compiles;
+			double loadTime;
+			double compileTime;
+		};
+
+		ScriptableProgramCache() noexcept;
+		~ScriptableProgramCache() noexcept;
+
+		// An empty path disables the on-disk cache.
+		void setCachePath(const std::filesystem::path& path) noexcept;
+		const std::filesystem::path& getCachePath() const noexcept;
+
+		GraphicsProgramPtr getProgram(const GraphicsDevicePtr& device, const std::string& vertexShader, const std::string& fragmentShader) noexcept;
+
+		// Load and compile times are accumulated in milliseconds.
+		const Statistics& getStatistics() const noexcept;
+		void resetStatistics() noexcept;
+
+		void clear() noexcept;
+
+	private:
+		GraphicsProgramPtr loadProgram(const GraphicsDevicePtr& device, const std::filesystem::path& path, std::uint64_t size) noexcept;
+		void saveProgram(const GraphicsProgramPtr& program, const std::filesystem::path& path, std::uint64_t size) noexcept;
+
+	private:
+		ScriptableProgramCache(const ScriptableProgramCache&) = delete;
+		ScriptableProgramCache& operator=(const ScriptableProgramCache&) = delete;
+
+	private:
+		Statistics statistics_;
+		std::filesystem::path cachePath_;
+		std::unordered_map<std::uint64_t, std::weak_ptr<GraphicsProgram>> programs_;
+	};
+}
+
+#endif
@@ -7,9 +7,16 @@
 
 namespace octoon
 {
+	// GPU copy of a mesh split into a dynamic stream (slot 0: position, normal) and a static
+	// stream (slot 1: texcoord 0 and 1). Each update compares the mesh against a CPU shadow of
+	// the last upload and only writes the vertex range that changed. On OpenGL 4.5 the dynamic
+	// stream is a persistently mapped ring of NumFrames segments, each guarded by a fence, so the
+	// CPU only waits when it gets NumFrames updates ahead of the GPU.
 	class OCTOON_EXPORT ScriptableRenderBuffer final
 	{
 	public:
+		static constexpr std::size_t NumFrames = 3;
+
 		ScriptableRenderBuffer() noexcept;
 		ScriptableRenderBuffer(const GraphicsDevicePtr& context, const std::shared_ptr<Mesh>& mesh) noexcept(false);
 		virtual ~ScriptableRenderBuffer() noexcept;
@@ -21,26 +28,47 @@ namespace octoon
 		std::size_t getStartIndices(std::size_t n) const noexcept;
 
 		const GraphicsDataPtr& getVertexBuffer() const noexcept;
+		const GraphicsDataPtr& getTexcoordBuffer() const noexcept;
 		const GraphicsDataPtr& getIndexBuffer() const noexcept;
 
+		std::intptr_t getVertexBufferOffset() const noexcept;
+
 		void updateData(const GraphicsDevicePtr& context, const std::shared_ptr<Mesh>& mesh) noexcept(false);
 
+	private:
+		void updateVertexData(const Mesh& mesh, bool force) noexcept;
+		void updateTexcoordData(const Mesh& mesh, bool force) noexcept;
+		void updateIndexData(const Mesh& mesh, bool force) noexcept;
+
 	private:
 		ScriptableRenderBuffer(const ScriptableRenderBuffer&) = delete;
 		ScriptableRenderBuffer& operator=(const ScriptableRenderBuffer&) = delete;
 
 	private:
-		std::uint32_t numVertices_;
-		std::uint32_t numIndices_;
-		std::uint32_t numSubsets_;
+		struct DirtyRange
+		{
+			std::size_t first;
+			std::size_t last;
+		};
+
+		bool persistent_;
+
+		std::size_t frame_;
+		std::size_t segmentSize_;
+		std::size_t indicesVersion_;
+		DirtyRange pending_[NumFrames];
 
+		std::vector<float> vertexShadow_;
+		std::vector<float> texcoordShadow_;
+		std::vector<std::size_t> subsetSizes_;
 		std::vector<std::size_t> startIndice_;
 
 		GraphicsDataPtr vertices_;
+		GraphicsDataPtr texcoords_;
 		GraphicsDataPtr indices_;
 
 		std::shared_ptr<Mesh> mesh_;
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
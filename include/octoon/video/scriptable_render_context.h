@@ -15,6 +15,18 @@ namespace octoon
 	class OCTOON_EXPORT ScriptableRenderContext
 	{
 	public:
+		struct Statistics
+		{
+			std::uint32_t pipelineChanges;
+			std::uint32_t descriptorSetChanges;
+			std::uint32_t vertexBufferChanges;
+			std::uint32_t indexBufferChanges;
+			std::uint32_t drawCalls;
+			std::uint32_t mergedDraws;
+			std::uint32_t instancedDraws;
+			std::uint32_t instances;
+		};
+
 		ScriptableRenderContext();
 		ScriptableRenderContext(const GraphicsContextPtr& context);
 		~ScriptableRenderContext();
@@ -79,15 +91,109 @@ namespace octoon
 		void drawIndexedIndirect(const GraphicsDataPtr& data, std::size_t offset, std::uint32_t drawCount, std::uint32_t stride) noexcept;
 
 		void drawMesh(const std::shared_ptr<Mesh>& mesh, std::size_t subset, const RenderingData& renderingData);
+
+		// Draws are sorted by program, material, mesh and distance to the camera. Only the state that
+		// differs from the previous draw is set, and subsets of one geometry sharing a material are
+		// merged into a single (or, on OpenGL 4.5, multi-draw-indirect) call.
 		void drawRenderers(const Geometry& geometry, const Camera& camera, const RenderingData& renderingData, const std::shared_ptr<Material>& overrideMaterial = nullptr) noexcept;
 		void drawRenderers(const std::vector<Geometry*>& objects, const Camera& camera, const RenderingData& renderingData, const std::shared_ptr<Material>& overrideMaterial = nullptr) noexcept;
 
+		// Opaque geometries drawing the same mesh with the same material are collected into one
+		// instanced draw that reads the transforms from a per-instance stream. Enabled by default.
+		void setInstancingEnable(bool enable) noexcept;
+		bool getInstancingEnable() const noexcept;
+
+		// State changes and draw calls issued by drawRenderers since the last reset.
+		const Statistics& getStatistics() const noexcept;
+		void resetStatistics() noexcept;
+
 		void compileMaterial(const std::shared_ptr<Material>& material, const RenderingData& renderingData);
 		void setMaterial(const std::shared_ptr<Material>& material, const RenderingData& renderingData, const Camera& camera, const Geometry& geometry);
 
+		// std140 FrameUniforms block shared by every material drawn with the camera; it is only
+		// written when the camera matrices changed since the last call.
+		const GraphicsDataPtr& getFrameUniforms(const Camera& camera) noexcept;
+
 	private:
+		class ScriptableRenderMaterial* getRenderMaterial(const Material* material, const RenderingData& renderingData) const noexcept;
+		class ScriptableRenderBuffer* getRenderBuffer(const Mesh* mesh, const RenderingData& renderingData) const noexcept;
+		class ScriptableRenderMaterial* getInstancedMaterial(class ScriptableRenderMaterial* material, const RenderingData& renderingData) noexcept;
+
+		void buildRenderQueue(const Geometry* const* geometries, std::size_t count, const Camera& camera, const RenderingData& renderingData, const std::shared_ptr<Material>& overrideMaterial) noexcept;
+		void submitRenderQueue(const Camera& camera, const RenderingData& renderingData) noexcept;
+		void buildInstances(const RenderingData& renderingData) noexcept;
+
+	private:
+		struct DrawItem
+		{
+			std::uint64_t key;
+			std::uint32_t order;
+			std::uint32_t subset;
+			float distance;
+			const Geometry* geometry;
+			class ScriptableRenderMaterial* material;
+			class ScriptableRenderBuffer* buffer;
+		};
+
+		struct DrawBatch
+		{
+			std::size_t first;
+			std::size_t last;
+			std::uint32_t command;
+			std::uint32_t numCommands;
+			std::uint32_t instance;
+			std::uint32_t numInstances;
+			class ScriptableRenderMaterial* material;
+		};
+
+		struct DrawIndexedIndirectCommand
+		{
+			std::uint32_t count;
+			std::uint32_t instanceCount;
+			std::uint32_t firstIndex;
+			std::int32_t baseVertex;
+			std::uint32_t baseInstance;
+		};
+
+		struct FrameUniforms
+		{
+			math::float4x4 viewMatrix;
+			math::float4x4 projectionMatrix;
+			math::float4x4 viewProjMatrix;
+		};
+
+		struct FrameBuffer
+		{
+			std::weak_ptr<const Object> camera;
+			FrameUniforms data;
+			GraphicsDataPtr buffer;
+		};
+
+		struct InstancedMaterial
+		{
+			std::weak_ptr<class ScriptableRenderMaterial> source;
+			std::shared_ptr<class ScriptableRenderMaterial> material;
+		};
+
 		GraphicsContextPtr context_;
 
+		std::unordered_map<const Camera*, FrameBuffer> frameBuffers_;
+
+		Statistics statistics_;
+
+		std::vector<DrawItem> queue_;
+		std::vector<DrawBatch> batches_;
+		std::vector<DrawIndexedIndirectCommand> commands_;
+		std::unordered_map<const void*, std::uint16_t> sortIds_;
+		std::size_t indirectOffset_;
+		GraphicsDataPtr indirectBuffer_;
+
+		bool instancing_;
+		std::vector<math::float4x4> instances_;
+		std::size_t instanceOffset_;
+		GraphicsDataPtr instanceBuffer_;
+		std::unordered_map<const void*, InstancedMaterial> instancedMaterials_;
+
 		std::unordered_map<void*, std::shared_ptr<class ScriptableRenderBuffer>> buffers_;
 		std::unordered_map<void*, std::shared_ptr<class ScriptableRenderMaterial>> materials_;
 	};
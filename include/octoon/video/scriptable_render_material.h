@@ -13,13 +13,19 @@ namespace octoon
 	{
 	public:
 		ScriptableRenderMaterial() noexcept;
-		ScriptableRenderMaterial(GraphicsContextPtr&context, const MaterialPtr& material, const RenderingData& scene) noexcept;
+		ScriptableRenderMaterial(GraphicsContextPtr&context, const MaterialPtr& material, const RenderingData& scene, bool instancing = false) noexcept;
 		virtual ~ScriptableRenderMaterial() noexcept;
 
+		// The instanced variant reads the model matrix from the per-instance stream in slot 2
+		// (four float4 columns) instead of the modelMatrix uniforms.
+		bool isInstancing() const noexcept;
+
+		const MaterialPtr& getMaterial() const noexcept;
+
 		const GraphicsPipelinePtr& getPipeline() const noexcept;
 		const GraphicsDescriptorSetPtr& getDescriptorSet() const noexcept;
 
-		void update(const RenderingData& context, const Camera& camera, const Geometry& geometry) noexcept;
+		void update(const RenderingData& context, const Camera& camera, const Geometry& geometry, const GraphicsDataPtr& frameUniforms) noexcept;
 
 	private:
 		void updateParameters(bool force = false) noexcept;
@@ -36,6 +42,8 @@ namespace octoon
 		ScriptableRenderMaterial& operator=(const ScriptableRenderMaterial&) = delete;
 
 	private:
+		bool instancing_;
+
 		MaterialPtr material_;
 
 		GraphicsProgramPtr program_;
@@ -54,15 +62,25 @@ namespace octoon
 		GraphicsUniformSetPtr envMapIntensity_;
 		GraphicsUniformSetPtr envMapOffset_;
 
-		GraphicsUniformSetPtr viewMatrix_;
-		GraphicsUniformSetPtr viewProjMatrix_;
+		GraphicsUniformSetPtr frameUniforms_;
 		GraphicsUniformSetPtr normalMatrix_;
 		GraphicsUniformSetPtr modelMatrix_;
 		GraphicsUniformSetPtr modelViewMatrix_;
-		GraphicsUniformSetPtr projectionMatrix_;
 
 		std::vector<GraphicsUniformSetPtr> directionalShadowMaps_;
 		std::vector<GraphicsUniformSetPtr> directionalShadowMatrixs_;
+
+		// material parameters are matched to the program uniforms by name once per material version,
+		// every other draw only compares the version
+		struct ParameterBinding
+		{
+			std::size_t index;
+			GraphicsUniformSetPtr uniform;
+		};
+
+		std::size_t version_;
+		std::vector<ParameterBinding> parameters_;
+		std::unordered_map<std::string, GraphicsUniformSetPtr> uniforms_;
 	};
 }
 
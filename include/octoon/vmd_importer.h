@@ -151,6 +151,7 @@ namespace octoon
 		VMDImporter() noexcept;
 		virtual ~VMDImporter() noexcept;
 
+		virtual void onPrepareAsset(const std::filesystem::path& assetPath) noexcept(false) override;
 		virtual void onImportAsset(AssetImporterContext& context) noexcept(false) override;
 
 		static void save(std::ostream& stream, const Animation& animation) noexcept(false);
@@ -159,6 +160,10 @@ namespace octoon
 	private:
 		VMDImporter(const VMDImporter&) = delete;
 		VMDImporter& operator=(const VMDImporter&) = delete;
+
+	private:
+		std::unique_ptr<VMD> vmd_;
+		std::shared_ptr<Animation> animation_;
 	};
 }
 
@@ -12,10 +12,35 @@ extern "C"
 
 namespace unreal
 {
+	namespace
+	{
+		constexpr std::size_t MaxFramesInFlight = 4;
+
+		void appendNals(const x264_nal_t* nals, int count, std::vector<std::uint8_t>& packet) noexcept
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				std::int32_t i_num_nal_h = 0;
+
+				if (nals[i].i_payload > 4)
+				{
+					while (i_num_nal_h < 5 && nals[i].p_payload[i_num_nal_h] == 0)
+						i_num_nal_h++;
+
+					if (i_num_nal_h < 3)
+						packet.insert(packet.end(), 3 - i_num_nal_h, 0);
+				}
+
+				packet.insert(packet.end(), nals[i].p_payload, nals[i].p_payload + nals[i].i_payload);
+			}
+		}
+	}
+
 	H264Component::H264Component() noexcept
 		: encoder_(nullptr)
 		, encoded_frame_(nullptr)
 		, frame_(nullptr)
+		, frameCount_(0)
 	{
 	}
 
@@ -37,7 +62,7 @@ namespace unreal
 		auto& framebufferSize = this->getContext()->profile->cameraModule->framebufferSize.getValue();
 		this->width_ = framebufferSize.x;
 		this->height_ = framebufferSize.y;
-		this->buf_ = std::make_unique<std::uint8_t[]>(this->width_ * this->height_ * 3);
+		this->frameCount_ = 0;
 		this->filepath_ = filepath;
 		this->ostream_ = std::make_shared<std::ofstream>(std::filesystem::path(filepath).append(".tmp"), std::ios_base::binary);
 		if (!this->ostream_->good())
@@ -63,7 +88,8 @@ namespace unreal
 		encode_param_.i_log_level = X264_LOG_NONE;
 		encode_param_.i_width = this->width_;
 		encode_param_.i_height = this->height_;
-		encode_param_.i_threads = 1;
+		encode_param_.i_threads = X264_THREADS_AUTO;
+		encode_param_.i_lookahead_threads = X264_THREADS_AUTO;
 		encode_param_.i_fps_num = context->profile->playerModule->recordFps;
 		encode_param_.i_fps_den = 1;
 		encode_param_.analyse.b_psnr = 1;
@@ -84,7 +110,18 @@ namespace unreal
 		frame_ = std::make_shared<x264_picture_t>();
 
 		x264_picture_init(encoded_frame_.get());
-		x264_picture_alloc(frame_.get(), X264_CSP_I420, this->width_, this->height_);
+		x264_picture_init(frame_.get());
+
+		frame_->img.i_csp = X264_CSP_I420;
+		frame_->img.i_plane = 3;
+		frame_->img.i_stride[0] = this->width_;
+		frame_->img.i_stride[1] = this->width_ / 2;
+		frame_->img.i_stride[2] = this->width_ / 2;
+
+		pipeline_.open(this->width_, this->height_, MaxFramesInFlight,
+			std::bind(&H264Component::encode, this, std::placeholders::_1, std::placeholders::_2),
+			std::bind(&H264Component::flush, this, std::placeholders::_1),
+			[this](const std::vector<std::uint8_t>& packet) { ostream_->write((const char*)packet.data(), packet.size()); });
 
 		return this->ostream_->good();
 	}
@@ -93,50 +130,42 @@ namespace unreal
 	H264Component::write(const octoon::math::Vector3* data) noexcept(false)
 	{
 		if (ostream_)
-		{
-			this->convert((float*)data, this->width_, this->height_, this->buf_.get());
+			pipeline_.push(data);
+	}
 
-			std::uint8_t* yuv[3];
-			yuv[0] = this->buf_.get();
-			yuv[1] = this->buf_.get() + this->width_ * this->height_;
-			yuv[2] = this->buf_.get() + this->width_ * this->height_ * 5 / 4;
+	void
+	H264Component::encode(const std::uint8_t* yuv, std::vector<std::uint8_t>& packet) noexcept(false)
+	{
+		// x264 copies the input picture, so the planes can point straight into the pipeline frame
+		frame_->img.plane[0] = const_cast<std::uint8_t*>(yuv);
+		frame_->img.plane[1] = frame_->img.plane[0] + this->width_ * this->height_;
+		frame_->img.plane[2] = frame_->img.plane[1] + this->width_ * this->height_ / 4;
+		frame_->i_pts = frameCount_++;
 
-			int y_size = this->width_ * this->height_;
-			memcpy(frame_->img.plane[0] + 0, yuv[0], y_size);
-			memcpy(frame_->img.plane[0] + y_size, yuv[1], y_size / 4);
-			memcpy(frame_->img.plane[0] + y_size * 5 / 4, yuv[2], y_size / 4);
+		int iNal = 0;
+		x264_nal_t* pNals = NULL;
 
-			int iFrameSize = 0;
-			int iNal = 0;
-			x264_nal_t* pNals = NULL;
+		if (x264_encoder_encode(encoder_, &pNals, &iNal, frame_.get(), encoded_frame_.get()) < 0)
+			throw std::runtime_error("x264_encoder_encode() failed");
 
-			int frame_size = x264_encoder_encode(encoder_, &pNals, &iNal, frame_.get(), encoded_frame_.get());
-			if (frame_size > 0 && iNal > 0)
-			{
-				for (int i = 0; i < iNal; ++i)
-				{
-					std::int32_t i_num_nal_h = 0;
+		appendNals(pNals, iNal, packet);
+	}
 
-					if (pNals[i].i_payload > 4)
-					{
-						while (i_num_nal_h < 5 && pNals[i].p_payload[i_num_nal_h] == 0)
-							i_num_nal_h++;
+	bool
+	H264Component::flush(std::vector<std::uint8_t>& packet) noexcept(false)
+	{
+		if (x264_encoder_delayed_frames(encoder_) <= 0)
+			return false;
 
-						static char nal_head_s[3] = { 0, 0, 0 };
+		int iNal = 0;
+		x264_nal_t* pNals = NULL;
 
-						if (i_num_nal_h < 3)
-						{
-							ostream_->write(nal_head_s, 3 - i_num_nal_h);
-							iFrameSize += (3 - i_num_nal_h);
-						}
-					}
+		if (x264_encoder_encode(encoder_, &pNals, &iNal, NULL, encoded_frame_.get()) < 0)
+			throw std::runtime_error("x264_encoder_encode() failed");
 
-					ostream_->write((char*)pNals[i].p_payload, pNals[i].i_payload);
+		appendNals(pNals, iNal, packet);
 
-					iFrameSize += pNals[i].i_payload;
-				}
-			}
-		}
+		return x264_encoder_delayed_frames(encoder_) > 0;
 	}
 
 	void
@@ -144,40 +173,16 @@ namespace unreal
 	{
 		if (this->ostream_)
 		{
-			int iFrameSize = 0;
-			int iNal = 0;
-			x264_nal_t* pNals = NULL;
-
-			int frame_size = x264_encoder_encode(encoder_, &pNals, &iNal, frame_.get(), encoded_frame_.get());
-			if (frame_size > 0 && iNal > 0)
+			try
+			{
+				pipeline_.close();
+			}
+			catch (...)
 			{
-				for (int i = 0; i < iNal; ++i)
-				{
-					std::int32_t i_num_nal_h = 0;
-
-					if (pNals[i].i_payload > 4)
-					{
-						while (i_num_nal_h < 5 && pNals[i].p_payload[i_num_nal_h] == 0)
-							i_num_nal_h++;
-
-						static char nal_head_s[3] = { 0, 0, 0 };
-
-						if (i_num_nal_h < 3)
-						{
-							ostream_->write(nal_head_s, 3 - i_num_nal_h);
-							iFrameSize += (3 - i_num_nal_h);
-						}
-					}
-
-					ostream_->write((char*)pNals[i].p_payload, pNals[i].i_payload);
-
-					iFrameSize += pNals[i].i_payload;
-				}
 			}
 
 			x264_encoder_close(encoder_);
-			x264_picture_clean(frame_.get());
-			
+
 			// freee frame memory
 			frame_ = nullptr;
 			encoded_frame_ = nullptr;
@@ -292,34 +297,4 @@ namespace unreal
 			}
 		}
 	}
-
-	void
-	H264Component::convert(float* rgb, int w, int h, std::uint8_t* yuvBuf) noexcept
-	{
-		auto ptrY = yuvBuf;
-		auto ptrU = ptrY + this->width_ * this->height_;
-		auto ptrV = ptrU + this->width_ * this->height_ / 4;
-
-		for (int j = 0; j < h; j++)
-		{
-			for (int i = 0; i < w; i++)
-			{
-				auto data = rgb + ((h - j - 1) * w + i) * 3;
-				std::int32_t r = (std::int32_t)(data[0] * 255.0f);
-				std::int32_t g = (std::int32_t)(data[1] * 255.0f);
-				std::int32_t b = (std::int32_t)(data[2] * 255.0f);
-
-				auto y = (std::uint8_t)std::clamp(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16, 0, 255);
-				auto u = (std::uint8_t)std::clamp(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128, 0, 255);
-				auto v = (std::uint8_t)std::clamp(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128, 0, 255);
-
-				*(ptrY++) = y;
-
-				if (j % 2 == 0 && i % 2 == 0)
-					*(ptrU++) = u;
-				else if (i % 2 == 0)
-					*(ptrV++) = v;
-			}
-		}
-	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "module/encode_module.h"
 #include "unreal_component.h"
+#include "../utils/video_export_pipeline.h"
 #include <octoon/math/vector3.h>
 #include <filesystem>
 
@@ -30,7 +31,8 @@ namespace unreal
 		void onDisable() noexcept override;
 
 	private:
-		void convert(float* rgb, int w, int h, std::uint8_t* yuvBuf) noexcept;
+		void encode(const std::uint8_t* yuv, std::vector<std::uint8_t>& packet) noexcept(false);
+		bool flush(std::vector<std::uint8_t>& packet) noexcept(false);
 
 	private:
 		H264Component(const H264Component&) = delete;
@@ -43,10 +45,9 @@ namespace unreal
 		x264_t* encoder_;
 		std::shared_ptr<x264_picture_t> frame_;
 		std::shared_ptr<x264_picture_t> encoded_frame_;
+		std::int64_t frameCount_;
 
-		std::unique_ptr<char[]> enc_;
-		std::unique_ptr<char[]> scratch_;
-		std::unique_ptr<std::uint8_t[]> buf_;
+		VideoExportPipeline pipeline_;
 
 		std::filesystem::path filepath_;
 		std::shared_ptr<std::ostream> ostream_;
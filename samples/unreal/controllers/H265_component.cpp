@@ -13,10 +13,16 @@ extern "C"
 
 namespace unreal
 {
+	namespace
+	{
+		constexpr std::size_t MaxFramesInFlight = 4;
+	}
+
 	H265Component::H265Component() noexcept
 		: encoder_(nullptr)
 		, picture_(nullptr)
 		, param_(nullptr)
+		, frameCount_(0)
 	{
 	}
 
@@ -38,7 +44,7 @@ namespace unreal
 		auto& framebufferSize = this->getContext()->profile->cameraModule->framebufferSize.getValue();
 		this->width_ = framebufferSize.x;
 		this->height_ = framebufferSize.y;
-		this->buf_ = std::make_unique<std::uint8_t[]>(this->width_ * this->height_ * 3);
+		this->frameCount_ = 0;
 		this->filepath_ = filepath;
 		this->ostream_ = std::make_shared<std::ofstream>(std::filesystem::path(this->filepath_).append(".h265"), std::ios_base::binary);
 		if (!this->ostream_->good())
@@ -62,6 +68,7 @@ namespace unreal
 		param_->fpsNum = context->profile->playerModule->recordFps;
 		param_->fpsDenom = 1;
 		param_->bframes = 12;
+		param_->frameNumThreads = 0;
 
 		encoder_ = x265_encoder_open(param_);
 		if (!encoder_)
@@ -72,14 +79,16 @@ namespace unreal
 			throw std::runtime_error("x265_picture_alloc() failed");
 
 		x265_picture_init(param_, picture_);
-		picture_->planes[0] = this->buf_.get();
-		picture_->planes[1] = this->buf_.get() + param_->sourceWidth * param_->sourceHeight;
-		picture_->planes[2] = this->buf_.get() + param_->sourceWidth * param_->sourceHeight * 5 / 4;
 		picture_->stride[0] = param_->sourceWidth;
 		picture_->stride[1] = param_->sourceWidth / 2;
 		picture_->stride[2] = param_->sourceWidth / 2;
 		picture_->height = param_->sourceHeight;
 
+		pipeline_.open(this->width_, this->height_, MaxFramesInFlight,
+			std::bind(&H265Component::encode, this, std::placeholders::_1, std::placeholders::_2),
+			std::bind(&H265Component::flush, this, std::placeholders::_1),
+			[this](const std::vector<std::uint8_t>& packet) { ostream_->write((const char*)packet.data(), packet.size()); });
+
 		return this->ostream_->good();
 	}
 
@@ -87,18 +96,41 @@ namespace unreal
 	H265Component::write(const octoon::math::Vector3* data) noexcept(false)
 	{
 		if (ostream_)
-		{
-			this->convert((float*)data, this->width_, this->height_, this->buf_.get());
+			pipeline_.push(data);
+	}
+
+	void
+	H265Component::encode(const std::uint8_t* yuv, std::vector<std::uint8_t>& packet) noexcept(false)
+	{
+		// x265 copies the input picture, so the planes can point straight into the pipeline frame
+		picture_->planes[0] = const_cast<std::uint8_t*>(yuv);
+		picture_->planes[1] = (std::uint8_t*)picture_->planes[0] + this->width_ * this->height_;
+		picture_->planes[2] = (std::uint8_t*)picture_->planes[1] + this->width_ * this->height_ / 4;
+		picture_->pts = frameCount_++;
+
+		x265_nal* nals = nullptr;
+		std::uint32_t inal = 0;
+		auto result = x265_encoder_encode(encoder_, &nals, &inal, picture_, nullptr);
+		if (result < 0)
+			throw std::runtime_error("x265_encoder_encode() failed");
+
+		for (std::uint32_t j = 0; j < inal; j++)
+			packet.insert(packet.end(), nals[j].payload, nals[j].payload + nals[j].sizeBytes);
+	}
+
+	bool
+	H265Component::flush(std::vector<std::uint8_t>& packet) noexcept(false)
+	{
+		x265_nal* nals = nullptr;
+		std::uint32_t inal = 0;
+		auto result = x265_encoder_encode(encoder_, &nals, &inal, nullptr, nullptr);
+		if (result < 0)
+			throw std::runtime_error("x265_encoder_encode() failed");
 
-			x265_nal* nals = nullptr;
-			std::uint32_t inal = 0;
-			auto result = x265_encoder_encode(encoder_, &nals, &inal, picture_, nullptr);
-			if (result < 0)
-				throw std::runtime_error("x265_encoder_encode() failed");
+		for (std::uint32_t j = 0; j < inal; j++)
+			packet.insert(packet.end(), nals[j].payload, nals[j].payload + nals[j].sizeBytes);
 
-			for (std::uint32_t j = 0;j < inal; j++)
-				ostream_->write((char*)nals[j].payload, nals[j].sizeBytes);
-		}
+		return result > 0;
 	}
 
 	void
@@ -106,13 +138,12 @@ namespace unreal
 	{
 		if (this->ostream_)
 		{
-			x265_nal* nals = nullptr;
-			std::uint32_t inal = 0;
-
-			while (x265_encoder_encode(encoder_, &nals, &inal, nullptr, nullptr) > 0)
+			try
+			{
+				pipeline_.close();
+			}
+			catch (...)
 			{
-				for (std::uint32_t j = 0; j < inal; j++)
-					ostream_->write((char*)nals[j].payload, nals[j].sizeBytes);
 			}
 
 			x265_encoder_close(encoder_);
@@ -248,34 +279,4 @@ namespace unreal
 			}
 		}
 	}
-
-	void
-	H265Component::convert(float* rgb, int w, int h, std::uint8_t* yuvBuf) noexcept
-	{
-		auto ptrY = yuvBuf;
-		auto ptrU = ptrY + this->width_ * this->height_;
-		auto ptrV = ptrU + this->width_ * this->height_ / 4;
-
-		for (int j = 0; j < h; j++)
-		{
-			for (int i = 0; i < w; i++)
-			{
-				auto data = rgb + ((h - j - 1) * w + i) * 3;
-				std::int32_t r = (std::int32_t)(data[0] * 255.0f);
-				std::int32_t g = (std::int32_t)(data[1] * 255.0f);
-				std::int32_t b = (std::int32_t)(data[2] * 255.0f);
-
-				auto y = (std::uint8_t)std::clamp(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16, 0, 255);
-				auto u = (std::uint8_t)std::clamp(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128, 0, 255);
-				auto v = (std::uint8_t)std::clamp(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128, 0, 255);
-
-				*(ptrY++) = y;
-
-				if (j % 2 == 0 && i % 2 == 0)
-					*(ptrU++) = u;
-				else if (i % 2 == 0)
-					*(ptrV++) = v;
-			}
-		}
-	}
 }
\ No newline at end of file
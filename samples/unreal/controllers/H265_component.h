@@ -3,6 +3,7 @@
 
 #include "module/encode_module.h"
 #include "unreal_component.h"
+#include "../utils/video_export_pipeline.h"
 #include <octoon/math/vector3.h>
 #include <filesystem>
 
@@ -32,7 +33,8 @@ namespace unreal
 		void onDisable() noexcept override;
 
 	private:
-		void convert(float* rgb, int w, int h, std::uint8_t* yuvBuf) noexcept;
+		void encode(const std::uint8_t* yuv, std::vector<std::uint8_t>& packet) noexcept(false);
+		bool flush(std::vector<std::uint8_t>& packet) noexcept(false);
 
 	private:
 		H265Component(const H265Component&) = delete;
@@ -45,10 +47,9 @@ namespace unreal
 		x265_param* param_;
 		x265_picture* picture_;
 		x265_encoder* encoder_;
+		std::int64_t frameCount_;
 
-		std::unique_ptr<char[]> enc_;
-		std::unique_ptr<char[]> scratch_;
-		std::unique_ptr<std::uint8_t[]> buf_;
+		VideoExportPipeline pipeline_;
 
 		std::filesystem::path filepath_;
 		std::shared_ptr<std::ostream> ostream_;
@@ -1,8 +1,7 @@
 #include "frame_sequence_component.h"
 #include "unreal_behaviour.h"
 
-#include <fstream>
-#include <octoon/texture/texture.h>
+#include <iostream>
 
 #include <QDir>
 #include <QFileInfo>
@@ -34,8 +33,19 @@ namespace unreal
 		dirpath_ = file.absoluteDir().absolutePath().toStdString();
 		filename_ = file.fileName().toStdString();
 		basename_ = file.baseName().toStdString();
-		extension_ = file.suffix().toStdString();
-		count_ = 0;
+		extension_ = file.suffix().toLower().toStdString();
+
+		auto format = ImageSequenceFormat::PNG;
+		if (extension_ == "exr")
+			format = ImageSequenceFormat::EXR;
+		else if (extension_ == "hdr")
+			format = ImageSequenceFormat::HDR;
+		else if (extension_ == "jpg" || extension_ == "jpeg")
+			format = ImageSequenceFormat::JPEG;
+		else if (this->getModel()->encode_speed > 0)
+			format = ImageSequenceFormat::PNGFast;
+
+		writer_.open(file.absoluteDir().absolutePath().toStdWString(), basename_, format, width_, height_);
 
 		return true;
 	}
@@ -43,36 +53,20 @@ namespace unreal
 	void
 	FrameSequenceComponent::write(const octoon::math::Vector3* data) noexcept(false)
 	{
-		std::string outname = dirpath_ + "/" + basename_ + "_" + std::to_string(count_);
-		if (extension_ == "png")
-		{
-			octoon::Texture image;
-			if (image.create(octoon::Format::R8G8B8SRGB, width_, height_))
-			{
-				std::uint8_t* img_ptr = const_cast<std::uint8_t*>(image.data());
-
-				for (std::uint32_t y = 0; y < height_; y++)
-				{
-					for (std::uint32_t x = 0; x < width_; x++)
-					{
-						auto src = y * width_ + x;
-						auto dst = ((height_ - y - 1) * width_ + x) * 3;
-
-						img_ptr[dst] = static_cast<std::uint8_t>(data[src].x * 255);
-						img_ptr[dst + 1] = static_cast<std::uint8_t>(data[src].y * 255);
-						img_ptr[dst + 2] = static_cast<std::uint8_t>(data[src].z * 255);
-					}
-				}
-
-				image.save(outname + ".png", "png");
-			}
-		}
-
-		count_ += 1;
+		if (writer_.isOpen())
+			writer_.write(data);
 	}
 
 	void
 	FrameSequenceComponent::close() noexcept
 	{
+		try
+		{
+			writer_.close();
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << "Error: " << e.what() << std::endl;
+		}
 	}
 }
\ No newline at end of file
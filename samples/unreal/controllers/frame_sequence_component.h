@@ -3,6 +3,7 @@
 
 #include "unreal_component.h"
 #include "module/encode_module.h"
+#include "../utils/image_sequence_writer.h"
 
 #include <filesystem>
 #include <octoon/math/vector3.h>
@@ -40,8 +41,9 @@ namespace unreal
 		std::string filename_;
 		std::string basename_;
 		std::string extension_;
-		std::int32_t count_;
 		std::filesystem::path filepath_;
+
+		ImageSequenceWriter writer_;
 	};
 
 }
@@ -4,11 +4,15 @@
 #include <octoon/timer_feature.h>
 #include <octoon/physics_feature.h>
 #include <iostream>
+#include <limits>
 
 namespace unreal
 {
 	PlayerComponent::PlayerComponent() noexcept
 		: needAnimationEvaluate_(false)
+		, physicsCheckedFrames_(0)
+		, physicsFrame_(std::numeric_limits<std::size_t>::max())
+		, physicsSignature_(0)
 	{
 	}
 
@@ -32,7 +36,7 @@ namespace unreal
 		auto physicsFeature = this->getContext()->behaviour->getFeature<octoon::PhysicsFeature>();
 		if (physicsFeature)
 		{
-			physicsFeature->setEnableSimulate(context->physicsModule->getEnable());
+			physicsFeature->setEnableSimulate(context->physicsModule->getEnable() && !context->physicsModule->bake.getValue());
 			physicsFeature->setFixedTimeStep(context->physicsModule->fixedTimeStep);
 			physicsFeature->setSolverIterationCounts(context->physicsModule->playSolverIterationCounts);
 		}
@@ -93,7 +97,7 @@ namespace unreal
 		auto physicsFeature = this->getContext()->behaviour->getFeature<octoon::PhysicsFeature>();
 		if (physicsFeature)
 		{
-			physicsFeature->setEnableSimulate(context->physicsModule->getEnable());
+			physicsFeature->setEnableSimulate(context->physicsModule->getEnable() && !context->physicsModule->bake.getValue());
 			physicsFeature->setFixedTimeStep(context->physicsModule->fixedTimeStep);
 			physicsFeature->setSolverIterationCounts(context->physicsModule->previewSolverIterationCounts);
 		}
@@ -164,6 +168,9 @@ namespace unreal
 
 		auto& context = this->getContext()->profile;
 
+		auto baked = this->checkPhysics(model->curTime) || this->bakePhysics(model->curTime);
+		this->physicsFrame_ = std::numeric_limits<std::size_t>::max();
+
 		auto timeFeature = this->getContext()->behaviour->getFeature<octoon::TimerFeature>();
 		if (timeFeature)
 			timeFeature->setTimeStep(1.0f / model->previewFps);
@@ -212,12 +219,7 @@ namespace unreal
 					animator->setTime(model->curTime);
 					animator->sample();
 
-					for (auto& transform : animator->getAvatar())
-					{
-						auto solver = transform->getComponent<octoon::CCDSolverComponent>();
-						if (solver)
-							solver->solve();
-					}
+					this->solveIK(*animator);
 				}
 			}
 
@@ -232,11 +234,11 @@ namespace unreal
 		auto physicsFeature = this->getContext()->behaviour->getFeature<octoon::PhysicsFeature>();
 		if (physicsFeature)
 		{
-			physicsFeature->setEnableSimulate(context->physicsModule->getEnable());
+			physicsFeature->setEnableSimulate(context->physicsModule->getEnable() && !context->physicsModule->bake.getValue());
 			physicsFeature->setFixedTimeStep(context->physicsModule->fixedTimeStep);
 			physicsFeature->setSolverIterationCounts(context->physicsModule->previewSolverIterationCounts);
 
-			if (context->physicsModule->getEnable())
+			if (context->physicsModule->getEnable() && !baked)
 				physicsFeature->simulate(timeFeature->getTimeStep());
 		}
 
@@ -254,15 +256,13 @@ namespace unreal
 				if (animation->isInstanceOf<octoon::AnimatorComponent>())
 				{
 					auto animator = component->downcast<octoon::AnimatorComponent>();
-					for (auto& transform : animator->getAvatar())
-					{
-						auto solver = transform->getComponent<octoon::CCDSolverComponent>();
-						if (solver)
-							solver->solve();
-					}
+					this->solveIK(*animator);
 				}
 			}
 		}
+
+		if (baked)
+			this->samplePhysics(model->curTime);
 	}
 
 	void
@@ -273,6 +273,10 @@ namespace unreal
 
 		auto& context = this->getContext();
 
+		// scrubbing only plays back frames that are already checked, it never records
+		auto baked = this->checkPhysics(model->curTime);
+		this->physicsFrame_ = std::numeric_limits<std::size_t>::max();
+
 		auto& sound = context->profile->soundModule->sound.getValue();
 		if (sound)
 		{
@@ -295,12 +299,7 @@ namespace unreal
 				if (animation->isInstanceOf<octoon::AnimatorComponent>())
 				{
 					auto animator = component->downcast<octoon::AnimatorComponent>();
-					for (auto& transform : animator->getAvatar())
-					{
-						auto solver = transform->getComponent<octoon::CCDSolverComponent>();
-						if (solver)
-							solver->solve();
-					}
+					this->solveIK(*animator);
 				}
 			}
 
@@ -324,7 +323,7 @@ namespace unreal
 		}
 
 		auto physicsFeature = context->behaviour->getFeature<octoon::PhysicsFeature>();
-		if (physicsFeature && context->profile->physicsModule->getEnable())
+		if (physicsFeature && context->profile->physicsModule->getEnable() && !baked)
 		{
 			physicsFeature->simulate(std::abs(delta));
 		}
@@ -342,16 +341,14 @@ namespace unreal
 					animator->setTime(model->curTime);
 					animator->sample();
 
-					for (auto& transform : animator->getAvatar())
-					{
-						auto solver = transform->getComponent<octoon::CCDSolverComponent>();
-						if (solver)
-							solver->solve();
-					}
+					this->solveIK(*animator);
 				}
 			}
 		}
 
+		if (baked)
+			this->samplePhysics(model->curTime);
+
 		if (camera)
 			this->updateDofTarget();
 
@@ -378,6 +375,8 @@ namespace unreal
 			}
 		}
 
+		auto baked = this->bakePhysics(model->curTime);
+
 		for (auto& it : profile->entitiesModule->objects.getValue())
 		{
 			for (auto component : it->getComponents())
@@ -392,12 +391,7 @@ namespace unreal
 				if (animation->isInstanceOf<octoon::AnimatorComponent>())
 				{
 					auto animator = component->downcast<octoon::AnimatorComponent>();
-					for (auto& transform : animator->getAvatar())
-					{
-						auto solver = transform->getComponent<octoon::CCDSolverComponent>();
-						if (solver)
-							solver->solve();
-					}
+					this->solveIK(*animator);
 				}
 			}
 
@@ -422,7 +416,19 @@ namespace unreal
 
 		auto physicsFeature = this->getContext()->behaviour->getFeature<octoon::PhysicsFeature>();
 		if (physicsFeature && profile->physicsModule->getEnable())
-			physicsFeature->simulate(delta);
+		{
+			// a frame that was just recorded is already on the bodies, anything else comes from the cache
+			auto frame = this->getPhysicsFrame(model->curTime);
+			if (!baked)
+			{
+				physicsFeature->simulate(delta);
+				physicsFrame_ = std::numeric_limits<std::size_t>::max();
+			}
+			else if (physicsFrame_ != frame)
+			{
+				this->samplePhysics(model->curTime);
+			}
+		}
 
 		if (camera)
 			this->updateDofTarget();
@@ -459,6 +465,34 @@ namespace unreal
 		model->timeLength = timeLength;
 		model->startFrame = 0;
 		model->endFrame = static_cast<std::uint32_t>(model->timeLength * 30.0f);
+
+		// the objects may have changed as well, they are gathered again on the next bake
+		physicsCache_.close();
+		this->invalidatePhysics();
+	}
+
+	void
+	PlayerComponent::solveIK(octoon::AnimatorComponent& animator) noexcept
+	{
+		auto it = ikSolvers_.find(&animator);
+		if (it == ikSolvers_.end() || it->second.animator.lock().get() != &animator)
+		{
+			// a new animator is the moment to drop the ones that were destroyed with their models
+			std::erase_if(ikSolvers_, [](auto& entry) { return entry.second.animator.expired(); });
+			it = ikSolvers_.try_emplace(&animator).first;
+			it->second.animator = animator.weak_from_this();
+			it->second.avatar.clear();
+			it->second.solver.clear();
+		}
+
+		auto& cache = it->second;
+		if (cache.avatar != animator.getAvatar())
+		{
+			cache.avatar = animator.getAvatar();
+			cache.solver.setBones(cache.avatar);
+		}
+
+		cache.solver.solve();
 	}
 
 	void
@@ -491,6 +525,387 @@ namespace unreal
 		}
 	}
 
+	bool
+	PlayerComponent::openPhysics() noexcept
+	{
+		auto& profile = this->getContext()->profile;
+		if (!profile->physicsModule->getEnable() || !profile->physicsModule->bake.getValue())
+			return false;
+
+		auto physicsFeature = this->getContext()->behaviour->getFeature<octoon::PhysicsFeature>();
+		if (!physicsFeature)
+			return false;
+
+		if (!physicsCache_.isOpen())
+		{
+			auto path = std::filesystem::path(profile->resourceModule->cachePath).append(L"physics.cache");
+			if (!physicsCache_.open(path, profile->entitiesModule->objects.getValue()))
+				return false;
+
+			this->invalidatePhysics();
+		}
+
+		return true;
+	}
+
+	std::size_t
+	PlayerComponent::getPhysicsFrame(float time) const noexcept
+	{
+		auto frame = static_cast<std::size_t>(std::ceil(std::max(0.0f, time) * physicsCache_.getFrameRate()));
+		return std::min<std::size_t>(frame, this->getModel()->endFrame.getValue());
+	}
+
+	bool
+	PlayerComponent::verifyPhysics(std::size_t frame) noexcept
+	{
+		auto numFrames = physicsCache_.getNumFrames();
+
+		physicsCheckedFrames_ = std::min(physicsCheckedFrames_, numFrames);
+		if (frame < physicsCheckedFrames_)
+			return true;
+
+		if (physicsCheckedFrames_ == numFrames)
+			return false;
+
+		// nothing that moves the kinematic bodies changed since the stored frames were compared, so they
+		// are taken as they are instead of evaluating the animation for each of them again
+		auto signature = this->computePhysicsSignature();
+		if (signature == physicsSignature_)
+		{
+			physicsCheckedFrames_ = numFrames;
+			return frame < physicsCheckedFrames_;
+		}
+
+		auto& profile = this->getContext()->profile;
+		auto physicsFeature = this->getContext()->behaviour->getFeature<octoon::PhysicsFeature>();
+
+		// the keys are computed with the export settings the frames were recorded with
+		auto fixedTimeStep = physicsFeature->getFixedTimeStep();
+		auto solverIterationCounts = physicsFeature->getSolverIterationCounts();
+
+		physicsFeature->setFixedTimeStep(profile->physicsModule->fixedTimeStep);
+		physicsFeature->setSolverIterationCounts(profile->physicsModule->recordSolverIterationCounts);
+
+		auto delta = 1.0f / physicsCache_.getFrameRate();
+		auto last = std::min(frame, numFrames - 1);
+
+		auto matches = [&](std::size_t i)
+		{
+			this->evaluateAnimation(i * delta);
+			return physicsCache_.computeInputKey(*physicsFeature) == physicsCache_.getInputKey(i);
+		};
+
+		if (!matches(last))
+		{
+			// something was edited, the frames before the first one that changed are kept
+			for (physicsCheckedFrames_ = 0; physicsCheckedFrames_ < last; physicsCheckedFrames_++)
+			{
+				if (!matches(physicsCheckedFrames_))
+					break;
+			}
+		}
+		else if (last + 1 == numFrames || matches(numFrames - 1))
+		{
+			physicsCheckedFrames_ = numFrames;
+		}
+		else
+		{
+			for (physicsCheckedFrames_ = last + 1; physicsCheckedFrames_ < numFrames - 1; physicsCheckedFrames_++)
+			{
+				if (!matches(physicsCheckedFrames_))
+					break;
+			}
+		}
+
+		if (physicsCheckedFrames_ < numFrames)
+			physicsCache_.invalidate(physicsCheckedFrames_);
+
+		physicsSignature_ = signature;
+
+		physicsFeature->setFixedTimeStep(fixedTimeStep);
+		physicsFeature->setSolverIterationCounts(solverIterationCounts);
+
+		return frame < physicsCheckedFrames_;
+	}
+
+	bool
+	PlayerComponent::bakePhysics(float time) noexcept
+	{
+		if (!this->openPhysics())
+			return false;
+
+		auto frame = this->getPhysicsFrame(time);
+		if (this->verifyPhysics(frame))
+			return true;
+
+		auto& profile = this->getContext()->profile;
+		auto& objects = profile->entitiesModule->objects.getValue();
+		auto physicsFeature = this->getContext()->behaviour->getFeature<octoon::PhysicsFeature>();
+
+		// records run with the export settings and are stepped by hand, one frame at a time
+		auto enableSimulate = physicsFeature->getEnableSimulate();
+		auto fixedTimeStep = physicsFeature->getFixedTimeStep();
+		auto solverIterationCounts = physicsFeature->getSolverIterationCounts();
+
+		physicsFeature->setEnableSimulate(false);
+		physicsFeature->setFixedTimeStep(profile->physicsModule->fixedTimeStep);
+		physicsFeature->setSolverIterationCounts(profile->physicsModule->recordSolverIterationCounts);
+
+		struct Motion
+		{
+			std::shared_ptr<octoon::TransformComponent> transform;
+			bool allowRelativeMotion;
+			bool kinematic;
+		};
+
+		std::vector<Motion> motions;
+
+		for (auto& it : objects)
+		{
+			for (auto component : it->getComponents())
+			{
+				if (!component->isInstanceOf<octoon::AnimatorComponent>())
+					continue;
+
+				auto animator = component->downcast<octoon::AnimatorComponent>();
+				for (auto& bone : animator->getAvatar())
+				{
+					for (auto& child : bone->getChildren())
+					{
+						auto rigidbody = child->getComponent<octoon::RigidbodyComponent>();
+						if (rigidbody)
+						{
+							auto transform = child->getComponent<octoon::TransformComponent>();
+							motions.push_back(Motion{ transform, transform->isAllowRelativeMotion(), rigidbody->getIsKinematic() });
+						}
+					}
+				}
+			}
+		}
+
+		for (auto& it : motions)
+			it.transform->setAllowRelativeMotion(it.kinematic);
+
+		auto delta = 1.0f / physicsCache_.getFrameRate();
+
+		// every stored frame up to here has been checked, so recording continues right after the last one
+		for (; physicsCheckedFrames_ <= frame; physicsCheckedFrames_++)
+		{
+			auto i = physicsCheckedFrames_;
+
+			if (i == 0)
+			{
+				// like reset(), the bodies start from the animated pose at rest
+				for (auto& it : motions)
+					it.transform->setAllowRelativeMotion(true);
+
+				for (auto& it : objects)
+				{
+					for (auto component : it->getComponents())
+					{
+						if (!component->isInstanceOf<octoon::AnimatorComponent>())
+							continue;
+
+						auto animator = component->downcast<octoon::AnimatorComponent>();
+						animator->setTime(0.0f);
+						animator->sample();
+
+						this->solveIK(*animator);
+					}
+				}
+
+				for (auto& it : motions)
+					it.transform->setAllowRelativeMotion(it.kinematic);
+			}
+			else if (physicsFrame_ != i - 1)
+			{
+				// the bodies show something else than the frame before, its state is restored from the last
+				// recorded frame, or from the snapshot of its block after an edit
+				auto resume = physicsCache_.getResumeFrame(i - 1);
+
+				this->evaluateAnimation(resume * delta);
+
+				if (!physicsCache_.resume(i - 1))
+				{
+					physicsFrame_ = std::numeric_limits<std::size_t>::max();
+					break;
+				}
+
+				for (auto j = resume + 1; j < i; j++)
+				{
+					this->evaluateAnimation(j * delta);
+					physicsFeature->simulate(delta);
+				}
+			}
+
+			this->evaluateAnimation(i * delta);
+
+			auto key = physicsCache_.computeInputKey(*physicsFeature);
+			physicsFeature->simulate(delta);
+
+			if (!physicsCache_.record(key))
+			{
+				physicsFrame_ = std::numeric_limits<std::size_t>::max();
+				break;
+			}
+
+			physicsFrame_ = i;
+		}
+
+		for (auto& it : motions)
+			it.transform->setAllowRelativeMotion(it.allowRelativeMotion);
+
+		physicsFeature->setEnableSimulate(enableSimulate);
+		physicsFeature->setFixedTimeStep(fixedTimeStep);
+		physicsFeature->setSolverIterationCounts(solverIterationCounts);
+
+		return frame < physicsCheckedFrames_;
+	}
+
+	bool
+	PlayerComponent::checkPhysics(float time) noexcept
+	{
+		if (!this->openPhysics())
+			return false;
+
+		// the frame is checked again, which catches models that were moved or given another motion since
+		auto frame = this->getPhysicsFrame(time);
+		physicsCheckedFrames_ = std::min(physicsCheckedFrames_, frame);
+
+		return this->verifyPhysics(frame);
+	}
+
+	bool
+	PlayerComponent::samplePhysics(float time) noexcept
+	{
+		auto& profile = this->getContext()->profile;
+		if (!profile->physicsModule->bake.getValue() || !physicsCache_.isOpen())
+			return false;
+
+		if (std::ceil(time * physicsCache_.getFrameRate()) >= physicsCheckedFrames_)
+			return false;
+
+		physicsFrame_ = std::numeric_limits<std::size_t>::max();
+
+		return physicsCache_.sample(time);
+	}
+
+	void
+	PlayerComponent::invalidatePhysics() noexcept
+	{
+		physicsCheckedFrames_ = 0;
+		physicsFrame_ = std::numeric_limits<std::size_t>::max();
+		physicsSignature_ = 0;
+	}
+
+	std::uint64_t
+	PlayerComponent::computePhysicsSignature() const noexcept
+	{
+		std::size_t seed = 0;
+
+		auto combine = [&seed](std::size_t value)
+		{
+			seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		};
+
+		for (auto& it : this->getContext()->profile->entitiesModule->objects.getValue())
+		{
+			if (!it) continue;
+
+			combine(std::hash<const void*>()(it.get()));
+
+			auto transform = it->getComponent<octoon::TransformComponent>();
+			if (transform)
+			{
+				auto& translate = transform->getTranslate();
+				auto& rotation = transform->getRotation();
+				auto& scale = transform->getScale();
+
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					combine(std::hash<float>()(translate[k]));
+					combine(std::hash<float>()(scale[k]));
+				}
+
+				combine(std::hash<float>()(rotation.x));
+				combine(std::hash<float>()(rotation.y));
+				combine(std::hash<float>()(rotation.z));
+				combine(std::hash<float>()(rotation.w));
+			}
+
+			auto animator = it->getComponent<octoon::AnimatorComponent>();
+			if (animator)
+			{
+				combine(animator->getAvatar().size());
+
+				auto& animation = animator->getAnimation();
+				combine(std::hash<const void*>()(animation.get()));
+
+				if (animation && animation->clip)
+				{
+					combine(std::hash<const void*>()(animation->clip.get()));
+					combine(animation->clip->getVersion());
+				}
+			}
+		}
+
+		// zero marks frames that were never compared
+		return seed != 0 ? seed : 1;
+	}
+
+	void
+	PlayerComponent::evaluateAnimation(float time) noexcept
+	{
+		for (auto& it : this->getContext()->profile->entitiesModule->objects.getValue())
+		{
+			for (auto component : it->getComponents())
+			{
+				if (!component->isA<octoon::AnimationComponent>())
+					continue;
+
+				auto animation = component->downcast<octoon::AnimationComponent>();
+				animation->setTime(time);
+				animation->evaluate();
+
+				if (animation->isInstanceOf<octoon::AnimatorComponent>())
+				{
+					auto animator = component->downcast<octoon::AnimatorComponent>();
+					this->solveIK(*animator);
+				}
+			}
+		}
+	}
+
+	void
+	PlayerComponent::onInit() noexcept
+	{
+		auto& physicsModule = this->getContext()->profile->physicsModule;
+
+		auto updateGravity = [this](const auto&)
+		{
+			auto& physicsModule = this->getContext()->profile->physicsModule;
+			auto physicsFeature = this->getContext()->behaviour->getFeature<octoon::PhysicsFeature>();
+			if (physicsFeature)
+				physicsFeature->setGravity(physicsModule->gravity * physicsModule->gravityScale);
+
+			this->invalidatePhysics();
+		};
+
+		physicsModule->gravity += updateGravity;
+		physicsModule->gravityScale += updateGravity;
+
+		physicsModule->bake += [this](bool) { this->invalidatePhysics(); };
+		physicsModule->fixedTimeStep += [this](float) { this->invalidatePhysics(); };
+		physicsModule->recordSolverIterationCounts += [this](std::uint32_t) { this->invalidatePhysics(); };
+
+		// the bodies in the cache are gathered from the objects when it is opened
+		this->getContext()->profile->entitiesModule->objects += [this](const octoon::GameObjects&)
+		{
+			this->physicsCache_.close();
+			this->invalidatePhysics();
+		};
+	}
+
 	void
 	PlayerComponent::onEnable() noexcept
 	{
@@ -504,7 +919,7 @@ namespace unreal
 		auto physicsFeature = this->getContext()->behaviour->getFeature<octoon::PhysicsFeature>();
 		if (physicsFeature)
 		{
-			physicsFeature->setEnableSimulate(context->physicsModule->enable);
+			physicsFeature->setEnableSimulate(context->physicsModule->getEnable() && !context->physicsModule->bake.getValue());
 			physicsFeature->setGravity(context->physicsModule->gravity * context->physicsModule->gravityScale);
 			physicsFeature->setSolverIterationCounts(context->physicsModule->previewSolverIterationCounts);
 			physicsFeature->setFixedTimeStep(1.0f / model->previewFps);
@@ -4,6 +4,10 @@
 #include "../unreal_component.h"
 #include "../module/player_module.h"
 #include <octoon/runtime/timer.h>
+#include <octoon/physics_cache.h>
+#include <octoon/ik_solver.h>
+#include <octoon/animator_component.h>
+#include <unordered_map>
 
 namespace unreal
 {
@@ -23,12 +27,17 @@ namespace unreal
 
 		void updateTimeLength() noexcept;
 
+		// Solves the IK chains of the animator's avatar. The solver is kept per animator and only
+		// gathered again when the avatar changes.
+		void solveIK(octoon::AnimatorComponent& animator) noexcept;
+
 		virtual const std::type_info& type_info() const noexcept
 		{
 			return typeid(PlayerComponent);
 		}
 
 	private:
+		void onInit() noexcept override;
 		void onEnable() noexcept override;
 		void onDisable() noexcept override;
 
@@ -38,10 +47,49 @@ namespace unreal
 	private:
 		void updateDofTarget() noexcept;
 
+		bool openPhysics() noexcept;
+		std::size_t getPhysicsFrame(float time) const noexcept;
+
+		// Extends the checked frames over the stored ones up to the given frame. While nothing that drives
+		// the kinematic bodies changed since the last comparison every stored frame is trusted as it is.
+		// After a change the requested and the last stored frame are compared by key, and if one of them
+		// differs the first changed frame is searched and everything from there on is dropped.
+		bool verifyPhysics(std::size_t frame) noexcept;
+
+		// Hashes the models, their placement and the identity and version of their motions. Cheap enough
+		// to be taken on every frame, unlike the per-frame keys that need the animation evaluated.
+		std::uint64_t computePhysicsSignature() const noexcept;
+
+		// Records the frames after the last checked one up to the frame at the given time. Stepping
+		// forward continues from the state of the last recorded frame; only an edit costs a re-simulation
+		// from the snapshot before it.
+		bool bakePhysics(float time) noexcept;
+
+		// Whether the frame at the given time is stored and still matches its input. Never records.
+		bool checkPhysics(float time) noexcept;
+		bool samplePhysics(float time) noexcept;
+
+		void invalidatePhysics() noexcept;
+
+		void evaluateAnimation(float time) noexcept;
+
 	private:
+		struct IKCache
+		{
+			std::weak_ptr<octoon::Object> animator;
+			octoon::GameObjects avatar;
+			octoon::IKSolver solver;
+		};
+
 		bool needAnimationEvaluate_;
+		std::size_t physicsCheckedFrames_;
+		std::size_t physicsFrame_;
+		std::uint64_t physicsSignature_;
 
 		octoon::Timer timer_;
+		octoon::PhysicsCache physicsCache_;
+
+		std::unordered_map<const octoon::AnimatorComponent*, IKCache> ikSolvers_;
 	};
 }
 
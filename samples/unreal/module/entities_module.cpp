@@ -31,19 +31,26 @@ namespace unreal
 		if (reader.contains("scene"))
 		{
 			octoon::GameObjects objects_;
+			std::vector<std::filesystem::path> assetPaths;
 
+			// the models are read and parsed side by side on the worker pool, the loop below picks them up in order
 			for (auto& it : reader["scene"])
 			{
-				auto uuid = it.get<std::string>();
-				auto assetPath = octoon::AssetDatabase::instance()->getAssetPath(uuid);
+				auto assetPath = octoon::AssetDatabase::instance()->getAssetPath(it.get<std::string>());
 				if (!assetPath.empty())
 				{
-					auto object = octoon::AssetDatabase::instance()->loadAssetAtPath<octoon::GameObject>(assetPath);
-					if (object)
-						objects_.push_back(std::move(object));
+					octoon::AssetDatabase::instance()->loadAssetAtPathAsync(assetPath);
+					assetPaths.push_back(std::move(assetPath));
 				}
 			}
 
+			for (auto& assetPath : assetPaths)
+			{
+				auto object = octoon::AssetDatabase::instance()->loadAssetAtPath<octoon::GameObject>(assetPath);
+				if (object)
+					objects_.push_back(std::move(object));
+			}
+
 			this->objects = std::move(objects_);
 		}
 	}
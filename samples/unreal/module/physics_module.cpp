@@ -14,6 +14,8 @@ namespace unreal
 	void
 	PhysicsModule::reset() noexcept
 	{
+		this->bake = false;
+		this->multiThreading = false;
 		this->gravity = octoon::math::float3(0.0, -9.8f, 0.0f);
 		this->gravityScale = 5.0f;
 		this->fixedTimeStep = 1.0f / 60.f;
@@ -27,6 +29,10 @@ namespace unreal
 	{
 		if (reader["enable"].is_boolean())
 			this->enable = reader["enable"].get<nlohmann::json::boolean_t>();
+		if (reader["bake"].is_boolean())
+			this->bake = reader["bake"].get<nlohmann::json::boolean_t>();
+		if (reader["multiThreading"].is_boolean())
+			this->multiThreading = reader["multiThreading"].get<nlohmann::json::boolean_t>();
 		if (reader["gravity"].is_array())
 			this->gravity = octoon::math::float3(reader["gravity"].get<std::array<float, 3>>());
 		if (reader["gravityScale"].is_number_float())
@@ -43,6 +49,8 @@ namespace unreal
 	PhysicsModule::save(nlohmann::json& writer) noexcept
 	{
 		writer["enable"] = this->enable.getValue();
+		writer["bake"] = this->bake.getValue();
+		writer["multiThreading"] = this->multiThreading.getValue();
 		writer["gravity"] = this->gravity.getValue().to_array();
 		writer["gravityScale"] = this->gravityScale.getValue();
 		writer["playSolverIterationCounts"] = this->playSolverIterationCounts.getValue();
@@ -54,6 +62,8 @@ namespace unreal
 	PhysicsModule::disconnect() noexcept
 	{
 		this->enable.disconnect();
+		this->bake.disconnect();
+		this->multiThreading.disconnect();
 		this->gravity.disconnect();
 		this->gravityScale.disconnect();
 		this->fixedTimeStep.disconnect();
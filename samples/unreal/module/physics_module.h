@@ -25,6 +25,9 @@ namespace unreal
 		PhysicsModule& operator=(const PhysicsModule&) = delete;
 
 	public:
+		MutableLiveData<bool> bake;
+		MutableLiveData<bool> multiThreading;
+
 		MutableLiveData<octoon::math::float3> gravity;
 
 		MutableLiveData<float> fixedTimeStep;
@@ -0,0 +1,207 @@
+#include "image_sequence_writer.h"
+#include <octoon/texture/texture.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace unreal
+{
+	namespace
+	{
+		const char* getSaveType(ImageSequenceFormat format) noexcept
+		{
+			switch (format)
+			{
+			case ImageSequenceFormat::PNG: return "png";
+			case ImageSequenceFormat::PNGFast: return "png-fast";
+			case ImageSequenceFormat::JPEG: return "jpg";
+			case ImageSequenceFormat::HDR: return "hdr";
+			case ImageSequenceFormat::EXR: return "exr";
+			default:
+				return "png";
+			}
+		}
+
+		bool isFloatFormat(ImageSequenceFormat format) noexcept
+		{
+			return format == ImageSequenceFormat::HDR || format == ImageSequenceFormat::EXR;
+		}
+	}
+
+	ImageSequenceWriter::ImageSequenceWriter() noexcept
+		: format_(ImageSequenceFormat::PNG)
+		, width_(0)
+		, height_(0)
+		, count_(0)
+		, maxMemory_(0)
+		, memoryInFlight_(0)
+		, framesInFlight_(0)
+	{
+	}
+
+	ImageSequenceWriter::~ImageSequenceWriter() noexcept
+	{
+		try
+		{
+			this->close();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	void
+	ImageSequenceWriter::open(const std::filesystem::path& dirpath, const std::string& basename, ImageSequenceFormat format, std::uint32_t width, std::uint32_t height, std::size_t maxMemory) noexcept(false)
+	{
+		this->close();
+
+		dirpath_ = dirpath;
+		basename_ = basename;
+		format_ = format;
+		width_ = width;
+		height_ = height;
+		count_ = 0;
+		maxMemory_ = maxMemory;
+		memoryInFlight_ = 0;
+		framesInFlight_ = 0;
+		error_.clear();
+
+		threadPool_ = std::make_unique<octoon::ThreadPool>();
+	}
+
+	void
+	ImageSequenceWriter::close() noexcept(false)
+	{
+		if (!threadPool_)
+			return;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this]() { return framesInFlight_ == 0; });
+		}
+
+		threadPool_.reset();
+
+		this->rethrowError();
+	}
+
+	bool
+	ImageSequenceWriter::isOpen() const noexcept
+	{
+		return threadPool_ != nullptr;
+	}
+
+	void
+	ImageSequenceWriter::write(const octoon::math::float3* data) noexcept(false)
+	{
+		assert(this->isOpen());
+
+		this->rethrowError();
+
+		auto frameSize = std::size_t(width_) * height_ * sizeof(octoon::math::float3);
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+
+			// a single frame larger than the cap is still let through once nothing else is queued
+			condition_.wait(lock, [&]() { return framesInFlight_ == 0 || memoryInFlight_ + frameSize <= maxMemory_; });
+
+			memoryInFlight_ += frameSize;
+			framesInFlight_++;
+		}
+
+		auto pixels = std::make_shared<std::vector<octoon::math::float3>>(data, data + std::size_t(width_) * height_);
+		auto path = std::filesystem::path(dirpath_).append(basename_ + "_" + std::to_string(count_++) + "." + getExtension(format_));
+
+		threadPool_->submit([this, path = std::move(path), pixels = std::move(pixels), frameSize]()
+		{
+			this->writeFrame(path, *pixels);
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				memoryInFlight_ -= frameSize;
+				framesInFlight_--;
+			}
+
+			condition_.notify_all();
+		});
+	}
+
+	void
+	ImageSequenceWriter::writeFrame(const std::filesystem::path& path, const std::vector<octoon::math::float3>& pixels) noexcept
+	{
+		octoon::Texture image;
+
+		try
+		{
+			if (isFloatFormat(format_))
+			{
+				if (image.create(octoon::Format::R32G32B32SFloat, width_, height_))
+				{
+					auto data = reinterpret_cast<octoon::math::float3*>(image.data());
+
+					for (std::uint32_t y = 0; y < height_; y++)
+						std::memcpy(data + std::size_t(height_ - y - 1) * width_, pixels.data() + std::size_t(y) * width_, width_ * sizeof(octoon::math::float3));
+				}
+			}
+			else
+			{
+				if (image.create(octoon::Format::R8G8B8SRGB, width_, height_))
+				{
+					auto data = image.data();
+
+					for (std::uint32_t y = 0; y < height_; y++)
+					{
+						auto src = pixels.data() + std::size_t(y) * width_;
+						auto dst = data + std::size_t(height_ - y - 1) * width_ * 3;
+
+						for (std::uint32_t x = 0; x < width_; x++, dst += 3)
+						{
+							dst[0] = static_cast<std::uint8_t>(std::clamp(src[x].x, 0.0f, 1.0f) * 255.0f + 0.5f);
+							dst[1] = static_cast<std::uint8_t>(std::clamp(src[x].y, 0.0f, 1.0f) * 255.0f + 0.5f);
+							dst[2] = static_cast<std::uint8_t>(std::clamp(src[x].z, 0.0f, 1.0f) * 255.0f + 0.5f);
+						}
+					}
+				}
+			}
+		}
+		catch (...)
+		{
+		}
+
+		if (image.empty() || !image.save(path, std::string(getSaveType(format_))))
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			if (error_.empty())
+				error_ = "Failed to write " + path.string();
+		}
+	}
+
+	void
+	ImageSequenceWriter::rethrowError() noexcept(false)
+	{
+		std::string error;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			error = error_;
+		}
+
+		if (!error.empty())
+			throw std::runtime_error(error);
+	}
+
+	const char*
+	ImageSequenceWriter::getExtension(ImageSequenceFormat format) noexcept
+	{
+		switch (format)
+		{
+		case ImageSequenceFormat::JPEG: return "jpg";
+		case ImageSequenceFormat::HDR: return "hdr";
+		case ImageSequenceFormat::EXR: return "exr";
+		default:
+			return "png";
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef UNREAL_IMAGE_SEQUENCE_WRITER_H_
+#define UNREAL_IMAGE_SEQUENCE_WRITER_H_
+
+#include <octoon/math/vector3.h>
+#include <octoon/runtime/thread_pool.h>
+
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace unreal
+{
+	enum class ImageSequenceFormat
+	{
+		PNG,
+		PNGFast,
+		JPEG,
+		HDR,
+		EXR
+	};
+
+	// Writes numbered frames on a worker pool. write() copies the bottom-up float framebuffer and
+	// returns; flipping, quantization and compression run on the workers, several files at once.
+	// The copies in flight are capped by maxMemory, past which write() waits for a file to finish.
+	class ImageSequenceWriter final
+	{
+	public:
+		ImageSequenceWriter() noexcept;
+		~ImageSequenceWriter() noexcept;
+
+		// Frames are written to <dirpath>/<basename>_<index>.<extension of the format>.
+		void open(const std::filesystem::path& dirpath, const std::string& basename, ImageSequenceFormat format, std::uint32_t width, std::uint32_t height, std::size_t maxMemory = 1024 * 1024 * 1024) noexcept(false);
+		void close() noexcept(false);
+
+		bool isOpen() const noexcept;
+
+		void write(const octoon::math::float3* data) noexcept(false);
+
+		static const char* getExtension(ImageSequenceFormat format) noexcept;
+
+	private:
+		void writeFrame(const std::filesystem::path& path, const std::vector<octoon::math::float3>& pixels) noexcept;
+		void rethrowError() noexcept(false);
+
+	private:
+		ImageSequenceWriter(const ImageSequenceWriter&) = delete;
+		ImageSequenceWriter& operator=(const ImageSequenceWriter&) = delete;
+
+	private:
+		std::filesystem::path dirpath_;
+		std::string basename_;
+		ImageSequenceFormat format_;
+
+		std::uint32_t width_;
+		std::uint32_t height_;
+		std::uint32_t count_;
+
+		std::size_t maxMemory_;
+		std::size_t memoryInFlight_;
+		std::size_t framesInFlight_;
+
+		std::string error_;
+
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::unique_ptr<octoon::ThreadPool> threadPool_;
+	};
+}
+
+#endif
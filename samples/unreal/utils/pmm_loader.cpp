@@ -20,6 +20,10 @@ namespace unreal
 		auto stream = octoon::io::ifstream(path);
 		auto pmm = octoon::PMMFile::load(stream).value();
 
+		// the models are read and parsed side by side on the worker pool, the loop below picks them up in order
+		for (auto& it : pmm.model)
+			octoon::AssetDatabase::instance()->loadAssetAtPathAsync(it.path);
+
 		for (auto& it : pmm.model)
 		{
 			auto object = octoon::AssetDatabase::instance()->loadAssetAtPath<octoon::GameObject>(it.path);
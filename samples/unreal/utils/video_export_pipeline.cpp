@@ -0,0 +1,444 @@
+#include "video_export_pipeline.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#	include <emmintrin.h>
+#endif
+
+namespace unreal
+{
+	namespace
+	{
+		// BT.601 limited range, with the colour already scaled to 0-255.
+		inline std::uint8_t toY(float r, float g, float b) noexcept
+		{
+			return static_cast<std::uint8_t>(std::clamp(16.5f + (66.0f * r + 129.0f * g + 25.0f * b) / 256.0f, 0.0f, 255.0f));
+		}
+
+		inline std::uint8_t toU(float r, float g, float b) noexcept
+		{
+			return static_cast<std::uint8_t>(std::clamp(128.5f + (-38.0f * r - 74.0f * g + 112.0f * b) / 256.0f, 0.0f, 255.0f));
+		}
+
+		inline std::uint8_t toV(float r, float g, float b) noexcept
+		{
+			return static_cast<std::uint8_t>(std::clamp(128.5f + (112.0f * r - 94.0f * g - 18.0f * b) / 256.0f, 0.0f, 255.0f));
+		}
+
+		inline void loadPixel(const octoon::math::float3& pixel, float& r, float& g, float& b) noexcept
+		{
+			r = std::clamp(pixel.x, 0.0f, 1.0f) * 255.0f;
+			g = std::clamp(pixel.y, 0.0f, 1.0f) * 255.0f;
+			b = std::clamp(pixel.z, 0.0f, 1.0f) * 255.0f;
+		}
+
+		// Converts the columns [x, width) of two rows, one 2x2 block at a time.
+		void convertRows(const octoon::math::float3* row0, const octoon::math::float3* row1, std::uint32_t x, std::uint32_t width, std::uint8_t* y0, std::uint8_t* y1, std::uint8_t* u, std::uint8_t* v) noexcept
+		{
+			for (; x < width; x += 2)
+			{
+				auto x1 = std::min(x + 1, width - 1);
+
+				float r[4], g[4], b[4];
+				loadPixel(row0[x], r[0], g[0], b[0]);
+				loadPixel(row0[x1], r[1], g[1], b[1]);
+				loadPixel(row1[x], r[2], g[2], b[2]);
+				loadPixel(row1[x1], r[3], g[3], b[3]);
+
+				y0[x] = toY(r[0], g[0], b[0]);
+				y1[x] = toY(r[2], g[2], b[2]);
+
+				if (x + 1 < width)
+				{
+					y0[x + 1] = toY(r[1], g[1], b[1]);
+					y1[x + 1] = toY(r[3], g[3], b[3]);
+				}
+
+				auto ra = (r[0] + r[1] + r[2] + r[3]) * 0.25f;
+				auto ga = (g[0] + g[1] + g[2] + g[3]) * 0.25f;
+				auto ba = (b[0] + b[1] + b[2] + b[3]) * 0.25f;
+
+				u[x / 2] = toU(ra, ga, ba);
+				v[x / 2] = toV(ra, ga, ba);
+			}
+		}
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+		// Splits four packed float3 pixels into R, G and B vectors scaled to 0-255.
+		inline void loadPixels(const octoon::math::float3* pixels, __m128& r, __m128& g, __m128& b) noexcept
+		{
+			auto ptr = reinterpret_cast<const float*>(pixels);
+			auto a = _mm_loadu_ps(ptr);
+			auto m = _mm_loadu_ps(ptr + 4);
+			auto c = _mm_loadu_ps(ptr + 8);
+
+			r = _mm_shuffle_ps(a, _mm_shuffle_ps(m, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+			g = _mm_shuffle_ps(_mm_shuffle_ps(a, m, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(m, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+			b = _mm_shuffle_ps(_mm_shuffle_ps(a, m, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+			auto zero = _mm_setzero_ps();
+			auto one = _mm_set1_ps(1.0f);
+			auto scale = _mm_set1_ps(255.0f);
+
+			r = _mm_mul_ps(_mm_min_ps(_mm_max_ps(r, zero), one), scale);
+			g = _mm_mul_ps(_mm_min_ps(_mm_max_ps(g, zero), one), scale);
+			b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(b, zero), one), scale);
+		}
+
+		inline __m128i evalChannel(__m128 r, __m128 g, __m128 b, float kr, float kg, float kb, float bias) noexcept
+		{
+			auto sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(kr / 256.0f)), _mm_mul_ps(g, _mm_set1_ps(kg / 256.0f))), _mm_mul_ps(b, _mm_set1_ps(kb / 256.0f)));
+			return _mm_cvttps_epi32(_mm_add_ps(sum, _mm_set1_ps(bias)));
+		}
+
+		inline void storeBytes(std::uint8_t* dst, __m128i value, std::size_t count) noexcept
+		{
+			auto packed = _mm_packus_epi16(_mm_packs_epi32(value, value), _mm_setzero_si128());
+			auto bytes = static_cast<std::uint32_t>(_mm_cvtsi128_si32(packed));
+			std::memcpy(dst, &bytes, count);
+		}
+
+		// Averages horizontal pairs of a row pair, giving the two 2x2 block means in the low lanes.
+		inline __m128 averageBlocks(__m128 a, __m128 b) noexcept
+		{
+			auto sum = _mm_add_ps(a, b);
+			auto pairs = _mm_add_ps(_mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(3, 1, 3, 1)));
+			return _mm_mul_ps(pairs, _mm_set1_ps(0.25f));
+		}
+
+		std::uint32_t convertRowsSIMD(const octoon::math::float3* row0, const octoon::math::float3* row1, std::uint32_t width, std::uint8_t* y0, std::uint8_t* y1, std::uint8_t* u, std::uint8_t* v) noexcept
+		{
+			std::uint32_t x = 0;
+
+			for (; x + 4 <= width; x += 4)
+			{
+				__m128 r0, g0, b0, r1, g1, b1;
+				loadPixels(row0 + x, r0, g0, b0);
+				loadPixels(row1 + x, r1, g1, b1);
+
+				storeBytes(y0 + x, evalChannel(r0, g0, b0, 66.0f, 129.0f, 25.0f, 16.5f), 4);
+				storeBytes(y1 + x, evalChannel(r1, g1, b1, 66.0f, 129.0f, 25.0f, 16.5f), 4);
+
+				auto r = averageBlocks(r0, r1);
+				auto g = averageBlocks(g0, g1);
+				auto b = averageBlocks(b0, b1);
+
+				storeBytes(u + x / 2, evalChannel(r, g, b, -38.0f, -74.0f, 112.0f, 128.5f), 2);
+				storeBytes(v + x / 2, evalChannel(r, g, b, 112.0f, -94.0f, -18.0f, 128.5f), 2);
+			}
+
+			return x;
+		}
+#endif
+	}
+
+	void convertRGBToI420(const octoon::math::float3* rgb, std::uint32_t width, std::uint32_t height, std::uint8_t* yuv) noexcept
+	{
+		auto chromaWidth = (width + 1) / 2;
+		auto planeY = yuv;
+		auto planeU = planeY + std::size_t(width) * height;
+		auto planeV = planeU + std::size_t(chromaWidth) * ((height + 1) / 2);
+
+		auto numRows = static_cast<std::int32_t>((height + 1) / 2);
+
+#pragma omp parallel for schedule(static)
+		for (std::int32_t j = 0; j < numRows; j++)
+		{
+			auto y = static_cast<std::uint32_t>(j) * 2;
+			auto y1 = std::min(y + 1, height - 1);
+
+			// the framebuffer is bottom-up, the encoder wants the first row on top
+			auto row0 = rgb + std::size_t(height - y - 1) * width;
+			auto row1 = rgb + std::size_t(height - y1 - 1) * width;
+
+			auto dstY0 = planeY + std::size_t(y) * width;
+			auto dstY1 = planeY + std::size_t(y1) * width;
+			auto dstU = planeU + std::size_t(j) * chromaWidth;
+			auto dstV = planeV + std::size_t(j) * chromaWidth;
+
+			std::uint32_t x = 0;
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+			x = convertRowsSIMD(row0, row1, width, dstY0, dstY1, dstU, dstV);
+#endif
+			convertRows(row0, row1, x, width, dstY0, dstY1, dstU, dstV);
+		}
+	}
+
+	VideoExportPipeline::VideoExportPipeline() noexcept
+		: width_(0)
+		, height_(0)
+		, closing_(false)
+		, convertDone_(false)
+		, encodeDone_(false)
+	{
+	}
+
+	VideoExportPipeline::~VideoExportPipeline() noexcept
+	{
+		try
+		{
+			this->close();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	void
+	VideoExportPipeline::open(std::uint32_t width, std::uint32_t height, std::size_t maxFrames, EncodeFunc&& encode, FlushFunc&& flush, WriteFunc&& write) noexcept(false)
+	{
+		assert(!this->isOpen());
+
+		width_ = width;
+		height_ = height;
+		encode_ = std::move(encode);
+		flush_ = std::move(flush);
+		write_ = std::move(write);
+
+		closing_ = false;
+		convertDone_ = false;
+		encodeDone_ = false;
+		error_ = nullptr;
+
+		frames_.resize(std::max<std::size_t>(maxFrames, 1));
+		for (auto& frame : frames_)
+		{
+			frame.rgb.resize(std::size_t(width) * height);
+			frame.yuv.resize(std::size_t(width) * height + std::size_t((width + 1) / 2) * ((height + 1) / 2) * 2);
+			freeFrames_.push_back(&frame);
+		}
+
+		convertThread_ = std::thread(&VideoExportPipeline::convertThread, this);
+		encodeThread_ = std::thread(&VideoExportPipeline::encodeThread, this);
+		writeThread_ = std::thread(&VideoExportPipeline::writeThread, this);
+	}
+
+	void
+	VideoExportPipeline::close() noexcept(false)
+	{
+		if (!this->isOpen())
+			return;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			closing_ = true;
+		}
+
+		condition_.notify_all();
+
+		convertThread_.join();
+		encodeThread_.join();
+		writeThread_.join();
+
+		frames_.clear();
+		freeFrames_.clear();
+		convertQueue_.clear();
+		encodeQueue_.clear();
+		writeQueue_.clear();
+
+		encode_ = nullptr;
+		flush_ = nullptr;
+		write_ = nullptr;
+
+		this->rethrowError();
+	}
+
+	bool
+	VideoExportPipeline::isOpen() const noexcept
+	{
+		return convertThread_.joinable();
+	}
+
+	void
+	VideoExportPipeline::push(const octoon::math::float3* rgb) noexcept(false)
+	{
+		assert(this->isOpen());
+
+		Frame* frame = nullptr;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this]() { return !freeFrames_.empty() || error_; });
+
+			if (error_)
+			{
+				lock.unlock();
+				this->rethrowError();
+			}
+
+			frame = freeFrames_.front();
+			freeFrames_.pop_front();
+		}
+
+		std::memcpy(frame->rgb.data(), rgb, frame->rgb.size() * sizeof(octoon::math::float3));
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			convertQueue_.push_back(frame);
+		}
+
+		condition_.notify_all();
+	}
+
+	void
+	VideoExportPipeline::convertThread() noexcept
+	{
+		for (;;)
+		{
+			Frame* frame = nullptr;
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				condition_.wait(lock, [this]() { return !convertQueue_.empty() || closing_ || error_; });
+
+				if (convertQueue_.empty() || error_)
+					break;
+
+				frame = convertQueue_.front();
+				convertQueue_.pop_front();
+			}
+
+			convertRGBToI420(frame->rgb.data(), width_, height_, frame->yuv.data());
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				encodeQueue_.push_back(frame);
+			}
+
+			condition_.notify_all();
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			convertDone_ = true;
+		}
+
+		condition_.notify_all();
+	}
+
+	void
+	VideoExportPipeline::encodeThread() noexcept
+	{
+		try
+		{
+			for (;;)
+			{
+				Frame* frame = nullptr;
+
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					condition_.wait(lock, [this]() { return !encodeQueue_.empty() || convertDone_ || error_; });
+
+					if (encodeQueue_.empty() || error_)
+						break;
+
+					frame = encodeQueue_.front();
+					encodeQueue_.pop_front();
+				}
+
+				std::vector<std::uint8_t> packet;
+				encode_(frame->yuv.data(), packet);
+
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					freeFrames_.push_back(frame);
+					if (!packet.empty())
+						writeQueue_.push_back(std::move(packet));
+				}
+
+				condition_.notify_all();
+			}
+
+			bool more = false;
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				more = !error_;
+			}
+
+			while (more)
+			{
+				std::vector<std::uint8_t> packet;
+				more = flush_(packet);
+
+				if (!packet.empty())
+				{
+					{
+						std::unique_lock<std::mutex> lock(mutex_);
+						writeQueue_.push_back(std::move(packet));
+					}
+
+					condition_.notify_all();
+				}
+			}
+		}
+		catch (...)
+		{
+			this->setError(std::current_exception());
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			encodeDone_ = true;
+		}
+
+		condition_.notify_all();
+	}
+
+	void
+	VideoExportPipeline::writeThread() noexcept
+	{
+		try
+		{
+			for (;;)
+			{
+				std::vector<std::uint8_t> packet;
+
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					condition_.wait(lock, [this]() { return !writeQueue_.empty() || encodeDone_ || error_; });
+
+					if (writeQueue_.empty() || error_)
+						break;
+
+					packet = std::move(writeQueue_.front());
+					writeQueue_.pop_front();
+				}
+
+				write_(packet);
+			}
+		}
+		catch (...)
+		{
+			this->setError(std::current_exception());
+		}
+	}
+
+	void
+	VideoExportPipeline::setError(std::exception_ptr error) noexcept
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			if (!error_)
+				error_ = error;
+		}
+
+		condition_.notify_all();
+	}
+
+	void
+	VideoExportPipeline::rethrowError() noexcept(false)
+	{
+		std::exception_ptr error;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			error = error_;
+		}
+
+		if (error)
+			std::rethrow_exception(error);
+	}
+}
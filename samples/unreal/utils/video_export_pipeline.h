@@ -0,0 +1,88 @@
+#ifndef UNREAL_VIDEO_EXPORT_PIPELINE_H_
+#define UNREAL_VIDEO_EXPORT_PIPELINE_H_
+
+#include <octoon/math/vector3.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace unreal
+{
+	// Converts the bottom-up float RGB framebuffer into a top-down I420 image (BT.601, limited range).
+	void convertRGBToI420(const octoon::math::float3* rgb, std::uint32_t width, std::uint32_t height, std::uint8_t* yuv) noexcept;
+
+	// Bounded frame queue between the renderer and a video encoder. push() copies the frame and
+	// returns; colour conversion, encoding and writing each run on their own thread so that they
+	// overlap with rendering of the next frames. When maxFrames frames are in flight push() waits,
+	// which keeps memory bounded and lets the export run at the speed of the slowest stage.
+	class VideoExportPipeline final
+	{
+	public:
+		// Encodes one I420 frame, appending any bitstream that is ready to packet.
+		using EncodeFunc = std::function<void(const std::uint8_t* yuv, std::vector<std::uint8_t>& packet)>;
+		// Drains delayed frames at the end of the stream; returns false once nothing is left.
+		using FlushFunc = std::function<bool(std::vector<std::uint8_t>& packet)>;
+		using WriteFunc = std::function<void(const std::vector<std::uint8_t>& packet)>;
+
+		VideoExportPipeline() noexcept;
+		~VideoExportPipeline() noexcept;
+
+		void open(std::uint32_t width, std::uint32_t height, std::size_t maxFrames, EncodeFunc&& encode, FlushFunc&& flush, WriteFunc&& write) noexcept(false);
+		void close() noexcept(false);
+
+		bool isOpen() const noexcept;
+
+		void push(const octoon::math::float3* rgb) noexcept(false);
+
+	private:
+		struct Frame
+		{
+			std::vector<octoon::math::float3> rgb;
+			std::vector<std::uint8_t> yuv;
+		};
+
+		void convertThread() noexcept;
+		void encodeThread() noexcept;
+		void writeThread() noexcept;
+
+		void setError(std::exception_ptr error) noexcept;
+		void rethrowError() noexcept(false);
+
+	private:
+		VideoExportPipeline(const VideoExportPipeline&) = delete;
+		VideoExportPipeline& operator=(const VideoExportPipeline&) = delete;
+
+	private:
+		std::uint32_t width_;
+		std::uint32_t height_;
+
+		EncodeFunc encode_;
+		FlushFunc flush_;
+		WriteFunc write_;
+
+		bool closing_;
+		bool convertDone_;
+		bool encodeDone_;
+		std::exception_ptr error_;
+
+		std::vector<Frame> frames_;
+		std::deque<Frame*> freeFrames_;
+		std::deque<Frame*> convertQueue_;
+		std::deque<Frame*> encodeQueue_;
+		std::deque<std::vector<std::uint8_t>> writeQueue_;
+
+		std::mutex mutex_;
+		std::condition_variable condition_;
+
+		std::thread convertThread_;
+		std::thread encodeThread_;
+		std::thread writeThread_;
+	};
+}
+
+#endif
@@ -680,6 +680,12 @@ namespace unreal
 
 				gameApp_->setGameListener(listener_);
 				gameApp_->open((octoon::WindHandle)viewDock_->winId(), w, h, w, h);
+
+				// the physics scene is created when the features start, so this has to be set before
+				auto physicsFeature = gameApp_->getFeature<octoon::PhysicsFeature>();
+				if (physicsFeature)
+					physicsFeature->setEnableMultiThreading(profile_->physicsModule->multiThreading.getValue());
+
 				gameApp_->start();
 
 				listener_->splash_ = nullptr;
@@ -232,15 +232,7 @@ namespace unreal
 									animator->setName(package["name"].get<nlohmann::json::string_t>());
 									animator->sample();
 
-									if (smr)
-									{
-										for (auto& transform : smr->getBones())
-										{
-											auto solver = transform->getComponent<octoon::CCDSolverComponent>();
-											if (solver)
-												solver->solve();
-										}
-									}
+									behaviour->getComponent<PlayerComponent>()->solveIK(*animator);
 
 									octoon::AssetDatabase::instance()->setDirty(model, true);
 								}
@@ -252,6 +252,19 @@ namespace unreal
 		denoiseLayout_->setSpacing(0);
 		denoiseLayout_->setContentsMargins(0, 0, 0, 0);
 
+		bakePhysicsLabel_ = new QLabel();
+		bakePhysicsLabel_->setText(tr("Bake physics:"));
+
+		bakePhysicsButton_ = new QCheckBox();
+		bakePhysicsButton_->setCheckState(Qt::CheckState::Unchecked);
+		bakePhysicsButton_->installEventFilter(this);
+
+		auto bakePhysicsLayout_ = new QHBoxLayout();
+		bakePhysicsLayout_->addWidget(bakePhysicsLabel_, 0, Qt::AlignLeft);
+		bakePhysicsLayout_->addWidget(bakePhysicsButton_, 0, Qt::AlignLeft);
+		bakePhysicsLayout_->setSpacing(0);
+		bakePhysicsLayout_->setContentsMargins(0, 0, 0, 0);
+
 		bouncesSpinbox_ = USpinLine::create(this, tr("Recursion depth per pixel:"), 1, 32, 1, 0);
 
 		sppSpinbox_ = USpinLine::create(this, tr("Sample number per pixel:"), 1, 9999, 1, 0);
@@ -295,6 +308,7 @@ namespace unreal
 		videoLayout->addLayout(qualityLayout_);
 		videoLayout->addSpacing(8);
 		videoLayout->addLayout(denoiseLayout_);
+		videoLayout->addLayout(bakePhysicsLayout_);
 		videoLayout->addWidget(sppSpinbox_);
 		videoLayout->addWidget(bouncesSpinbox_);
 		videoLayout->addStretch();
@@ -424,6 +438,13 @@ namespace unreal
 			denoiseButton_->blockSignals(false);
 		};
 
+		profile_->physicsModule->bake += [this](bool value)
+		{
+			bakePhysicsButton_->blockSignals(true);
+			bakePhysicsButton_->setChecked(value);
+			bakePhysicsButton_->blockSignals(false);
+		};
+
 		profile_->playerModule->startFrame += [this](std::uint32_t value)
 		{
 			startFrame_->blockSignals(true);
@@ -487,6 +508,7 @@ namespace unreal
 		connect(mode2_, SIGNAL(toggled(bool)), this, SLOT(mode2Event(bool)));
 		connect(mode3_, SIGNAL(toggled(bool)), this, SLOT(mode3Event(bool)));
 		connect(denoiseButton_, SIGNAL(stateChanged(int)), this, SLOT(denoiseEvent(int)));
+		connect(bakePhysicsButton_, SIGNAL(stateChanged(int)), this, SLOT(bakePhysicsEvent(int)));
 		connect(startFrame_, SIGNAL(valueChanged(int)), this, SLOT(startEvent(int)));
 		connect(endFrame_, SIGNAL(valueChanged(int)), this, SLOT(endEvent(int)));
 		connect(sppSpinbox_, SIGNAL(valueChanged(int)), this, SLOT(onSppChanged(int)));
@@ -624,6 +646,15 @@ namespace unreal
 			profile_->recordModule->denoise = false;
 	}
 
+	void
+	RecordDock::bakePhysicsEvent(int checked)
+	{
+		if (checked == Qt::CheckState::Checked)
+			profile_->physicsModule->bake = true;
+		else
+			profile_->physicsModule->bake = false;
+	}
+
 	void
 	RecordDock::speed1Event(bool checked)
 	{
@@ -725,7 +756,12 @@ namespace unreal
 				if (profile_->encodeModule->encodeMode == EncodeMode::H264 || profile_->encodeModule->encodeMode == EncodeMode::H265)
 					fileName = QFileDialog::getSaveFileName(this, tr("Save Video"), tr("New Video"), tr("MP4 Files (*.mp4)"));
 				else if (profile_->encodeModule->encodeMode == EncodeMode::Frame)
-					fileName = QFileDialog::getSaveFileName(this, tr("Save Image Sequence"), "", tr("PNG Files (*.png)"));
+				{
+					QString fastFilter = tr("PNG Files, fast compression (*.png)");
+					QString selectedFilter;
+					fileName = QFileDialog::getSaveFileName(this, tr("Save Image Sequence"), "", tr("PNG Files (*.png);;") + fastFilter + tr(";;JPEG Files (*.jpg);;OpenEXR Files (*.exr);;HDR Files (*.hdr)"), &selectedFilter);
+					profile_->encodeModule->encode_speed = selectedFilter == fastFilter ? 1 : 0;
+				}
 				else
 					throw std::runtime_error("Unknown encode mode");
 
@@ -748,6 +784,7 @@ namespace unreal
 		startFrame_->setValue(0);
 		endFrame_->setValue(profile_->playerModule->endFrame);
 		denoiseButton_->setCheckState(profile_->recordModule->denoise ? Qt::CheckState::Checked : Qt::CheckState::Unchecked);
+		bakePhysicsButton_->setCheckState(profile_->physicsModule->bake ? Qt::CheckState::Checked : Qt::CheckState::Unchecked);
 		sppSpinbox_->setValue(profile_->offlineModule->spp);
 		crfSpinbox->doublespinbox_->setValue(profile_->encodeModule->crf);
 		bouncesSpinbox_->setValue(profile_->offlineModule->bounces);
@@ -46,6 +46,7 @@ namespace unreal
 		void select1Event(bool checked);
 		void select2Event(bool checked);
 		void denoiseEvent(int checked);
+		void bakePhysicsEvent(int checked);
 		void speed1Event(bool checked);
 		void speed2Event(bool checked);
 		void speed3Event(bool checked);
@@ -73,6 +74,7 @@ namespace unreal
 		QLabel* middleLabel_;
 		QLabel* endLabel_;
 		QLabel* denoiseLabel_;
+		QLabel* bakePhysicsLabel_;
 		QLabel* resolutionLabel;
 		QLabel* title_;
 
@@ -108,6 +110,7 @@ namespace unreal
 
 		QPushButton* recordButton_;
 		QCheckBox* denoiseButton_;
+		QCheckBox* bakePhysicsButton_;
 
 		QSpinBox* startFrame_;
 		QSpinBox* endFrame_;
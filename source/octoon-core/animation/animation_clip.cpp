@@ -7,6 +7,7 @@ namespace octoon
 	AnimationClip::AnimationClip() noexcept
 		: finish(false)
 		, timeLength(0)
+		, version_(0)
 	{
 	}
 
@@ -14,6 +15,7 @@ namespace octoon
 		: name(_name)
 		, finish(false)
 		, timeLength(0)
+		, version_(0)
 	{
 	}
 
@@ -41,6 +43,8 @@ namespace octoon
 			for (auto& it : binding.second)
 				timeLength = std::max(it.second.timeLength, timeLength);
 		}
+
+		this->version_++;
 	}
 
 	void
@@ -55,6 +59,8 @@ namespace octoon
 			for (auto& it : binding.second)
 				timeLength = std::max(it.second.timeLength, timeLength);
 		}
+
+		this->version_++;
 	}
 
 	bool
@@ -80,6 +86,7 @@ namespace octoon
 	{
 		this->timeLength = 0;
 		this->bindings.clear();
+		this->version_++;
 	}
 
 	bool
@@ -126,4 +133,20 @@ namespace octoon
 				this->finish &= curve.second.finish;
 		}
 	}
+
+	void
+	AnimationClip::setBezierSolver(BezierSolver solver) noexcept
+	{
+		for (auto& binding : this->bindings)
+		{
+			for (auto& curve : binding.second)
+				curve.second.compiled.solver = solver;
+		}
+	}
+
+	std::uint32_t
+	AnimationClip::getVersion() const noexcept
+	{
+		return this->version_;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include <octoon/animation/bezier_table.h>
+#include <octoon/math/mathutil.h>
+#include <algorithm>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+
+namespace octoon
+{
+	BezierTable::BezierTable(const BezierControl& control) noexcept
+		: xa_(control.xa / 127.0f)
+		, xb_(control.xb / 127.0f)
+		, ya_(control.ya / 127.0f)
+		, yb_(control.yb / 127.0f)
+	{
+		for (std::size_t i = 0; i <= Size; i++)
+		{
+			auto x = float(i) / Size;
+
+			float min = 0.0f;
+			float max = 1.0f;
+
+			for (std::size_t j = 0; j < 32; j++)
+			{
+				auto t = (min + max) * 0.5f;
+				if (this->evalX(t) < x)
+					min = t;
+				else
+					max = t;
+			}
+
+			t_[i] = (min + max) * 0.5f;
+			y_[i] = this->evalY(t_[i]);
+		}
+	}
+
+	float
+	BezierTable::evalX(float t) const noexcept
+	{
+		float it = 1.0f - t;
+		return 3.0f * it * it * t * xa_ + 3.0f * it * t * t * xb_ + t * t * t;
+	}
+
+	float
+	BezierTable::evalY(float t) const noexcept
+	{
+		float it = 1.0f - t;
+		return 3.0f * it * it * t * ya_ + 3.0f * it * t * t * yb_ + t * t * t;
+	}
+
+	float
+	BezierTable::derivativeX(float t) const noexcept
+	{
+		float it = 1.0f - t;
+		return 3.0f * it * it * xa_ + 6.0f * it * t * (xb_ - xa_) + 3.0f * t * t * (1.0f - xb_);
+	}
+
+	float
+	BezierTable::solve(float x, BezierSolver solver) const noexcept
+	{
+		switch (solver)
+		{
+		case BezierSolver::Bisection:
+			return this->bisection(x);
+		case BezierSolver::Newton:
+			return this->newton(x);
+		case BezierSolver::Table:
+			return this->lookup(x);
+		default:
+			return this->newton(x);
+		}
+	}
+
+	float
+	BezierTable::bisection(float x) const noexcept
+	{
+		float min = 0.0f;
+		float max = 1.0f;
+
+		float t = 0.5f;
+		float v = this->evalX(t);
+
+		for (std::size_t i = 0; i < 32 && std::abs(v - x) > math::EPSILON_E4; i++)
+		{
+			if (v < x)
+				min = t;
+			else
+				max = t;
+
+			t = (min + max) * 0.5f;
+			v = this->evalX(t);
+		}
+
+		return this->evalY(t);
+	}
+
+	float
+	BezierTable::newton(float x) const noexcept
+	{
+		auto f = std::clamp(x, 0.0f, 1.0f) * Size;
+		auto i = std::min(static_cast<std::size_t>(f), Size - 1);
+
+		// x(t) is monotonic, so the two neighbouring samples bracket the root
+		auto min = t_[i];
+		auto max = t_[i + 1];
+		auto t = min + (max - min) * (f - i);
+
+		for (std::size_t n = 0; n < 4; n++)
+		{
+			auto delta = this->evalX(t) - x;
+			if (std::abs(delta) < math::EPSILON_E6)
+				break;
+
+			if (delta < 0.0f)
+				min = t;
+			else
+				max = t;
+
+			auto slope = this->derivativeX(t);
+			auto next = slope > math::EPSILON_E5 ? t - delta / slope : min;
+
+			t = (next > min && next < max) ? next : (min + max) * 0.5f;
+		}
+
+		return this->evalY(t);
+	}
+
+	float
+	BezierTable::lookup(float x) const noexcept
+	{
+		auto f = std::clamp(x, 0.0f, 1.0f) * Size;
+		auto i = std::min(static_cast<std::size_t>(f), Size - 1);
+		return y_[i] + (y_[i + 1] - y_[i]) * (f - i);
+	}
+
+	const BezierTable*
+	BezierTable::get(const BezierControl& control) noexcept
+	{
+		static std::mutex mutex;
+		static std::unordered_map<std::uint32_t, std::unique_ptr<BezierTable>> tables;
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		auto& table = tables[control.key()];
+		if (!table)
+			table = std::make_unique<BezierTable>(control);
+
+		return table.get();
+	}
+}
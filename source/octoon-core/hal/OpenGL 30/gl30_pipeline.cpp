@@ -32,11 +32,15 @@ namespace octoon
 			assert(pipelineDesc.getInputLayout()->isInstanceOf<GL30InputLayout>());
 			assert(pipelineDesc.getDescriptorSetLayout()->isInstanceOf<GL30DescriptorSetLayout>());
 
-			std::uint16_t offset = 0;
+			std::vector<std::uint16_t> offsets;
 
 			auto& layouts = pipelineDesc.getInputLayout()->getInputLayoutDesc().getVertexLayouts();
 			for (auto& it : layouts)
 			{
+				if (offsets.size() <= it.getVertexSlot())
+					offsets.resize(it.getVertexSlot() + 1, 0);
+
+				auto& offset = offsets[it.getVertexSlot()];
 				GLuint attribIndex = GL_INVALID_INDEX;
 
 				auto& attributes = pipelineDesc.getProgram()->getActiveAttributes();
@@ -28,6 +28,12 @@ namespace octoon
 			return _param->getName();
 		}
 
+		std::uint32_t
+		GL33GraphicsUniformSet::getVersion() const noexcept
+		{
+			return _variant.getVersion();
+		}
+
 		void
 		GL33GraphicsUniformSet::uniform1b(bool value) noexcept
 		{
@@ -684,6 +690,7 @@ namespace octoon
 		}
 
 		GL33DescriptorSet::GL33DescriptorSet() noexcept
+			: _appliedProgram(GL_NONE)
 		{
 		}
 
@@ -714,6 +721,8 @@ namespace octoon
 		void
 		GL33DescriptorSet::close() noexcept
 		{
+			_appliedProgram = GL_NONE;
+			_appliedVersions.clear();
 			_activeUniformSets.clear();
 		}
 
@@ -721,10 +730,28 @@ namespace octoon
 		GL33DescriptorSet::apply(const GL33Program& shaderObject) noexcept
 		{
 			auto program = shaderObject.getInstanceID();
-			for (auto& it : _activeUniformSets)
+
+			// uniform values are program state and survive between draws, so only the ones that changed
+			// since the last apply are issued; texture and buffer bindings are context state and always are
+			bool force = _appliedProgram != program || shaderObject.getUniformOwner() != this;
+			_appliedProgram = program;
+			shaderObject.setUniformOwner(this);
+			_appliedVersions.resize(_activeUniformSets.size(), 0);
+
+			for (std::size_t i = 0; i < _activeUniformSets.size(); i++)
 			{
+				auto& it = _activeUniformSets[i];
 				auto type = it->getGraphicsParam()->getType();
 				auto location = it->getGraphicsParam()->getBindingPoint();
+
+				if (type < UniformAttributeFormat::Sampler)
+				{
+					auto version = it->downcast<GL33GraphicsUniformSet>()->getVersion();
+					if (!force && _appliedVersions[i] == version)
+						continue;
+					_appliedVersions[i] = version;
+				}
+
 				switch (type)
 				{
 				case UniformAttributeFormat::Boolean:
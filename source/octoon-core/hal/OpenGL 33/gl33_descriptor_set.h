@@ -15,6 +15,7 @@ namespace octoon
 			virtual ~GL33GraphicsUniformSet() noexcept;
 
 			const std::string& getName() const noexcept;
+			std::uint32_t getVersion() const noexcept;
 
 			void uniform1b(bool value) noexcept;
 			void uniform1f(float i1) noexcept;
@@ -204,6 +205,9 @@ namespace octoon
 			GL33DescriptorSet& operator=(const GL33DescriptorSet&) noexcept = delete;
 
 		private:
+			GLuint _appliedProgram;
+			std::vector<std::uint32_t> _appliedVersions;
+
 			GraphicsUniformSets _activeUniformSets;
 			GraphicsDeviceWeakPtr _device;
 			GraphicsDescriptorSetDesc _descriptorSetDesc;
@@ -785,6 +785,19 @@ namespace octoon
 			assert(_glcontext->getActive());
 			assert(data && data->getDataDesc().getType() == GraphicsDataType::IndirectBiffer);
 
+			if (_needUpdatePipeline || _needUpdateVertexBuffers)
+			{
+				_pipeline->bindVertexBuffers(_vertexBuffers, _needUpdatePipeline);
+				_needUpdatePipeline = false;
+				_needUpdateVertexBuffers = false;
+			}
+
+			if (_needUpdateDescriptor)
+			{
+				_descriptorSet->apply(*_program);
+				_needUpdateDescriptor = false;
+			}
+
 			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, data->downcast<GL33GraphicsData>()->getInstanceID());
 
 			if (drawCount > 0)
@@ -804,6 +817,19 @@ namespace octoon
 			assert(_glcontext->getActive());
 			assert(data && data->getDataDesc().getType() == GraphicsDataType::IndirectBiffer);
 
+			if (_needUpdatePipeline || _needUpdateVertexBuffers)
+			{
+				_pipeline->bindVertexBuffers(_vertexBuffers, _needUpdatePipeline);
+				_needUpdatePipeline = false;
+				_needUpdateVertexBuffers = false;
+			}
+
+			if (_needUpdateDescriptor)
+			{
+				_descriptorSet->apply(*_program);
+				_needUpdateDescriptor = false;
+			}
+
 			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, data->downcast<GL33GraphicsData>()->getInstanceID());
 
 			if (drawCount > 0)
@@ -484,6 +484,7 @@ namespace octoon
 
 		GL33Program::GL33Program() noexcept
 			: _program(GL_NONE)
+			, _uniformOwner(nullptr)
 		{
 		}
 
@@ -497,7 +498,11 @@ namespace octoon
 		{
 			assert(_program == GL_NONE);
 
-			if (programDesc.getShaders().empty())
+			auto& binary = programDesc.getProgramBinary();
+			if (programDesc.getShaders().empty() && binary.empty())
+				return false;
+
+			if (!binary.empty() && !GLEW_ARB_get_program_binary)
 				return false;
 
 			_program = glCreateProgram();
@@ -507,19 +512,33 @@ namespace octoon
 				return false;
 			}
 
-			for (auto& shader : programDesc.getShaders())
+			if (!binary.empty())
 			{
-				auto glshader = shader->downcast<GL33Shader>();
-				if (glshader)
-					glAttachShader(_program, glshader->getInstanceID());
+				glProgramBinary(_program, programDesc.getProgramBinaryFormat(), binary.data(), (GLsizei)binary.size());
 			}
+			else
+			{
+				if (GLEW_ARB_get_program_binary)
+					glProgramParameteri(_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
-			glLinkProgram(_program);
+				for (auto& shader : programDesc.getShaders())
+				{
+					auto glshader = shader->downcast<GL33Shader>();
+					if (glshader)
+						glAttachShader(_program, glshader->getInstanceID());
+				}
+
+				glLinkProgram(_program);
+			}
 
 			GLint status = GL_FALSE;
 			glGetProgramiv(_program, GL_LINK_STATUS, &status);
 			if (!status)
 			{
+				// a binary from another driver or GPU is expected to be rejected, the caller recompiles
+				if (!binary.empty())
+					return false;
+
 				GLint length = 0;
 				glGetProgramiv(_program, GL_INFO_LOG_LENGTH, &length);
 
@@ -535,6 +554,7 @@ namespace octoon
 			_initActiveUniformBlock();
 
 			_programDesc = programDesc;
+			_programDesc.setProgramBinary(0, std::vector<std::uint8_t>());
 			return true;
 		}
 
@@ -549,6 +569,7 @@ namespace octoon
 
 			_activeAttributes.clear();
 			_activeParams.clear();
+			_uniformOwner = nullptr;
 		}
 
 		void
@@ -563,6 +584,18 @@ namespace octoon
 			return _program;
 		}
 
+		void
+		GL33Program::setUniformOwner(const void* owner) const noexcept
+		{
+			_uniformOwner = owner;
+		}
+
+		const void*
+		GL33Program::getUniformOwner() const noexcept
+		{
+			return _uniformOwner;
+		}
+
 		const GraphicsAttributes&
 		GL33Program::getActiveAttributes() const noexcept
 		{
@@ -932,6 +965,26 @@ namespace octoon
 			return _programDesc;
 		}
 
+		bool
+		GL33Program::getProgramBinary(std::uint32_t& format, std::vector<std::uint8_t>& binary) const noexcept
+		{
+			if (_program == GL_NONE || !GLEW_ARB_get_program_binary)
+				return false;
+
+			GLint length = 0;
+			glGetProgramiv(_program, GL_PROGRAM_BINARY_LENGTH, &length);
+			if (length <= 0)
+				return false;
+
+			GLenum binaryFormat = GL_NONE;
+			binary.resize(length);
+			glGetProgramBinary(_program, length, &length, &binaryFormat, binary.data());
+			binary.resize(length);
+
+			format = binaryFormat;
+			return length > 0;
+		}
+
 		void
 		GL33Program::setDevice(const GraphicsDevicePtr& device) noexcept
 		{
@@ -162,11 +162,17 @@ namespace octoon
 
 			GLuint getInstanceID() const noexcept;
 
+			// Descriptor set whose uniform values were last written into this program.
+			void setUniformOwner(const void* owner) const noexcept;
+			const void* getUniformOwner() const noexcept;
+
 			const GraphicsParams& getActiveParams() const noexcept;
 			const GraphicsAttributes& getActiveAttributes() const noexcept;
 
 			const GraphicsProgramDesc& getProgramDesc() const noexcept override;
 
+			bool getProgramBinary(std::uint32_t& format, std::vector<std::uint8_t>& binary) const noexcept override;
+
 		private:
 			void _initActiveAttribute() noexcept;
 			void _initActiveUniform() noexcept;
@@ -187,6 +193,7 @@ namespace octoon
 
 		private:
 			GLuint _program;
+			mutable const void* _uniformOwner;
 			GraphicsParams _activeParams;
 			GraphicsAttributes  _activeAttributes;
 			GraphicsProgramDesc _programDesc;
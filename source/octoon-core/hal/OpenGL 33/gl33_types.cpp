@@ -891,6 +891,10 @@ namespace octoon
 				return std::max(16, width * height / 2);
 			case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
 			case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+			case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+			case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+			case GL_COMPRESSED_RED_RGTC1:
+			case GL_COMPRESSED_SIGNED_RED_RGTC1:
 			case GL_RGB_S3TC:
 			case GL_RGB4_S3TC:
 				width = (width + 3) & ~3;
@@ -898,6 +902,14 @@ namespace octoon
 				return std::max(8, width * height / 2);
 			case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
 			case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+			case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+			case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+			case GL_COMPRESSED_RG_RGTC2:
+			case GL_COMPRESSED_SIGNED_RG_RGTC2:
+			case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+			case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+			case GL_COMPRESSED_RGBA_BPTC_UNORM:
+			case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
 			case GL_RGBA_S3TC:
 			case GL_RGBA4_S3TC:
 				width = (width + 3) & ~3;
@@ -12,6 +12,7 @@ namespace octoon
 		OctoonImplementSubClass(GL45DescriptorSet, GraphicsDescriptorSet, "GL45DescriptorSet")
 
 		GL45DescriptorSet::GL45DescriptorSet() noexcept
+			: _appliedProgram(GL_NONE)
 		{
 		}
 
@@ -42,6 +43,8 @@ namespace octoon
 		void
 		GL45DescriptorSet::close() noexcept
 		{
+			_appliedProgram = GL_NONE;
+			_appliedVersions.clear();
 			_activeUniformSets.clear();
 		}
 
@@ -49,10 +52,28 @@ namespace octoon
 		GL45DescriptorSet::apply(const GL33Program& shaderObject) noexcept
 		{
 			auto program = shaderObject.getInstanceID();
-			for (auto& it : _activeUniformSets)
+
+			// uniform values are program state and survive between draws, so only the ones that changed
+			// since the last apply are issued; texture and buffer bindings are context state and always are
+			bool force = _appliedProgram != program || shaderObject.getUniformOwner() != this;
+			_appliedProgram = program;
+			shaderObject.setUniformOwner(this);
+			_appliedVersions.resize(_activeUniformSets.size(), 0);
+
+			for (std::size_t i = 0; i < _activeUniformSets.size(); i++)
 			{
+				auto& it = _activeUniformSets[i];
 				auto type = it->getGraphicsParam()->getType();
 				auto location = it->getGraphicsParam()->getBindingPoint();
+
+				if (type < UniformAttributeFormat::Sampler)
+				{
+					auto version = it->downcast<GL33GraphicsUniformSet>()->getVersion();
+					if (!force && _appliedVersions[i] == version)
+						continue;
+					_appliedVersions[i] = version;
+				}
+
 				switch (type)
 				{
 				case UniformAttributeFormat::Boolean:
@@ -34,6 +34,9 @@ namespace octoon
 			GL45DescriptorSet& operator=(const GL45DescriptorSet&) noexcept = delete;
 
 		private:
+			GLuint _appliedProgram;
+			std::vector<std::uint32_t> _appliedVersions;
+
 			GraphicsUniformSets _activeUniformSets;
 			GraphicsDeviceWeakPtr _device;
 			GraphicsDescriptorSetDesc _descriptorSetDesc;
@@ -701,6 +701,19 @@ namespace octoon
 			assert(_glcontext->getActive());
 			assert(data && data->getDataDesc().getType() == GraphicsDataType::IndirectBiffer);
 
+			if (_needUpdatePipeline || _needUpdateVertexBuffers)
+			{
+				_pipeline->bindVertexBuffers(_vertexBuffers, _needUpdatePipeline);
+				_needUpdatePipeline = false;
+				_needUpdateVertexBuffers = false;
+			}
+
+			if (_needUpdateDescriptor)
+			{
+				_descriptorSet->apply(*_program);
+				_needUpdateDescriptor = false;
+			}
+
 			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, data->downcast<GL45GraphicsData>()->getInstanceID());
 
 			if (drawCount > 0)
@@ -720,13 +733,26 @@ namespace octoon
 			assert(_glcontext->getActive());
 			assert(data && data->getDataDesc().getType() == GraphicsDataType::IndirectBiffer);
 
+			if (_needUpdatePipeline || _needUpdateVertexBuffers)
+			{
+				_pipeline->bindVertexBuffers(_vertexBuffers, _needUpdatePipeline);
+				_needUpdatePipeline = false;
+				_needUpdateVertexBuffers = false;
+			}
+
+			if (_needUpdateDescriptor)
+			{
+				_descriptorSet->apply(*_program);
+				_needUpdateDescriptor = false;
+			}
+
 			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, data->downcast<GL45GraphicsData>()->getInstanceID());
 
 			if (drawCount > 0)
 			{
 				GLenum drawType = GL33Types::asVertexType(_stateCaptured.getPrimitiveType());
 				if (drawType != GL_INVALID_ENUM)
-					glMultiDrawElementsIndirect(drawType, GL_UNSIGNED_INT, (char*)nullptr + offset, drawCount, stride);
+					glMultiDrawElementsIndirect(drawType, _indexType, (char*)nullptr + offset, drawCount, stride);
 				else
 					this->getDevice()->downcast<GL33Device>()->message("Invalid vertex type");
 			}
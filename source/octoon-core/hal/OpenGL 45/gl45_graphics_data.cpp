@@ -87,8 +87,16 @@ namespace octoon
 		void
 		GL45GraphicsData::close() noexcept
 		{
+			for (auto& it : _fences)
+				glDeleteSync(it.sync);
+
+			_fences.clear();
+
 			if (_data)
+			{
 				glUnmapNamedBuffer(_buffer);
+				_data = nullptr;
+			}
 
 			if (_buffer)
 			{
@@ -130,7 +138,7 @@ namespace octoon
 				flags |= GL_MAP_FLUSH_EXPLICIT_BIT;
 
 			if (!_data && usage & GraphicsUsageFlagBits::PersistentBit)
-				_data = glMapNamedBuffer(_buffer, flags);
+				_data = glMapNamedBufferRange(_buffer, 0, _desc.getStreamSize(), flags);
 
 			if (_data && usage & GraphicsUsageFlagBits::PersistentBit)
 			{
@@ -145,10 +153,52 @@ namespace octoon
 		void
 		GL45GraphicsData::unmap() noexcept
 		{
+			// persistent mappings stay valid until the buffer is closed
 			auto usage = _desc.getUsage();
 			if (!(usage & GraphicsUsageFlagBits::PersistentBit))
+			{
 				glUnmapNamedBuffer(_buffer);
-			_data = nullptr;
+				_data = nullptr;
+			}
+		}
+
+		void
+		GL45GraphicsData::lock(std::ptrdiff_t offset, std::ptrdiff_t count) noexcept
+		{
+			auto sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			if (sync)
+				_fences.push_back(FenceRange{ offset, count, sync });
+		}
+
+		void
+		GL45GraphicsData::wait(std::ptrdiff_t offset, std::ptrdiff_t count) noexcept
+		{
+			for (auto it = _fences.begin(); it != _fences.end();)
+			{
+				if (it->offset < offset + count && offset < it->offset + it->count)
+				{
+					// the first try only polls; later ones flush so the fence is guaranteed to signal
+					GLbitfield flags = 0;
+					GLuint64 timeout = 0;
+
+					for (;;)
+					{
+						auto result = glClientWaitSync(it->sync, flags, timeout);
+						if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+							break;
+
+						flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+						timeout = 1000000000;
+					}
+
+					glDeleteSync(it->sync);
+					it = _fences.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
 		}
 
 		GLuint
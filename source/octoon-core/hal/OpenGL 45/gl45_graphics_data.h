@@ -23,6 +23,9 @@ namespace octoon
 			bool map(std::ptrdiff_t offset, std::ptrdiff_t count, void** data) noexcept;
 			void unmap() noexcept;
 
+			void lock(std::ptrdiff_t offset, std::ptrdiff_t count) noexcept override;
+			void wait(std::ptrdiff_t offset, std::ptrdiff_t count) noexcept override;
+
 			GLuint getInstanceID() const noexcept;
 			GLuint64 getInstanceAddr() const noexcept;
 
@@ -38,10 +41,18 @@ namespace octoon
 			GL45GraphicsData& operator=(const GL45GraphicsData&) noexcept = delete;
 
 		private:
+			struct FenceRange
+			{
+				std::ptrdiff_t offset;
+				std::ptrdiff_t count;
+				GLsync sync;
+			};
+
 			GLuint _buffer;
 			GLuint64 _bufferAddr;
 			GLvoid* _data;
 			GraphicsDataDesc _desc;
+			std::vector<FenceRange> _fences;
 			GraphicsDeviceWeakPtr _device;
 		};
 	}
@@ -80,7 +80,6 @@ namespace octoon
 				if (GL33Types::isCompressedTexture(textureDesc.getTexFormat()))
 				{
 					GLsizei offset = 0;
-					GLsizei blockSize = internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT ? 8 : 16;
 
 					GLint oldPackStore = 1;
 					glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldPackStore);
@@ -90,7 +89,13 @@ namespace octoon
 					{
 						GLsizei w = std::max(width / (1 << mip), 1);
 						GLsizei h = std::max(height / (1 << mip), 1);
-						GLsizei mipSize = ((w + 3) / 4) * ((h + 3) / 4) * blockSize;
+						GLsizei mipSize = GL33Types::getCompressedTextureSize(w, h, 1, internalFormat);
+						if (mipSize == 0)
+						{
+							glPixelStorei(GL_UNPACK_ALIGNMENT, oldPackStore);
+							this->getDevice()->downcast<GL33Device>()->message("bad texformat in compressed_texture_size");
+							return false;
+						}
 
 						glCompressedTextureSubImage2D(_texture, mip, 0, 0, w, h, internalFormat, mipSize, (char*)stream + offset);
 
@@ -79,4 +79,14 @@ namespace octoon
 	GraphicsData::~GraphicsData() noexcept
 	{
 	}
+
+	void
+	GraphicsData::lock(std::ptrdiff_t offset, std::ptrdiff_t count) noexcept
+	{
+	}
+
+	void
+	GraphicsData::wait(std::ptrdiff_t offset, std::ptrdiff_t count) noexcept
+	{
+	}
 }
\ No newline at end of file
@@ -7,6 +7,7 @@ namespace octoon
 	UniformHolder::UniformHolder() noexcept
 		: type_(UniformAttributeFormat::Null)
 		, texture_(nullptr)
+		, version_(0)
 	{
 	}
 
@@ -102,6 +103,7 @@ namespace octoon
 			}
 
 			type_ = type;
+			version_++;
 		}
 	}
 
@@ -111,242 +113,364 @@ namespace octoon
 		return type_;
 	}
 
+	std::uint32_t
+	UniformHolder::getVersion() const noexcept
+	{
+		return version_;
+	}
+
 	void
 	UniformHolder::uniform1b(bool b1) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Boolean);
-		boolValue_ = b1;
+		if (boolValue_ != b1)
+		{
+			boolValue_ = b1;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform1i(std::int32_t i1) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Int);
-		intValue_[0] = i1;
+		if (intValue_[0] != i1)
+		{
+			intValue_[0] = i1;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform2i(const math::int2& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Int2);
-		intValue_[0] = value.x;
-		intValue_[1] = value.y;
+		if (intValue_[0] != value.x || intValue_[1] != value.y)
+		{
+			intValue_[0] = value.x;
+			intValue_[1] = value.y;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform2i(std::int32_t i1, std::int32_t i2) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Int2);
-		intValue_[0] = i1;
-		intValue_[1] = i2;
+		if (intValue_[0] != i1 || intValue_[1] != i2)
+		{
+			intValue_[0] = i1;
+			intValue_[1] = i2;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform3i(const math::int3& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Int3);
-		intValue_[0] = value.x;
-		intValue_[1] = value.y;
-		intValue_[2] = value.z;
+		if (intValue_[0] != value.x || intValue_[1] != value.y || intValue_[2] != value.z)
+		{
+			intValue_[0] = value.x;
+			intValue_[1] = value.y;
+			intValue_[2] = value.z;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform3i(std::int32_t i1, std::int32_t i2, std::int32_t i3) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Int3);
-		intValue_[0] = i1;
-		intValue_[1] = i2;
-		intValue_[2] = i3;
+		if (intValue_[0] != i1 || intValue_[1] != i2 || intValue_[2] != i3)
+		{
+			intValue_[0] = i1;
+			intValue_[1] = i2;
+			intValue_[2] = i3;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform4i(const math::int4& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Int4);
-		intValue_[0] = value.x;
-		intValue_[1] = value.y;
-		intValue_[2] = value.z;
-		intValue_[3] = value.w;
+		if (intValue_[0] != value.x || intValue_[1] != value.y || intValue_[2] != value.z || intValue_[3] != value.w)
+		{
+			intValue_[0] = value.x;
+			intValue_[1] = value.y;
+			intValue_[2] = value.z;
+			intValue_[3] = value.w;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform4i(std::int32_t i1, std::int32_t i2, std::int32_t i3, std::int32_t i4) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Int4);
-		intValue_[0] = i1;
-		intValue_[1] = i2;
-		intValue_[2] = i3;
-		intValue_[3] = i4;
+		if (intValue_[0] != i1 || intValue_[1] != i2 || intValue_[2] != i3 || intValue_[3] != i4)
+		{
+			intValue_[0] = i1;
+			intValue_[1] = i2;
+			intValue_[2] = i3;
+			intValue_[3] = i4;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform1ui(std::uint32_t ui1) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float);
-		uintValue_[0] = ui1;
+		if (uintValue_[0] != ui1)
+		{
+			uintValue_[0] = ui1;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform2ui(const math::uint2& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::UInt2);
-		uintValue_[0] = value.x;
-		uintValue_[1] = value.y;
+		if (uintValue_[0] != value.x || uintValue_[1] != value.y)
+		{
+			uintValue_[0] = value.x;
+			uintValue_[1] = value.y;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform2ui(std::uint32_t ui1, std::uint32_t ui2) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float2);
-		uintValue_[0] = ui1;
-		uintValue_[1] = ui2;
+		if (uintValue_[0] != ui1 || uintValue_[1] != ui2)
+		{
+			uintValue_[0] = ui1;
+			uintValue_[1] = ui2;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform3ui(const math::uint3& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::UInt3);
-		uintValue_[0] = value.x;
-		uintValue_[1] = value.y;
-		uintValue_[2] = value.z;
+		if (uintValue_[0] != value.x || uintValue_[1] != value.y || uintValue_[2] != value.z)
+		{
+			uintValue_[0] = value.x;
+			uintValue_[1] = value.y;
+			uintValue_[2] = value.z;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform3ui(std::uint32_t ui1, std::uint32_t ui2, std::uint32_t ui3) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float3);
-		uintValue_[0] = ui1;
-		uintValue_[1] = ui2;
-		uintValue_[2] = ui3;
+		if (uintValue_[0] != ui1 || uintValue_[1] != ui2 || uintValue_[2] != ui3)
+		{
+			uintValue_[0] = ui1;
+			uintValue_[1] = ui2;
+			uintValue_[2] = ui3;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform4ui(const math::uint4& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::UInt4);
-		uintValue_[0] = value.x;
-		uintValue_[1] = value.y;
-		uintValue_[2] = value.z;
-		uintValue_[3] = value.w;
+		if (uintValue_[0] != value.x || uintValue_[1] != value.y || uintValue_[2] != value.z || uintValue_[3] != value.w)
+		{
+			uintValue_[0] = value.x;
+			uintValue_[1] = value.y;
+			uintValue_[2] = value.z;
+			uintValue_[3] = value.w;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform4ui(std::uint32_t ui1, std::uint32_t ui2, std::uint32_t ui3, std::uint32_t ui4) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::UInt4);
-		uintValue_[0] = ui1;
-		uintValue_[1] = ui2;
-		uintValue_[2] = ui3;
-		uintValue_[3] = ui4;
+		if (uintValue_[0] != ui1 || uintValue_[1] != ui2 || uintValue_[2] != ui3 || uintValue_[3] != ui4)
+		{
+			uintValue_[0] = ui1;
+			uintValue_[1] = ui2;
+			uintValue_[2] = ui3;
+			uintValue_[3] = ui4;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform1f(float f1) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float);
-		floatValue_[0] = f1;
+		if (floatValue_[0] != f1)
+		{
+			floatValue_[0] = f1;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform2f(const math::float2& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float2);
-		floatValue_[0] = value.x;
-		floatValue_[1] = value.y;
+		if (floatValue_[0] != value.x || floatValue_[1] != value.y)
+		{
+			floatValue_[0] = value.x;
+			floatValue_[1] = value.y;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform2f(float f1, float f2) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float2);
-		floatValue_[0] = f1;
-		floatValue_[1] = f2;
+		if (floatValue_[0] != f1 || floatValue_[1] != f2)
+		{
+			floatValue_[0] = f1;
+			floatValue_[1] = f2;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform3f(const math::float3& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float3);
-		floatValue_[0] = value.x;
-		floatValue_[1] = value.y;
-		floatValue_[2] = value.z;
+		if (floatValue_[0] != value.x || floatValue_[1] != value.y || floatValue_[2] != value.z)
+		{
+			floatValue_[0] = value.x;
+			floatValue_[1] = value.y;
+			floatValue_[2] = value.z;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform3f(float f1, float f2, float f3) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float3);
-		floatValue_[0] = f1;
-		floatValue_[1] = f2;
-		floatValue_[2] = f3;
+		if (floatValue_[0] != f1 || floatValue_[1] != f2 || floatValue_[2] != f3)
+		{
+			floatValue_[0] = f1;
+			floatValue_[1] = f2;
+			floatValue_[2] = f3;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform4f(const math::float4& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float4);
-		floatValue_[0] = value.x;
-		floatValue_[1] = value.y;
-		floatValue_[2] = value.z;
-		floatValue_[3] = value.w;
+		if (floatValue_[0] != value.x || floatValue_[1] != value.y || floatValue_[2] != value.z || floatValue_[3] != value.w)
+		{
+			floatValue_[0] = value.x;
+			floatValue_[1] = value.y;
+			floatValue_[2] = value.z;
+			floatValue_[3] = value.w;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform4f(float f1, float f2, float f3, float f4) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float4);
-		floatValue_[0] = f1;
-		floatValue_[1] = f2;
-		floatValue_[2] = f3;
-		floatValue_[3] = f4;
+		if (floatValue_[0] != f1 || floatValue_[1] != f2 || floatValue_[2] != f3 || floatValue_[3] != f4)
+		{
+			floatValue_[0] = f1;
+			floatValue_[1] = f2;
+			floatValue_[2] = f3;
+			floatValue_[3] = f4;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform2fmat(const math::float2x2& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float2x2);
-		*m2Value_ = value;
+		if (*m2Value_ != value)
+		{
+			*m2Value_ = value;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform2fmat(const float mat2[]) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float2x2);
-		std::memcpy(m2Value_, mat2, sizeof(math::float2x2));
+		if (std::memcmp(m2Value_, mat2, sizeof(math::float2x2)) != 0)
+		{
+			std::memcpy(m2Value_, mat2, sizeof(math::float2x2));
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform3fmat(const math::float3x3& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float3x3);
-		*m3Value_ = value;
+		if (*m3Value_ != value)
+		{
+			*m3Value_ = value;
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform3fmat(const float mat3[]) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float3x3);
-		std::memcpy(m3Value_, mat3, sizeof(math::float3x3));
+		if (std::memcmp(m3Value_, mat3, sizeof(math::float3x3)) != 0)
+		{
+			std::memcpy(m3Value_, mat3, sizeof(math::float3x3));
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform4fmat(const math::float4x4& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float4x4);
-		*m4Value_ = value;
+		if (*m4Value_ != value)
+		{
+			*m4Value_ = value;
+			version_++;
+		}
 	}
 	void
 	UniformHolder::uniform4fmat(const float mat4[]) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float4x4);
-		std::memcpy(m4Value_, mat4, sizeof(math::float4x4));
+		if (std::memcmp(m4Value_, mat4, sizeof(math::float4x4)) != 0)
+		{
+			std::memcpy(m4Value_, mat4, sizeof(math::float4x4));
+			version_++;
+		}
 	}
 
 	void
 	UniformHolder::uniform1iv(const std::vector<math::int1>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::IntArray);
-		*iarray_ = value;
+		if (*iarray_ != value)
+		{
+			*iarray_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -355,13 +479,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::IntArray);
 		iarray_->resize(num);
 		std::memcpy(iarray_->data(), str, sizeof(math::int1) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform2iv(const std::vector<math::int2>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Int2Array);
-		*iarray2_ = value;
+		if (*iarray2_ != value)
+		{
+			*iarray2_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -370,13 +499,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::Int2Array);
 		iarray2_->resize(num);
 		std::memcpy(iarray2_->data(), str, sizeof(math::int2) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform3iv(const std::vector<math::int3>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Int3Array);
-		*iarray3_ = value;
+		if (*iarray3_ != value)
+		{
+			*iarray3_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -385,13 +519,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::Int2Array);
 		iarray3_->resize(num);
 		std::memcpy(iarray3_->data(), str, sizeof(math::int3) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform4iv(const std::vector<math::int4>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Int4Array);
-		*iarray4_ = value;
+		if (*iarray4_ != value)
+		{
+			*iarray4_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -400,13 +539,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::Int2Array);
 		iarray4_->resize(num);
 		std::memcpy(iarray4_->data(), str, sizeof(math::int4) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform1uiv(const std::vector<math::uint1>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::UIntArray);
-		*uiarray_ = value;
+		if (*uiarray_ != value)
+		{
+			*uiarray_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -415,13 +559,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::UIntArray);
 		uiarray_->resize(num);
 		std::memcpy(uiarray_->data(), str, sizeof(math::uint1) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform2uiv(const std::vector<math::uint2>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::UInt2Array);
-		*uiarray2_ = value;
+		if (*uiarray2_ != value)
+		{
+			*uiarray2_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -430,13 +579,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::UInt2Array);
 		uiarray2_->resize(num);
 		std::memcpy(uiarray2_->data(), str, sizeof(math::uint2) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform3uiv(const std::vector<math::uint3>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::UInt3Array);
-		*uiarray3_ = value;
+		if (*uiarray3_ != value)
+		{
+			*uiarray3_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -445,13 +599,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::UInt3Array);
 		uiarray3_->resize(num);
 		std::memcpy(uiarray3_->data(), str, sizeof(math::uint3) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform4uiv(const std::vector<math::uint4>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::UInt4Array);
-		*uiarray4_ = value;
+		if (*uiarray4_ != value)
+		{
+			*uiarray4_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -460,13 +619,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::UInt4Array);
 		uiarray4_->resize(num);
 		std::memcpy(uiarray4_->data(), str, sizeof(math::uint4) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform1fv(const std::vector<math::float1>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::FloatArray);
-		*farray_ = value;
+		if (*farray_ != value)
+		{
+			*farray_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -475,13 +639,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::FloatArray);
 		farray_->resize(num);
 		std::memcpy(farray_->data(), str, sizeof(math::float1) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform2fv(const std::vector<math::float2>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float2Array);
-		*farray2_ = value;
+		if (*farray2_ != value)
+		{
+			*farray2_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -490,13 +659,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::Float2Array);
 		farray2_->resize(num);
 		std::memcpy(farray2_->data(), str, sizeof(math::float2) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform3fv(const std::vector<math::float3>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float3Array);
-		*farray3_ = value;
+		if (*farray3_ != value)
+		{
+			*farray3_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -505,13 +679,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::Float3Array);
 		farray3_->resize(num);
 		std::memcpy(farray3_->data(), str, sizeof(math::float3) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform4fv(const std::vector<math::float4>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float4Array);
-		*farray4_ = value;
+		if (*farray4_ != value)
+		{
+			*farray4_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -520,13 +699,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::Float4Array);
 		farray4_->resize(num);
 		std::memcpy(farray4_->data(), str, sizeof(math::float4) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform2fmatv(const std::vector<math::float2x2>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float2x2Array);
-		*m2array_ = value;
+		if (*m2array_ != value)
+		{
+			*m2array_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -535,13 +719,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::Float4Array);
 		m2array_->resize(num);
 		std::memcpy(m2array_->data(), mat2, sizeof(math::float2x2) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform3fmatv(const std::vector<math::float3x3>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float3x3Array);
-		*m3array_ = value;
+		if (*m3array_ != value)
+		{
+			*m3array_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -550,13 +739,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::Float4Array);
 		m3array_->resize(num);
 		std::memcpy(m3array_->data(), mat3, sizeof(math::float3x3) * num);
+		version_++;
 	}
 
 	void
 	UniformHolder::uniform4fmatv(const std::vector<math::float4x4>& value) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::Float4x4Array);
-		*m4array_ = value;
+		if (*m4array_ != value)
+		{
+			*m4array_ = value;
+			version_++;
+		}
 	}
 
 	void
@@ -565,6 +759,7 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::Float4Array);
 		m4array_->resize(num);
 		std::memcpy(m4array_->data(), mat4, sizeof(math::float4x4) * num);
+		version_++;
 	}
 
 	void
@@ -573,13 +768,18 @@ namespace octoon
 		assert(type_ == UniformAttributeFormat::StorageImage || type_ == UniformAttributeFormat::CombinedImageSampler || type_ == UniformAttributeFormat::SamplerImage);
 		texture_->image = texture;
 		texture_->sampler = sampler;
+		version_++;
 	}
 
 	void
 	UniformHolder::uniformBuffer(GraphicsDataPtr ubo) noexcept
 	{
 		assert(type_ == UniformAttributeFormat::UniformBuffer);
-		*ubo_ = ubo;
+		if (*ubo_ != ubo)
+		{
+			*ubo_ = ubo;
+			version_++;
+		}
 	}
 
 	bool
@@ -0,0 +1,135 @@
+#include <octoon/io/mapped_file.h>
+
+#if defined(OCTOON_BUILD_PLATFORM_WINDOWS)
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+namespace octoon
+{
+	namespace io
+	{
+		MappedFile::MappedFile() noexcept
+			: data_(nullptr)
+			, size_(0)
+			, file_(nullptr)
+			, mapping_(nullptr)
+		{
+		}
+
+		MappedFile::MappedFile(const std::filesystem::path& path) noexcept
+			: MappedFile()
+		{
+			this->open(path);
+		}
+
+		MappedFile::~MappedFile() noexcept
+		{
+			this->close();
+		}
+
+		bool
+		MappedFile::open(const std::filesystem::path& path) noexcept
+		{
+			this->close();
+
+#if defined(OCTOON_BUILD_PLATFORM_WINDOWS)
+			auto file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+				return false;
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+			{
+				CloseHandle(file);
+				return false;
+			}
+
+			auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping)
+			{
+				CloseHandle(file);
+				return false;
+			}
+
+			auto data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (!data)
+			{
+				CloseHandle(mapping);
+				CloseHandle(file);
+				return false;
+			}
+
+			file_ = file;
+			mapping_ = mapping;
+			data_ = static_cast<const std::uint8_t*>(data);
+			size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+			int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+				return false;
+
+			struct stat st;
+			if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+			{
+				::close(fd);
+				return false;
+			}
+
+			auto data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+
+			if (data == MAP_FAILED)
+				return false;
+
+			::madvise(data, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+
+			data_ = static_cast<const std::uint8_t*>(data);
+			size_ = static_cast<std::size_t>(st.st_size);
+#endif
+			return true;
+		}
+
+		void
+		MappedFile::close() noexcept
+		{
+			if (!data_)
+				return;
+
+#if defined(OCTOON_BUILD_PLATFORM_WINDOWS)
+			UnmapViewOfFile(data_);
+			CloseHandle(mapping_);
+			CloseHandle(file_);
+#else
+			::munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+
+			data_ = nullptr;
+			size_ = 0;
+			file_ = nullptr;
+			mapping_ = nullptr;
+		}
+
+		bool
+		MappedFile::is_open() const noexcept
+		{
+			return data_ != nullptr;
+		}
+
+		const std::uint8_t*
+		MappedFile::data() const noexcept
+		{
+			return data_;
+		}
+
+		std::size_t
+		MappedFile::size() const noexcept
+		{
+			return size_;
+		}
+	}
+}
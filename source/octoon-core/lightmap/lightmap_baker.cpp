@@ -0,0 +1,728 @@
+#include <octoon/lightmap/lightmap_baker.h>
+#include <octoon/video/render_scene.h>
+#include <octoon/geometry/geometry.h>
+#include <octoon/light/ambient_light.h>
+#include <octoon/light/directional_light.h>
+#include <octoon/light/environment_light.h>
+#include <octoon/light/point_light.h>
+#include <octoon/light/spot_light.h>
+#include <octoon/material/mesh_basic_material.h>
+#include <octoon/material/mesh_standard_material.h>
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+
+namespace octoon::bake
+{
+	namespace
+	{
+		constexpr float Pi = 3.14159265358979323846f;
+		constexpr std::uint32_t InvalidIndex = 0xFFFFFFFF;
+
+		std::uint32_t hash(std::uint32_t v) noexcept
+		{
+			// PCG output permutation, see "Hash Functions for GPU Rendering" (Jarzynski, Olano)
+			std::uint32_t state = v * 747796405u + 2891336453u;
+			std::uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+			return (word >> 22u) ^ word;
+		}
+
+		struct Random
+		{
+			std::uint32_t state;
+
+			float next() noexcept
+			{
+				state = hash(state);
+				return (state >> 8) * (1.0f / 16777216.0f);
+			}
+		};
+
+		float radicalInverse2(std::uint32_t i) noexcept
+		{
+			i = (i << 16u) | (i >> 16u);
+			i = ((i & 0x55555555u) << 1u) | ((i & 0xAAAAAAAAu) >> 1u);
+			i = ((i & 0x33333333u) << 2u) | ((i & 0xCCCCCCCCu) >> 2u);
+			i = ((i & 0x0F0F0F0Fu) << 4u) | ((i & 0xF0F0F0F0u) >> 4u);
+			i = ((i & 0x00FF00FFu) << 8u) | ((i & 0xFF00FF00u) >> 8u);
+			return (i >> 8) * (1.0f / 16777216.0f);
+		}
+
+		float radicalInverse3(std::uint32_t i) noexcept
+		{
+			float result = 0.0f;
+			float digit = 1.0f / 3.0f;
+
+			for (; i > 0; i /= 3, digit /= 3.0f)
+				result += (i % 3) * digit;
+
+			return result;
+		}
+
+		float wrap(float x) noexcept
+		{
+			return x >= 1.0f ? x - 1.0f : x;
+		}
+
+		math::float3 sampleCosineHemisphere(const math::float3& n, float u1, float u2) noexcept
+		{
+			// Orthonormal basis from "Building an Orthonormal Basis, Revisited" (Duff et al.)
+			float sign = std::copysign(1.0f, n.z);
+			float a = -1.0f / (sign + n.z);
+			float b = n.x * n.y * a;
+
+			math::float3 t(1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x);
+			math::float3 s(b, sign + n.y * n.y * a, -n.y);
+
+			float r = std::sqrt(u1);
+			float phi = 2.0f * Pi * u2;
+			float z = std::sqrt(std::max(0.0f, 1.0f - u1));
+
+			return t * (r * std::cos(phi)) + s * (r * std::sin(phi)) + n * z;
+		}
+
+		float smoothstep(float edge0, float edge1, float x) noexcept
+		{
+			if (edge1 <= edge0)
+				return x >= edge1 ? 1.0f : 0.0f;
+
+			float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+			return t * t * (3.0f - 2.0f * t);
+		}
+	}
+
+	LightmapBaker::LightmapBaker(std::size_t numThreads) noexcept
+		: width_(512)
+		, height_(512)
+		, bounces_(3)
+		, tileSize_(32)
+		, dilation_(2)
+		, numSamples_(0)
+		, directLighting_(false)
+		, bias_(1e-4f)
+		, skyRadiance_(math::float3::Zero)
+		, cancel_(false)
+		, finishedTiles_(0)
+		, threadPool_(std::make_unique<ThreadPool>(numThreads))
+	{
+	}
+
+	LightmapBaker::~LightmapBaker() noexcept
+	{
+		this->cancel();
+	}
+
+	void
+	LightmapBaker::setResolution(std::uint32_t width, std::uint32_t height) noexcept
+	{
+		width_ = std::max(width, 1u);
+		height_ = std::max(height, 1u);
+	}
+
+	std::uint32_t
+	LightmapBaker::getWidth() const noexcept
+	{
+		return width_;
+	}
+
+	std::uint32_t
+	LightmapBaker::getHeight() const noexcept
+	{
+		return height_;
+	}
+
+	void
+	LightmapBaker::setNumBounces(std::uint32_t bounces) noexcept
+	{
+		bounces_ = bounces;
+	}
+
+	std::uint32_t
+	LightmapBaker::getNumBounces() const noexcept
+	{
+		return bounces_;
+	}
+
+	void
+	LightmapBaker::setTileSize(std::uint32_t size) noexcept
+	{
+		tileSize_ = std::max(size, 1u);
+	}
+
+	std::uint32_t
+	LightmapBaker::getTileSize() const noexcept
+	{
+		return tileSize_;
+	}
+
+	void
+	LightmapBaker::setDilation(std::uint32_t texels) noexcept
+	{
+		dilation_ = texels;
+	}
+
+	std::uint32_t
+	LightmapBaker::getDilation() const noexcept
+	{
+		return dilation_;
+	}
+
+	void
+	LightmapBaker::setDirectLighting(bool enable) noexcept
+	{
+		directLighting_ = enable;
+	}
+
+	bool
+	LightmapBaker::getDirectLighting() const noexcept
+	{
+		return directLighting_;
+	}
+
+	bool
+	LightmapBaker::setScene(const RenderScene& scene) noexcept(false)
+	{
+		this->clear();
+
+		for (auto& light : scene.getLights())
+		{
+			if (!light->getVisible())
+				continue;
+
+			auto radiance = light->getColor() * light->getIntensity();
+
+			// Image based lighting is approximated by a constant sky of the light's color
+			if (light->isA<EnvironmentLight>() || light->isA<AmbientLight>())
+			{
+				skyRadiance_ += radiance;
+			}
+			else if (light->isA<DirectionalLight>())
+			{
+				Light it;
+				it.type = Light::Directional;
+				it.radiance = radiance;
+				it.direction = math::normalize(-light->getForward());
+				it.range = 0.0f;
+				it.innerCos = it.outerCos = -1.0f;
+				lights_.push_back(it);
+			}
+			else if (light->isA<PointLight>() || light->isA<SpotLight>())
+			{
+				Light it;
+				it.type = Light::Point;
+				it.radiance = radiance;
+				it.position = light->getTranslate();
+				it.direction = math::normalize(-light->getForward());
+				it.range = light->getRange();
+				it.innerCos = it.outerCos = -1.0f;
+
+				if (light->isA<SpotLight>())
+				{
+					auto spot = light->downcast<SpotLight>();
+					it.type = Light::Spot;
+					it.innerCos = spot->getInnerCone().y;
+					it.outerCos = spot->getOuterCone().y;
+				}
+
+				lights_.push_back(it);
+			}
+		}
+
+		for (auto& geometry : scene.getGeometries())
+		{
+			if (!geometry->getVisible())
+				continue;
+
+			auto& mesh = geometry->getMesh();
+			if (!mesh || mesh->getVertexArray().empty())
+				continue;
+
+			if (geometry->getCastShadow())
+			{
+				auto& vertices = mesh->getVertexArray();
+				auto& transform = geometry->getTransform();
+				auto offset = static_cast<std::uint32_t>(vertices_.size());
+
+				for (auto& v : vertices)
+					vertices_.push_back(transform * v);
+
+				auto numSubsets = std::max<std::size_t>(mesh->getNumSubsets(), 1);
+
+				for (std::size_t i = 0; i < numSubsets; i++)
+				{
+					math::uint1s indices;
+
+					if (i < mesh->getNumSubsets())
+					{
+						indices = mesh->getIndicesArray(i);
+						for (auto& index : indices)
+							index = index < vertices.size() ? index + offset : InvalidIndex;
+					}
+					else
+					{
+						indices.resize(vertices.size() / 3 * 3);
+						for (std::size_t j = 0; j < indices.size(); j++)
+							indices[j] = offset + static_cast<std::uint32_t>(j);
+					}
+
+					Surface surface;
+					surface.albedo = math::float3(0.5f);
+					surface.emissive = math::float3::Zero;
+
+					auto& materials = geometry->getMaterials();
+					auto material = materials.empty() ? nullptr : materials[std::min(i, materials.size() - 1)].get();
+					if (material)
+					{
+						if (material->isA<MeshStandardMaterial>())
+						{
+							auto standard = material->downcast<MeshStandardMaterial>();
+							surface.albedo = standard->getColor() * (1.0f - std::clamp(standard->getMetalness(), 0.0f, 1.0f));
+							surface.emissive = standard->getEmissive() * standard->getEmissiveIntensity();
+						}
+						else if (material->isA<MeshBasicMaterial>())
+						{
+							surface.albedo = material->downcast<MeshBasicMaterial>()->getColor();
+						}
+					}
+
+					indices_.push_back(std::move(indices));
+					surfaces_.push_back(surface);
+				}
+			}
+
+			if (!mesh->getTexcoordArray(1).empty())
+			{
+				Lightmap lightmap;
+				lightmap.geometry = geometry;
+				lightmaps_.push_back(std::move(lightmap));
+			}
+		}
+
+		if (lightmaps_.empty())
+		{
+			this->clear();
+			return false;
+		}
+
+		bvh_.build(vertices_, indices_);
+
+		auto size = bvh_.empty() ? math::float3::Zero : bvh_.getBoundingBox().size();
+		bias_ = std::max(math::length(size) * 1e-5f, 1e-5f);
+
+		std::vector<Texel> image;
+
+		for (std::size_t i = 0; i < lightmaps_.size(); i++)
+		{
+			auto& lightmap = lightmaps_[i];
+
+			this->rasterize(*lightmap.geometry, image);
+
+			for (std::uint32_t y = 0; y < height_; y += tileSize_)
+			{
+				for (std::uint32_t x = 0; x < width_; x += tileSize_)
+				{
+					Tile tile;
+					tile.lightmap = static_cast<std::uint32_t>(i);
+					tile.begin = static_cast<std::uint32_t>(lightmap.texels.size());
+
+					for (std::uint32_t ty = y; ty < std::min(y + tileSize_, height_); ty++)
+					{
+						for (std::uint32_t tx = x; tx < std::min(x + tileSize_, width_); tx++)
+						{
+							auto& texel = image[ty * width_ + tx];
+							if (texel.pixel != InvalidIndex)
+								lightmap.texels.push_back(texel);
+						}
+					}
+
+					tile.end = static_cast<std::uint32_t>(lightmap.texels.size());
+					if (tile.begin != tile.end)
+						tiles_.push_back(tile);
+				}
+			}
+
+			lightmap.radiance.resize(lightmap.texels.size(), math::float3::Zero);
+			lightmap.samples.resize(lightmap.texels.size(), 0);
+		}
+
+		return true;
+	}
+
+	void
+	LightmapBaker::clear() noexcept
+	{
+		numSamples_ = 0;
+		skyRadiance_ = math::float3::Zero;
+		finishedTiles_ = 0;
+
+		bvh_.clear();
+		vertices_.clear();
+		indices_.clear();
+		surfaces_.clear();
+		lights_.clear();
+		lightmaps_.clear();
+		tiles_.clear();
+	}
+
+	void
+	LightmapBaker::rasterize(const Geometry& geometry, std::vector<Texel>& image) const noexcept
+	{
+		Texel empty;
+		empty.pixel = InvalidIndex;
+
+		image.assign(std::size_t(width_) * height_, empty);
+
+		auto& mesh = *geometry.getMesh();
+		auto& vertices = mesh.getVertexArray();
+		auto& normals = mesh.getNormalArray();
+		auto& texcoords = mesh.getTexcoordArray(1);
+		auto& transform = geometry.getTransform();
+		auto normalMatrix = (math::float3x3)transform;
+
+		bool hasNormals = normals.size() == vertices.size();
+		auto numSubsets = std::max<std::size_t>(mesh.getNumSubsets(), 1);
+
+		for (std::size_t subset = 0; subset < numSubsets; subset++)
+		{
+			auto numIndices = subset < mesh.getNumSubsets() ? mesh.getIndicesArray(subset).size() : vertices.size() / 3 * 3;
+
+			for (std::size_t i = 0; i + 2 < numIndices; i += 3)
+			{
+				std::uint32_t index[3];
+				for (std::size_t k = 0; k < 3; k++)
+					index[k] = subset < mesh.getNumSubsets() ? mesh.getIndicesArray(subset)[i + k] : static_cast<std::uint32_t>(i + k);
+
+				if (index[0] >= vertices.size() || index[1] >= vertices.size() || index[2] >= vertices.size())
+					continue;
+				if (index[0] >= texcoords.size() || index[1] >= texcoords.size() || index[2] >= texcoords.size())
+					continue;
+
+				math::float3 p[3];
+				math::float3 n[3];
+				math::float2 uv[3];
+
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					p[k] = transform * vertices[index[k]];
+					uv[k] = math::float2(texcoords[index[k]].x * width_, texcoords[index[k]].y * height_);
+				}
+
+				auto faceNormal = math::cross(p[1] - p[0], p[2] - p[0]);
+				if (math::length2(faceNormal) <= 0.0f)
+					continue;
+
+				faceNormal = math::normalize(faceNormal);
+
+				for (std::size_t k = 0; k < 3; k++)
+					n[k] = hasNormals ? normalMatrix * normals[index[k]] : faceNormal;
+
+				float area = math::cross(uv[1] - uv[0], uv[2] - uv[0]);
+				if (std::abs(area) < 1e-12f)
+					continue;
+
+				float invArea = 1.0f / area;
+
+				auto minX = std::max(0, static_cast<int>(std::floor(std::min({ uv[0].x, uv[1].x, uv[2].x }))));
+				auto minY = std::max(0, static_cast<int>(std::floor(std::min({ uv[0].y, uv[1].y, uv[2].y }))));
+				auto maxX = std::min(static_cast<int>(width_) - 1, static_cast<int>(std::ceil(std::max({ uv[0].x, uv[1].x, uv[2].x }))));
+				auto maxY = std::min(static_cast<int>(height_) - 1, static_cast<int>(std::ceil(std::max({ uv[0].y, uv[1].y, uv[2].y }))));
+
+				for (int y = minY; y <= maxY; y++)
+				{
+					for (int x = minX; x <= maxX; x++)
+					{
+						math::float2 center(x + 0.5f, y + 0.5f);
+
+						float w0 = math::cross(uv[2] - uv[1], center - uv[1]) * invArea;
+						float w1 = math::cross(uv[0] - uv[2], center - uv[2]) * invArea;
+						float w2 = 1.0f - w0 - w1;
+
+						if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+							continue;
+
+						auto normal = n[0] * w0 + n[1] * w1 + n[2] * w2;
+						if (math::length2(normal) <= 0.0f)
+							normal = faceNormal;
+
+						auto& texel = image[y * width_ + x];
+						texel.position = p[0] * w0 + p[1] * w1 + p[2] * w2;
+						texel.normal = math::normalize(normal);
+						texel.pixel = y * width_ + x;
+					}
+				}
+			}
+		}
+	}
+
+	math::float3
+	LightmapBaker::sampleDirect(const math::float3& position, const math::float3& normal) const noexcept
+	{
+		math::float3 irradiance = math::float3::Zero;
+
+		for (auto& light : lights_)
+		{
+			math::float3 direction = light.direction;
+			float distance = std::numeric_limits<float>::infinity();
+			float attenuation = 1.0f;
+
+			if (light.type != Light::Directional)
+			{
+				auto v = light.position - position;
+				distance = math::length(v);
+				if (distance <= 0.0f)
+					continue;
+
+				direction = v / distance;
+
+				// Same falloff as the forward renderer with physically correct lights
+				attenuation = 1.0f / std::max(distance * distance, 0.01f);
+				if (light.range > 0.0f)
+				{
+					float ratio = distance / light.range;
+					float window = std::clamp(1.0f - ratio * ratio * ratio * ratio, 0.0f, 1.0f);
+					attenuation *= window * window;
+				}
+
+				if (light.type == Light::Spot)
+					attenuation *= smoothstep(light.outerCos, light.innerCos, math::dot(direction, light.direction));
+			}
+
+			float cosTheta = math::dot(normal, direction);
+			if (cosTheta <= 0.0f || attenuation <= 0.0f)
+				continue;
+
+			math::Raycast ray(position + normal * bias_, direction);
+			ray.maxDistance = distance - bias_ * 2.0f;
+
+			MeshBVHHit hit;
+			if (!bvh_.raycast(ray, hit))
+				irradiance += light.radiance * (cosTheta * attenuation);
+		}
+
+		return irradiance;
+	}
+
+	math::float3
+	LightmapBaker::tracePath(const math::float3& position, const math::float3& normal, std::uint32_t texel, std::uint32_t sample) const noexcept
+	{
+		// The first bounce follows a Halton sequence, rotated per texel to decorrelate neighbours;
+		// deeper bounces are plain random.
+		Random random{ hash(texel ^ hash(sample)) };
+
+		std::uint32_t rotation = hash(texel);
+		float u1 = wrap(radicalInverse2(sample) + (rotation >> 16) * (1.0f / 65536.0f));
+		float u2 = wrap(radicalInverse3(sample) + (rotation & 0xFFFF) * (1.0f / 65536.0f));
+
+		math::float3 radiance = math::float3::Zero;
+		math::float3 throughput = math::float3::One;
+		math::float3 origin = position + normal * bias_;
+		math::float3 direction = sampleCosineHemisphere(normal, u1, u2);
+
+		for (std::uint32_t bounce = 0; bounce < bounces_; bounce++)
+		{
+			math::Raycast ray(origin, direction);
+
+			MeshBVHHit hit;
+			if (!bvh_.raycast(ray, hit))
+			{
+				radiance += throughput * skyRadiance_;
+				break;
+			}
+
+			auto& indices = indices_[hit.subset];
+			auto& v0 = vertices_[indices[hit.triangle * 3]];
+			auto& v1 = vertices_[indices[hit.triangle * 3 + 1]];
+			auto& v2 = vertices_[indices[hit.triangle * 3 + 2]];
+
+			auto hitNormal = math::normalize(math::cross(v1 - v0, v2 - v0));
+			if (math::dot(hitNormal, direction) > 0.0f)
+				hitNormal = -hitNormal;
+
+			auto hitPosition = ray.getPoint(hit.distance);
+			auto& surface = surfaces_[hit.subset];
+
+			radiance += throughput * surface.emissive;
+			throughput *= surface.albedo;
+
+			if (!lights_.empty())
+				radiance += throughput * this->sampleDirect(hitPosition, hitNormal) * (1.0f / Pi);
+
+			if (bounce + 1 >= bounces_)
+				break;
+
+			if (bounce >= 2)
+			{
+				float survive = std::min(std::max({ throughput.x, throughput.y, throughput.z }), 0.95f);
+				if (random.next() >= survive)
+					break;
+
+				throughput /= survive;
+			}
+
+			origin = hitPosition + hitNormal * bias_;
+			direction = sampleCosineHemisphere(hitNormal, random.next(), random.next());
+		}
+
+		return radiance;
+	}
+
+	void
+	LightmapBaker::bakeTile(const Tile& tile, std::uint32_t samples) noexcept
+	{
+		auto& lightmap = lightmaps_[tile.lightmap];
+		auto seed = hash(tile.lightmap);
+
+		for (std::uint32_t i = tile.begin; i < tile.end; i++)
+		{
+			if (cancel_.load(std::memory_order_relaxed))
+				return;
+
+			auto& texel = lightmap.texels[i];
+			auto radiance = math::float3::Zero;
+
+			for (std::uint32_t s = 0; s < samples; s++)
+				radiance += this->tracePath(texel.position, texel.normal, seed + i, lightmap.samples[i] + s);
+
+			if (directLighting_)
+				radiance += this->sampleDirect(texel.position, texel.normal) * (samples / Pi);
+
+			lightmap.radiance[i] += radiance;
+			lightmap.samples[i] += samples;
+		}
+
+		finishedTiles_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool
+	LightmapBaker::bake(std::uint32_t samples) noexcept
+	{
+		cancel_ = false;
+		finishedTiles_ = 0;
+
+		if (tiles_.empty() || samples == 0)
+			return true;
+
+		std::vector<std::future<void>> futures;
+		futures.reserve(tiles_.size());
+
+		for (auto& tile : tiles_)
+			futures.push_back(threadPool_->async([this, &tile, samples]() { this->bakeTile(tile, samples); }));
+
+		for (auto& future : futures)
+			future.wait();
+
+		if (cancel_)
+			return false;
+
+		numSamples_ += samples;
+		return true;
+	}
+
+	void
+	LightmapBaker::cancel() noexcept
+	{
+		cancel_ = true;
+	}
+
+	float
+	LightmapBaker::getProgress() const noexcept
+	{
+		return tiles_.empty() ? 1.0f : float(finishedTiles_.load()) / tiles_.size();
+	}
+
+	std::uint32_t
+	LightmapBaker::getNumSamples() const noexcept
+	{
+		return numSamples_;
+	}
+
+	std::size_t
+	LightmapBaker::getNumLightmaps() const noexcept
+	{
+		return lightmaps_.size();
+	}
+
+	const Geometry*
+	LightmapBaker::getGeometry(std::size_t n) const noexcept
+	{
+		return n < lightmaps_.size() ? lightmaps_[n].geometry : nullptr;
+	}
+
+	std::shared_ptr<Texture>
+	LightmapBaker::getLightmap(std::size_t n) const noexcept(false)
+	{
+		if (n >= lightmaps_.size())
+			return nullptr;
+
+		auto& lightmap = lightmaps_[n];
+
+		std::vector<math::float3> pixels(std::size_t(width_) * height_, math::float3::Zero);
+		std::vector<std::uint8_t> valid(pixels.size(), 0);
+
+		for (std::size_t i = 0; i < lightmap.texels.size(); i++)
+		{
+			if (lightmap.samples[i] > 0)
+			{
+				pixels[lightmap.texels[i].pixel] = lightmap.radiance[i] / float(lightmap.samples[i]);
+				valid[lightmap.texels[i].pixel] = 1;
+			}
+		}
+
+		for (std::uint32_t pass = 0; pass < dilation_; pass++)
+		{
+			auto mask = valid;
+
+			for (std::int32_t y = 0; y < static_cast<std::int32_t>(height_); y++)
+			{
+				for (std::int32_t x = 0; x < static_cast<std::int32_t>(width_); x++)
+				{
+					if (mask[y * width_ + x])
+						continue;
+
+					math::float3 sum = math::float3::Zero;
+					std::uint32_t count = 0;
+
+					for (std::int32_t dy = -1; dy <= 1; dy++)
+					{
+						for (std::int32_t dx = -1; dx <= 1; dx++)
+						{
+							auto sx = x + dx;
+							auto sy = y + dy;
+							if (sx < 0 || sy < 0 || sx >= static_cast<std::int32_t>(width_) || sy >= static_cast<std::int32_t>(height_))
+								continue;
+
+							if (mask[sy * width_ + sx])
+							{
+								sum += pixels[sy * width_ + sx];
+								count++;
+							}
+						}
+					}
+
+					if (count > 0)
+					{
+						pixels[y * width_ + x] = sum / float(count);
+						valid[y * width_ + x] = 1;
+					}
+				}
+			}
+		}
+
+		auto texture = std::make_shared<Texture>(Format::R32G32B32SFloat, width_, height_);
+		std::memcpy(texture->data(), pixels.data(), pixels.size() * sizeof(math::float3));
+		return texture;
+	}
+
+	std::shared_ptr<Texture>
+	LightmapBaker::getLightmap(const Geometry& geometry) const noexcept(false)
+	{
+		for (std::size_t i = 0; i < lightmaps_.size(); i++)
+		{
+			if (lightmaps_[i].geometry == &geometry)
+				return this->getLightmap(i);
+		}
+
+		return nullptr;
+	}
+}
@@ -51,6 +51,7 @@ namespace octoon
 		, _stencilBackZFail(StencilOp::Keep)
 		, _stencilBackPass(StencilOp::Keep)
 		, dirty_(true)
+		, version_(0)
 	{
 	}
 
@@ -594,6 +595,8 @@ namespace octoon
 	Material::setDirty(bool dirty) noexcept
 	{
 		this->dirty_ = dirty;
+		if (dirty)
+			this->version_++;
 	}
 
 	bool
@@ -602,6 +605,12 @@ namespace octoon
 		return this->dirty_;
 	}
 
+	std::size_t
+	Material::getVersion() const noexcept
+	{
+		return this->version_;
+	}
+
 	const std::vector<MaterialParam>&
 	Material::getMaterialParams() const noexcept
 	{
@@ -13,6 +13,7 @@ namespace octoon
 
 	Mesh::Mesh() noexcept
 		: dirty_(true)
+		, indicesVersion_(0)
 	{
 	}
 
@@ -72,6 +73,7 @@ namespace octoon
 	Mesh::setVertexArray(const float3s& array) noexcept
 	{
 		vertices_ = array;
+		bvh_.invalidate(false);
 	}
 
 	void
@@ -105,6 +107,8 @@ namespace octoon
 		if (triangles_.size() <= n)
 			triangles_.resize(n + 1);
 		triangles_[n] = array;
+		bvh_.invalidate(true);
+		indicesVersion_++;
 	}
 
 	void
@@ -119,10 +123,17 @@ namespace octoon
 		weights_ = array;
 	}
 
+	void
+	Mesh::setSkinningArray(const std::vector<VertexSkinning>& array) noexcept
+	{
+		skinnings_ = array;
+	}
+
 	void
 	Mesh::setVertexArray(float3s&& array) noexcept
 	{
 		vertices_ = std::move(array);
+		bvh_.invalidate(false);
 	}
 
 	void
@@ -156,6 +167,8 @@ namespace octoon
 		if (triangles_.size() <= n)
 			triangles_.resize(n + 1);
 		triangles_[n] = std::move(array);
+		bvh_.invalidate(true);
+		indicesVersion_++;
 	}
 
 	void
@@ -164,6 +177,12 @@ namespace octoon
 		weights_ = std::move(array);
 	}
 
+	void
+	Mesh::setSkinningArray(std::vector<VertexSkinning>&& array) noexcept
+	{
+		skinnings_ = std::move(array);
+	}
+
 	void
 	Mesh::setBindposes(float4x4s&& array) noexcept
 	{
@@ -207,6 +226,12 @@ namespace octoon
 		return weights_;
 	}
 
+	std::vector<VertexSkinning>&
+	Mesh::getSkinningArray() noexcept
+	{
+		return skinnings_;
+	}
+
 	uint1s&
 	Mesh::getIndicesArray(std::size_t n) noexcept
 	{
@@ -256,6 +281,12 @@ namespace octoon
 		return weights_;
 	}
 
+	const std::vector<VertexSkinning>&
+	Mesh::getSkinningArray() const noexcept
+	{
+		return skinnings_;
+	}
+
 	const float4x4s&
 	Mesh::getBindposes() const noexcept
 	{
@@ -286,6 +317,8 @@ namespace octoon
 	Mesh::setDirty(bool dirty) noexcept
 	{
 		this->dirty_ = dirty;
+		if (dirty)
+			bvh_.invalidate(false);
 	}
 
 	bool
@@ -294,32 +327,25 @@ namespace octoon
 		return this->dirty_;
 	}
 
+	std::size_t
+	Mesh::getIndicesVersion() const noexcept
+	{
+		return this->indicesVersion_;
+	}
+
 	bool
 	Mesh::raycast(const math::Raycast& ray, MeshHit& hit) noexcept
 	{
-		for (std::size_t i = 0; i < this->getNumSubsets(); i++)
-		{
-			if (math::intersect(ray, this->getBoundingBox(i).box()))
-			{
-				auto& indices = this->triangles_[i];
+		bvh_.update(vertices_, triangles_);
 
-				for (std::size_t j = 0; j < indices.size(); j += 3)
-				{
-					auto& v0 = this->vertices_[indices[j]];
-					auto& v1 = this->vertices_[indices[j+1]];
-					auto& v2 = this->vertices_[indices[j+2]];
-
-					if (math::intersect(ray, math::Triangle(v0, v1, v2), hit.point, hit.distance))
-					{
-						if (hit.distance > 0 && hit.distance < ray.maxDistance)
-						{
-							hit.mesh = i;
-							hit.object = this;
-							return true;
-						}
-					}
-				}
-			}
+		MeshBVHHit result;
+		if (bvh_.raycast(ray, result))
+		{
+			hit.object = this;
+			hit.mesh = result.subset;
+			hit.distance = result.distance;
+			hit.point = ray.getPoint(result.distance);
+			return true;
 		}
 
 		return false;
@@ -328,65 +354,24 @@ namespace octoon
 	bool
 	Mesh::raycastAll(const math::Raycast& ray, std::vector<MeshHit>& hits) noexcept
 	{
-		if (!math::intersect(ray, this->getBoundingBoxAll().sphere()))
+		bvh_.update(vertices_, triangles_);
+
+		std::vector<MeshBVHHit> results;
+		if (!bvh_.raycastAll(ray, results))
 			return false;
 
-		if (this->triangles_.empty())
+		for (auto& it : results)
 		{
-			for (std::size_t i = 0; i < vertices_.size(); i += 3)
-			{
-				auto& v0 = vertices_[i];
-				auto& v1 = vertices_[i + 1];
-				auto& v2 = vertices_[i + 2];
-
-				MeshHit hit;
-				if (math::intersect(ray, math::Triangle(v0, v1, v2), hit.point, hit.distance))
-				{
-					if (hit.distance > 0 && hit.distance < ray.maxDistance)
-					{
-						hit.mesh = 0;
-						hit.object = this;
+			MeshHit hit;
+			hit.object = this;
+			hit.mesh = it.subset;
+			hit.distance = it.distance;
+			hit.point = ray.getPoint(it.distance);
 
-						hits.emplace_back(hit);
-					}
-				}
-			}
-		}
-		else
-		{
-			for (std::size_t i = 0; i < this->getNumSubsets(); i++)
-			{
-				if (math::intersect(ray, this->getBoundingBox(i).sphere()))
-				{
-					auto& indices = triangles_[i];
-
-					for (std::size_t j = 0; j < triangles_[i].size(); j += 3)
-					{
-						std::size_t f1 = indices[j];
-						std::size_t f2 = indices[j + 1];
-						std::size_t f3 = indices[j + 2];
-
-						auto& v0 = vertices_[f1];
-						auto& v1 = vertices_[f2];
-						auto& v2 = vertices_[f3];
-
-						MeshHit hit;
-						if (math::intersect(ray, math::Triangle(v0, v1, v2), hit.point, hit.distance))
-						{
-							if (hit.distance > 0 && hit.distance < ray.maxDistance)
-							{
-								hit.mesh = i;
-								hit.object = this;
-
-								hits.emplace_back(hit);
-							}
-						}
-					}
-				}
-			}
+			hits.emplace_back(hit);
 		}
 
-		return !hits.empty();
+		return true;
 	}
 
 	void
@@ -413,6 +398,7 @@ namespace octoon
 		mesh->setNormalArray(this->getNormalArray());
 		mesh->setColorArray(this->getColorArray());
 		mesh->setWeightArray(this->getWeightArray());
+		mesh->setSkinningArray(this->getSkinningArray());
 		mesh->setTangentArray(this->getTangentArray());
 		mesh->setBindposes(this->getBindposes());
 		mesh->boundingBox_ = this->boundingBox_;
@@ -455,9 +441,22 @@ namespace octoon
 		triangles_.insert(triangles_.end(), mesh.triangles_.begin(), mesh.triangles_.end());
 		weights_.insert(weights_.end(), mesh.weights_.begin(), mesh.weights_.end());
 
+		if (!skinnings_.empty() || !mesh.skinnings_.empty())
+		{
+			VertexSkinning linear{ SkinningType::Linear };
+			skinnings_.resize(vertices_.size() - mesh.vertices_.size(), linear);
+			if (mesh.skinnings_.empty())
+				skinnings_.resize(vertices_.size(), linear);
+			else
+				skinnings_.insert(skinnings_.end(), mesh.skinnings_.begin(), mesh.skinnings_.end());
+		}
+
 		for (std::size_t i = 0; i < TEXTURE_ARRAY_COUNT; i++)
 			texcoords_[i].insert(texcoords_[i].end(), mesh.texcoords_[i].begin(), mesh.texcoords_[i].end());
 
+		bvh_.invalidate(true);
+		indicesVersion_++;
+
 		return true;
 	}
 
@@ -553,6 +552,9 @@ namespace octoon
 
 		this->computeBoundingBox();
 
+		bvh_.invalidate(true);
+		indicesVersion_++;
+
 		return true;
 	}
 
@@ -605,6 +607,9 @@ namespace octoon
 
 		vertices_.swap(changeVertex);
 		normals_.swap(changeNormal);
+
+		bvh_.invalidate(true);
+		indicesVersion_++;
 	}
 
 	void
@@ -0,0 +1,1025 @@
+#include <octoon/mesh/mesh_bvh.h>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#	include <emmintrin.h>
+#endif
+
+namespace octoon
+{
+	namespace
+	{
+		constexpr std::int64_t ParallelThreshold = 4096;
+
+		constexpr std::size_t MaxLeafSize = 8;
+		constexpr std::size_t MaxDepth = 64;
+		constexpr std::size_t StackSize = 256;
+		constexpr std::size_t NumBins = 16;
+
+		// Cost of visiting a node relative to one triangle test.
+		constexpr float TraversalCost = 1.0f;
+
+		constexpr std::uint32_t InvalidId = 0xFFFFFFFF;
+
+		struct Bounds
+		{
+			math::float3 min;
+			math::float3 max;
+
+			Bounds() noexcept
+				: min(std::numeric_limits<float>::max())
+				, max(-std::numeric_limits<float>::max())
+			{
+			}
+
+			void grow(const math::float3& p) noexcept
+			{
+				min = math::min(min, p);
+				max = math::max(max, p);
+			}
+
+			void grow(const Bounds& bounds) noexcept
+			{
+				min = math::min(min, bounds.min);
+				max = math::max(max, bounds.max);
+			}
+
+			float area() const noexcept
+			{
+				auto d = max - min;
+				if (d.x < 0.0f || d.y < 0.0f || d.z < 0.0f)
+					return 0.0f;
+				return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+			}
+		};
+
+		struct StackEntry
+		{
+			std::uint32_t node;
+			float distance;
+		};
+
+		struct TraversalRay
+		{
+			float origin[3];
+			float direction[3];
+			float invDirection[3];
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+			__m128 origin4[3];
+			__m128 direction4[3];
+			__m128 invDirection4[3];
+#endif
+
+			explicit TraversalRay(const math::Raycast& ray) noexcept
+			{
+				for (std::uint8_t i = 0; i < 3; i++)
+				{
+					// A tiny direction instead of zero keeps the slab distances free of 0 * inf.
+					auto d = ray.normal[i];
+					if (std::abs(d) < 1e-20f)
+						d = d < 0.0f ? -1e-20f : 1e-20f;
+
+					origin[i] = ray.origin[i];
+					direction[i] = ray.normal[i];
+					invDirection[i] = 1.0f / d;
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+					origin4[i] = _mm_set1_ps(origin[i]);
+					direction4[i] = _mm_set1_ps(direction[i]);
+					invDirection4[i] = _mm_set1_ps(invDirection[i]);
+#endif
+				}
+			}
+		};
+
+		// Slab test of the ray against the four boxes of a node, laid out as minX, minY, minZ, maxX,
+		// maxY, maxZ with four lanes each. Returns the mask of boxes entered before maxDistance.
+		inline int intersectBoxes(const float* bounds, const TraversalRay& ray, float maxDistance, float* distances) noexcept
+		{
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+			auto t0x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bounds + 0), ray.origin4[0]), ray.invDirection4[0]);
+			auto t0y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bounds + 4), ray.origin4[1]), ray.invDirection4[1]);
+			auto t0z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bounds + 8), ray.origin4[2]), ray.invDirection4[2]);
+			auto t1x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bounds + 12), ray.origin4[0]), ray.invDirection4[0]);
+			auto t1y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bounds + 16), ray.origin4[1]), ray.invDirection4[1]);
+			auto t1z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bounds + 20), ray.origin4[2]), ray.invDirection4[2]);
+
+			auto tmin = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)), _mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+			auto tmax = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)), _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_set1_ps(maxDistance)));
+
+			_mm_store_ps(distances, tmin);
+
+			return _mm_movemask_ps(_mm_cmple_ps(tmin, tmax));
+#else
+			int mask = 0;
+
+			for (std::uint8_t lane = 0; lane < 4; lane++)
+			{
+				float tmin = 0.0f;
+				float tmax = maxDistance;
+
+				for (std::uint8_t i = 0; i < 3; i++)
+				{
+					auto t0 = (bounds[i * 4 + lane] - ray.origin[i]) * ray.invDirection[i];
+					auto t1 = (bounds[12 + i * 4 + lane] - ray.origin[i]) * ray.invDirection[i];
+					tmin = std::max(tmin, std::min(t0, t1));
+					tmax = std::min(tmax, std::max(t0, t1));
+				}
+
+				distances[lane] = tmin;
+
+				if (tmin <= tmax)
+					mask |= 1 << lane;
+			}
+
+			return mask;
+#endif
+		}
+
+		// Two-sided Moller-Trumbore test against a packet of four triangles, laid out as v0, e1 and
+		// e2 with three components of four lanes each. Padding lanes have zero edges and never hit.
+		inline int intersectTriangles(const float* packet, const TraversalRay& ray, float maxDistance, float* distances) noexcept
+		{
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+			auto e1x = _mm_load_ps(packet + 12);
+			auto e1y = _mm_load_ps(packet + 16);
+			auto e1z = _mm_load_ps(packet + 20);
+			auto e2x = _mm_load_ps(packet + 24);
+			auto e2y = _mm_load_ps(packet + 28);
+			auto e2z = _mm_load_ps(packet + 32);
+
+			auto& d = ray.direction4;
+
+			auto px = _mm_sub_ps(_mm_mul_ps(d[1], e2z), _mm_mul_ps(d[2], e2y));
+			auto py = _mm_sub_ps(_mm_mul_ps(d[2], e2x), _mm_mul_ps(d[0], e2z));
+			auto pz = _mm_sub_ps(_mm_mul_ps(d[0], e2y), _mm_mul_ps(d[1], e2x));
+
+			auto det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+			auto invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+			auto sx = _mm_sub_ps(ray.origin4[0], _mm_load_ps(packet + 0));
+			auto sy = _mm_sub_ps(ray.origin4[1], _mm_load_ps(packet + 4));
+			auto sz = _mm_sub_ps(ray.origin4[2], _mm_load_ps(packet + 8));
+
+			auto u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+
+			auto qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+			auto qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+			auto qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+
+			auto v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], qx), _mm_mul_ps(d[1], qy)), _mm_mul_ps(d[2], qz)), invDet);
+			auto t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+			auto zero = _mm_setzero_ps();
+			auto mask = _mm_and_ps(_mm_cmpneq_ps(det, zero), _mm_cmpge_ps(u, zero));
+			mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+			mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+			mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, zero));
+			mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(maxDistance)));
+
+			_mm_store_ps(distances, t);
+
+			return _mm_movemask_ps(mask);
+#else
+			int mask = 0;
+
+			for (std::uint8_t lane = 0; lane < 4; lane++)
+			{
+				float v0[3], e1[3], e2[3];
+				for (std::uint8_t i = 0; i < 3; i++)
+				{
+					v0[i] = packet[i * 4 + lane];
+					e1[i] = packet[12 + i * 4 + lane];
+					e2[i] = packet[24 + i * 4 + lane];
+				}
+
+				auto& d = ray.direction;
+
+				float p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+				float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+				if (det == 0.0f)
+					continue;
+
+				float invDet = 1.0f / det;
+				float s[3] = { ray.origin[0] - v0[0], ray.origin[1] - v0[1], ray.origin[2] - v0[2] };
+				float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * invDet;
+
+				float q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+				float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * invDet;
+				float t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * invDet;
+
+				distances[lane] = t;
+
+				if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t > 0.0f && t < maxDistance)
+					mask |= 1 << lane;
+			}
+
+			return mask;
+#endif
+		}
+	}
+
+	class MeshBVHBuilder final
+	{
+	public:
+		MeshBVHBuilder(MeshBVH& bvh, const math::float3s& vertices) noexcept
+			: bvh_(bvh)
+			, vertices_(vertices)
+		{
+		}
+
+		void build() noexcept
+		{
+			auto& indices = bvh_.indices_;
+			auto numTriangles = static_cast<std::int64_t>(indices.size() / 3);
+			auto numVertices = vertices_.size();
+
+			std::vector<Prim> prims(numTriangles);
+
+#			pragma omp parallel for schedule(static) if(numTriangles >= ParallelThreshold)
+			for (std::int64_t i = 0; i < numTriangles; i++)
+			{
+				auto& prim = prims[i];
+				prim.id = InvalidId;
+
+				if (indices[i * 3] < numVertices && indices[i * 3 + 1] < numVertices && indices[i * 3 + 2] < numVertices)
+				{
+					for (std::size_t j = 0; j < 3; j++)
+						prim.bounds.grow(vertices_[indices[i * 3 + j]]);
+
+					prim.centroid = (prim.bounds.min + prim.bounds.max) * 0.5f;
+					prim.id = static_cast<std::uint32_t>(i);
+				}
+			}
+
+			// Triangles referencing missing vertices are left out of the tree.
+			prims_.reserve(numTriangles);
+			for (auto& prim : prims)
+			{
+				if (prim.id != InvalidId)
+					prims_.push_back(prim);
+			}
+
+			if (!prims_.empty())
+			{
+				Range root;
+				root.begin = 0;
+				root.end = prims_.size();
+				root.leaf = false;
+				this->computeBounds(root);
+
+				bvh_.nodes_.reserve(prims_.size() / 4 + 1);
+				bvh_.packets_.reserve(prims_.size() / 3 + 1);
+				this->buildNode(&root, 1, 0);
+			}
+		}
+
+	private:
+		struct Prim
+		{
+			Bounds bounds;
+			math::float3 centroid;
+			std::uint32_t id;
+		};
+
+		struct Range
+		{
+			std::size_t begin;
+			std::size_t end;
+			Bounds bounds;
+			bool leaf;
+
+			std::size_t count() const noexcept { return end - begin; }
+		};
+
+		struct Bin
+		{
+			Bounds bounds;
+			std::size_t count = 0;
+		};
+
+		void computeBounds(Range& range) const noexcept
+		{
+			range.bounds = Bounds();
+			for (std::size_t i = range.begin; i < range.end; i++)
+				range.bounds.grow(prims_[i].bounds);
+		}
+
+		// Binned SAH split of a range, all three axes binned in one pass over the triangles.
+		// Returns false if the range is cheaper as a leaf.
+		bool split(const Range& range, Range& left, Range& right, std::size_t depth) noexcept
+		{
+			// A single packet tests four triangles at the cost of one, so it is never worth splitting.
+			auto count = range.count();
+			if (count <= 4)
+				return false;
+
+			Bounds centroidBounds;
+			for (std::size_t i = range.begin; i < range.end; i++)
+				centroidBounds.grow(prims_[i].centroid);
+
+			int bestAxis = -1;
+			std::size_t bestBin = 0;
+			float bestCost = std::numeric_limits<float>::max();
+
+			// Small ranges get fewer bins, there is nothing to gain from more bins than triangles.
+			auto numBins = std::min(NumBins, count);
+
+			Bin bins[3][NumBins];
+			float scale[3];
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				auto extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+				scale[axis] = extent > 0.0f ? numBins / extent : 0.0f;
+			}
+
+			if (depth < MaxDepth)
+			{
+				if (count >= static_cast<std::size_t>(ParallelThreshold) * 16)
+				{
+#					pragma omp parallel
+					{
+						Bin local[3][NumBins];
+
+#						pragma omp for schedule(static) nowait
+						for (std::int64_t i = range.begin; i < static_cast<std::int64_t>(range.end); i++)
+							this->binPrim(prims_[i], centroidBounds, scale, numBins, local);
+
+#						pragma omp critical
+						{
+							for (int axis = 0; axis < 3; axis++)
+							{
+								for (std::size_t i = 0; i < numBins; i++)
+								{
+									bins[axis][i].bounds.grow(local[axis][i].bounds);
+									bins[axis][i].count += local[axis][i].count;
+								}
+							}
+						}
+					}
+				}
+				else
+				{
+					for (std::size_t i = range.begin; i < range.end; i++)
+						this->binPrim(prims_[i], centroidBounds, scale, numBins, bins);
+				}
+
+				for (int axis = 0; axis < 3; axis++)
+				{
+					if (scale[axis] == 0.0f)
+						continue;
+
+					float rightArea[NumBins];
+					std::size_t rightCount[NumBins];
+
+					Bounds accum;
+					std::size_t accumCount = 0;
+
+					for (std::size_t i = numBins - 1; i > 0; i--)
+					{
+						accum.grow(bins[axis][i].bounds);
+						accumCount += bins[axis][i].count;
+						rightArea[i] = accum.area();
+						rightCount[i] = accumCount;
+					}
+
+					accum = Bounds();
+					accumCount = 0;
+
+					for (std::size_t i = 0; i < numBins - 1; i++)
+					{
+						accum.grow(bins[axis][i].bounds);
+						accumCount += bins[axis][i].count;
+
+						if (accumCount == 0 || rightCount[i + 1] == 0)
+							continue;
+
+						auto cost = accum.area() * accumCount + rightArea[i + 1] * rightCount[i + 1];
+						if (cost < bestCost)
+						{
+							bestCost = cost;
+							bestAxis = axis;
+							bestBin = i;
+						}
+					}
+				}
+			}
+
+			if (bestAxis >= 0)
+			{
+				auto area = range.bounds.area();
+				auto cost = area > 0.0f ? TraversalCost + bestCost / area : TraversalCost;
+				if (count <= MaxLeafSize && cost >= count)
+					return false;
+
+				auto axis = bestAxis;
+				auto min = centroidBounds.min[axis];
+
+				auto it = std::partition(prims_.begin() + range.begin, prims_.begin() + range.end, [&](const Prim& prim)
+				{
+					return this->binIndex(prim.centroid[axis], min, scale[axis], numBins) <= bestBin;
+				});
+
+				left.begin = range.begin;
+				left.end = it - prims_.begin();
+				right.begin = left.end;
+				right.end = range.end;
+
+				left.bounds = Bounds();
+				right.bounds = Bounds();
+
+				for (std::size_t i = 0; i < numBins; i++)
+				{
+					if (i <= bestBin)
+						left.bounds.grow(bins[axis][i].bounds);
+					else
+						right.bounds.grow(bins[axis][i].bounds);
+				}
+			}
+			else
+			{
+				// All centroids coincide or the tree got too deep: split in half without sorting.
+				if (count <= MaxLeafSize)
+					return false;
+
+				left.begin = range.begin;
+				left.end = range.begin + count / 2;
+				right.begin = left.end;
+				right.end = range.end;
+
+				this->computeBounds(left);
+				this->computeBounds(right);
+			}
+
+			left.leaf = false;
+			right.leaf = false;
+
+			return true;
+		}
+
+		void binPrim(const Prim& prim, const Bounds& centroidBounds, const float scale[3], std::size_t numBins, Bin (&bins)[3][NumBins]) const noexcept
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				auto& bin = bins[axis][this->binIndex(prim.centroid[axis], centroidBounds.min[axis], scale[axis], numBins)];
+				bin.bounds.grow(prim.bounds);
+				bin.count++;
+			}
+		}
+
+		std::size_t binIndex(float centroid, float min, float scale, std::size_t numBins) const noexcept
+		{
+			auto f = (centroid - min) * scale;
+			return f > 0.0f ? std::min(static_cast<std::size_t>(static_cast<std::int32_t>(f)), numBins - 1) : 0;
+		}
+
+		// Opens the largest child until the node holds four children or nothing is left to split.
+		std::uint32_t buildNode(const Range* initial, std::size_t numInitial, std::size_t depth) noexcept
+		{
+			Range ranges[4];
+			std::size_t numRanges = numInitial;
+
+			for (std::size_t i = 0; i < numInitial; i++)
+				ranges[i] = initial[i];
+
+			while (numRanges < 4)
+			{
+				std::size_t best = numRanges;
+				float bestArea = -1.0f;
+
+				for (std::size_t i = 0; i < numRanges; i++)
+				{
+					if (!ranges[i].leaf && ranges[i].bounds.area() > bestArea)
+					{
+						best = i;
+						bestArea = ranges[i].bounds.area();
+					}
+				}
+
+				if (best == numRanges)
+					break;
+
+				Range left, right;
+				if (this->split(ranges[best], left, right, depth))
+				{
+					ranges[best] = left;
+					ranges[numRanges++] = right;
+				}
+				else
+				{
+					ranges[best].leaf = true;
+				}
+			}
+
+			auto index = static_cast<std::uint32_t>(bvh_.nodes_.size());
+			bvh_.nodes_.emplace_back();
+
+			auto& node = bvh_.nodes_[index];
+			std::memset(&node, 0, sizeof(node));
+			node.numChildren = static_cast<std::uint32_t>(numRanges);
+
+			for (std::size_t i = 0; i < numRanges; i++)
+			{
+				auto& range = ranges[i];
+
+				node.minX[i] = range.bounds.min.x;
+				node.minY[i] = range.bounds.min.y;
+				node.minZ[i] = range.bounds.min.z;
+				node.maxX[i] = range.bounds.max.x;
+				node.maxY[i] = range.bounds.max.y;
+				node.maxZ[i] = range.bounds.max.z;
+			}
+
+			for (std::size_t i = 0; i < numRanges; i++)
+			{
+				auto& range = ranges[i];
+
+				Range children[2];
+				if (!range.leaf && range.count() <= MaxLeafSize && !this->split(range, children[0], children[1], depth + 1))
+					range.leaf = true;
+
+				if (range.leaf)
+				{
+					auto first = static_cast<std::uint32_t>(bvh_.packets_.size());
+
+					for (std::size_t j = range.begin; j < range.end; j += 4)
+					{
+						MeshBVH::TrianglePacket packet;
+
+						for (std::size_t lane = 0; lane < 4; lane++)
+							bvh_.setPacket(packet, lane, vertices_, j + lane < range.end ? prims_[j + lane].id : InvalidId);
+
+						bvh_.packets_.push_back(packet);
+					}
+
+					bvh_.nodes_[index].child[i] = first;
+					bvh_.nodes_[index].count[i] = static_cast<std::uint32_t>(bvh_.packets_.size()) - first;
+				}
+				else
+				{
+					std::uint32_t child;
+					if (range.count() <= MaxLeafSize)
+						child = this->buildNode(children, 2, depth + 1);
+					else
+						child = this->buildNode(&range, 1, depth + 1);
+
+					bvh_.nodes_[index].child[i] = child;
+					bvh_.nodes_[index].count[i] = 0;
+				}
+			}
+
+			return index;
+		}
+
+	private:
+		MeshBVH& bvh_;
+		const math::float3s& vertices_;
+
+		std::vector<Prim> prims_;
+	};
+
+	MeshBVH::MeshBVH() noexcept
+		: state_(Rebuild)
+	{
+	}
+
+	MeshBVH::MeshBVH(const MeshBVH& bvh) noexcept
+		: nodes_(bvh.nodes_)
+		, packets_(bvh.packets_)
+		, indices_(bvh.indices_)
+		, offsets_(bvh.offsets_)
+		, state_(bvh.state_.load())
+	{
+	}
+
+	MeshBVH::MeshBVH(MeshBVH&& bvh) noexcept
+		: nodes_(std::move(bvh.nodes_))
+		, packets_(std::move(bvh.packets_))
+		, indices_(std::move(bvh.indices_))
+		, offsets_(std::move(bvh.offsets_))
+		, state_(bvh.state_.exchange(Rebuild))
+	{
+	}
+
+	MeshBVH::~MeshBVH() noexcept
+	{
+	}
+
+	void
+	MeshBVH::build(const math::float3s& vertices, const std::vector<math::uint1s>& indices) noexcept
+	{
+		this->clear();
+
+		offsets_.push_back(0);
+
+		if (indices.empty())
+		{
+			auto numTriangles = vertices.size() / 3;
+
+			indices_.resize(numTriangles * 3);
+			for (std::size_t i = 0; i < indices_.size(); i++)
+				indices_[i] = static_cast<std::uint32_t>(i);
+
+			offsets_.push_back(numTriangles);
+		}
+		else
+		{
+			for (auto& it : indices)
+			{
+				indices_.insert(indices_.end(), it.begin(), it.begin() + it.size() / 3 * 3);
+				offsets_.push_back(indices_.size() / 3);
+			}
+		}
+
+		MeshBVHBuilder(*this, vertices).build();
+
+		state_.store(Valid, std::memory_order_release);
+	}
+
+	bool
+	MeshBVH::refit(const math::float3s& vertices, const std::vector<math::uint1s>& indices) noexcept
+	{
+		if (offsets_.empty())
+			return false;
+
+		if (indices.empty())
+		{
+			if (offsets_.size() != 2 || offsets_[1] != vertices.size() / 3)
+				return false;
+		}
+		else
+		{
+			if (offsets_.size() != indices.size() + 1)
+				return false;
+
+			for (std::size_t i = 0; i < indices.size(); i++)
+			{
+				auto first = offsets_[i] * 3;
+				auto count = (offsets_[i + 1] - offsets_[i]) * 3;
+
+				if (indices[i].size() / 3 * 3 != count)
+					return false;
+
+				if (!std::equal(indices[i].begin(), indices[i].begin() + count, indices_.begin() + first))
+					return false;
+			}
+
+			if (!indices_.empty() && *std::max_element(indices_.begin(), indices_.end()) >= vertices.size())
+				return false;
+		}
+
+		auto numPackets = static_cast<std::int64_t>(packets_.size());
+
+#		pragma omp parallel for schedule(static) if(numPackets >= ParallelThreshold / 4)
+		for (std::int64_t i = 0; i < numPackets; i++)
+		{
+			auto& packet = packets_[i];
+			for (std::size_t lane = 0; lane < 4; lane++)
+				this->setPacket(packet, lane, vertices, packet.id[lane]);
+		}
+
+		this->refitNodes(vertices);
+
+		state_.store(Valid, std::memory_order_release);
+
+		return true;
+	}
+
+	void
+	MeshBVH::invalidate(bool rebuild) noexcept
+	{
+		if (rebuild)
+		{
+			state_.store(Rebuild, std::memory_order_release);
+		}
+		else
+		{
+			std::uint8_t expected = Valid;
+			state_.compare_exchange_strong(expected, Refit, std::memory_order_acq_rel);
+		}
+	}
+
+	void
+	MeshBVH::update(const math::float3s& vertices, const std::vector<math::uint1s>& indices) noexcept
+	{
+		if (state_.load(std::memory_order_acquire) == Valid)
+			return;
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		auto state = state_.load(std::memory_order_acquire);
+		if (state == Refit)
+		{
+			if (!this->refit(vertices, indices))
+				this->build(vertices, indices);
+		}
+		else if (state == Rebuild)
+		{
+			this->build(vertices, indices);
+		}
+	}
+
+	void
+	MeshBVH::clear() noexcept
+	{
+		nodes_.clear();
+		packets_.clear();
+		indices_.clear();
+		offsets_.clear();
+	}
+
+	bool
+	MeshBVH::empty() const noexcept
+	{
+		return nodes_.empty();
+	}
+
+	std::size_t
+	MeshBVH::getNumNodes() const noexcept
+	{
+		return nodes_.size();
+	}
+
+	std::size_t
+	MeshBVH::getNumTriangles() const noexcept
+	{
+		return indices_.size() / 3;
+	}
+
+	math::AABB
+	MeshBVH::getBoundingBox() const noexcept
+	{
+		math::AABB aabb;
+
+		if (!nodes_.empty())
+		{
+			auto& root = nodes_.front();
+
+			for (std::size_t i = 0; i < root.numChildren; i++)
+			{
+				aabb.encapsulate(math::float3(root.minX[i], root.minY[i], root.minZ[i]));
+				aabb.encapsulate(math::float3(root.maxX[i], root.maxY[i], root.maxZ[i]));
+			}
+		}
+
+		return aabb;
+	}
+
+	bool
+	MeshBVH::raycast(const math::Raycast& ray, MeshBVHHit& hit) const noexcept
+	{
+		if (nodes_.empty())
+			return false;
+
+		TraversalRay traversalRay(ray);
+
+		float maxDistance = ray.maxDistance;
+		std::uint32_t closest = InvalidId;
+
+		StackEntry stack[StackSize];
+		std::size_t stackSize = 0;
+		stack[stackSize++] = { 0, 0.0f };
+
+		alignas(16) float distances[4];
+
+		while (stackSize > 0)
+		{
+			auto entry = stack[--stackSize];
+			if (entry.distance >= maxDistance)
+				continue;
+
+			auto& node = nodes_[entry.node];
+			auto mask = intersectBoxes(node.minX, traversalRay, maxDistance, distances) & ((1 << node.numChildren) - 1);
+
+			StackEntry children[4];
+			std::size_t numChildren = 0;
+
+			for (std::size_t i = 0; i < 4; i++)
+			{
+				if (!(mask & (1 << i)))
+					continue;
+
+				if (node.count[i] > 0)
+				{
+					for (std::size_t j = node.child[i]; j < node.child[i] + node.count[i]; j++)
+					{
+						alignas(16) float t[4];
+
+						auto& packet = packets_[j];
+						auto hits = intersectTriangles(packet.v0[0], traversalRay, maxDistance, t);
+
+						for (std::size_t lane = 0; hits; lane++, hits >>= 1)
+						{
+							if ((hits & 1) && t[lane] < maxDistance)
+							{
+								maxDistance = t[lane];
+								closest = packet.id[lane];
+							}
+						}
+					}
+				}
+				else
+				{
+					// Insertion sort, farthest first, so the nearest child is popped next.
+					StackEntry child{ node.child[i], distances[i] };
+
+					auto k = numChildren++;
+					for (; k > 0 && children[k - 1].distance < child.distance; k--)
+						children[k] = children[k - 1];
+
+					children[k] = child;
+				}
+			}
+
+			for (std::size_t i = 0; i < numChildren; i++)
+			{
+				if (children[i].distance < maxDistance)
+					stack[stackSize++] = children[i];
+			}
+		}
+
+		if (closest == InvalidId)
+			return false;
+
+		auto subset = std::upper_bound(offsets_.begin(), offsets_.end(), closest) - offsets_.begin() - 1;
+
+		hit.subset = subset;
+		hit.triangle = closest - offsets_[subset];
+		hit.distance = maxDistance;
+
+		return true;
+	}
+
+	bool
+	MeshBVH::raycastAll(const math::Raycast& ray, std::vector<MeshBVHHit>& hits) const noexcept
+	{
+		if (nodes_.empty())
+			return false;
+
+		TraversalRay traversalRay(ray);
+
+		auto numHits = hits.size();
+		auto maxDistance = ray.maxDistance;
+
+		std::uint32_t stack[StackSize];
+		std::size_t stackSize = 0;
+		stack[stackSize++] = 0;
+
+		alignas(16) float distances[4];
+
+		while (stackSize > 0)
+		{
+			auto& node = nodes_[stack[--stackSize]];
+			auto mask = intersectBoxes(node.minX, traversalRay, maxDistance, distances) & ((1 << node.numChildren) - 1);
+
+			for (std::size_t i = 0; i < 4; i++)
+			{
+				if (!(mask & (1 << i)))
+					continue;
+
+				if (node.count[i] > 0)
+				{
+					for (std::size_t j = node.child[i]; j < node.child[i] + node.count[i]; j++)
+					{
+						alignas(16) float t[4];
+
+						auto& packet = packets_[j];
+						auto mask = intersectTriangles(packet.v0[0], traversalRay, maxDistance, t);
+
+						for (std::size_t lane = 0; mask; lane++, mask >>= 1)
+						{
+							if (mask & 1)
+							{
+								auto id = packet.id[lane];
+								auto subset = std::upper_bound(offsets_.begin(), offsets_.end(), id) - offsets_.begin() - 1;
+
+								MeshBVHHit hit;
+								hit.subset = subset;
+								hit.triangle = id - offsets_[subset];
+								hit.distance = t[lane];
+
+								hits.push_back(hit);
+							}
+						}
+					}
+				}
+				else
+				{
+					stack[stackSize++] = node.child[i];
+				}
+			}
+		}
+
+		return hits.size() > numHits;
+	}
+
+	void
+	MeshBVH::setPacket(TrianglePacket& packet, std::size_t lane, const math::float3s& vertices, std::uint32_t id) const noexcept
+	{
+		packet.id[lane] = id;
+
+		if (id != InvalidId)
+		{
+			auto& v0 = vertices[indices_[id * 3]];
+			auto e1 = vertices[indices_[id * 3 + 1]] - v0;
+			auto e2 = vertices[indices_[id * 3 + 2]] - v0;
+
+			for (std::uint8_t i = 0; i < 3; i++)
+			{
+				packet.v0[i][lane] = v0[i];
+				packet.e1[i][lane] = e1[i];
+				packet.e2[i][lane] = e2[i];
+			}
+		}
+		else
+		{
+			for (std::uint8_t i = 0; i < 3; i++)
+			{
+				packet.v0[i][lane] = 0.0f;
+				packet.e1[i][lane] = 0.0f;
+				packet.e2[i][lane] = 0.0f;
+			}
+		}
+	}
+
+	void
+	MeshBVH::refitNodes(const math::float3s& vertices) noexcept
+	{
+		// Children are always stored after their parent, so a reverse sweep sees them refitted.
+		for (std::size_t n = nodes_.size(); n > 0; n--)
+		{
+			auto& node = nodes_[n - 1];
+
+			for (std::size_t i = 0; i < node.numChildren; i++)
+			{
+				Bounds bounds;
+
+				if (node.count[i] > 0)
+				{
+					for (std::size_t j = node.child[i]; j < node.child[i] + node.count[i]; j++)
+					{
+						for (auto id : packets_[j].id)
+						{
+							if (id == InvalidId)
+								continue;
+
+							for (std::size_t k = 0; k < 3; k++)
+								bounds.grow(vertices[indices_[id * 3 + k]]);
+						}
+					}
+				}
+				else
+				{
+					auto& child = nodes_[node.child[i]];
+
+					for (std::size_t j = 0; j < child.numChildren; j++)
+					{
+						bounds.grow(math::float3(child.minX[j], child.minY[j], child.minZ[j]));
+						bounds.grow(math::float3(child.maxX[j], child.maxY[j], child.maxZ[j]));
+					}
+				}
+
+				node.minX[i] = bounds.min.x;
+				node.minY[i] = bounds.min.y;
+				node.minZ[i] = bounds.min.z;
+				node.maxX[i] = bounds.max.x;
+				node.maxY[i] = bounds.max.y;
+				node.maxZ[i] = bounds.max.z;
+			}
+		}
+	}
+
+	MeshBVH&
+	MeshBVH::operator=(const MeshBVH& bvh) noexcept
+	{
+		if (this != &bvh)
+		{
+			nodes_ = bvh.nodes_;
+			packets_ = bvh.packets_;
+			indices_ = bvh.indices_;
+			offsets_ = bvh.offsets_;
+			state_.store(bvh.state_.load());
+		}
+
+		return *this;
+	}
+
+	MeshBVH&
+	MeshBVH::operator=(MeshBVH&& bvh) noexcept
+	{
+		if (this != &bvh)
+		{
+			nodes_ = std::move(bvh.nodes_);
+			packets_ = std::move(bvh.packets_);
+			indices_ = std::move(bvh.indices_);
+			offsets_ = std::move(bvh.offsets_);
+			state_.store(bvh.state_.exchange(Rebuild));
+		}
+
+		return *this;
+	}
+}
@@ -0,0 +1,302 @@
+#include <octoon/mesh/morph_blender.h>
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace octoon
+{
+	namespace
+	{
+		constexpr std::size_t ParallelThreshold = 4096;
+		constexpr std::size_t ResyncInterval = 256;
+	}
+
+	MorphBlender::MorphBlender() noexcept
+		: invalid_(false)
+		, hasNormals_(false)
+		, threads_(0)
+		, incremental_(0)
+	{
+	}
+
+	MorphBlender::~MorphBlender() noexcept
+	{
+	}
+
+	void
+	MorphBlender::setThreadCount(std::uint32_t count) noexcept
+	{
+		threads_ = count;
+	}
+
+	std::uint32_t
+	MorphBlender::getThreadCount() const noexcept
+	{
+		return threads_;
+	}
+
+	void
+	MorphBlender::build(std::size_t numVertices, const std::vector<MorphTarget>& targets) noexcept
+	{
+		this->clear();
+
+		constexpr auto none = std::numeric_limits<std::uint32_t>::max();
+
+		math::uint1s counts(numVertices, 0);
+
+		for (auto& target : targets)
+		{
+			hasNormals_ |= target.normals != nullptr;
+
+			for (std::size_t i = 0; i < target.count; i++)
+			{
+				if (target.indices[i] < numVertices)
+					counts[target.indices[i]]++;
+			}
+		}
+
+		math::uint1s rowOf(numVertices, none);
+
+		rowStarts_.push_back(0);
+
+		for (std::uint32_t v = 0; v < numVertices; v++)
+		{
+			if (counts[v] > 0)
+			{
+				rowOf[v] = static_cast<std::uint32_t>(rows_.size());
+				rows_.push_back(v);
+				rowStarts_.push_back(rowStarts_.back() + counts[v]);
+			}
+		}
+
+		auto numEntries = rowStarts_.back();
+		entryTargets_.resize(numEntries);
+		entryOffsets_.resize(numEntries);
+		if (hasNormals_)
+			entryNormals_.resize(numEntries, math::float3::Zero);
+
+		math::uint1s cursor(rowStarts_.begin(), rowStarts_.end() - 1);
+		math::uint1s slot(rows_.size(), none);
+
+		targetStarts_.push_back(0);
+
+		for (std::uint32_t t = 0; t < targets.size(); t++)
+		{
+			auto& target = targets[t];
+			auto first = targetRows_.size();
+
+			for (std::size_t i = 0; i < target.count; i++)
+			{
+				auto v = target.indices[i];
+				if (v >= numVertices)
+					continue;
+
+				auto row = rowOf[v];
+				auto normal = target.normals ? target.normals[i] : math::float3::Zero;
+
+				auto entry = cursor[row]++;
+				entryTargets_[entry] = t;
+				entryOffsets_[entry] = target.offsets[i];
+				if (hasNormals_)
+					entryNormals_[entry] = normal;
+
+				// duplicate vertices inside one target are merged so its rows stay unique
+				if (slot[row] != none && slot[row] >= first)
+				{
+					targetOffsets_[slot[row]] += target.offsets[i];
+					if (hasNormals_)
+						targetNormals_[slot[row]] += normal;
+				}
+				else
+				{
+					slot[row] = static_cast<std::uint32_t>(targetRows_.size());
+					targetRows_.push_back(row);
+					targetOffsets_.push_back(target.offsets[i]);
+					if (hasNormals_)
+						targetNormals_.push_back(normal);
+				}
+			}
+
+			targetStarts_.push_back(static_cast<std::uint32_t>(targetRows_.size()));
+		}
+
+		deltas_.resize(rows_.size(), math::float3::Zero);
+		if (hasNormals_)
+			normalDeltas_.resize(rows_.size(), math::float3::Zero);
+
+		weights_.resize(targets.size(), 0.0f);
+		applied_.resize(targets.size(), 0.0f);
+		dirty_.resize(rows_.size(), 0);
+	}
+
+	void
+	MorphBlender::clear() noexcept
+	{
+		invalid_ = false;
+		hasNormals_ = false;
+		incremental_ = 0;
+
+		rows_.clear();
+		rowStarts_.clear();
+		entryTargets_.clear();
+		entryOffsets_.clear();
+		entryNormals_.clear();
+		targetStarts_.clear();
+		targetRows_.clear();
+		targetOffsets_.clear();
+		targetNormals_.clear();
+		deltas_.clear();
+		normalDeltas_.clear();
+		weights_.clear();
+		applied_.clear();
+		dirty_.clear();
+		dirtyRows_.clear();
+	}
+
+	void
+	MorphBlender::invalidate() noexcept
+	{
+		invalid_ = true;
+	}
+
+	bool
+	MorphBlender::empty() const noexcept
+	{
+		return rows_.empty();
+	}
+
+	bool
+	MorphBlender::hasNormals() const noexcept
+	{
+		return hasNormals_;
+	}
+
+	std::size_t
+	MorphBlender::getNumRows() const noexcept
+	{
+		return rows_.size();
+	}
+
+	std::size_t
+	MorphBlender::getNumTargets() const noexcept
+	{
+		return weights_.size();
+	}
+
+	void
+	MorphBlender::setWeight(std::size_t target, float weight) noexcept
+	{
+		assert(target < weights_.size());
+		weights_[target] = weight;
+	}
+
+	float
+	MorphBlender::getWeight(std::size_t target) const noexcept
+	{
+		assert(target < weights_.size());
+		return weights_[target];
+	}
+
+	bool
+	MorphBlender::update(const math::float3s& baseVertices, const math::float3s& baseNormals, math::float3s& vertices, math::float3s& normals) noexcept
+	{
+		std::size_t changed = 0;
+		for (std::size_t t = 0; t < weights_.size(); t++)
+		{
+			if (weights_[t] != applied_[t])
+				changed++;
+		}
+
+		if (!changed && !invalid_)
+			return false;
+
+		auto weights = weights_.data();
+		auto writeNormals = hasNormals_ && !normals.empty();
+		auto numThreads = threads_ > 0 ? threads_ : std::max(1u, std::thread::hardware_concurrency() / 2);
+
+		if (invalid_ || ++incremental_ >= ResyncInterval)
+		{
+			auto numRows = static_cast<std::int64_t>(rows_.size());
+
+#			pragma omp parallel for num_threads(numThreads) schedule(static) if(rows_.size() >= ParallelThreshold)
+			for (std::int64_t row = 0; row < numRows; row++)
+			{
+				math::float3 offset = math::float3::Zero;
+				math::float3 normal = math::float3::Zero;
+
+				for (auto entry = rowStarts_[row]; entry < rowStarts_[row + 1]; entry++)
+				{
+					auto w = weights[entryTargets_[entry]];
+					if (w != 0.0f)
+					{
+						offset += entryOffsets_[entry] * w;
+						if (hasNormals_)
+							normal += entryNormals_[entry] * w;
+					}
+				}
+
+				deltas_[row] = offset;
+				if (hasNormals_)
+					normalDeltas_[row] = normal;
+
+				auto vertex = rows_[row];
+				vertices[vertex] = baseVertices[vertex] + offset;
+				if (writeNormals)
+					normals[vertex] = baseNormals[vertex] + normal;
+			}
+
+			invalid_ = false;
+			incremental_ = 0;
+		}
+		else
+		{
+			dirtyRows_.clear();
+
+			for (std::size_t t = 0; t < weights_.size(); t++)
+			{
+				if (weights_[t] == applied_[t])
+					continue;
+
+				auto delta = weights_[t] - applied_[t];
+				auto first = static_cast<std::int64_t>(targetStarts_[t]);
+				auto last = static_cast<std::int64_t>(targetStarts_[t + 1]);
+
+#				pragma omp parallel for num_threads(numThreads) schedule(static) if(last - first >= std::int64_t(ParallelThreshold))
+				for (std::int64_t i = first; i < last; i++)
+				{
+					auto row = targetRows_[i];
+					deltas_[row] += targetOffsets_[i] * delta;
+					if (hasNormals_)
+						normalDeltas_[row] += targetNormals_[i] * delta;
+				}
+
+				for (auto i = first; i < last; i++)
+				{
+					auto row = targetRows_[i];
+					if (!dirty_[row])
+					{
+						dirty_[row] = 1;
+						dirtyRows_.push_back(row);
+					}
+				}
+			}
+
+			auto numRows = static_cast<std::int64_t>(dirtyRows_.size());
+
+#			pragma omp parallel for num_threads(numThreads) schedule(static) if(dirtyRows_.size() >= ParallelThreshold)
+			for (std::int64_t i = 0; i < numRows; i++)
+			{
+				auto row = dirtyRows_[i];
+				auto vertex = rows_[row];
+
+				dirty_[row] = 0;
+				vertices[vertex] = baseVertices[vertex] + deltas_[row];
+				if (writeNormals)
+					normals[vertex] = baseNormals[vertex] + normalDeltas_[row];
+			}
+		}
+
+		applied_ = weights_;
+		return true;
+	}
+}
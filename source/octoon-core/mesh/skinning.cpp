@@ -0,0 +1,275 @@
+#include <octoon/mesh/skinning.h>
+#include <algorithm>
+#include <thread>
+
+#if defined(__AVX__)
+#	include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#	include <emmintrin.h>
+#endif
+
+namespace octoon
+{
+	namespace
+	{
+		constexpr std::size_t ParallelThreshold = 4096;
+
+#if defined(__AVX__)
+		inline __m256 madd(__m256 a, __m256 b, __m256 c) noexcept
+		{
+#	if defined(__FMA__)
+			return _mm256_fmadd_ps(a, b, c);
+#	else
+			return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#	endif
+		}
+
+		inline void skinVertex(const SkinningJoint* joints, const VertexWeight& blend, const math::float3& v, const math::float3& n, math::float3& outVertex, math::float3& outNormal) noexcept
+		{
+			__m256 ab = _mm256_setzero_ps();
+			__m256 cd = _mm256_setzero_ps();
+
+			for (std::size_t j = 0; j < 4; j++)
+			{
+				if (blend.weights[j] != 0.0f)
+				{
+					auto& m = joints[blend.bones[j]];
+					auto w = _mm256_set1_ps(blend.weights[j]);
+					ab = madd(_mm256_load_ps(m.a), w, ab);
+					cd = madd(_mm256_load_ps(m.c), w, cd);
+				}
+			}
+
+			auto p = madd(ab, _mm256_setr_ps(v.x, v.x, v.x, v.x, v.y, v.y, v.y, v.y), _mm256_mul_ps(cd, _mm256_setr_ps(v.z, v.z, v.z, v.z, 1.0f, 1.0f, 1.0f, 1.0f)));
+			auto r = madd(ab, _mm256_setr_ps(n.x, n.x, n.x, n.x, n.y, n.y, n.y, n.y), _mm256_mul_ps(cd, _mm256_setr_ps(n.z, n.z, n.z, n.z, 0.0f, 0.0f, 0.0f, 0.0f)));
+
+			alignas(16) float position[4];
+			alignas(16) float normal[4];
+			_mm_store_ps(position, _mm_add_ps(_mm256_castps256_ps128(p), _mm256_extractf128_ps(p, 1)));
+			_mm_store_ps(normal, _mm_add_ps(_mm256_castps256_ps128(r), _mm256_extractf128_ps(r, 1)));
+
+			outVertex.set(position[0], position[1], position[2]);
+			outNormal.set(normal[0], normal[1], normal[2]);
+		}
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+		inline void skinVertex(const SkinningJoint* joints, const VertexWeight& blend, const math::float3& v, const math::float3& n, math::float3& outVertex, math::float3& outNormal) noexcept
+		{
+			__m128 a = _mm_setzero_ps();
+			__m128 b = _mm_setzero_ps();
+			__m128 c = _mm_setzero_ps();
+			__m128 d = _mm_setzero_ps();
+
+			for (std::size_t j = 0; j < 4; j++)
+			{
+				if (blend.weights[j] != 0.0f)
+				{
+					auto& m = joints[blend.bones[j]];
+					auto w = _mm_set1_ps(blend.weights[j]);
+					a = _mm_add_ps(a, _mm_mul_ps(_mm_load_ps(m.a), w));
+					b = _mm_add_ps(b, _mm_mul_ps(_mm_load_ps(m.b), w));
+					c = _mm_add_ps(c, _mm_mul_ps(_mm_load_ps(m.c), w));
+					d = _mm_add_ps(d, _mm_mul_ps(_mm_load_ps(m.d), w));
+				}
+			}
+
+			auto p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(v.x)), _mm_mul_ps(b, _mm_set1_ps(v.y))), _mm_add_ps(_mm_mul_ps(c, _mm_set1_ps(v.z)), d));
+			auto r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(n.x)), _mm_mul_ps(b, _mm_set1_ps(n.y))), _mm_mul_ps(c, _mm_set1_ps(n.z)));
+
+			alignas(16) float position[4];
+			alignas(16) float normal[4];
+			_mm_store_ps(position, p);
+			_mm_store_ps(normal, r);
+
+			outVertex.set(position[0], position[1], position[2]);
+			outNormal.set(normal[0], normal[1], normal[2]);
+		}
+#else
+		inline void skinVertex(const SkinningJoint* joints, const VertexWeight& blend, const math::float3& v, const math::float3& n, math::float3& outVertex, math::float3& outNormal) noexcept
+		{
+			float m[16] = { 0.0f };
+
+			for (std::size_t j = 0; j < 4; j++)
+			{
+				auto w = blend.weights[j];
+				if (w != 0.0f)
+				{
+					auto src = joints[blend.bones[j]].a;
+					for (std::size_t k = 0; k < 16; k++)
+						m[k] += src[k] * w;
+				}
+			}
+
+			outVertex.set(
+				m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12],
+				m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13],
+				m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14]);
+
+			outNormal.set(
+				m[0] * n.x + m[4] * n.y + m[8] * n.z,
+				m[1] * n.x + m[5] * n.y + m[9] * n.z,
+				m[2] * n.x + m[6] * n.y + m[10] * n.z);
+		}
+#endif
+
+		inline math::float3 transformJoint(const SkinningJoint& m, const math::float3& v) noexcept
+		{
+			return math::float3(
+				m.a[0] * v.x + m.b[0] * v.y + m.c[0] * v.z + m.d[0],
+				m.a[1] * v.x + m.b[1] * v.y + m.c[1] * v.z + m.d[1],
+				m.a[2] * v.x + m.b[2] * v.y + m.c[2] * v.z + m.d[2]);
+		}
+
+		inline void skinDualQuaternion(const math::Quaternion* rotations, const math::Quaternion* duals, const VertexWeight& blend, const math::float3& v, const math::float3& n, math::float3& outVertex, math::float3& outNormal) noexcept
+		{
+			auto& pivot = rotations[blend.bones[0]];
+
+			math::Quaternion real(0.0f, 0.0f, 0.0f, 0.0f);
+			math::Quaternion dual(0.0f, 0.0f, 0.0f, 0.0f);
+
+			for (std::size_t j = 0; j < 4; j++)
+			{
+				auto w = blend.weights[j];
+				if (w != 0.0f)
+				{
+					auto& r = rotations[blend.bones[j]];
+					if (math::dot(pivot, r) < 0.0f)
+						w = -w;
+
+					real = real + r * w;
+					dual = dual + duals[blend.bones[j]] * w;
+				}
+			}
+
+			auto length = std::sqrt(math::dot(real, real));
+			if (length > 0.0f)
+			{
+				real = real * (1.0f / length);
+				dual = dual * (1.0f / length);
+			}
+
+			auto t = dual * math::conjugate(real);
+
+			outVertex = math::rotate(real, v) + math::float3(t.x, t.y, t.z) * 2.0f;
+			outNormal = math::rotate(real, n);
+		}
+
+		inline void skinSdef(const SkinningJoint* joints, const math::Quaternion* rotations, const VertexWeight& blend, const VertexSkinning& skinning, const math::float3& v, const math::float3& n, math::float3& outVertex, math::float3& outNormal) noexcept
+		{
+			auto i0 = blend.bones[0];
+			auto i1 = blend.bones[1];
+			auto w0 = blend.weights[0];
+			auto w1 = blend.weights[1];
+
+			auto& c = skinning.sdefC;
+			auto rw = skinning.sdefR0 * w0 + skinning.sdefR1 * w1;
+			auto cr0 = c + (skinning.sdefR0 - rw) * 0.5f;
+			auto cr1 = c + (skinning.sdefR1 - rw) * 0.5f;
+
+			auto q = math::slerp(rotations[i0], rotations[i1], w1);
+
+			outVertex = math::rotate(q, v - c) + transformJoint(joints[i0], cr0) * w0 + transformJoint(joints[i1], cr1) * w1;
+			outNormal = math::rotate(q, n);
+		}
+	}
+
+	SkinningKernel::SkinningKernel() noexcept
+		: threads_(0)
+	{
+	}
+
+	SkinningKernel::~SkinningKernel() noexcept
+	{
+	}
+
+	void
+	SkinningKernel::setThreadCount(std::uint32_t count) noexcept
+	{
+		threads_ = count;
+	}
+
+	std::uint32_t
+	SkinningKernel::getThreadCount() const noexcept
+	{
+		return threads_;
+	}
+
+	void
+	SkinningKernel::setJoints(const math::float4x4s& joints) noexcept
+	{
+		joints_.resize(joints.size());
+		rotations_.resize(joints.size());
+		duals_.resize(joints.size());
+
+		for (std::size_t i = 0; i < joints.size(); i++)
+		{
+			auto& m = joints[i];
+			joints_[i] = SkinningJoint{
+				{ m.a1, m.a2, m.a3, 0.0f },
+				{ m.b1, m.b2, m.b3, 0.0f },
+				{ m.c1, m.c2, m.c3, 0.0f },
+				{ m.d1, m.d2, m.d3, 0.0f }
+			};
+
+			// joints are rigid, so the rotation and translation form the dual quaternion
+			auto q = math::normalize(math::Quaternion(m));
+			rotations_[i] = q;
+			duals_[i] = math::Quaternion(m.d1, m.d2, m.d3, 0.0f) * q * 0.5f;
+		}
+	}
+
+	const std::vector<SkinningJoint>&
+	SkinningKernel::getJoints() const noexcept
+	{
+		return joints_;
+	}
+
+	void
+	SkinningKernel::skin(const math::float3* vertices, const math::float3* normals, const VertexWeight* weights, const VertexSkinning* skinnings, math::float3* outVertices, math::float3* outNormals, std::size_t count) const noexcept
+	{
+		auto joints = joints_.data();
+		auto rotations = rotations_.data();
+		auto duals = duals_.data();
+		auto numThreads = threads_ > 0 ? threads_ : std::max(1u, std::thread::hardware_concurrency() / 2);
+		auto numVertices = static_cast<std::int64_t>(count);
+
+#		pragma omp parallel for num_threads(numThreads) schedule(static) if(count >= ParallelThreshold)
+		for (std::int64_t i = 0; i < numVertices; i++)
+		{
+			switch (skinnings ? skinnings[i].type : SkinningType::Linear)
+			{
+			case SkinningType::DualQuaternion:
+				skinDualQuaternion(rotations, duals, weights[i], vertices[i], normals[i], outVertices[i], outNormals[i]);
+				break;
+			case SkinningType::Sdef:
+				skinSdef(joints, rotations, weights[i], skinnings[i], vertices[i], normals[i], outVertices[i], outNormals[i]);
+				break;
+			default:
+				skinVertex(joints, weights[i], vertices[i], normals[i], outVertices[i], outNormals[i]);
+				break;
+			}
+		}
+	}
+
+	void
+	SkinningKernel::skin(math::float3s& vertices, math::float3s& normals, const std::vector<VertexWeight>& weights, const std::vector<VertexSkinning>& skinnings) const noexcept
+	{
+		assert(vertices.size() == normals.size());
+		assert(vertices.size() <= weights.size());
+		assert(skinnings.empty() || vertices.size() <= skinnings.size());
+
+		this->skin(vertices.data(), normals.data(), weights.data(), skinnings.empty() ? nullptr : skinnings.data(), vertices.data(), normals.data(), vertices.size());
+	}
+
+	void
+	SkinningKernel::skin(const math::float3s& vertices, const math::float3s& normals, const std::vector<VertexWeight>& weights, const std::vector<VertexSkinning>& skinnings, math::float3s& outVertices, math::float3s& outNormals) const noexcept
+	{
+		assert(vertices.size() == normals.size());
+		assert(vertices.size() <= weights.size());
+		assert(skinnings.empty() || vertices.size() <= skinnings.size());
+
+		outVertices.resize(vertices.size());
+		outNormals.resize(normals.size());
+
+		this->skin(vertices.data(), normals.data(), weights.data(), skinnings.empty() ? nullptr : skinnings.data(), outVertices.data(), outNormals.data(), vertices.size());
+	}
+}
@@ -3,7 +3,10 @@
 #include "bullet_joint.h"
 
 #include <bullet/btBulletDynamicsCommon.h>
+#include <bullet/BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
 #include <bullet/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <bullet/LinearMath/btThreads.h>
 
 namespace octoon
 {
@@ -17,19 +20,32 @@ namespace octoon
 		}
 	};
 
+	// Bullet runs its parallel loops on one global scheduler, created once and shared by all scenes
+	static btITaskScheduler* GetTaskScheduler() noexcept
+	{
+		static btITaskScheduler* scheduler = []()
+		{
+			auto scheduler = btCreateDefaultTaskScheduler();
+			if (!scheduler)
+				scheduler = btGetSequentialTaskScheduler();
+
+			scheduler->setNumThreads(scheduler->getMaxNumThreads());
+			return scheduler;
+		}();
+
+		return scheduler;
+	}
+
 	BulletScene::BulletScene(PhysicsSceneDesc desc)
 		: broadphase_(std::make_unique<btDbvtBroadphase>())
 		, collisionConfiguration_(std::make_unique<btDefaultCollisionConfiguration>())
 		, filterCallback_(std::make_unique<FilterCallback>())
-		, solver_(std::make_unique<btSequentialImpulseConstraintSolver>())
 		, maxSubSteps_(1)
 		, fixedTimeStep_(1.0f / 60.f)
 		, groundEnabled_(true)
 		, groundBoxShape_(nullptr)
 		, groundCollisionObject_(nullptr)
 	{
-		dispatcher_ = std::make_unique<btCollisionDispatcher>(collisionConfiguration_.get());
-
 		auto groundBoxShape_ = new btBoxShape(btVector3(50, 50, 50));
 		groundBoxShape_->setMargin(0.5f);
 
@@ -47,7 +63,26 @@ namespace octoon
 		groundCollisionObject_->setCollisionFlags(groundCollisionObject_->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
 		groundCollisionObject_->setActivationState(DISABLE_DEACTIVATION);
 
-		dynamicsWorld_ = std::make_unique<btDiscreteDynamicsWorld>(dispatcher_.get(), broadphase_.get(), solver_.get(), collisionConfiguration_.get());
+		if (desc.enableMultiThreading)
+		{
+			auto scheduler = GetTaskScheduler();
+			if (btGetTaskScheduler() != scheduler)
+				btSetTaskScheduler(scheduler);
+
+			// Islands are dispatched to the solver pool in parallel, every model whose bodies
+			// don't touch another one forms islands of its own
+			dispatcher_ = std::make_unique<btCollisionDispatcherMt>(collisionConfiguration_.get());
+			solver_ = std::make_unique<btSequentialImpulseConstraintSolverMt>();
+			solverPool_ = std::make_unique<btConstraintSolverPoolMt>(scheduler->getNumThreads());
+			dynamicsWorld_ = std::make_unique<btDiscreteDynamicsWorldMt>(dispatcher_.get(), broadphase_.get(), solverPool_.get(), solver_.get(), collisionConfiguration_.get());
+		}
+		else
+		{
+			dispatcher_ = std::make_unique<btCollisionDispatcher>(collisionConfiguration_.get());
+			solver_ = std::make_unique<btSequentialImpulseConstraintSolver>();
+			dynamicsWorld_ = std::make_unique<btDiscreteDynamicsWorld>(dispatcher_.get(), broadphase_.get(), solver_.get(), collisionConfiguration_.get());
+		}
+
 		dynamicsWorld_->setGravity(btVector3(desc.gravity.x, desc.gravity.y, desc.gravity.z));
 		dynamicsWorld_->getPairCache()->setOverlapFilterCallback(filterCallback_.get());
 		dynamicsWorld_->addCollisionObject(groundCollisionObject_, 1 << groundCollisionObject_->getUserIndex(), groundCollisionObject_->getUserIndex2());
@@ -156,20 +191,26 @@ namespace octoon
 	void
 	BulletScene::simulate(float time)
 	{
-		auto collision = this->dynamicsWorld_->getCollisionObjectArray();
+		auto& collision = this->dynamicsWorld_->getCollisionObjectArray();
 		auto collisionNums = this->dynamicsWorld_->getNumCollisionObjects();
 
+		// Changed filters are applied to the broadphase proxies in place, the bodies keep their
+		// slots in the world so the simulation order stays the same from frame to frame
 		for (int i = 0; i < collisionNums; ++i)
 		{
-			auto& collider = collision[i];
+			auto collider = collision[i];
 			if (collider->getUserIndex3() > 0)
 			{
-				btRigidBody* body = btRigidBody::upcast(collision[i]);
+				auto proxy = collider->getBroadphaseHandle();
+				if (proxy)
+				{
+					proxy->m_collisionFilterGroup = 1 << collider->getUserIndex();
+					proxy->m_collisionFilterMask = collider->getUserIndex2();
 
-				this->dynamicsWorld_->removeRigidBody(body);
-				this->dynamicsWorld_->addRigidBody(body, 1 << body->getUserIndex(), body->getUserIndex2());
+					this->dynamicsWorld_->refreshBroadphaseProxy(collider);
+				}
 
-				body->setUserIndex3(false);
+				collider->setUserIndex3(false);
 			}
 		}
 
@@ -189,7 +230,7 @@ namespace octoon
 	void
 	BulletScene::fetchResults()
 	{
-		auto rigidbodies = this->dynamicsWorld_->getCollisionObjectArray();
+		auto& rigidbodies = this->dynamicsWorld_->getNonStaticRigidBodies();
 		auto rigidbodiesNums = rigidbodies.size();
 
 		for (int i = 0; i < rigidbodiesNums; ++i)
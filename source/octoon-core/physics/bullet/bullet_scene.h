@@ -57,6 +57,7 @@ namespace octoon
 		std::unique_ptr<btCollisionDispatcher> dispatcher_;
 		std::unique_ptr<btDefaultCollisionConfiguration> collisionConfiguration_;
 		std::unique_ptr<btSequentialImpulseConstraintSolver> solver_;
+		std::unique_ptr<btConstraintSolverPoolMt> solverPool_;
 		std::unique_ptr<btDiscreteDynamicsWorld> dynamicsWorld_;
 	};
 }
@@ -17,6 +17,7 @@ class btCollisionDispatcher;
 class btDefaultCollisionConfiguration;
 class btSequentialImpulseConstraintSolver;
 class btSequentialImpulseConstraintSolverMt;
+class btConstraintSolverPoolMt;
 class btDiscreteDynamicsWorld;
 class btActionInterface;
 class btPairCachingGhostObject;
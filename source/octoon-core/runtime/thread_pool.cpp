@@ -0,0 +1,71 @@
+#include <octoon/runtime/thread_pool.h>
+
+#include <algorithm>
+
+namespace octoon
+{
+	ThreadPool::ThreadPool(std::size_t numThreads) noexcept
+		: quit_(false)
+	{
+		if (numThreads == 0)
+			numThreads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+		this->threads_.reserve(numThreads);
+
+		for (std::size_t i = 0; i < numThreads; i++)
+			this->threads_.emplace_back(&ThreadPool::run, this);
+	}
+
+	ThreadPool::~ThreadPool() noexcept
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex_);
+			this->quit_ = true;
+		}
+
+		this->condition_.notify_all();
+
+		for (auto& it : this->threads_)
+			it.join();
+	}
+
+	std::size_t
+	ThreadPool::getNumThreads() const noexcept
+	{
+		return this->threads_.size();
+	}
+
+	void
+	ThreadPool::submit(std::function<void()>&& task) noexcept
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex_);
+			this->tasks_.push_back(std::move(task));
+		}
+
+		this->condition_.notify_one();
+	}
+
+	void
+	ThreadPool::run() noexcept
+	{
+		for (;;)
+		{
+			std::function<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock(this->mutex_);
+				this->condition_.wait(lock, [this]() { return this->quit_ || !this->tasks_.empty(); });
+
+				// queued tasks still run on shutdown so no promise is left without a value
+				if (this->tasks_.empty())
+					return;
+
+				task = std::move(this->tasks_.front());
+				this->tasks_.pop_front();
+			}
+
+			task();
+		}
+	}
+}
@@ -1,5 +1,6 @@
 #include <octoon/texture/texture.h>
 #include <octoon/texture/texture_util.h>
+#include <octoon/texture/texture_processing.h>
 #include <octoon/runtime/except.h>
 #include <octoon/io/vstream.h>
 #include <octoon/io/mstream.h>
@@ -175,7 +176,9 @@ namespace octoon
 			if (format == Format::BC1RGBUNormBlock ||
 				format == Format::BC1RGBSRGBBlock ||
 				format == Format::BC1RGBAUNormBlock ||
-				format == Format::BC1RGBASRGBBlock)
+				format == Format::BC1RGBASRGBBlock ||
+				format == Format::BC4UNormBlock ||
+				format == Format::BC4SNormBlock)
 			{
 				blockSize = 8;
 			}
@@ -328,6 +331,9 @@ namespace octoon
 		if (width == 0 || height == 0 || this->width() == 0 || this->height() == 0)
 			return Texture();
 
+		if (isFilterableFormat(this->format_) && this->depth() == 1)
+			return resampleTexture(*this, width, height, TextureFilter::Lanczos);
+
 		Texture image(this->format_, width, height);
 
 		switch (image.format())
@@ -18,6 +18,9 @@
 #if OCTOON_BUILD_HDR_HANDLER
 #	include "texture_hdr.h"
 #endif
+#if OCTOON_BUILD_EXR_HANDLER
+#	include "texture_exr.h"
+#endif
 
 #include <vector>
 #include <algorithm>
@@ -32,6 +35,7 @@ namespace octoon
 	#endif
 	#if OCTOON_BUILD_PNG_HANDLER
 	std::shared_ptr<TextureHandler> png = std::make_shared<PNGHandler>();
+	std::shared_ptr<TextureHandler> pngFast = std::make_shared<PNGHandler>("png-fast", 1);
 	#endif
 	#if OCTOON_BUILD_JPG_HANDLER
 	std::shared_ptr<TextureHandler> jpeg = std::make_shared<JPEGHandler>();
@@ -42,9 +46,14 @@ namespace octoon
 	#if OCTOON_BUILD_HDR_HANDLER
 	std::shared_ptr<TextureHandler> hdr = std::make_shared<HDRHandler>();
 	#endif
+	#if OCTOON_BUILD_EXR_HANDLER
+	std::shared_ptr<TextureHandler> exr = std::make_shared<EXRHandler>();
+	#endif
 
+	// "png" matches any type name starting with png, so the fast variant has to be looked up first
 	std::vector<std::shared_ptr<TextureHandler>> _handlers = {
 	#if OCTOON_BUILD_PNG_HANDLER
+		pngFast,
 		png,
 	#endif
 	#if OCTOON_BUILD_TGA_HANDLER
@@ -62,6 +71,9 @@ namespace octoon
 	#if OCTOON_BUILD_HDR_HANDLER
 		hdr,
 	#endif
+	#if OCTOON_BUILD_EXR_HANDLER
+		exr,
+	#endif
 	};
 
 	bool emptyLoader() noexcept
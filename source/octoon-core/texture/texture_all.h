@@ -9,6 +9,7 @@
 #define OCTOON_BUILD_PNG_HANDLER  1
 #define OCTOON_BUILD_TGA_HANDLER  1
 #define OCTOON_BUILD_HDR_HANDLER  1
+#define OCTOON_BUILD_EXR_HANDLER  1
 
 namespace octoon
 {
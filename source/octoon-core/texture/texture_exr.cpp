@@ -0,0 +1,192 @@
+#include "texture_exr.h"
+#include <cstring>
+#include <vector>
+
+namespace octoon
+{
+	namespace
+	{
+		std::uint16_t floatToHalf(float value) noexcept
+		{
+			std::uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+
+			std::uint32_t sign = (bits >> 16) & 0x8000;
+			std::uint32_t exponent = (bits >> 23) & 0xFF;
+			std::uint32_t mantissa = bits & 0x7FFFFF;
+
+			if (exponent == 0xFF)
+				return static_cast<std::uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+			std::int32_t e = static_cast<std::int32_t>(exponent) - 127 + 15;
+			if (e >= 31)
+				return static_cast<std::uint16_t>(sign | 0x7C00);
+
+			if (e <= 0)
+			{
+				if (e < -10)
+					return static_cast<std::uint16_t>(sign);
+
+				mantissa |= 0x800000;
+				auto shift = static_cast<std::uint32_t>(14 - e);
+				auto half = mantissa >> shift;
+				auto rest = mantissa & ((1u << shift) - 1);
+				auto halfway = 1u << (shift - 1);
+				if (rest > halfway || (rest == halfway && (half & 1)))
+					half++;
+				return static_cast<std::uint16_t>(sign | half);
+			}
+
+			auto half = (static_cast<std::uint32_t>(e) << 10) | (mantissa >> 13);
+			auto rest = mantissa & 0x1FFF;
+			if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+				half++;
+
+			return static_cast<std::uint16_t>(sign | half);
+		}
+
+		class HeaderWriter final
+		{
+		public:
+			template<typename T>
+			void write(const T& value)
+			{
+				auto ptr = reinterpret_cast<const char*>(&value);
+				data.insert(data.end(), ptr, ptr + sizeof(T));
+			}
+
+			void write(const char* str)
+			{
+				data.insert(data.end(), str, str + std::strlen(str) + 1);
+			}
+
+			void attribute(const char* name, const char* type, std::int32_t size)
+			{
+				this->write(name);
+				this->write(type);
+				this->write(size);
+			}
+
+			std::vector<char> data;
+		};
+	}
+
+	bool
+	EXRHandler::doCanRead(istream& stream) const noexcept
+	{
+		return false;
+	}
+
+	bool
+	EXRHandler::doCanRead(const char* type_name) const noexcept
+	{
+		return std::strncmp(type_name, "exr", 3) == 0;
+	}
+
+	bool
+	EXRHandler::doLoad(istream& stream, Texture& image) noexcept
+	{
+		return false;
+	}
+
+	bool
+	EXRHandler::doSave(ostream& stream, const Texture& image) noexcept
+	{
+		auto& format = image.format();
+		if (format != Format::R32G32B32SFloat && format != Format::R32G32B32A32SFloat)
+			return false;
+
+		auto channels = format.channel();
+		auto width = static_cast<std::int32_t>(image.width());
+		auto height = static_cast<std::int32_t>(image.height());
+
+		// channels are stored in alphabetical order, so the source components are visited A, B, G, R
+		static constexpr const char* names[] = { "A", "B", "G", "R" };
+		static constexpr std::uint8_t components[] = { 3, 2, 1, 0 };
+		auto first = channels == 4 ? 0 : 1;
+
+		HeaderWriter header;
+		header.write(std::uint32_t(20000630));
+		header.write(std::uint32_t(2));
+
+		header.attribute("channels", "chlist", static_cast<std::int32_t>((4 - first) * 18 + 1));
+		for (auto i = first; i < 4; i++)
+		{
+			header.write(names[i]);
+			header.write(std::int32_t(1));
+			header.write(std::uint32_t(0));
+			header.write(std::int32_t(1));
+			header.write(std::int32_t(1));
+		}
+		header.write(std::uint8_t(0));
+
+		header.attribute("compression", "compression", 1);
+		header.write(std::uint8_t(0));
+
+		header.attribute("dataWindow", "box2i", 16);
+		header.write(std::int32_t(0));
+		header.write(std::int32_t(0));
+		header.write(width - 1);
+		header.write(height - 1);
+
+		header.attribute("displayWindow", "box2i", 16);
+		header.write(std::int32_t(0));
+		header.write(std::int32_t(0));
+		header.write(width - 1);
+		header.write(height - 1);
+
+		header.attribute("lineOrder", "lineOrder", 1);
+		header.write(std::uint8_t(0));
+
+		header.attribute("pixelAspectRatio", "float", 4);
+		header.write(1.0f);
+
+		header.attribute("screenWindowCenter", "v2f", 8);
+		header.write(0.0f);
+		header.write(0.0f);
+
+		header.attribute("screenWindowWidth", "float", 4);
+		header.write(1.0f);
+
+		header.write(std::uint8_t(0));
+
+		auto lineSize = static_cast<std::size_t>(width) * (4 - first) * sizeof(std::uint16_t);
+		auto chunkSize = lineSize + sizeof(std::int32_t) * 2;
+
+		std::vector<std::uint64_t> offsets(height);
+		for (std::int32_t y = 0; y < height; y++)
+			offsets[y] = header.data.size() + offsets.size() * sizeof(std::uint64_t) + chunkSize * y;
+
+		if (!stream.write(header.data.data(), header.data.size()))
+			return false;
+
+		if (!stream.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(std::uint64_t)))
+			return false;
+
+		auto pixels = reinterpret_cast<const float*>(image.data());
+
+		std::vector<std::uint16_t> line(lineSize / sizeof(std::uint16_t));
+
+		for (std::int32_t y = 0; y < height; y++)
+		{
+			auto row = pixels + static_cast<std::size_t>(y) * width * channels;
+			auto dst = line.data();
+
+			for (auto i = first; i < 4; i++)
+			{
+				for (std::int32_t x = 0; x < width; x++)
+					*dst++ = floatToHalf(row[x * channels + components[i]]);
+			}
+
+			auto size = static_cast<std::int32_t>(lineSize);
+			if (!stream.write(reinterpret_cast<const char*>(&y), sizeof(y)))
+				return false;
+			if (!stream.write(reinterpret_cast<const char*>(&size), sizeof(size)))
+				return false;
+			if (!stream.write(reinterpret_cast<const char*>(line.data()), lineSize))
+				return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,27 @@
+#ifndef OCTOON_TEXTURE_EXR_H_
+#define OCTOON_TEXTURE_EXR_H_
+
+#include <octoon/texture/texture.h>
+
+namespace octoon
+{
+	// Writes uncompressed scanline OpenEXR files with half float channels. Reading is not supported.
+	class EXRHandler final : public TextureHandler
+	{
+	public:
+		EXRHandler() noexcept = default;
+		virtual ~EXRHandler() = default;
+
+		bool doCanRead(istream& stream) const noexcept override;
+		bool doCanRead(const char* type_name) const noexcept override;
+
+		bool doLoad(istream& stream, Texture& image) noexcept override;
+		bool doSave(ostream& stream, const Texture& image) noexcept override;
+
+	private:
+		EXRHandler(const EXRHandler&) noexcept = delete;
+		EXRHandler& operator=(const EXRHandler&) noexcept = delete;
+	};
+}
+
+#endif
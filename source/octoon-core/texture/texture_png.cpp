@@ -48,6 +48,18 @@ namespace octoon
 		info->stream.out->write((char*)data, (std::streamsize)length);
 	}
 
+	PNGHandler::PNGHandler() noexcept
+		: typeName_("png")
+		, compressionLevel_(-1)
+	{
+	}
+
+	PNGHandler::PNGHandler(const char* typeName, int compressionLevel) noexcept
+		: typeName_(typeName)
+		, compressionLevel_(compressionLevel)
+	{
+	}
+
 	bool
 	PNGHandler::doCanRead(istream& stream) const noexcept
 	{
@@ -64,7 +76,7 @@ namespace octoon
 	bool
 	PNGHandler::doCanRead(const char* type_name) const noexcept
 	{
-		return std::strncmp(type_name, "png", 3) == 0;
+		return std::strncmp(type_name, typeName_, std::strlen(typeName_)) == 0;
 	}
 
 	bool
@@ -205,6 +217,15 @@ namespace octoon
 			::png_set_PLTE(png_ptr, info_ptr, palette.get(), PNG_MAX_PALETTE_LENGTH);
 			::png_set_IHDR(png_ptr, info_ptr, image.width(), image.height(), 8, format.channel() == 3 ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
 
+			if (compressionLevel_ >= 0)
+			{
+				::png_set_compression_level(png_ptr, compressionLevel_);
+
+				// adaptive filtering costs more than the deflate pass itself at the lowest levels
+				if (compressionLevel_ <= 2)
+					::png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+			}
+
 			::png_write_info(png_ptr, info_ptr);
 
 			auto stride = image.width() * format.channel();
@@ -8,7 +8,9 @@ namespace octoon
 	class PNGHandler final : public TextureHandler
 	{
 	public:
-		PNGHandler() noexcept = default;
+		PNGHandler() noexcept;
+		// Registers under another type name with a fixed zlib level (0-9), e.g. a fast variant for image sequences.
+		PNGHandler(const char* typeName, int compressionLevel) noexcept;
 		virtual ~PNGHandler() = default;
 
 		bool doCanRead(istream& stream) const noexcept override;
@@ -20,6 +22,10 @@ namespace octoon
 	private:
 		PNGHandler(const PNGHandler&) noexcept = delete;
 		PNGHandler& operator=(const PNGHandler&) noexcept = delete;
+
+	private:
+		const char* typeName_;
+		int compressionLevel_;
 	};
 }
 
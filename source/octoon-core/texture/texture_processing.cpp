@@ -0,0 +1,1116 @@
+#include <octoon/texture/texture_processing.h>
+#include <octoon/runtime/except.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#	include <emmintrin.h>
+#endif
+
+namespace octoon
+{
+	namespace
+	{
+		constexpr std::int64_t ParallelThreshold = 16384;
+		constexpr float Pi = 3.14159265358979323846f;
+
+		// Pixels are processed as four floats whatever the channel count, so every filter tap is one vector multiply-add.
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+		struct Vec4
+		{
+			__m128 v;
+		};
+
+		inline Vec4 zero4() noexcept { return Vec4{ _mm_setzero_ps() }; }
+		inline Vec4 load4(const float* ptr) noexcept { return Vec4{ _mm_loadu_ps(ptr) }; }
+		inline void store4(float* ptr, Vec4 a) noexcept { _mm_storeu_ps(ptr, a.v); }
+		inline Vec4 madd4(Vec4 acc, Vec4 a, float w) noexcept { return Vec4{ _mm_add_ps(acc.v, _mm_mul_ps(a.v, _mm_set1_ps(w))) }; }
+#else
+		struct Vec4
+		{
+			float v[4];
+		};
+
+		inline Vec4 zero4() noexcept { return Vec4{ { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+		inline Vec4 load4(const float* ptr) noexcept { return Vec4{ { ptr[0], ptr[1], ptr[2], ptr[3] } }; }
+		inline void store4(float* ptr, Vec4 a) noexcept { std::memcpy(ptr, a.v, sizeof(a.v)); }
+		inline Vec4 madd4(Vec4 acc, Vec4 a, float w) noexcept { return Vec4{ { acc.v[0] + a.v[0] * w, acc.v[1] + a.v[1] * w, acc.v[2] + a.v[2] * w, acc.v[3] + a.v[3] * w } }; }
+#endif
+
+		struct PixelLayout
+		{
+			std::uint8_t channels;
+			std::uint8_t alpha;
+			bool isFloat;
+			bool srgb;
+		};
+
+		bool getPixelLayout(const Format& format, PixelLayout& layout) noexcept
+		{
+			if (format == Format::Undefined)
+				return false;
+
+			auto valueType = format.value_type();
+			auto typeSize = format.type_size();
+			auto channels = format.channel();
+
+			if (channels < 1 || channels > 4)
+				return false;
+
+			if ((valueType == value_t::UNorm || valueType == value_t::SRGB) && typeSize == 1)
+				layout.isFloat = false;
+			else if (valueType == value_t::Float && typeSize == 4)
+				layout.isFloat = true;
+			else
+				return false;
+
+			layout.channels = channels;
+			layout.srgb = valueType == value_t::SRGB;
+			layout.alpha = 4;
+
+			if (channels == 4)
+				layout.alpha = 3;
+			else if (format >= Format::L8A8UNorm && format <= Format::L8A8SRGB)
+				layout.alpha = 1;
+			else if (format >= Format::A8UNorm && format <= Format::A8SRGB)
+				layout.alpha = 0;
+
+			return true;
+		}
+
+		const float* getSrgbTable() noexcept
+		{
+			static const auto table = []()
+			{
+				std::array<float, 256> values;
+				for (std::size_t i = 0; i < values.size(); i++)
+				{
+					auto c = i / 255.0f;
+					values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				}
+
+				return values;
+			}();
+
+			return table.data();
+		}
+
+		inline float linearToSrgb(float c) noexcept
+		{
+			c = std::clamp(c, 0.0f, 1.0f);
+			return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+		}
+
+		std::size_t getLevelSize(const Format& format, std::uint32_t width, std::uint32_t height) noexcept
+		{
+			if (format.value_type() == value_t::Compressed)
+			{
+				std::size_t blockSize = 16;
+				if (format >= Format::BC1RGBUNormBlock && format <= Format::BC1RGBASRGBBlock)
+					blockSize = 8;
+				else if (format == Format::BC4UNormBlock || format == Format::BC4SNormBlock)
+					blockSize = 8;
+
+				return std::size_t((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+			}
+
+			return std::size_t(width) * height * format.channel() * format.type_size();
+		}
+
+		// Texture keeps every layer of a level next to each other, level after level.
+		std::size_t getLevelOffset(const Format& format, std::uint32_t width, std::uint32_t height, std::uint32_t mip, std::uint32_t layers, std::uint32_t layer) noexcept
+		{
+			std::size_t offset = 0;
+
+			for (std::uint32_t i = 0; i < mip; i++)
+			{
+				offset += getLevelSize(format, width, height) * layers;
+				width = std::max(width >> 1, 1u);
+				height = std::max(height >> 1, 1u);
+			}
+
+			return offset + getLevelSize(format, width, height) * layer;
+		}
+
+		void decodePixels(const std::uint8_t* src, const PixelLayout& layout, std::size_t count, float* dst) noexcept
+		{
+			auto numPixels = static_cast<std::int64_t>(count);
+
+			if (layout.isFloat)
+			{
+				auto data = reinterpret_cast<const float*>(src);
+
+#				pragma omp parallel for schedule(static) if(numPixels >= ParallelThreshold)
+				for (std::int64_t i = 0; i < numPixels; i++)
+				{
+					float pixel[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+					for (std::uint8_t c = 0; c < layout.channels; c++)
+						pixel[c] = data[i * layout.channels + c];
+					std::memcpy(dst + i * 4, pixel, sizeof(pixel));
+				}
+			}
+			else
+			{
+				auto table = getSrgbTable();
+				bool premultiply = layout.alpha < layout.channels && layout.channels > 1;
+
+#				pragma omp parallel for schedule(static) if(numPixels >= ParallelThreshold)
+				for (std::int64_t i = 0; i < numPixels; i++)
+				{
+					float pixel[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+					for (std::uint8_t c = 0; c < layout.channels; c++)
+					{
+						auto value = src[i * layout.channels + c];
+						pixel[c] = (layout.srgb && c != layout.alpha) ? table[value] : value / 255.0f;
+					}
+
+					// colour is weighted by coverage so transparent texels do not bleed into the smaller levels
+					if (premultiply)
+					{
+						for (std::uint8_t c = 0; c < layout.channels; c++)
+						{
+							if (c != layout.alpha)
+								pixel[c] *= pixel[layout.alpha];
+						}
+					}
+
+					std::memcpy(dst + i * 4, pixel, sizeof(pixel));
+				}
+			}
+		}
+
+		void encodePixels(const float* src, const PixelLayout& layout, std::size_t count, std::uint8_t* dst) noexcept
+		{
+			auto numPixels = static_cast<std::int64_t>(count);
+
+			if (layout.isFloat)
+			{
+				auto data = reinterpret_cast<float*>(dst);
+
+#				pragma omp parallel for schedule(static) if(numPixels >= ParallelThreshold)
+				for (std::int64_t i = 0; i < numPixels; i++)
+				{
+					for (std::uint8_t c = 0; c < layout.channels; c++)
+						data[i * layout.channels + c] = src[i * 4 + c];
+				}
+			}
+			else
+			{
+				bool premultiply = layout.alpha < layout.channels && layout.channels > 1;
+
+#				pragma omp parallel for schedule(static) if(numPixels >= ParallelThreshold)
+				for (std::int64_t i = 0; i < numPixels; i++)
+				{
+					float pixel[4];
+					std::memcpy(pixel, src + i * 4, sizeof(pixel));
+
+					if (premultiply)
+					{
+						auto alpha = pixel[layout.alpha];
+						auto rcp = alpha > 1e-6f ? 1.0f / alpha : 0.0f;
+
+						for (std::uint8_t c = 0; c < layout.channels; c++)
+						{
+							if (c != layout.alpha)
+								pixel[c] *= rcp;
+						}
+					}
+
+					for (std::uint8_t c = 0; c < layout.channels; c++)
+					{
+						auto value = (layout.srgb && c != layout.alpha) ? linearToSrgb(pixel[c]) : std::clamp(pixel[c], 0.0f, 1.0f);
+						dst[i * layout.channels + c] = static_cast<std::uint8_t>(value * 255.0f + 0.5f);
+					}
+				}
+			}
+		}
+
+		float getFilterRadius(TextureFilter filter) noexcept
+		{
+			switch (filter)
+			{
+			case TextureFilter::Box: return 0.5f;
+			case TextureFilter::Triangle: return 1.0f;
+			case TextureFilter::Kaiser: return 3.0f;
+			case TextureFilter::Lanczos: return 3.0f;
+			default:
+				return 1.0f;
+			}
+		}
+
+		inline float sinc(float x) noexcept
+		{
+			if (std::abs(x) < 1e-5f)
+				return 1.0f;
+			return std::sin(Pi * x) / (Pi * x);
+		}
+
+		float bessel0(float x) noexcept
+		{
+			float sum = 1.0f;
+			float term = 1.0f;
+			float y = x * x * 0.25f;
+
+			for (int k = 1; k < 32 && term > sum * 1e-8f; k++)
+			{
+				term *= y / float(k * k);
+				sum += term;
+			}
+
+			return sum;
+		}
+
+		float evalFilter(TextureFilter filter, float x) noexcept
+		{
+			x = std::abs(x);
+
+			switch (filter)
+			{
+			case TextureFilter::Box:
+				return x <= 0.5f ? 1.0f : 0.0f;
+			case TextureFilter::Triangle:
+				return std::max(0.0f, 1.0f - x);
+			case TextureFilter::Kaiser:
+			{
+				constexpr float alpha = 4.0f;
+				constexpr float radius = 3.0f;
+				if (x >= radius)
+					return 0.0f;
+
+				auto t = x / radius;
+				return sinc(x) * bessel0(alpha * std::sqrt(1.0f - t * t)) / bessel0(alpha);
+			}
+			case TextureFilter::Lanczos:
+				return x < 3.0f ? sinc(x) * sinc(x / 3.0f) : 0.0f;
+			default:
+				return 0.0f;
+			}
+		}
+
+		// Source taps of every destination texel along one axis, clamped to the edge and normalized.
+		struct FilterTaps
+		{
+			std::vector<std::uint32_t> begin;
+			std::vector<std::uint32_t> index;
+			std::vector<float> weight;
+		};
+
+		FilterTaps computeTaps(std::uint32_t srcSize, std::uint32_t dstSize, TextureFilter filter) noexcept
+		{
+			FilterTaps taps;
+			taps.begin.reserve(dstSize + 1);
+
+			auto scale = float(srcSize) / float(dstSize);
+			auto filterScale = std::max(scale, 1.0f);
+			auto support = getFilterRadius(filter) * filterScale;
+
+			for (std::uint32_t i = 0; i < dstSize; i++)
+			{
+				auto first = taps.weight.size();
+				taps.begin.push_back(static_cast<std::uint32_t>(first));
+
+				auto center = (i + 0.5f) * scale;
+				auto lo = static_cast<std::int64_t>(std::floor(center - support));
+				auto hi = static_cast<std::int64_t>(std::ceil(center + support));
+
+				float sum = 0.0f;
+
+				for (auto j = lo; j <= hi; j++)
+				{
+					auto w = evalFilter(filter, (j + 0.5f - center) / filterScale);
+					if (w == 0.0f)
+						continue;
+
+					taps.index.push_back(static_cast<std::uint32_t>(std::clamp<std::int64_t>(j, 0, srcSize - 1)));
+					taps.weight.push_back(w);
+					sum += w;
+				}
+
+				if (std::abs(sum) < 1e-6f)
+				{
+					taps.index.resize(first);
+					taps.weight.resize(first);
+					taps.index.push_back(std::min(static_cast<std::uint32_t>(center), srcSize - 1));
+					taps.weight.push_back(1.0f);
+				}
+				else
+				{
+					for (auto k = first; k < taps.weight.size(); k++)
+						taps.weight[k] /= sum;
+				}
+			}
+
+			taps.begin.push_back(static_cast<std::uint32_t>(taps.weight.size()));
+			return taps;
+		}
+
+		std::vector<float> resamplePixels(const std::vector<float>& src, std::uint32_t srcWidth, std::uint32_t srcHeight, std::uint32_t dstWidth, std::uint32_t dstHeight, TextureFilter filter) noexcept
+		{
+			std::vector<float> rows;
+
+			if (srcWidth != dstWidth)
+			{
+				auto taps = computeTaps(srcWidth, dstWidth, filter);
+				auto numRows = static_cast<std::int64_t>(srcHeight);
+
+				rows.resize(std::size_t(dstWidth) * srcHeight * 4);
+
+#				pragma omp parallel for schedule(static) if(std::int64_t(dstWidth) * srcHeight >= ParallelThreshold)
+				for (std::int64_t y = 0; y < numRows; y++)
+				{
+					auto srcRow = src.data() + y * srcWidth * 4;
+					auto dstRow = rows.data() + y * dstWidth * 4;
+
+					for (std::uint32_t x = 0; x < dstWidth; x++)
+					{
+						auto acc = zero4();
+						for (auto k = taps.begin[x]; k < taps.begin[x + 1]; k++)
+							acc = madd4(acc, load4(srcRow + taps.index[k] * 4), taps.weight[k]);
+						store4(dstRow + x * 4, acc);
+					}
+				}
+			}
+			else
+			{
+				rows = src;
+			}
+
+			if (srcHeight == dstHeight)
+				return rows;
+
+			auto taps = computeTaps(srcHeight, dstHeight, filter);
+			auto numRows = static_cast<std::int64_t>(dstHeight);
+			auto rowSize = std::size_t(dstWidth) * 4;
+
+			std::vector<float> dst(rowSize * dstHeight);
+
+#			pragma omp parallel for schedule(static) if(std::int64_t(dstWidth) * dstHeight >= ParallelThreshold)
+			for (std::int64_t y = 0; y < numRows; y++)
+			{
+				auto dstRow = dst.data() + y * rowSize;
+
+				for (auto k = taps.begin[y]; k < taps.begin[y + 1]; k++)
+				{
+					auto srcRow = rows.data() + taps.index[k] * rowSize;
+					auto w = taps.weight[k];
+
+					for (std::size_t n = 0; n < rowSize; n += 4)
+						store4(dstRow + n, madd4(load4(dstRow + n), load4(srcRow + n), w));
+				}
+			}
+
+			return dst;
+		}
+
+		// BC block encoders. Colours are handled as floats in 0-255 and endpoints are found along the
+		// principal axis of the block, then refined once by least squares against the chosen indices.
+		void computePrincipalAxis(const float (*points)[4], std::size_t count, std::size_t dims, float mean[4], float axis[4]) noexcept
+		{
+			for (std::size_t c = 0; c < 4; c++)
+				mean[c] = axis[c] = 0.0f;
+
+			for (std::size_t i = 0; i < count; i++)
+				for (std::size_t c = 0; c < dims; c++)
+					mean[c] += points[i][c];
+
+			for (std::size_t c = 0; c < dims; c++)
+				mean[c] /= float(std::max<std::size_t>(count, 1));
+
+			float cov[4][4] = {};
+			for (std::size_t i = 0; i < count; i++)
+			{
+				for (std::size_t a = 0; a < dims; a++)
+					for (std::size_t b = 0; b < dims; b++)
+						cov[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+			}
+
+			float v[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+			for (std::size_t iter = 0; iter < 8; iter++)
+			{
+				float r[4] = {};
+				for (std::size_t a = 0; a < dims; a++)
+					for (std::size_t b = 0; b < dims; b++)
+						r[a] += cov[a][b] * v[b];
+
+				float len = 0.0f;
+				for (std::size_t a = 0; a < dims; a++)
+					len = std::max(len, std::abs(r[a]));
+
+				if (len < 1e-8f)
+					break;
+
+				for (std::size_t a = 0; a < dims; a++)
+					v[a] = r[a] / len;
+			}
+
+			float len = 0.0f;
+			for (std::size_t a = 0; a < dims; a++)
+				len += v[a] * v[a];
+
+			len = std::sqrt(len);
+			for (std::size_t a = 0; a < dims; a++)
+				axis[a] = len > 0.0f ? v[a] / len : 0.0f;
+		}
+
+		void computeEndpoints(const float (*points)[4], std::size_t count, std::size_t dims, float e0[4], float e1[4]) noexcept
+		{
+			float mean[4], axis[4];
+			computePrincipalAxis(points, count, dims, mean, axis);
+
+			float lo = 0.0f, hi = 0.0f;
+			for (std::size_t i = 0; i < count; i++)
+			{
+				float t = 0.0f;
+				for (std::size_t c = 0; c < dims; c++)
+					t += (points[i][c] - mean[c]) * axis[c];
+
+				lo = std::min(lo, t);
+				hi = std::max(hi, t);
+			}
+
+			for (std::size_t c = 0; c < 4; c++)
+			{
+				e0[c] = std::clamp(mean[c] + axis[c] * hi, 0.0f, 255.0f);
+				e1[c] = std::clamp(mean[c] + axis[c] * lo, 0.0f, 255.0f);
+			}
+		}
+
+		// Solves for the two endpoints that best reproduce the points given a weight (towards e0) per point.
+		bool refineEndpoints(const float (*points)[4], const float* weights, std::size_t count, std::size_t dims, float e0[4], float e1[4]) noexcept
+		{
+			float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+			float ax[4] = {}, bx[4] = {};
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				auto a = weights[i];
+				auto b = 1.0f - a;
+
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+
+				for (std::size_t c = 0; c < dims; c++)
+				{
+					ax[c] += a * points[i][c];
+					bx[c] += b * points[i][c];
+				}
+			}
+
+			auto det = aa * bb - ab * ab;
+			if (std::abs(det) < 1e-6f)
+				return false;
+
+			auto rcp = 1.0f / det;
+			for (std::size_t c = 0; c < dims; c++)
+			{
+				e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) * rcp, 0.0f, 255.0f);
+				e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) * rcp, 0.0f, 255.0f);
+			}
+
+			return true;
+		}
+
+		inline std::uint16_t packRGB565(const float c[4]) noexcept
+		{
+			auto r = static_cast<std::uint16_t>(std::clamp(c[0] * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f));
+			auto g = static_cast<std::uint16_t>(std::clamp(c[1] * (63.0f / 255.0f) + 0.5f, 0.0f, 63.0f));
+			auto b = static_cast<std::uint16_t>(std::clamp(c[2] * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f));
+			return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+		}
+
+		inline void unpackRGB565(std::uint16_t v, float c[3]) noexcept
+		{
+			auto r = (v >> 11) & 31;
+			auto g = (v >> 5) & 63;
+			auto b = v & 31;
+			c[0] = float((r << 3) | (r >> 2));
+			c[1] = float((g << 2) | (g >> 4));
+			c[2] = float((b << 3) | (b >> 2));
+		}
+
+		// Picks the nearest palette entry for every point and returns the total squared error.
+		// A mask bit marks a point as transparent, which always maps to index 3 in three colour mode.
+		float selectBC1Indices(const float (*points)[4], std::uint16_t mask, std::uint16_t c0, std::uint16_t c1, bool threeColor, std::uint8_t indices[16]) noexcept
+		{
+			float palette[4][3];
+			unpackRGB565(c0, palette[0]);
+			unpackRGB565(c1, palette[1]);
+
+			for (std::size_t c = 0; c < 3; c++)
+			{
+				if (threeColor)
+				{
+					palette[2][c] = (palette[0][c] + palette[1][c]) * 0.5f;
+					palette[3][c] = 0.0f;
+				}
+				else
+				{
+					palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+					palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+				}
+			}
+
+			float error = 0.0f;
+
+			for (std::size_t i = 0; i < 16; i++)
+			{
+				if (mask & (1 << i))
+				{
+					indices[i] = 3;
+					continue;
+				}
+
+				float best = 1e30f;
+				for (std::uint8_t k = 0; k < (threeColor ? 3 : 4); k++)
+				{
+					auto dr = points[i][0] - palette[k][0];
+					auto dg = points[i][1] - palette[k][1];
+					auto db = points[i][2] - palette[k][2];
+					auto d = dr * dr + dg * dg + db * db;
+					if (d < best)
+					{
+						best = d;
+						indices[i] = k;
+					}
+				}
+
+				error += best;
+			}
+
+			return error;
+		}
+
+		void encodeBC1(const std::uint8_t rgba[16][4], bool allowAlpha, std::uint8_t* out) noexcept
+		{
+			float points[16][4];
+			float opaque[16][4];
+			std::size_t numOpaque = 0;
+			std::uint16_t mask = 0;
+
+			for (std::size_t i = 0; i < 16; i++)
+			{
+				for (std::size_t c = 0; c < 4; c++)
+					points[i][c] = rgba[i][c];
+
+				if (allowAlpha && rgba[i][3] < 128)
+					mask |= 1 << i;
+				else
+					std::memcpy(opaque[numOpaque++], points[i], sizeof(points[i]));
+			}
+
+			bool threeColor = mask != 0;
+
+			std::uint16_t c0 = 0, c1 = 0;
+			std::uint8_t indices[16];
+
+			for (std::size_t i = 0; i < 16; i++)
+				indices[i] = (mask & (1 << i)) ? 3 : 0;
+
+			if (numOpaque > 0)
+			{
+				float e0[4], e1[4];
+				computeEndpoints(opaque, numOpaque, 3, e0, e1);
+
+				c0 = packRGB565(e0);
+				c1 = packRGB565(e1);
+				auto error = selectBC1Indices(points, mask, c0, c1, threeColor, indices);
+
+				float weights[16];
+				const float table[2][4] = { { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f }, { 1.0f, 0.0f, 0.5f, 0.0f } };
+
+				std::size_t n = 0;
+				for (std::size_t i = 0; i < 16; i++)
+				{
+					if (!(mask & (1 << i)))
+						weights[n++] = table[threeColor][indices[i]];
+				}
+
+				if (refineEndpoints(opaque, weights, numOpaque, 3, e0, e1))
+				{
+					std::uint8_t refined[16];
+					auto r0 = packRGB565(e0);
+					auto r1 = packRGB565(e1);
+					auto refinedError = selectBC1Indices(points, mask, r0, r1, threeColor, refined);
+					if (refinedError < error)
+					{
+						c0 = r0;
+						c1 = r1;
+						std::memcpy(indices, refined, sizeof(indices));
+					}
+				}
+			}
+
+			// the endpoint order selects the mode: c0 > c1 is four colour, otherwise three colour with transparency
+			if (threeColor ? c0 > c1 : c0 < c1)
+			{
+				std::swap(c0, c1);
+				for (auto& index : indices)
+				{
+					if (index < 2)
+						index ^= 1;
+					else if (!threeColor)
+						index ^= 1;
+				}
+			}
+			else if (!threeColor && c0 == c1)
+			{
+				std::memset(indices, 0, sizeof(indices));
+			}
+
+			std::uint32_t bits = 0;
+			for (std::size_t i = 0; i < 16; i++)
+				bits |= std::uint32_t(indices[i]) << (i * 2);
+
+			out[0] = static_cast<std::uint8_t>(c0 & 0xFF);
+			out[1] = static_cast<std::uint8_t>(c0 >> 8);
+			out[2] = static_cast<std::uint8_t>(c1 & 0xFF);
+			out[3] = static_cast<std::uint8_t>(c1 >> 8);
+			std::memcpy(out + 4, &bits, sizeof(bits));
+		}
+
+		void encodeBC4(const std::uint8_t values[16], std::uint8_t* out) noexcept
+		{
+			auto lo = *std::min_element(values, values + 16);
+			auto hi = *std::max_element(values, values + 16);
+
+			out[0] = hi;
+			out[1] = lo;
+
+			std::uint64_t bits = 0;
+
+			if (hi > lo)
+			{
+				float palette[8];
+				palette[0] = hi;
+				palette[1] = lo;
+				for (std::size_t k = 1; k < 7; k++)
+					palette[k + 1] = ((7 - k) * hi + k * lo) / 7.0f;
+
+				for (std::size_t i = 0; i < 16; i++)
+				{
+					std::uint64_t index = 0;
+					float best = 1e30f;
+					for (std::uint64_t k = 0; k < 8; k++)
+					{
+						auto d = std::abs(values[i] - palette[k]);
+						if (d < best)
+						{
+							best = d;
+							index = k;
+						}
+					}
+
+					bits |= index << (i * 3);
+				}
+			}
+
+			for (std::size_t i = 0; i < 6; i++)
+				out[2 + i] = static_cast<std::uint8_t>(bits >> (i * 8));
+		}
+
+		// BC7 mode 6: one subset, 7 bit RGBA endpoints with a p-bit each and 4 bit indices.
+		constexpr std::uint32_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		void quantizeBC7Endpoint(const float e[4], std::uint8_t q[4], std::uint8_t& p) noexcept
+		{
+			float bestError = 1e30f;
+
+			for (std::uint8_t bit = 0; bit < 2; bit++)
+			{
+				std::uint8_t candidate[4];
+				float error = 0.0f;
+
+				for (std::size_t c = 0; c < 4; c++)
+				{
+					candidate[c] = static_cast<std::uint8_t>(std::clamp((e[c] - bit) * 0.5f + 0.5f, 0.0f, 127.0f));
+					auto d = float((candidate[c] << 1) | bit) - e[c];
+					error += d * d;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					p = bit;
+					std::memcpy(q, candidate, sizeof(candidate));
+				}
+			}
+		}
+
+		float selectBC7Indices(const float (*points)[4], const std::uint8_t q0[4], std::uint8_t p0, const std::uint8_t q1[4], std::uint8_t p1, std::uint8_t indices[16]) noexcept
+		{
+			float palette[16][4];
+			for (std::size_t k = 0; k < 16; k++)
+			{
+				for (std::size_t c = 0; c < 4; c++)
+				{
+					std::uint32_t a = (q0[c] << 1) | p0;
+					std::uint32_t b = (q1[c] << 1) | p1;
+					palette[k][c] = float(((64 - BC7Weights[k]) * a + BC7Weights[k] * b + 32) >> 6);
+				}
+			}
+
+			float error = 0.0f;
+
+			for (std::size_t i = 0; i < 16; i++)
+			{
+				float best = 1e30f;
+				for (std::uint8_t k = 0; k < 16; k++)
+				{
+					float d = 0.0f;
+					for (std::size_t c = 0; c < 4; c++)
+					{
+						auto t = points[i][c] - palette[k][c];
+						d += t * t;
+					}
+
+					if (d < best)
+					{
+						best = d;
+						indices[i] = k;
+					}
+				}
+
+				error += best;
+			}
+
+			return error;
+		}
+
+		class BlockWriter final
+		{
+		public:
+			BlockWriter(std::uint8_t* out) noexcept
+				: out_(out)
+				, bit_(0)
+			{
+				std::memset(out_, 0, 16);
+			}
+
+			void write(std::uint32_t value, std::uint32_t bits) noexcept
+			{
+				for (std::uint32_t i = 0; i < bits; i++, bit_++)
+				{
+					if (value & (1u << i))
+						out_[bit_ >> 3] |= static_cast<std::uint8_t>(1u << (bit_ & 7));
+				}
+			}
+
+		private:
+			std::uint8_t* out_;
+			std::uint32_t bit_;
+		};
+
+		void encodeBC7(const std::uint8_t rgba[16][4], std::uint8_t* out) noexcept
+		{
+			float points[16][4];
+			for (std::size_t i = 0; i < 16; i++)
+				for (std::size_t c = 0; c < 4; c++)
+					points[i][c] = rgba[i][c];
+
+			float e0[4], e1[4];
+			computeEndpoints(points, 16, 4, e0, e1);
+
+			std::uint8_t q0[4], q1[4], p0 = 0, p1 = 0;
+			quantizeBC7Endpoint(e0, q0, p0);
+			quantizeBC7Endpoint(e1, q1, p1);
+
+			std::uint8_t indices[16];
+			auto error = selectBC7Indices(points, q0, p0, q1, p1, indices);
+
+			float weights[16];
+			for (std::size_t i = 0; i < 16; i++)
+				weights[i] = 1.0f - BC7Weights[indices[i]] / 64.0f;
+
+			if (refineEndpoints(points, weights, 16, 4, e0, e1))
+			{
+				std::uint8_t r0[4], r1[4], rp0 = 0, rp1 = 0, refined[16];
+				quantizeBC7Endpoint(e0, r0, rp0);
+				quantizeBC7Endpoint(e1, r1, rp1);
+
+				auto refinedError = selectBC7Indices(points, r0, rp0, r1, rp1, refined);
+				if (refinedError < error)
+				{
+					std::memcpy(q0, r0, sizeof(q0));
+					std::memcpy(q1, r1, sizeof(q1));
+					std::memcpy(indices, refined, sizeof(indices));
+					p0 = rp0;
+					p1 = rp1;
+				}
+			}
+
+			// the most significant bit of the first index is implied zero
+			if (indices[0] & 8)
+			{
+				std::swap(q0, q1);
+				std::swap(p0, p1);
+				for (auto& index : indices)
+					index = 15 - index;
+			}
+
+			BlockWriter writer(out);
+			writer.write(1 << 6, 7);
+
+			for (std::size_t c = 0; c < 4; c++)
+			{
+				writer.write(q0[c], 7);
+				writer.write(q1[c], 7);
+			}
+
+			writer.write(p0, 1);
+			writer.write(p1, 1);
+			writer.write(indices[0], 3);
+
+			for (std::size_t i = 1; i < 16; i++)
+				writer.write(indices[i], 4);
+		}
+
+		enum class BlockKind
+		{
+			BC1,
+			BC1A,
+			BC3,
+			BC4,
+			BC5,
+			BC7
+		};
+
+		bool getBlockKind(const Format& format, BlockKind& kind, std::size_t& blockSize) noexcept
+		{
+			switch (format)
+			{
+			case Format::BC1RGBUNormBlock:
+			case Format::BC1RGBSRGBBlock:
+				kind = BlockKind::BC1; blockSize = 8; return true;
+			case Format::BC1RGBAUNormBlock:
+			case Format::BC1RGBASRGBBlock:
+				kind = BlockKind::BC1A; blockSize = 8; return true;
+			case Format::BC3UNormBlock:
+			case Format::BC3SRGBBlock:
+				kind = BlockKind::BC3; blockSize = 16; return true;
+			case Format::BC4UNormBlock:
+				kind = BlockKind::BC4; blockSize = 8; return true;
+			case Format::BC5UNormBlock:
+				kind = BlockKind::BC5; blockSize = 16; return true;
+			case Format::BC7UNormBlock:
+			case Format::BC7SRGBBlock:
+				kind = BlockKind::BC7; blockSize = 16; return true;
+			default:
+				return false;
+			}
+		}
+
+		void gatherBlock(const std::uint8_t* src, std::uint32_t width, std::uint32_t height, std::uint8_t channels, swizzle_t swizzle, std::uint32_t bx, std::uint32_t by, std::uint8_t rgba[16][4]) noexcept
+		{
+			for (std::uint32_t y = 0; y < 4; y++)
+			{
+				for (std::uint32_t x = 0; x < 4; x++)
+				{
+					auto sx = std::min(bx * 4 + x, width - 1);
+					auto sy = std::min(by * 4 + y, height - 1);
+					auto pixel = src + (std::size_t(sy) * width + sx) * channels;
+					auto& dst = rgba[y * 4 + x];
+
+					dst[0] = pixel[0];
+					dst[1] = channels > 1 ? pixel[1] : 0;
+					dst[2] = channels > 2 ? pixel[2] : 0;
+					dst[3] = channels > 3 ? pixel[3] : 255;
+
+					if (swizzle == swizzle_t::BGR || swizzle == swizzle_t::BGRA)
+						std::swap(dst[0], dst[2]);
+				}
+			}
+		}
+	}
+
+	bool
+	isFilterableFormat(const Format& format) noexcept
+	{
+		PixelLayout layout;
+		return getPixelLayout(format, layout);
+	}
+
+	bool
+	isCompressibleFormat(const Format& src, const Format& dst) noexcept
+	{
+		PixelLayout layout;
+		if (!getPixelLayout(src, layout) || layout.isFloat)
+			return false;
+
+		auto swizzle = src.swizzle_type();
+		if (swizzle != swizzle_t::R && swizzle != swizzle_t::RG && swizzle != swizzle_t::RGB && swizzle != swizzle_t::BGR && swizzle != swizzle_t::RGBA && swizzle != swizzle_t::BGRA)
+			return false;
+
+		BlockKind kind;
+		std::size_t blockSize;
+		return getBlockKind(dst, kind, blockSize);
+	}
+
+	Texture
+	resampleTexture(const Texture& texture, std::uint32_t width, std::uint32_t height, TextureFilter filter) noexcept(false)
+	{
+		PixelLayout layout;
+		if (!getPixelLayout(texture.format(), layout) || texture.depth() != 1)
+			throw runtime_error::create("This texture format cannot be resampled.");
+
+		if (width == 0 || height == 0 || texture.width() == 0 || texture.height() == 0)
+			return Texture();
+
+		auto layers = texture.getLayerLevel();
+
+		Texture image(texture.format(), width, height, 1, 1, layers, 0, texture.getLayerBase());
+
+		std::vector<float> pixels(std::size_t(texture.width()) * texture.height() * 4);
+
+		for (std::uint32_t layer = 0; layer < layers; layer++)
+		{
+			auto src = texture.data() + getLevelOffset(texture.format(), texture.width(), texture.height(), 0, layers, layer);
+			auto dst = image.data() + getLevelOffset(image.format(), width, height, 0, layers, layer);
+
+			decodePixels(src, layout, std::size_t(texture.width()) * texture.height(), pixels.data());
+			auto result = resamplePixels(pixels, texture.width(), texture.height(), width, height, filter);
+			encodePixels(result.data(), layout, std::size_t(width) * height, dst);
+		}
+
+		return image;
+	}
+
+	Texture
+	generateMipmaps(const Texture& texture, std::uint32_t mipLevel, TextureFilter filter) noexcept(false)
+	{
+		PixelLayout layout;
+		if (!getPixelLayout(texture.format(), layout) || texture.depth() != 1)
+			throw runtime_error::create("This texture format cannot be filtered.");
+
+		auto width = texture.width();
+		auto height = texture.height();
+		auto layers = texture.getLayerLevel();
+
+		std::uint32_t numLevels = 1;
+		while ((std::max(width, height) >> numLevels) > 0)
+			numLevels++;
+
+		if (mipLevel > 0)
+			numLevels = std::min(numLevels, mipLevel);
+
+		Texture image(texture.format(), width, height, 1, numLevels, layers, texture.getMipBase(), texture.getLayerBase());
+
+		auto firstLevelSize = getLevelSize(texture.format(), width, height) * layers;
+		std::memcpy(image.data(), texture.data(), firstLevelSize);
+
+		for (std::uint32_t layer = 0; layer < layers; layer++)
+		{
+			std::vector<float> pixels(std::size_t(width) * height * 4);
+			decodePixels(texture.data() + getLevelOffset(texture.format(), width, height, 0, layers, layer), layout, std::size_t(width) * height, pixels.data());
+
+			auto w = width;
+			auto h = height;
+
+			for (std::uint32_t mip = 1; mip < numLevels; mip++)
+			{
+				auto nw = std::max(w >> 1, 1u);
+				auto nh = std::max(h >> 1, 1u);
+
+				pixels = resamplePixels(pixels, w, h, nw, nh, filter);
+				encodePixels(pixels.data(), layout, std::size_t(nw) * nh, image.data() + getLevelOffset(image.format(), width, height, mip, layers, layer));
+
+				w = nw;
+				h = nh;
+			}
+		}
+
+		return image;
+	}
+
+	Texture
+	compressTexture(const Texture& texture, Format format) noexcept(false)
+	{
+		if (!isCompressibleFormat(texture.format(), format) || texture.depth() != 1)
+			throw runtime_error::create("This texture format cannot be compressed to the requested format.");
+
+		BlockKind kind;
+		std::size_t blockSize;
+		getBlockKind(format, kind, blockSize);
+
+		auto width = texture.width();
+		auto height = texture.height();
+		auto layers = texture.getLayerLevel();
+		auto mipLevel = texture.getMipLevel();
+		auto channels = texture.format().channel();
+		auto swizzle = texture.format().swizzle_type();
+
+		Texture image(format, width, height, 1, mipLevel, layers, texture.getMipBase(), texture.getLayerBase());
+
+		for (std::uint32_t mip = 0; mip < mipLevel; mip++)
+		{
+			auto w = std::max(width >> mip, 1u);
+			auto h = std::max(height >> mip, 1u);
+			auto blocksX = (w + 3) / 4;
+			auto blocksY = static_cast<std::int64_t>((h + 3) / 4);
+
+			for (std::uint32_t layer = 0; layer < layers; layer++)
+			{
+				auto src = texture.data() + getLevelOffset(texture.format(), width, height, mip, layers, layer);
+				auto dst = image.data() + getLevelOffset(format, width, height, mip, layers, layer);
+
+#				pragma omp parallel for schedule(dynamic) if(blocksX * blocksY >= ParallelThreshold / 16)
+				for (std::int64_t by = 0; by < blocksY; by++)
+				{
+					for (std::uint32_t bx = 0; bx < blocksX; bx++)
+					{
+						std::uint8_t rgba[16][4];
+						gatherBlock(src, w, h, channels, swizzle, bx, static_cast<std::uint32_t>(by), rgba);
+
+						auto out = dst + (by * blocksX + bx) * blockSize;
+
+						switch (kind)
+						{
+						case BlockKind::BC1:
+							encodeBC1(rgba, false, out);
+							break;
+						case BlockKind::BC1A:
+							encodeBC1(rgba, true, out);
+							break;
+						case BlockKind::BC3:
+						{
+							std::uint8_t alpha[16];
+							for (std::size_t i = 0; i < 16; i++)
+								alpha[i] = rgba[i][3];
+							encodeBC4(alpha, out);
+							encodeBC1(rgba, false, out + 8);
+						}
+						break;
+						case BlockKind::BC4:
+						{
+							std::uint8_t red[16];
+							for (std::size_t i = 0; i < 16; i++)
+								red[i] = rgba[i][0];
+							encodeBC4(red, out);
+						}
+						break;
+						case BlockKind::BC5:
+						{
+							std::uint8_t red[16], green[16];
+							for (std::size_t i = 0; i < 16; i++)
+							{
+								red[i] = rgba[i][0];
+								green[i] = rgba[i][1];
+							}
+							encodeBC4(red, out);
+							encodeBC4(green, out + 8);
+						}
+						break;
+						case BlockKind::BC7:
+							encodeBC7(rgba, out);
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		return image;
+	}
+}
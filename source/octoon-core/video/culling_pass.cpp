@@ -0,0 +1,129 @@
+#include <octoon/video/culling_pass.h>
+#include <octoon/light/point_light.h>
+#include <octoon/light/spot_light.h>
+#include <octoon/light/directional_light.h>
+#include <algorithm>
+#include <thread>
+
+namespace octoon
+{
+	namespace
+	{
+		constexpr std::size_t ParallelThreshold = 256;
+
+		const Camera* getShadowCamera(const Light& light) noexcept
+		{
+			if (light.isA<DirectionalLight>())
+			{
+				auto directionalLight = light.downcast<DirectionalLight>();
+				if (directionalLight->getShadowEnable())
+					return directionalLight->getCamera().get();
+			}
+			else if (light.isA<SpotLight>())
+			{
+				auto spotLight = light.downcast<SpotLight>();
+				if (spotLight->getShadowEnable())
+					return spotLight->getCamera().get();
+			}
+			else if (light.isA<PointLight>())
+			{
+				auto pointLight = light.downcast<PointLight>();
+				if (pointLight->getShadowEnable())
+					return pointLight->getCamera().get();
+			}
+
+			return nullptr;
+		}
+	}
+
+	CullingPass::CullingPass() noexcept
+		: threads_(0)
+	{
+	}
+
+	void
+	CullingPass::setThreadCount(std::uint32_t count) noexcept
+	{
+		threads_ = count;
+	}
+
+	std::uint32_t
+	CullingPass::getThreadCount() const noexcept
+	{
+		return threads_;
+	}
+
+	void
+	CullingPass::Execute(RenderingData& renderingData) noexcept
+	{
+		renderingData.numCulled = 0;
+		renderingData.numDrawn = 0;
+		renderingData.cullingResults.clear();
+
+		if (renderingData.camera)
+			this->cull(*renderingData.camera, renderingData.geometries, renderingData.cullingResults[renderingData.camera]);
+
+		for (auto& light : renderingData.lights)
+		{
+			if (!light->getVisible())
+				continue;
+
+			auto camera = getShadowCamera(*light);
+			if (camera && renderingData.cullingResults.find(camera) == renderingData.cullingResults.end())
+				this->cull(*camera, renderingData.geometries, renderingData.cullingResults[camera]);
+		}
+
+		for (auto& it : renderingData.cullingResults)
+		{
+			renderingData.numCulled += it.second.numCulled;
+			renderingData.numDrawn += it.second.numDrawn;
+		}
+	}
+
+	void
+	CullingPass::cull(const Camera& camera, const std::vector<Geometry*>& geometries, RenderingData::CullingResults& out) noexcept
+	{
+		math::Frustum frustum(camera.getViewProjection());
+
+		auto layer = camera.getLayer();
+		auto numGeometries = static_cast<std::int64_t>(geometries.size());
+		auto numThreads = threads_ > 0 ? threads_ : std::max(1u, std::thread::hardware_concurrency() / 2);
+
+		visibles_.resize(geometries.size());
+		auto visibles = visibles_.data();
+
+		std::int64_t numCulled = 0;
+
+#		pragma omp parallel for num_threads(numThreads) schedule(static) reduction(+:numCulled) if(geometries.size() >= ParallelThreshold)
+		for (std::int64_t i = 0; i < numGeometries; i++)
+		{
+			auto geometry = geometries[i];
+
+			visibles[i] = 0;
+
+			if (geometry->getLayer() != layer || !geometry->getVisible())
+				continue;
+
+			// unbounded geometries such as an empty mesh are never culled
+			auto& bound = geometry->getBoundingBox();
+			if (!bound.empty() && !math::intersects(frustum, math::transform(bound.box(), geometry->getTransform())))
+			{
+				numCulled++;
+				continue;
+			}
+
+			visibles[i] = 1;
+		}
+
+		out.geometries.clear();
+		out.numCulled = static_cast<std::size_t>(numCulled);
+
+		for (std::size_t i = 0; i < geometries.size(); i++)
+		{
+			if (visibles[i])
+				out.geometries.push_back(geometries[i]);
+		}
+
+		out.numDrawn = out.geometries.size();
+	}
+}
@@ -19,11 +19,15 @@ namespace octoon
 			context.configureClear(camera->getClearFlags(), camera->getClearColor(), 1.0f, 0);
 			context.setViewport(0, math::float4((float)vp.x, (float)vp.y, (float)vp.width, (float)vp.height));
 
-			for (auto& geometry : renderingData.geometries)
+			geometries_.clear();
+
+			for (auto& geometry : renderingData.getVisibleGeometries(*camera))
 			{
 				if (geometry->getRendererPriority() < 1)
-					context.drawRenderers(*geometry, *camera, renderingData);
+					geometries_.push_back(geometry);
 			}
+
+			context.drawRenderers(geometries_, *camera, renderingData);
 		}
 	}
 }
\ No newline at end of file
@@ -81,7 +81,7 @@ namespace octoon
 		context.configureClear(ClearFlagBits::AllBit, math::float4::Zero, 1.0f, 0);
 		context.setViewport(0, math::float4((float)vp.x, (float)vp.y, (float)vp.width, (float)vp.height));
 
-		for (auto& geometry : renderingData.geometries)
+		for (auto& geometry : renderingData.getVisibleGeometries(*camera))
 		{
 			if (geometry->getRendererPriority() == 1)
 				context.drawRenderers(*geometry, *camera, renderingData);
@@ -33,6 +33,7 @@ namespace octoon
 		, framebufferWidth_(0)
 		, framebufferHeight_(0)
 	{
+		cullingPass_ = std::make_unique<CullingPass>();
 		lightsShadowCasterPass_ = std::make_unique<LightsShadowCasterPass>();
 		drawOpaquePass_ = std::make_unique<DrawObjectPass>(true);
 		drawTranparentPass_ = std::make_unique<DrawObjectPass>(false);
@@ -70,6 +71,12 @@ namespace octoon
 		return this->edgeFramebuffer_;
 	}
 
+	const ScriptableRenderContext::Statistics&
+	ForwardRenderer::getStatistics() const noexcept
+	{
+		return this->configs_.front().context->getStatistics();
+	}
+
 	void
 	ForwardRenderer::setWorkBufferSize(const std::shared_ptr<ScriptableRenderContext>& context, std::uint32_t w, std::uint32_t h) except
 	{
@@ -197,6 +204,9 @@ namespace octoon
 		{
 			auto& renderingData = c.controller->getCachedScene(scene);
 
+			c.context->resetStatistics();
+
+			cullingPass_->Execute(renderingData);
 			lightsShadowCasterPass_->Execute(*c.context, renderingData);
 			drawOpaquePass_->Execute(*c.context, renderingData);
 			drawTranparentPass_->Execute(*c.context, renderingData);
@@ -45,6 +45,11 @@ namespace octoon
 				}
 			}
 
+			if (faceCount == 0)
+				continue;
+
+			auto& geometries = renderingData.getVisibleGeometries(*camera);
+
 			for (std::uint32_t face = 0; face < faceCount; face++)
 			{
 				auto framebuffer = camera->getFramebuffer();
@@ -52,7 +57,7 @@ namespace octoon
 				{
 					context.configureTarget(framebuffer);
 					context.configureClear(camera->getClearFlags(), camera->getClearColor(), 1.0f, 0);
-					context.drawRenderers(renderingData.geometries, *camera, renderingData, renderingData.depthMaterial);
+					context.drawRenderers(geometries, *camera, renderingData, renderingData.depthMaterial);
 
 					if (camera->getRenderToScreen())
 					{
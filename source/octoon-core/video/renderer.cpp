@@ -1,6 +1,7 @@
 #include <octoon/video/renderer.h>
 #include <octoon/video/render_scene.h>
 #include <octoon/video/forward_renderer.h>
+#include <octoon/video/scriptable_program_cache.h>
 
 #include <octoon/runtime/except.h>
 
@@ -123,6 +124,8 @@ namespace octoon
 	void
 	Renderer::setCachePath(const std::filesystem::path& path)
 	{
+		ScriptableProgramCache::instance()->setCachePath(path.empty() ? path : path / "shaders");
+
 		if (pathRenderer_)
 			return pathRenderer_->setCachePath(path);
 		cachePath_ = path;
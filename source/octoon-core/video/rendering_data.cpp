@@ -4,7 +4,9 @@
 namespace octoon
 {
 	RenderingData::RenderingData() noexcept
-		:depthMaterial(std::make_shared<MeshDepthMaterial>())
+		: numCulled(0)
+		, numDrawn(0)
+		, depthMaterial(std::make_shared<MeshDepthMaterial>())
 	{
 	}
 
@@ -35,4 +37,13 @@ namespace octoon
 
 		this->lights.clear();
 	}
+
+	const std::vector<Geometry*>&
+	RenderingData::getVisibleGeometries(const Camera& camera) const noexcept
+	{
+		auto it = this->cullingResults.find(&camera);
+		if (it != this->cullingResults.end())
+			return (*it).second.geometries;
+		return this->geometries;
+	}
 }
\ No newline at end of file
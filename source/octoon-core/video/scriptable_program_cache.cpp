@@ -0,0 +1,212 @@
+#include <octoon/video/scriptable_program_cache.h>
+#include <octoon/hal/system_info.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace octoon
+{
+	OctoonImplementSingleton(ScriptableProgramCache)
+
+	namespace
+	{
+		constexpr std::uint32_t BinaryMagic = 0x4250434F; // "OCPB"
+		constexpr std::uint32_t BinaryVersion = 1;
+
+		struct BinaryHeader
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint32_t format;
+			std::uint32_t reserved;
+			std::uint64_t sourceSize;
+			std::uint64_t binarySize;
+		};
+
+		inline std::uint64_t fnv1a(std::string_view str, std::uint64_t hash = 14695981039346656037ull) noexcept
+		{
+			for (auto ch : str)
+			{
+				hash ^= static_cast<std::uint8_t>(ch);
+				hash *= 1099511628211ull;
+			}
+
+			return hash;
+		}
+
+		inline double elapsed(std::chrono::steady_clock::time_point start) noexcept
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+	}
+
+	ScriptableProgramCache::ScriptableProgramCache() noexcept
+	{
+		this->resetStatistics();
+	}
+
+	ScriptableProgramCache::~ScriptableProgramCache() noexcept
+	{
+	}
+
+	void
+	ScriptableProgramCache::setCachePath(const std::filesystem::path& path) noexcept
+	{
+		cachePath_ = path;
+	}
+
+	const std::filesystem::path&
+	ScriptableProgramCache::getCachePath() const noexcept
+	{
+		return cachePath_;
+	}
+
+	const ScriptableProgramCache::Statistics&
+	ScriptableProgramCache::getStatistics() const noexcept
+	{
+		return statistics_;
+	}
+
+	void
+	ScriptableProgramCache::resetStatistics() noexcept
+	{
+		statistics_.memoryHits = 0;
+		statistics_.diskHits = 0;
+		statistics_.compiles = 0;
+		statistics_.loadTime = 0.0;
+		statistics_.compileTime = 0.0;
+	}
+
+	void
+	ScriptableProgramCache::clear() noexcept
+	{
+		programs_.clear();
+	}
+
+	GraphicsProgramPtr
+	ScriptableProgramCache::getProgram(const GraphicsDevicePtr& device, const std::string& vertexShader, const std::string& fragmentShader) noexcept
+	{
+		auto& info = device->getSystemInfo();
+
+		// the light counts are already substituted into the sources, so they are part of the key
+		auto key = fnv1a(info.graphicsDeviceName);
+		key = fnv1a(info.graphicsDeviceVersion, key);
+		key = fnv1a(vertexShader, key);
+		key = fnv1a(std::string_view("\0", 1), key);
+		key = fnv1a(fragmentShader, key);
+
+		auto it = programs_.find(key);
+		if (it != programs_.end())
+		{
+			auto program = it->second.lock();
+			if (program && program->getDevice() == device)
+			{
+				statistics_.memoryHits++;
+				return program;
+			}
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		auto size = static_cast<std::uint64_t>(vertexShader.size() + fragmentShader.size());
+
+		std::filesystem::path path;
+		if (!cachePath_.empty())
+		{
+			char name[24];
+			std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+			path = cachePath_ / name;
+
+			auto program = this->loadProgram(device, path, size);
+			if (program)
+			{
+				statistics_.diskHits++;
+				statistics_.loadTime += elapsed(start);
+				programs_[key] = program;
+				return program;
+			}
+		}
+
+		GraphicsProgramDesc programDesc;
+		programDesc.addShader(device->createShader(GraphicsShaderDesc(ShaderStageFlagBits::VertexBit, vertexShader, "main", ShaderLanguage::GLSL)));
+		programDesc.addShader(device->createShader(GraphicsShaderDesc(ShaderStageFlagBits::FragmentBit, fragmentShader, "main", ShaderLanguage::GLSL)));
+
+		auto program = device->createProgram(programDesc);
+		if (program)
+		{
+			statistics_.compiles++;
+			statistics_.compileTime += elapsed(start);
+
+			if (!path.empty())
+				this->saveProgram(program, path, size);
+
+			programs_[key] = program;
+		}
+
+		return program;
+	}
+
+	GraphicsProgramPtr
+	ScriptableProgramCache::loadProgram(const GraphicsDevicePtr& device, const std::filesystem::path& path, std::uint64_t size) noexcept
+	{
+		std::ifstream stream(path, std::ios_base::in | std::ios_base::binary);
+		if (!stream)
+			return nullptr;
+
+		BinaryHeader header;
+		if (!stream.read((char*)&header, sizeof(header)))
+			return nullptr;
+
+		if (header.magic != BinaryMagic || header.version != BinaryVersion || header.sourceSize != size || header.binarySize == 0)
+			return nullptr;
+
+		std::vector<std::uint8_t> binary(header.binarySize);
+		if (!stream.read((char*)binary.data(), binary.size()))
+			return nullptr;
+
+		GraphicsProgramDesc programDesc;
+		programDesc.setProgramBinary(header.format, std::move(binary));
+
+		return device->createProgram(programDesc);
+	}
+
+	void
+	ScriptableProgramCache::saveProgram(const GraphicsProgramPtr& program, const std::filesystem::path& path, std::uint64_t size) noexcept
+	{
+		std::uint32_t format = 0;
+		std::vector<std::uint8_t> binary;
+		if (!program->getProgramBinary(format, binary))
+			return;
+
+		std::error_code ec;
+		std::filesystem::create_directories(path.parent_path(), ec);
+
+		// written next to the final name first so a crash never leaves a truncated binary behind
+		auto temp = path;
+		temp += ".tmp";
+
+		{
+			std::ofstream stream(temp, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+			if (!stream)
+				return;
+
+			BinaryHeader header;
+			std::memset(&header, 0, sizeof(header));
+			header.magic = BinaryMagic;
+			header.version = BinaryVersion;
+			header.format = format;
+			header.sourceSize = size;
+			header.binarySize = binary.size();
+
+			stream.write((const char*)&header, sizeof(header));
+			stream.write((const char*)binary.data(), binary.size());
+			if (!stream)
+				return;
+		}
+
+		std::filesystem::rename(temp, path, ec);
+		if (ec)
+			std::filesystem::remove(temp, ec);
+	}
+}
@@ -2,14 +2,44 @@
 #include <octoon/video/renderer.h>
 #include <octoon/hal/graphics_input_layout.h>
 #include <octoon/runtime/profiling_scope.h>
+#include <algorithm>
+#include <cstring>
 
 namespace octoon
 {
+	namespace
+	{
+		constexpr std::size_t VertexStride = 6;
+		constexpr std::size_t TexcoordStride = 4;
+		constexpr std::size_t SegmentAlignment = 256;
+
+		// Writes the interleaved values of vertex i into the shadow copy and widens the dirty
+		// range when they differ from the previous upload.
+		template<std::size_t N>
+		inline void writeShadow(float* shadow, const float(&value)[N], std::size_t i, std::size_t& first, std::size_t& last) noexcept
+		{
+			auto dst = shadow + i * N;
+			if (std::memcmp(dst, value, sizeof(value)) != 0)
+			{
+				std::memcpy(dst, value, sizeof(value));
+				first = std::min(first, i);
+				last = i + 1;
+			}
+		}
+	}
+
 	ScriptableRenderBuffer::ScriptableRenderBuffer() noexcept
+		: persistent_(false)
+		, frame_(0)
+		, segmentSize_(0)
+		, indicesVersion_(0)
 	{
+		for (auto& it : pending_)
+			it = DirtyRange{ 0, 0 };
 	}
 
 	ScriptableRenderBuffer::ScriptableRenderBuffer(const GraphicsDevicePtr& context, const std::shared_ptr<Mesh>& mesh) noexcept(false)
+		: ScriptableRenderBuffer()
 	{
 		this->updateData(context, mesh);
 	}
@@ -24,12 +54,24 @@ namespace octoon
 		return vertices_;
 	}
 
+	const GraphicsDataPtr&
+	ScriptableRenderBuffer::getTexcoordBuffer() const noexcept
+	{
+		return texcoords_;
+	}
+
 	const GraphicsDataPtr&
 	ScriptableRenderBuffer::getIndexBuffer() const noexcept
 	{
 		return indices_;
 	}
 
+	std::intptr_t
+	ScriptableRenderBuffer::getVertexBufferOffset() const noexcept
+	{
+		return persistent_ ? frame_ * segmentSize_ : 0;
+	}
+
 	std::size_t
 	ScriptableRenderBuffer::getNumVertices() const noexcept
 	{
@@ -68,26 +110,45 @@ namespace octoon
 			std::size_t numVertices = mesh->getNumVertices();
 			std::size_t numIndices = mesh->getNumIndices();
 
-			if (numVertices > 0 && (!this->vertices_ || mesh_ && mesh_->getNumVertices() != mesh->getNumVertices()))
-			{
-				GraphicsInputLayoutDesc inputLayout;
-				inputLayout.addVertexLayout(GraphicsVertexLayout(0, "POSITION", 0, GraphicsFormat::R32G32B32SFloat));
-				inputLayout.addVertexLayout(GraphicsVertexLayout(0, "NORMAL", 0, GraphicsFormat::R32G32B32SFloat));
-				inputLayout.addVertexLayout(GraphicsVertexLayout(0, "TEXCOORD", 0, GraphicsFormat::R32G32SFloat));
-				inputLayout.addVertexLayout(GraphicsVertexLayout(0, "TEXCOORD", 1, GraphicsFormat::R32G32SFloat));
+			bool vertexChanged = numVertices > 0 && (!this->vertices_ || this->vertexShadow_.size() != numVertices * VertexStride);
+			bool indexChanged = numIndices > 0 && (!this->indices_ || this->indices_->getDataDesc().getStreamSize() != numIndices * sizeof(std::uint32_t));
 
-				inputLayout.addVertexBinding(GraphicsVertexBinding(0, inputLayout.getVertexSize()));
+			if (vertexChanged)
+			{
+				this->persistent_ = context->getDeviceDesc().getDeviceType() == GraphicsDeviceType::OpenGL45;
+				this->segmentSize_ = (numVertices * VertexStride * sizeof(float) + SegmentAlignment - 1) / SegmentAlignment * SegmentAlignment;
+				this->frame_ = 0;
 
 				GraphicsDataDesc dataDesc;
 				dataDesc.setType(GraphicsDataType::StorageVertexBuffer);
 				dataDesc.setStream((std::uint8_t*)nullptr);
-				dataDesc.setStreamSize(numVertices * inputLayout.getVertexSize());
-				dataDesc.setUsage(GraphicsUsageFlagBits::WriteBit);
+
+				if (this->persistent_)
+				{
+					dataDesc.setStreamSize(this->segmentSize_ * NumFrames);
+					dataDesc.setUsage(GraphicsUsageFlagBits::WriteBit | GraphicsUsageFlagBits::PersistentBit | GraphicsUsageFlagBits::CoherentBit);
+				}
+				else
+				{
+					dataDesc.setStreamSize(this->segmentSize_);
+					dataDesc.setUsage(GraphicsUsageFlagBits::WriteBit);
+				}
 
 				this->vertices_ = context->createGraphicsData(dataDesc);
+
+				GraphicsDataDesc texcoordDesc;
+				texcoordDesc.setType(GraphicsDataType::StorageVertexBuffer);
+				texcoordDesc.setStream((std::uint8_t*)nullptr);
+				texcoordDesc.setStreamSize(numVertices * TexcoordStride * sizeof(float));
+				texcoordDesc.setUsage(GraphicsUsageFlagBits::WriteBit);
+
+				this->texcoords_ = context->createGraphicsData(texcoordDesc);
+
+				this->vertexShadow_.resize(numVertices * VertexStride);
+				this->texcoordShadow_.resize(numVertices * TexcoordStride);
 			}
 
-			if (numIndices > 0 && (!this->indices_ || mesh_ && mesh_->getNumIndices() != mesh->getNumIndices()))
+			if (indexChanged)
 			{
 				GraphicsDataDesc indiceDesc;
 				indiceDesc.setType(GraphicsDataType::StorageIndexBuffer);
@@ -99,102 +160,176 @@ namespace octoon
 			}
 
 			if (numVertices > 0 && this->vertices_)
-			{
-				auto streamSize = this->vertices_->getDataDesc().getStreamSize();
+				this->updateVertexData(*mesh, vertexChanged);
 
-				void* data = nullptr;
-				if (this->vertices_->map(0, streamSize, &data))
-				{
-					auto& vertices = mesh->getVertexArray();
-					auto& texcoord = mesh->getTexcoordArray();
-					auto& texcoord1 = mesh->getTexcoordArray(1);
-					auto& normals = mesh->getNormalArray();
-
-					auto vertexSize = streamSize / numVertices / sizeof(float);
-
-					if (!vertices.empty())
-					{
-						auto dst = (float*)data;
-
-						for (std::size_t i = 0; i < numVertices; i++, dst += vertexSize)
-						{
-							auto& v = vertices[i];
-							dst[0] = v.x;
-							dst[1] = v.y;
-							dst[2] = v.z;
-						}
-					}
-
-					if (!normals.empty())
-					{
-						auto dst = (float*)data;
-
-						for (std::size_t i = 0; i < numVertices; i++, dst += vertexSize)
-						{
-							auto& n = normals[i];
-							dst[3] = n.x;
-							dst[4] = n.y;
-							dst[5] = n.z;
-						}
-					}
-
-					if (!texcoord.empty())
-					{
-						auto dst = (float*)data;
-
-						for (std::size_t i = 0; i < numVertices; i++, dst += vertexSize)
-						{
-							auto& uv = texcoord[i];
-							dst[6] = uv.x;
-							dst[7] = uv.y;
-						}
-					}
-
-					if (!texcoord1.empty())
-					{
-						auto dst = (float*)data;
-
-						for (std::size_t i = 0; i < numVertices; i++, dst += vertexSize)
-						{
-							auto& uv = texcoord1[i];
-							dst[8] = uv.x;
-							dst[9] = uv.y;
-						}
-					}
-				}
-
-				this->vertices_->unmap();
-			}
+			if (numVertices > 0 && this->texcoords_)
+				this->updateTexcoordData(*mesh, vertexChanged);
 
 			if (numIndices > 0 && this->indices_)
-			{
-				this->startIndice_.resize(mesh->getNumSubsets());
-
-				void* data = nullptr;
-				if (this->indices_->map(0, numIndices * sizeof(std::uint32_t), &data))
-				{
-					for (std::size_t i = 0, streamOffset = 0; i < mesh->getNumSubsets(); i++)
-					{
-						auto& indices = mesh->getIndicesArray(i);
-						if (!indices.empty())
-						{
-							std::memcpy((std::uint32_t*)data + streamOffset, indices.data(), indices.size() * sizeof(std::uint32_t));
-
-							this->startIndice_[i] = streamOffset;
-							streamOffset += indices.size();
-						}
-					}
-				}
-
-				this->indices_->unmap();
-			}
+				this->updateIndexData(*mesh, indexChanged || this->mesh_ != mesh);
 		}
 		else
 		{
 			this->vertices_.reset();
+			this->texcoords_.reset();
 			this->indices_.reset();
+			this->vertexShadow_.clear();
+			this->texcoordShadow_.clear();
+			this->subsetSizes_.clear();
 		}
 
 		this->mesh_ = mesh;
 	}
-}
\ No newline at end of file
+
+	void
+	ScriptableRenderBuffer::updateVertexData(const Mesh& mesh, bool force) noexcept
+	{
+		auto& vertices = mesh.getVertexArray();
+		auto& normals = mesh.getNormalArray();
+
+		auto numVertices = mesh.getNumVertices();
+		auto shadow = this->vertexShadow_.data();
+
+		std::size_t first = numVertices;
+		std::size_t last = 0;
+
+		for (std::size_t i = 0; i < numVertices; i++)
+		{
+			auto& v = vertices[i];
+			auto n = normals.empty() ? math::float3::Zero : normals[i];
+
+			float value[VertexStride] = { v.x, v.y, v.z, n.x, n.y, n.z };
+			writeShadow(shadow, value, i, first, last);
+		}
+
+		if (force)
+		{
+			first = 0;
+			last = numVertices;
+
+			for (auto& it : pending_)
+				it = DirtyRange{ 0, numVertices };
+		}
+
+		if (first >= last)
+			return;
+
+		auto write = [&](std::size_t segment, std::size_t begin, std::size_t end)
+		{
+			auto offset = segment * this->segmentSize_ + begin * VertexStride * sizeof(float);
+			auto count = (end - begin) * VertexStride * sizeof(float);
+
+			void* data = nullptr;
+			if (this->vertices_->map(offset, count, &data))
+				std::memcpy(data, shadow + begin * VertexStride, count);
+
+			this->vertices_->unmap();
+		};
+
+		if (this->persistent_)
+		{
+			// segments still hold older frames, so every segment remembers the ranges it missed
+			for (auto& it : pending_)
+			{
+				it.first = std::min(it.first, first);
+				it.last = std::max(it.last, last);
+			}
+
+			// every draw reading the current segment has been submitted by now, fence it before moving
+			// on and wait for the fence of the segment that is about to be rewritten
+			this->vertices_->lock(this->frame_ * this->segmentSize_, this->segmentSize_);
+			this->frame_ = (this->frame_ + 1) % NumFrames;
+			this->vertices_->wait(this->frame_ * this->segmentSize_, this->segmentSize_);
+
+			auto& range = pending_[this->frame_];
+			write(this->frame_, range.first, range.last);
+			range = DirtyRange{ numVertices, 0 };
+		}
+		else
+		{
+			write(0, first, last);
+		}
+	}
+
+	void
+	ScriptableRenderBuffer::updateTexcoordData(const Mesh& mesh, bool force) noexcept
+	{
+		auto& texcoord = mesh.getTexcoordArray();
+		auto& texcoord1 = mesh.getTexcoordArray(1);
+
+		auto numVertices = mesh.getNumVertices();
+		auto shadow = this->texcoordShadow_.data();
+
+		std::size_t first = numVertices;
+		std::size_t last = 0;
+
+		for (std::size_t i = 0; i < numVertices; i++)
+		{
+			auto uv0 = texcoord.empty() ? math::float2::Zero : texcoord[i];
+			auto uv1 = texcoord1.empty() ? math::float2::Zero : texcoord1[i];
+
+			float value[TexcoordStride] = { uv0.x, uv0.y, uv1.x, uv1.y };
+			writeShadow(shadow, value, i, first, last);
+		}
+
+		if (force)
+		{
+			first = 0;
+			last = numVertices;
+		}
+
+		if (first < last)
+		{
+			auto offset = first * TexcoordStride * sizeof(float);
+			auto count = (last - first) * TexcoordStride * sizeof(float);
+
+			void* data = nullptr;
+			if (this->texcoords_->map(offset, count, &data))
+				std::memcpy(data, shadow + first * TexcoordStride, count);
+
+			this->texcoords_->unmap();
+		}
+	}
+
+	void
+	ScriptableRenderBuffer::updateIndexData(const Mesh& mesh, bool force) noexcept
+	{
+		auto numSubsets = mesh.getNumSubsets();
+
+		// indices are not diffed like vertices, the mesh counts every change to them instead
+		if (!force && this->indicesVersion_ == mesh.getIndicesVersion() && this->subsetSizes_.size() == numSubsets)
+		{
+			bool changed = false;
+			for (std::size_t i = 0; i < numSubsets && !changed; i++)
+				changed = this->subsetSizes_[i] != mesh.getIndicesArray(i).size();
+
+			if (!changed)
+				return;
+		}
+
+		this->indicesVersion_ = mesh.getIndicesVersion();
+
+		this->subsetSizes_.resize(numSubsets);
+		this->startIndice_.resize(numSubsets);
+
+		void* data = nullptr;
+		if (this->indices_->map(0, mesh.getNumIndices() * sizeof(std::uint32_t), &data))
+		{
+			for (std::size_t i = 0, streamOffset = 0; i < numSubsets; i++)
+			{
+				auto& indices = mesh.getIndicesArray(i);
+				if (!indices.empty())
+				{
+					std::memcpy((std::uint32_t*)data + streamOffset, indices.data(), indices.size() * sizeof(std::uint32_t));
+
+					this->startIndice_[i] = streamOffset;
+					streamOffset += indices.size();
+				}
+
+				this->subsetSizes_[i] = indices.size();
+			}
+		}
+
+		this->indices_->unmap();
+	}
+}
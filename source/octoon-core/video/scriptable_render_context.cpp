@@ -16,17 +16,30 @@
 #include <octoon/hal/graphics_device.h>
 #include <octoon/hal/graphics_framebuffer.h>
 #include <octoon/hal/graphics_data.h>
+#include <octoon/hal/graphics_pipeline.h>
 #include <octoon/hal/graphics_context.h>
 
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 namespace octoon
 {
 	ScriptableRenderContext::ScriptableRenderContext()
+		: indirectOffset_(0)
+		, instancing_(true)
+		, instanceOffset_(0)
 	{
+		this->resetStatistics();
 	}
 
 	ScriptableRenderContext::ScriptableRenderContext(const GraphicsContextPtr& context)
 		: context_(context)
+		, indirectOffset_(0)
+		, instancing_(true)
+		, instanceOffset_(0)
 	{
+		this->resetStatistics();
 	}
 
 	ScriptableRenderContext::~ScriptableRenderContext()
@@ -309,11 +322,13 @@ namespace octoon
 	{
 		assert(material);
 
+		auto& frameUniforms = this->getFrameUniforms(camera);
+
 		auto it = this->materials_.find(material.get());
 		if (it == this->materials_.end())
 		{
 			auto& pipeline = renderingData.materials_.at(material.get());
-			pipeline->update(renderingData, camera, geometry);
+			pipeline->update(renderingData, camera, geometry, frameUniforms);
 
 			this->setRenderPipeline(pipeline->getPipeline());
 			this->setDescriptorSet(pipeline->getDescriptorSet());
@@ -321,7 +336,7 @@ namespace octoon
 		else
 		{
 			auto& pipeline = this->materials_.at(material.get());
-			pipeline->update(renderingData, camera, geometry);
+			pipeline->update(renderingData, camera, geometry, frameUniforms);
 
 			this->setRenderPipeline(pipeline->getPipeline());
 			this->setDescriptorSet(pipeline->getDescriptorSet());
@@ -329,6 +344,55 @@ namespace octoon
 
 	}
 
+	const GraphicsDataPtr&
+	ScriptableRenderContext::getFrameUniforms(const Camera& camera) noexcept
+	{
+		FrameUniforms data;
+		data.viewMatrix = camera.getView();
+		data.projectionMatrix = camera.getProjection();
+		data.viewProjMatrix = camera.getViewProjection();
+
+		auto it = this->frameBuffers_.find(&camera);
+		if (it == this->frameBuffers_.end() || it->second.camera.lock().get() != &camera)
+		{
+			// the uniforms live as long as their camera, a new one is the moment to drop those released since
+			for (auto entry = this->frameBuffers_.begin(); entry != this->frameBuffers_.end();)
+			{
+				if (entry->second.camera.expired())
+					entry = this->frameBuffers_.erase(entry);
+				else
+					++entry;
+			}
+
+			it = this->frameBuffers_.try_emplace(&camera).first;
+			it->second.camera = camera.weak_from_this();
+			it->second.buffer = nullptr;
+		}
+
+		auto& frame = it->second;
+		if (!frame.buffer)
+		{
+			frame.data = data;
+			frame.buffer = this->context_->getDevice()->createGraphicsData(GraphicsDataDesc(
+				GraphicsDataType::UniformBuffer,
+				GraphicsUsageFlagBits::ReadBit | GraphicsUsageFlagBits::WriteBit,
+				&frame.data,
+				sizeof(FrameUniforms)
+			));
+		}
+		else if (std::memcmp(&frame.data, &data, sizeof(FrameUniforms)) != 0)
+		{
+			frame.data = data;
+
+			void* stream;
+			if (frame.buffer->map(0, sizeof(FrameUniforms), &stream))
+				std::memcpy(stream, &frame.data, sizeof(FrameUniforms));
+			frame.buffer->unmap();
+		}
+
+		return frame.buffer;
+	}
+
 	void
 	ScriptableRenderContext::generateMipmap(const std::shared_ptr<GraphicsTexture>& texture) noexcept
 	{
@@ -342,7 +406,8 @@ namespace octoon
 		if (it == this->buffers_.end())
 		{
 			auto& buffer = renderingData.buffers_.at(mesh.get());
-			this->setVertexBufferData(0, buffer->getVertexBuffer(), 0);
+			this->setVertexBufferData(0, buffer->getVertexBuffer(), buffer->getVertexBufferOffset());
+			this->setVertexBufferData(1, buffer->getTexcoordBuffer(), 0);
 			this->setIndexBufferData(buffer->getIndexBuffer(), 0, IndexFormat::UInt32);
 
 			if (buffer->getIndexBuffer())
@@ -353,7 +418,8 @@ namespace octoon
 		else
 		{
 			auto& buffer = buffers_.at(mesh.get());
-			this->setVertexBufferData(0, buffer->getVertexBuffer(), 0);
+			this->setVertexBufferData(0, buffer->getVertexBuffer(), buffer->getVertexBufferOffset());
+			this->setVertexBufferData(1, buffer->getTexcoordBuffer(), 0);
 			this->setIndexBufferData(buffer->getIndexBuffer(), 0, IndexFormat::UInt32);
 
 			if (buffer->getIndexBuffer())
@@ -366,36 +432,517 @@ namespace octoon
 	void
 	ScriptableRenderContext::drawRenderers(const Geometry& geometry, const Camera& camera, const RenderingData& renderingData, const std::shared_ptr<Material>& overrideMaterial) noexcept
 	{
-		if (camera.getLayer() != geometry.getLayer())
-			return;
+		const Geometry* geometries[] = { &geometry };
+		this->buildRenderQueue(geometries, 1, camera, renderingData, overrideMaterial);
+		this->submitRenderQueue(camera, renderingData);
+	}
+
+	void
+	ScriptableRenderContext::drawRenderers(const std::vector<Geometry*>& geometries, const Camera& camera, const RenderingData& renderingData, const std::shared_ptr<Material>& overrideMaterial) noexcept
+	{
+		this->buildRenderQueue(geometries.data(), geometries.size(), camera, renderingData, overrideMaterial);
+		this->submitRenderQueue(camera, renderingData);
+	}
+
+	void
+	ScriptableRenderContext::setInstancingEnable(bool enable) noexcept
+	{
+		this->instancing_ = enable;
+	}
+
+	bool
+	ScriptableRenderContext::getInstancingEnable() const noexcept
+	{
+		return this->instancing_;
+	}
+
+	const ScriptableRenderContext::Statistics&
+	ScriptableRenderContext::getStatistics() const noexcept
+	{
+		return this->statistics_;
+	}
+
+	void
+	ScriptableRenderContext::resetStatistics() noexcept
+	{
+		std::memset(&this->statistics_, 0, sizeof(Statistics));
+	}
+
+	ScriptableRenderMaterial*
+	ScriptableRenderContext::getRenderMaterial(const Material* material, const RenderingData& renderingData) const noexcept
+	{
+		auto it = this->materials_.find((void*)material);
+		if (it != this->materials_.end())
+			return it->second.get();
+
+		auto pipeline = renderingData.materials_.find((void*)material);
+		if (pipeline != renderingData.materials_.end())
+			return pipeline->second.get();
+
+		return nullptr;
+	}
+
+	ScriptableRenderBuffer*
+	ScriptableRenderContext::getRenderBuffer(const Mesh* mesh, const RenderingData& renderingData) const noexcept
+	{
+		auto it = this->buffers_.find((void*)mesh);
+		if (it != this->buffers_.end())
+			return it->second.get();
+
+		auto buffer = renderingData.buffers_.find((void*)mesh);
+		if (buffer != renderingData.buffers_.end())
+			return buffer->second.get();
 
-		if (geometry.getVisible())
+		return nullptr;
+	}
+
+	ScriptableRenderMaterial*
+	ScriptableRenderContext::getInstancedMaterial(ScriptableRenderMaterial* material, const RenderingData& renderingData) noexcept
+	{
+		auto it = this->instancedMaterials_.find(material);
+		if (it != this->instancedMaterials_.end() && it->second.source.lock().get() == material)
+			return it->second.material->getPipeline() ? it->second.material.get() : nullptr;
+
+		// a variant lives as long as the material it was made from, which is rebuilt on every material or light change
+		for (auto entry = this->instancedMaterials_.begin(); entry != this->instancedMaterials_.end();)
+		{
+			if (entry->second.source.expired())
+				entry = this->instancedMaterials_.erase(entry);
+			else
+				++entry;
+		}
+
+		std::shared_ptr<ScriptableRenderMaterial> source;
+
+		auto key = (void*)material->getMaterial().get();
+		auto local = this->materials_.find(key);
+		if (local != this->materials_.end() && local->second.get() == material)
+			source = local->second;
+		else
+		{
+			auto shared = renderingData.materials_.find(key);
+			if (shared != renderingData.materials_.end() && shared->second.get() == material)
+				source = shared->second;
+		}
+
+		if (!source)
+			return nullptr;
+
+		auto& instanced = this->instancedMaterials_[material];
+		instanced.source = source;
+		instanced.material = std::make_shared<ScriptableRenderMaterial>(this->context_, source->getMaterial(), renderingData, true);
+
+		return instanced.material->getPipeline() ? instanced.material.get() : nullptr;
+	}
+
+	void
+	ScriptableRenderContext::buildRenderQueue(const Geometry* const* geometries, std::size_t count, const Camera& camera, const RenderingData& renderingData, const std::shared_ptr<Material>& overrideMaterial) noexcept
+	{
+		this->queue_.clear();
+		this->sortIds_.clear();
+
+		auto sortId = [this](const void* ptr) -> std::uint64_t
+		{
+			auto it = this->sortIds_.emplace(ptr, static_cast<std::uint16_t>(std::min<std::size_t>(this->sortIds_.size(), 0xFFFE)));
+			return it.first->second;
+		};
+
+		float maxDistance = 0.0f;
+
+		for (std::size_t n = 0; n < count; n++)
 		{
+			auto& geometry = *geometries[n];
+			if (camera.getLayer() != geometry.getLayer() || !geometry.getVisible())
+				continue;
+
+			auto& mesh = geometry.getMesh();
+			if (!mesh)
+				continue;
+
+			auto buffer = this->getRenderBuffer(mesh.get(), renderingData);
+			if (!buffer)
+				continue;
+
+			auto& bound = geometry.getBoundingBox();
+			auto center = geometry.getTransform() * bound.center();
+			auto distance = math::sqrDistance(center, camera.getTranslate());
+
+			// empty or inverted bounds have no usable center, those draws go to the farthest bucket
+			if (bound.empty() || !std::isfinite(distance))
+				distance = std::numeric_limits<float>::infinity();
+			else
+				maxDistance = std::max(maxDistance, distance);
+
 			auto numMaterials = geometry.getMaterials().size();
 
-			for (std::size_t i = 0; i < numMaterials; i++)
+			for (std::size_t i = 0; i < numMaterials && i < mesh->getNumSubsets(); i++)
+			{
+				auto material = geometry.getMaterial(i).get();
+				if (!material)
+					continue;
+
+				if (overrideMaterial)
+					material = overrideMaterial.get();
+
+				auto pipeline = this->getRenderMaterial(material, renderingData);
+				if (!pipeline || !pipeline->getPipeline())
+					continue;
+
+				auto program = pipeline->getPipeline()->getPipelineDesc().getProgram().get();
+
+				// blended subsets keep their submission order and are drawn after everything opaque
+				DrawItem item;
+				if (material->getBlendEnable())
+					item.key = std::numeric_limits<std::uint64_t>::max();
+				else
+					item.key = sortId(program) << 48 | sortId(pipeline) << 32 | sortId(buffer) << 16;
+				item.order = static_cast<std::uint32_t>(this->queue_.size());
+				item.subset = static_cast<std::uint32_t>(i);
+				item.geometry = &geometry;
+				item.material = pipeline;
+				item.buffer = buffer;
+				item.distance = distance;
+
+				this->queue_.push_back(item);
+			}
+		}
+
+		// opaque draws go front to back so early depth testing rejects hidden fragments
+		for (auto& item : this->queue_)
+		{
+			if (item.key == std::numeric_limits<std::uint64_t>::max())
+				continue;
+
+			if (!std::isfinite(item.distance))
+				item.key |= 0xFFFE;
+			else if (maxDistance > 0.0f)
+				item.key |= std::min<std::uint64_t>(static_cast<std::uint64_t>(item.distance / maxDistance * 65535.0f), 0xFFFE);
+		}
+
+		std::sort(this->queue_.begin(), this->queue_.end(), [](const DrawItem& a, const DrawItem& b)
+		{
+			return a.key != b.key ? a.key < b.key : a.order < b.order;
+		});
+	}
+
+	void
+	ScriptableRenderContext::submitRenderQueue(const Camera& camera, const RenderingData& renderingData) noexcept
+	{
+		if (this->queue_.empty())
+			return;
+
+		this->batches_.clear();
+		this->commands_.clear();
+		this->instances_.clear();
+
+		bool multiDraw = false;
+
+		// items of one geometry with the same material stay adjacent after sorting, so each run is one batch
+		for (std::size_t first = 0; first < this->queue_.size();)
+		{
+			auto& item = this->queue_[first];
+
+			auto last = first + 1;
+			while (last < this->queue_.size() && this->queue_[last].geometry == item.geometry && this->queue_[last].material == item.material)
+				last++;
+
+			DrawBatch batch;
+			batch.first = first;
+			batch.last = last;
+			batch.command = static_cast<std::uint32_t>(this->commands_.size());
+			batch.numCommands = 0;
+			batch.instance = 0;
+			batch.numInstances = 1;
+			batch.material = item.material;
+
+			if (item.buffer->getIndexBuffer())
+			{
+				// subsets are laid out in order in the index buffer, so neighbours merge into one range
+				for (auto i = first; i < last; i++)
+				{
+					auto subset = this->queue_[i].subset;
+					auto start = static_cast<std::uint32_t>(item.buffer->getStartIndices(subset));
+					auto numIndices = static_cast<std::uint32_t>(item.buffer->getNumIndices(subset));
+					if (numIndices == 0)
+						continue;
+
+					if (batch.numCommands > 0)
+					{
+						auto& command = this->commands_.back();
+						if (command.firstIndex + command.count == start)
+						{
+							command.count += numIndices;
+							continue;
+						}
+					}
+
+					this->commands_.push_back(DrawIndexedIndirectCommand{ numIndices, 1, start, 0, 0 });
+					batch.numCommands++;
+				}
+
+				multiDraw |= batch.numCommands > 1;
+			}
+
+			this->batches_.push_back(batch);
+			first = last;
+		}
+
+		if (this->instancing_)
+			this->buildInstances(renderingData);
+
+		// multi-draw-indirect needs OpenGL 4.3, so only the 4.5 backend takes this path; the same backend
+		// keeps both rings persistently mapped and fences the ranges a pass has read
+		bool persistent = this->context_->getDevice()->getDeviceDesc().getDeviceType() == GraphicsDeviceType::OpenGL45;
+		GraphicsUsageFlags ringUsage = GraphicsUsageFlagBits::WriteBit;
+		if (persistent)
+			ringUsage |= GraphicsUsageFlagBits::PersistentBit | GraphicsUsageFlagBits::CoherentBit;
+
+		std::size_t indirectOffset = 0;
+		std::size_t indirectSize = 0;
+		multiDraw &= persistent;
+
+		if (multiDraw)
+		{
+			auto size = this->commands_.size() * sizeof(DrawIndexedIndirectCommand);
+			if (!this->indirectBuffer_ || this->indirectBuffer_->getDataDesc().getStreamSize() < size)
+			{
+				this->indirectBuffer_ = this->context_->getDevice()->createGraphicsData(GraphicsDataDesc(
+					GraphicsDataType::IndirectBiffer,
+					ringUsage,
+					nullptr,
+					std::max<std::size_t>(size * 4, sizeof(DrawIndexedIndirectCommand) * 1024)
+				));
+
+				this->indirectOffset_ = 0;
+			}
+
+			if (this->indirectBuffer_)
+			{
+				// passes append behind each other, so only wrapping around can reach a range the GPU has not
+				// read yet and has to wait for its fence
+				if (this->indirectOffset_ + size > this->indirectBuffer_->getDataDesc().getStreamSize())
+					this->indirectOffset_ = 0;
+
+				indirectOffset = this->indirectOffset_;
+				indirectSize = size;
+				this->indirectOffset_ += size;
+
+				this->indirectBuffer_->wait(indirectOffset, indirectSize);
+
+				void* data;
+				if (this->indirectBuffer_->map(indirectOffset, size, &data))
+					std::memcpy(data, this->commands_.data(), size);
+				this->indirectBuffer_->unmap();
+			}
+
+			multiDraw = this->indirectBuffer_ != nullptr;
+		}
+
+		std::size_t instanceOffset = 0;
+		std::size_t instanceSize = 0;
+
+		if (!this->instances_.empty())
+		{
+			auto size = this->instances_.size() * sizeof(math::float4x4);
+			if (!this->instanceBuffer_ || this->instanceBuffer_->getDataDesc().getStreamSize() < size)
+			{
+				this->instanceBuffer_ = this->context_->getDevice()->createGraphicsData(GraphicsDataDesc(
+					GraphicsDataType::StorageVertexBuffer,
+					ringUsage,
+					nullptr,
+					std::max<std::size_t>(size * 4, sizeof(math::float4x4) * 1024)
+				));
+
+				this->instanceOffset_ = 0;
+			}
+
+			if (this->instanceBuffer_)
+			{
+				// appended like the indirect commands, so a pass never overwrites transforms still in flight
+				if (this->instanceOffset_ + size > this->instanceBuffer_->getDataDesc().getStreamSize())
+					this->instanceOffset_ = 0;
+
+				instanceOffset = this->instanceOffset_;
+				instanceSize = size;
+				this->instanceOffset_ += size;
+
+				this->instanceBuffer_->wait(instanceOffset, instanceSize);
+
+				void* data;
+				if (this->instanceBuffer_->map(instanceOffset, size, &data))
+					std::memcpy(data, this->instances_.data(), size);
+				this->instanceBuffer_->unmap();
+			}
+		}
+
+		auto& frameUniforms = this->getFrameUniforms(camera);
+
+		const Geometry* lastGeometry = nullptr;
+		ScriptableRenderMaterial* lastMaterial = nullptr;
+		ScriptableRenderBuffer* lastBuffer = nullptr;
+		GraphicsPipeline* lastPipeline = nullptr;
+		GraphicsDescriptorSet* lastDescriptorSet = nullptr;
+
+		for (auto& batch : this->batches_)
+		{
+			auto& item = this->queue_[batch.first];
+			auto material = batch.material;
+			auto buffer = item.buffer;
+
+			if (batch.numInstances > 1 && !this->instanceBuffer_)
+				continue;
+
+			// per object uniforms have to be written again whenever the object or the material changes
+			bool needUpdate = item.geometry != lastGeometry || material != lastMaterial;
+			if (needUpdate)
+			{
+				material->update(renderingData, camera, *item.geometry, frameUniforms);
+				lastGeometry = item.geometry;
+				lastMaterial = material;
+			}
+
+			if (material->getPipeline().get() != lastPipeline)
+			{
+				this->setRenderPipeline(material->getPipeline());
+				lastPipeline = material->getPipeline().get();
+				statistics_.pipelineChanges++;
+			}
+
+			if (material->getDescriptorSet().get() != lastDescriptorSet || needUpdate)
+			{
+				this->setDescriptorSet(material->getDescriptorSet());
+				lastDescriptorSet = material->getDescriptorSet().get();
+				statistics_.descriptorSetChanges++;
+			}
+
+			if (buffer != lastBuffer)
 			{
-				auto mesh = geometry.getMesh();
-				auto material = geometry.getMaterial(i);
-				if (material && overrideMaterial)
+				this->setVertexBufferData(0, buffer->getVertexBuffer(), buffer->getVertexBufferOffset());
+				this->setVertexBufferData(1, buffer->getTexcoordBuffer(), 0);
+				statistics_.vertexBufferChanges++;
+
+				if (buffer->getIndexBuffer())
 				{
-					if (material->getPrimitiveType() == overrideMaterial->getPrimitiveType())
-						material = overrideMaterial;
+					this->setIndexBufferData(buffer->getIndexBuffer(), 0, IndexFormat::UInt32);
+					statistics_.indexBufferChanges++;
 				}
 
-				if (material && mesh && i < mesh->getNumSubsets())
+				lastBuffer = buffer;
+			}
+
+			if (batch.numInstances > 1)
+			{
+				this->setVertexBufferData(2, this->instanceBuffer_, instanceOffset + batch.instance * sizeof(math::float4x4));
+				statistics_.vertexBufferChanges++;
+			}
+
+			std::uint32_t numDraws = 0;
+
+			if (!buffer->getIndexBuffer())
+			{
+				this->draw((std::uint32_t)buffer->getNumVertices(), batch.numInstances, 0, 0);
+				numDraws = 1;
+			}
+			else if (multiDraw && batch.numCommands > 1)
+			{
+				this->drawIndexedIndirect(this->indirectBuffer_, indirectOffset + batch.command * sizeof(DrawIndexedIndirectCommand), batch.numCommands, sizeof(DrawIndexedIndirectCommand));
+				numDraws = 1;
+			}
+			else
+			{
+				for (std::uint32_t i = 0; i < batch.numCommands; i++)
 				{
-					this->setMaterial(overrideMaterial ? overrideMaterial : material, renderingData, camera, geometry);
-					this->drawMesh(mesh, i, renderingData);
+					auto& command = this->commands_[batch.command + i];
+					this->drawIndexed(command.count, batch.numInstances, command.firstIndex, 0, 0);
 				}
+
+				numDraws = batch.numCommands;
+			}
+
+			auto numItems = static_cast<std::uint32_t>(batch.last - batch.first) * batch.numInstances;
+
+			statistics_.drawCalls += numDraws;
+			statistics_.mergedDraws += numItems > numDraws ? numItems - numDraws : 0;
+
+			if (batch.numInstances > 1)
+			{
+				statistics_.instancedDraws += numDraws;
+				statistics_.instances += batch.numInstances;
 			}
 		}
+
+		if (indirectSize > 0)
+			this->indirectBuffer_->lock(indirectOffset, indirectSize);
+
+		if (instanceSize > 0)
+			this->instanceBuffer_->lock(instanceOffset, instanceSize);
 	}
 
 	void
-	ScriptableRenderContext::drawRenderers(const std::vector<Geometry*>& geometries, const Camera& camera, const RenderingData& renderingData, const std::shared_ptr<Material>& overrideMaterial) noexcept
+	ScriptableRenderContext::buildInstances(const RenderingData& renderingData) noexcept
 	{
-		for (auto& geometry : geometries)
-			this->drawRenderers(*geometry, camera, renderingData, overrideMaterial);
+		// opaque batches that draw the same index ranges of one buffer with one material only differ
+		// in their transform; the sort key puts them next to each other
+		auto isInstanceOf = [this](const DrawBatch& a, const DrawBatch& b)
+		{
+			auto& first = this->queue_[a.first];
+			auto& item = this->queue_[b.first];
+
+			if (first.key == std::numeric_limits<std::uint64_t>::max() || item.key == std::numeric_limits<std::uint64_t>::max())
+				return false;
+
+			if (first.material != item.material || first.buffer != item.buffer || a.numCommands != b.numCommands)
+				return false;
+
+			for (std::uint32_t i = 0; i < a.numCommands; i++)
+			{
+				auto& lhs = this->commands_[a.command + i];
+				auto& rhs = this->commands_[b.command + i];
+				if (lhs.firstIndex != rhs.firstIndex || lhs.count != rhs.count)
+					return false;
+			}
+
+			return true;
+		};
+
+		std::size_t count = 0;
+
+		for (std::size_t first = 0; first < this->batches_.size();)
+		{
+			auto batch = this->batches_[first];
+
+			auto last = first + 1;
+			while (last < this->batches_.size() && isInstanceOf(batch, this->batches_[last]))
+				last++;
+
+			if (last - first > 1)
+			{
+				auto material = this->getInstancedMaterial(batch.material, renderingData);
+				if (material)
+				{
+					batch.material = material;
+					batch.instance = static_cast<std::uint32_t>(this->instances_.size());
+					batch.numInstances = static_cast<std::uint32_t>(last - first);
+
+					for (auto i = first; i < last; i++)
+						this->instances_.push_back(this->queue_[this->batches_[i].first].geometry->getTransform());
+
+					for (std::uint32_t i = 0; i < batch.numCommands; i++)
+						this->commands_[batch.command + i].instanceCount = batch.numInstances;
+
+					this->batches_[count++] = batch;
+					first = last;
+					continue;
+				}
+			}
+
+			// without an instanced variant every batch of the run is drawn on its own
+			for (auto i = first; i < last; i++)
+				this->batches_[count++] = this->batches_[i];
+
+			first = last;
+		}
+
+		this->batches_.resize(count);
 	}
-}
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 ﻿#include <octoon/video/scriptable_render_material.h>
 #include <octoon/video/rendering_data.h>
 #include <octoon/video/renderer.h>
+#include <octoon/video/scriptable_program_cache.h>
 #include <octoon/material/mesh_standard_material.h>
 #include <octoon/hal/graphics_input_layout.h>
 #include <octoon/hal/graphics_framebuffer.h>
@@ -8,7 +9,7 @@
 #include <octoon/hal/graphics_descriptor.h>
 #include <octoon/hal/graphics_pipeline.h>
 #include <octoon/hal/graphics_shader.h>
-#include <regex>
+#include <limits>
 
 static const char* common = R"(
 #define PI 3.14159265359
@@ -2155,11 +2156,15 @@ static std::unordered_map<std::string, std::string_view> ShaderChunk = {
 namespace octoon
 {
 	ScriptableRenderMaterial::ScriptableRenderMaterial() noexcept
+		: instancing_(false)
+		, version_(std::numeric_limits<std::size_t>::max())
 	{
 	}
 
-	ScriptableRenderMaterial::ScriptableRenderMaterial(GraphicsContextPtr& context, const MaterialPtr& material, const RenderingData& scene) noexcept
+	ScriptableRenderMaterial::ScriptableRenderMaterial(GraphicsContextPtr& context, const MaterialPtr& material, const RenderingData& scene, bool instancing) noexcept
+		: ScriptableRenderMaterial()
 	{
+		this->instancing_ = instancing;
 		this->material_ = material;
 		this->updateMaterial(context, material, scene);
 	}
@@ -2178,11 +2183,13 @@ namespace octoon
 		envMap_.reset();
 		envMapIntensity_.reset();
 
-		viewMatrix_.reset();
+		frameUniforms_.reset();
 		normalMatrix_.reset();
 		modelMatrix_.reset();
 		modelViewMatrix_.reset();
-		projectionMatrix_.reset();
+
+		parameters_.clear();
+		uniforms_.clear();
 
 		program_.reset();
 		renderState_.reset();
@@ -2190,6 +2197,18 @@ namespace octoon
 		pipeline_.reset();
 	}
 
+	bool
+	ScriptableRenderMaterial::isInstancing() const noexcept
+	{
+		return instancing_;
+	}
+
+	const MaterialPtr&
+	ScriptableRenderMaterial::getMaterial() const noexcept
+	{
+		return material_;
+	}
+
 	const GraphicsPipelinePtr&
 	ScriptableRenderMaterial::getPipeline() const noexcept
 	{
@@ -2203,25 +2222,19 @@ namespace octoon
 	}
 
 	void
-	ScriptableRenderMaterial::update(const RenderingData& context, const Camera& camera, const Geometry& geometry) noexcept
+	ScriptableRenderMaterial::update(const RenderingData& context, const Camera& camera, const Geometry& geometry, const GraphicsDataPtr& frameUniforms) noexcept
 	{
 		if (this->material_)
 		{
+			if (this->frameUniforms_)
+				this->frameUniforms_->uniformBuffer(frameUniforms);
+
 			if (this->modelMatrix_)
 				this->modelMatrix_->uniform4fmat(geometry.getTransform());
-			
-			if (this->viewMatrix_)
-				this->viewMatrix_->uniform4fmat(camera.getView());
-
-			if (this->viewProjMatrix_)
-				this->viewProjMatrix_->uniform4fmat(camera.getViewProjection());
 
 			if (this->modelViewMatrix_)
 				this->modelViewMatrix_->uniform4fmat(camera.getView() * geometry.getTransform());
 			
-			if (this->projectionMatrix_)
-				this->projectionMatrix_->uniform4fmat(camera.getProjection());
-			
 			if (this->normalMatrix_)
 				this->normalMatrix_->uniform3fmat((math::float3x3)camera.getView() * (math::float3x3)geometry.getTransform());
 
@@ -2266,52 +2279,88 @@ namespace octoon
 				}
 			}
 
-			this->updateParameters(true);
+			this->updateParameters();
 		}
 	}
 
 	void
 	ScriptableRenderMaterial::parseIncludes(std::string& str)
 	{
-		std::regex pattern("#include +<([^<>]*)>");
-		std::smatch m;
+		constexpr std::string_view directive = "#include";
 
-		std::size_t pos = 0;
+		std::string out;
+		out.reserve(str.size() * 4);
 
-		std::string::const_iterator start = str.begin();
-		std::string::const_iterator end = str.end();
+		std::size_t last = 0;
+		std::size_t pos = str.find(directive);
 
-		while (std::regex_search(start, end, m, pattern))
+		while (pos != std::string::npos)
 		{
-			auto position = m.position() + ShaderChunk[m[1]].length();
+			auto first = pos + directive.size();
+			auto open = str.find_first_not_of(' ', first);
 
-			str.replace(pos + m.position(), m[0].length(), ShaderChunk[m[1]]);
+			if (open != first && open != std::string::npos && str[open] == '<')
+			{
+				auto close = str.find_first_of("<>", open + 1);
+				if (close != std::string::npos && str[close] == '>')
+				{
+					out.append(str, last, pos - last);
+
+					auto chunk = ShaderChunk.find(str.substr(open + 1, close - open - 1));
+					if (chunk != ShaderChunk.end())
+						out.append(chunk->second);
 
-			pos += position;
+					last = close + 1;
+					pos = str.find(directive, last);
+					continue;
+				}
+			}
 
-			start = str.begin() + pos;
-			end = str.end();
+			pos = str.find(directive, first);
 		}
+
+		out.append(str, last, std::string::npos);
+		str = std::move(out);
 	}
 
 	void
 	ScriptableRenderMaterial::replaceLightNums(std::string& str, const RenderingData& parameters)
 	{
-		auto replace = [](std::string& str, std::string_view patten, std::string_view right)
+		const std::pair<std::string_view, std::string> macros[] =
 		{
-			auto pos = str.find(patten);
-			while (pos != std::string::npos)
+			{ "NUM_DIR_LIGHTS", std::to_string(parameters.numDirectional) },
+			{ "NUM_SPOT_LIGHTS", std::to_string(parameters.numSpot) },
+			{ "NUM_RECT_AREA_LIGHTS", std::to_string(parameters.numRectangle) },
+			{ "NUM_POINT_LIGHTS", std::to_string(parameters.numPoint) },
+			{ "NUM_HEMI_LIGHTS", std::to_string(parameters.numHemi) },
+		};
+
+		std::string out;
+		out.reserve(str.size());
+
+		std::size_t last = 0;
+		std::size_t pos = str.find("NUM_");
+
+		while (pos != std::string::npos)
+		{
+			auto next = pos + 4;
+
+			for (auto& [name, value] : macros)
 			{
-				str.replace(pos, patten.length(), right);
-				pos = str.find(patten, pos + 1);
+				if (str.compare(pos, name.size(), name) == 0)
+				{
+					out.append(str, last, pos - last);
+					out.append(value);
+					last = next = pos + name.size();
+					break;
+				}
 			}
-		};
 
-		replace(str, "NUM_DIR_LIGHTS", std::to_string(parameters.numDirectional));
-		replace(str, "NUM_SPOT_LIGHTS", std::to_string(parameters.numSpot));
-		replace(str, "NUM_RECT_AREA_LIGHTS", std::to_string(parameters.numRectangle));
-		replace(str, "NUM_POINT_LIGHTS", std::to_string(parameters.numPoint));
-		replace(str, "NUM_HEMI_LIGHTS", std::to_string(parameters.numHemi));
+			pos = str.find("NUM_", next);
+		}
+
+		out.append(str, last, std::string::npos);
+		str = std::move(out);
 	}
 
 	void
@@ -2320,18 +2369,36 @@ namespace octoon
 		auto shader = material->getShader();
 
 		std::string vertexShader = "#version 330\n\t";
+		if (this->instancing_)
+			vertexShader += "#define USE_INSTANCING\n";
 		vertexShader += R"(
 				layout(location = 0) in vec4 POSITION0;
 				layout(location = 1) in vec2 TEXCOORD0;
 				layout(location = 2) in vec3 NORMAL0;
 				layout(location = 3) in vec2 TEXCOORD1;
 
-				uniform mat4 modelMatrix;
-				uniform mat4 modelViewMatrix;
-				uniform mat4 projectionMatrix;
-				uniform mat4 viewMatrix;
-				uniform mat4 viewProjMatrix;
-				uniform mat3 normalMatrix;
+				layout(std140) uniform FrameUniforms
+				{
+					mat4 viewMatrix;
+					mat4 projectionMatrix;
+					mat4 viewProjMatrix;
+				};
+
+				#ifdef USE_INSTANCING
+					layout(location = 4) in vec4 INSTANCE0;
+					layout(location = 5) in vec4 INSTANCE1;
+					layout(location = 6) in vec4 INSTANCE2;
+					layout(location = 7) in vec4 INSTANCE3;
+
+					#define modelMatrix mat4(INSTANCE0, INSTANCE1, INSTANCE2, INSTANCE3)
+					#define modelViewMatrix (viewMatrix * modelMatrix)
+					#define normalMatrix (mat3(viewMatrix) * mat3(modelMatrix))
+				#else
+					uniform mat4 modelMatrix;
+					uniform mat4 modelViewMatrix;
+					uniform mat3 normalMatrix;
+				#endif
+
 				uniform vec3 cameraPosition;
 
 				#ifdef USE_COLOR
@@ -2344,7 +2411,7 @@ namespace octoon
 
 		std::string fragmentShader = "#version 330\n\t";
 		fragmentShader += "layout(location  = 0) out vec4 fragColor;\n";
-		fragmentShader += "uniform mat4 viewMatrix;\n";
+		fragmentShader += "layout(std140) uniform FrameUniforms { mat4 viewMatrix; mat4 projectionMatrix; mat4 viewProjMatrix; };\n";
 		//fragmentShader += "#define TONE_MAPPING\n";
 		fragmentShader += "#define ENVMAP_TYPE_LATLONG_UV\n";
 		fragmentShader += "#define ENVMAP_MODE_REFLECTION\n";
@@ -2396,10 +2463,7 @@ namespace octoon
 		this->replaceLightNums(vertexShader, scene);
 		this->replaceLightNums(fragmentShader, scene);
 
-		GraphicsProgramDesc programDesc;
-		programDesc.addShader(context->getDevice()->createShader(GraphicsShaderDesc(ShaderStageFlagBits::VertexBit, vertexShader, "main", ShaderLanguage::GLSL)));
-		programDesc.addShader(context->getDevice()->createShader(GraphicsShaderDesc(ShaderStageFlagBits::FragmentBit, fragmentShader, "main", ShaderLanguage::GLSL)));
-		this->program_ = context->getDevice()->createProgram(programDesc);
+		this->program_ = ScriptableProgramCache::instance()->getProgram(context->getDevice(), vertexShader, fragmentShader);
 	}
 
 	void
@@ -2489,10 +2553,19 @@ namespace octoon
 			GraphicsInputLayoutDesc layoutDesc;
 			layoutDesc.addVertexLayout(GraphicsVertexLayout(0, "POSITION", 0, GraphicsFormat::R32G32B32SFloat));
 			layoutDesc.addVertexLayout(GraphicsVertexLayout(0, "NORMAL", 0, GraphicsFormat::R32G32B32SFloat));
-			layoutDesc.addVertexLayout(GraphicsVertexLayout(0, "TEXCOORD", 0, GraphicsFormat::R32G32SFloat));
-			layoutDesc.addVertexLayout(GraphicsVertexLayout(0, "TEXCOORD", 1, GraphicsFormat::R32G32SFloat));
+			layoutDesc.addVertexLayout(GraphicsVertexLayout(1, "TEXCOORD", 0, GraphicsFormat::R32G32SFloat));
+			layoutDesc.addVertexLayout(GraphicsVertexLayout(1, "TEXCOORD", 1, GraphicsFormat::R32G32SFloat));
+
+			layoutDesc.addVertexBinding(GraphicsVertexBinding(0, layoutDesc.getVertexSize(0)));
+			layoutDesc.addVertexBinding(GraphicsVertexBinding(1, layoutDesc.getVertexSize(1)));
+
+			if (this->instancing_)
+			{
+				for (std::uint8_t i = 0; i < 4; i++)
+					layoutDesc.addVertexLayout(GraphicsVertexLayout(2, "INSTANCE", i, GraphicsFormat::R32G32B32A32SFloat));
 
-			layoutDesc.addVertexBinding(GraphicsVertexBinding(0, layoutDesc.getVertexSize()));
+				layoutDesc.addVertexBinding(GraphicsVertexBinding(2, layoutDesc.getVertexSize(2), VertexAttribDivisor::Instance));
+			}
 
 			GraphicsDescriptorSetLayoutDesc descriptorSetLayout;
 			descriptorSetLayout.setUniformComponents(this->program_->getActiveParams());
@@ -2519,13 +2592,9 @@ namespace octoon
 				if (modelMatrix != end)
 					modelMatrix_ = *modelMatrix;
 
-				auto viewMatrix = std::find_if(begin, end, [](const GraphicsUniformSetPtr& set) { return set->getName() == "viewMatrix"; });
-				if (viewMatrix != end)
-					viewMatrix_ = *viewMatrix;
-
-				auto viewProjMatrix = std::find_if(begin, end, [](const GraphicsUniformSetPtr& set) { return set->getName() == "viewProjMatrix"; });
-				if (viewProjMatrix != end)
-					viewProjMatrix_ = *viewProjMatrix;
+				auto frameUniforms = std::find_if(begin, end, [](const GraphicsUniformSetPtr& set) { return set->getName() == "FrameUniforms"; });
+				if (frameUniforms != end)
+					frameUniforms_ = *frameUniforms;
 
 				auto normalMatrix = std::find_if(begin, end, [](const GraphicsUniformSetPtr& set) { return set->getName() == "normalMatrix"; });
 				if (normalMatrix != end)
@@ -2535,10 +2604,6 @@ namespace octoon
 				if (modelViewMatrix != end)
 					modelViewMatrix_ = *modelViewMatrix;
 
-				auto projectionMatrix = std::find_if(begin, end, [](const GraphicsUniformSetPtr& set) { return set->getName() == "projectionMatrix"; });
-				if (projectionMatrix != end)
-					projectionMatrix_ = *projectionMatrix;
-
 				auto ambientLightColor = std::find_if(begin, end, [](const GraphicsUniformSetPtr& set) { return set->getName() == "ambientLightColor"; });
 				if (ambientLightColor != end)
 					ambientLightColor_ = *ambientLightColor;
@@ -2593,6 +2658,9 @@ namespace octoon
 					}
 				}
 
+				for (auto& it : descriptorSet_->getUniformSets())
+					this->uniforms_[it->getName()] = it;
+
 				this->updateParameters(true);
 			}
 		}
@@ -2605,77 +2673,87 @@ namespace octoon
 	void
 	ScriptableRenderMaterial::updateParameters(bool force) noexcept
 	{
-		if (this->material_->isDirty() || force)
+		auto version = this->material_->getVersion();
+		if (this->version_ == version && !force)
+			return;
+
+		auto& params = this->material_->getMaterialParams();
+
+		// Material::set re-appends the changed entry, so the indices are matched again for each version
+		this->parameters_.clear();
+
+		for (std::size_t i = 0; i < params.size(); i++)
+		{
+			auto it = this->uniforms_.find(params[i].key);
+			if (it != this->uniforms_.end())
+				this->parameters_.push_back(ParameterBinding{ i, it->second });
+		}
+
+		for (auto& binding : this->parameters_)
 		{
-			auto begin = descriptorSet_->getUniformSets().begin();
-			auto end = descriptorSet_->getUniformSets().end();
+			auto& prop = params[binding.index];
+			auto& uniform = *binding.uniform;
 
-			for (auto& prop : material_->getMaterialParams())
+			switch (prop.type)
 			{
-				auto it = std::find_if(begin, end, [&](const GraphicsUniformSetPtr& set) { return set->getName() == prop.key; });
-				if (it != end)
-				{
-					auto uniform = *it;
-					switch (prop.type)
-					{
-					case PropertyTypeInfo::PropertyTypeInfoBool:
-					{
-						auto value = (bool*)prop.data;
-						uniform->uniform1b(*value);
-					}
-					break;
-					case PropertyTypeInfo::PropertyTypeInfoInt | PropertyTypeInfo::PropertyTypeInfoBuffer:
-					{
-						auto value = (int*)prop.data;
-						if (prop.length == 4)
-							uniform->uniform1i(value[0]);
-						else if (prop.length == 8)
-							uniform->uniform2i(value[0], value[1]);
-						else if (prop.length == 12)
-							uniform->uniform3i(value[0], value[1], value[2]);
-						else if (prop.length == 16)
-							uniform->uniform4i(value[0], value[1], value[2], value[3]);
-					}
-					break;
-					case PropertyTypeInfo::PropertyTypeInfoFloat:
-					{
-						auto value = (float*)prop.data;
-						uniform->uniform1f(value[0]);
-					}
-					break;
-					case PropertyTypeInfo::PropertyTypeInfoFloat2:
-					{
-						auto value = (float*)prop.data;
-						uniform->uniform2f(value[0], value[1]);
-					}
-					break;
-					case PropertyTypeInfo::PropertyTypeInfoFloat3:
-					{
-						auto value = (float*)prop.data;
-						uniform->uniform3f(value[0], value[1], value[2]);
-					}
-					break;
-					case PropertyTypeInfo::PropertyTypeInfoFloat4:
-					{
-						auto value = (float*)prop.data;
-						uniform->uniform4f(value[0], value[1], value[2], value[3]);
-					}
-					break;
-					case PropertyTypeInfo::PropertyTypeInfoTexture:
-					{
-						uniform->uniformTexture(prop.texture ? prop.texture->getNativeTexture() : nullptr);
-					}
-					break;
-					case PropertyTypeInfo::PropertyTypeInfoRenderTexture:
-					{
-						uniform->uniformTexture(prop.renderTexture);
-					}
-					break;
-					default:
-						break;
-					}
-				}
+			case PropertyTypeInfo::PropertyTypeInfoBool:
+			{
+				auto value = (bool*)prop.data;
+				uniform.uniform1b(*value);
+			}
+			break;
+			case PropertyTypeInfo::PropertyTypeInfoInt | PropertyTypeInfo::PropertyTypeInfoBuffer:
+			{
+				auto value = (int*)prop.data;
+				if (prop.length == 4)
+					uniform.uniform1i(value[0]);
+				else if (prop.length == 8)
+					uniform.uniform2i(value[0], value[1]);
+				else if (prop.length == 12)
+					uniform.uniform3i(value[0], value[1], value[2]);
+				else if (prop.length == 16)
+					uniform.uniform4i(value[0], value[1], value[2], value[3]);
+			}
+			break;
+			case PropertyTypeInfo::PropertyTypeInfoFloat:
+			{
+				auto value = (float*)prop.data;
+				uniform.uniform1f(value[0]);
+			}
+			break;
+			case PropertyTypeInfo::PropertyTypeInfoFloat2:
+			{
+				auto value = (float*)prop.data;
+				uniform.uniform2f(value[0], value[1]);
+			}
+			break;
+			case PropertyTypeInfo::PropertyTypeInfoFloat3:
+			{
+				auto value = (float*)prop.data;
+				uniform.uniform3f(value[0], value[1], value[2]);
+			}
+			break;
+			case PropertyTypeInfo::PropertyTypeInfoFloat4:
+			{
+				auto value = (float*)prop.data;
+				uniform.uniform4f(value[0], value[1], value[2], value[3]);
+			}
+			break;
+			case PropertyTypeInfo::PropertyTypeInfoTexture:
+			{
+				uniform.uniformTexture(prop.texture ? prop.texture->getNativeTexture() : nullptr);
+			}
+			break;
+			case PropertyTypeInfo::PropertyTypeInfoRenderTexture:
+			{
+				uniform.uniformTexture(prop.renderTexture);
+			}
+			break;
+			default:
+				break;
 			}
 		}
+
+		this->version_ = version;
 	}
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <octoon/asset_importer.h>
 #include <octoon/timer_feature.h>
 #include <octoon/runtime/guid.h>
+#include <limits>
 
 namespace octoon
 {
@@ -14,6 +15,7 @@ namespace octoon
 	AnimatorComponent::AnimatorComponent() noexcept
 		: enableAnimation_(true)
 		, enableAnimOnVisableOnly_(false)
+		, bindVersion_(0)
 	{
 		animatorStateInfo_.finish = false;
 		animatorStateInfo_.time = 0;
@@ -372,6 +374,7 @@ namespace octoon
 	void 
 	AnimatorComponent::onActivate() except
 	{
+		this->updateBindmap();
 	}
 
 	void
@@ -403,125 +406,133 @@ namespace octoon
 	void
 	AnimatorComponent::updateBindpose(const GameObjects& avatar) noexcept
 	{
+		pose_.setBones(avatar);
 		bindpose_.resize(avatar.size());
 
 		for (std::size_t i = 0; i < avatar.size(); i++)
-			bindpose_[i] = avatar[i]->getComponent<TransformComponent>()->getLocalTranslate();
+			bindpose_[i] = pose_.getLocalTranslate(i);
 	}
 
 	void
 	AnimatorComponent::updateBindmap() noexcept
 	{
-		bindmap_.clear();
+		tracks_.clear();
+		channels_.clear();
+		bindClip_.reset();
+
+		if (!animation_ || !animation_->clip)
+			return;
 
-		if (animation_ && animation_->clip && !avatar_.empty())
+		auto& clip = animation_->clip;
+		bindClip_ = clip;
+		bindVersion_ = clip->getVersion();
+
+		if (!avatar_.empty())
 		{
-			std::unordered_map<std::string, std::size_t> boneMap;
+			std::unordered_map<std::string_view, std::size_t> boneMap;
 
 			for (std::size_t i = 0; i < avatar_.size(); i++)
 				boneMap[avatar_[i]->getName()] = i;
 
-			auto& clip = animation_->clip;
-			bindmap_.reserve(clip->bindings.size());
-
 			for (auto& binding : clip->bindings)
 			{
 				auto it = boneMap.find(binding.first);
-				if (it != boneMap.end())
-					bindmap_[binding.first] = (*it).second;
+				if (it == boneMap.end())
+					continue;
+
+				AnimatorTrack track;
+				track.index = (*it).second;
+				track.first = channels_.size();
+				track.transform = avatar_[track.index]->getComponent<TransformComponent>();
+
+				for (auto& curve : binding.second)
+					channels_.push_back(AnimatorChannel{ parseProperty(curve.first), &curve.second, &curve.first });
+
+				track.last = channels_.size();
+				tracks_.push_back(std::move(track));
+			}
+		}
+		else
+		{
+			auto transform = this->getComponent<TransformComponent>();
+			if (!transform)
+			{
+				bindClip_.reset();
+				return;
+			}
+
+			for (auto& binding : clip->bindings)
+			{
+				AnimatorTrack track;
+				track.index = std::numeric_limits<std::size_t>::max();
+				track.first = channels_.size();
+				track.transform = transform;
+
+				for (auto& curve : binding.second)
+					channels_.push_back(AnimatorChannel{ parseProperty(curve.first), &curve.second, &curve.first });
+
+				track.last = channels_.size();
+				tracks_.push_back(std::move(track));
 			}
 		}
 	}
 
+	bool
+	AnimatorComponent::isBindmapDirty() const noexcept
+	{
+		// the channels point into the clip, a clip that was freed or edited since has to be bound again
+		auto& clip = animation_->clip;
+		if (!clip)
+			return !bindClip_.expired() || !channels_.empty();
+
+		return bindClip_.lock() != clip || bindVersion_ != clip->getVersion();
+	}
+
+	AnimatorProperty
+	AnimatorComponent::parseProperty(std::string_view name) noexcept
+	{
+		static const std::unordered_map<std::string_view, AnimatorProperty> properties =
+		{
+			{ "LocalPosition", AnimatorProperty::LocalPosition },
+			{ "LocalPosition.x", AnimatorProperty::LocalPositionX },
+			{ "LocalPosition.y", AnimatorProperty::LocalPositionY },
+			{ "LocalPosition.z", AnimatorProperty::LocalPositionZ },
+			{ "LocalScale", AnimatorProperty::LocalScale },
+			{ "LocalScale.x", AnimatorProperty::LocalScaleX },
+			{ "LocalScale.y", AnimatorProperty::LocalScaleY },
+			{ "LocalScale.z", AnimatorProperty::LocalScaleZ },
+			{ "LocalRotation", AnimatorProperty::LocalRotation },
+			{ "LocalRotation.x", AnimatorProperty::LocalRotationX },
+			{ "LocalRotation.y", AnimatorProperty::LocalRotationY },
+			{ "LocalRotation.z", AnimatorProperty::LocalRotationZ },
+			{ "LocalRotation.w", AnimatorProperty::LocalRotationW },
+			{ "LocalForward", AnimatorProperty::LocalForward },
+			{ "LocalEulerAnglesRaw", AnimatorProperty::LocalEulerAnglesRaw },
+			{ "LocalEulerAnglesRaw.x", AnimatorProperty::LocalEulerAnglesRawX },
+			{ "LocalEulerAnglesRaw.y", AnimatorProperty::LocalEulerAnglesRawY },
+			{ "LocalEulerAnglesRaw.z", AnimatorProperty::LocalEulerAnglesRawZ },
+		};
+
+		auto it = properties.find(name);
+		if (it != properties.end())
+			return (*it).second;
+
+		return AnimatorProperty::Message;
+	}
+
 	void
 	AnimatorComponent::updateAvatar(float delta) noexcept
 	{
 		if (this->getCurrentAnimatorStateInfo().finish)
 			return;
 
-		for (auto& binding : animation_->clip->bindings)
-		{
-			if (!bindmap_.contains(binding.first))
-				continue;
+		if (this->isBindmapDirty())
+			this->updateBindmap();
 
-			auto& index = bindmap_[binding.first];
-
-			auto transform = avatar_[index]->getComponent<TransformComponent>();
-			auto scale = transform->getLocalScale();
-			auto quat = transform->getLocalQuaternion();
-			auto translate = transform->getLocalTranslate();
-			auto euler = transform->getLocalEulerAngles();
-			auto move = 0.0f;
-
-			for (auto& curve : binding.second)
-			{
-				if (curve.first == "LocalPosition")
-					translate = curve.second.value.getFloat3() + bindpose_[index];
-				if (curve.first == "LocalPosition.x")
-					translate.x = curve.second.value.getFloat() + bindpose_[index].x;
-				else if (curve.first == "LocalPosition.y")
-					translate.y = curve.second.value.getFloat() + bindpose_[index].y;
-				else if (curve.first == "LocalPosition.z")
-					translate.z = curve.second.value.getFloat() + bindpose_[index].z;
-				else if (curve.first == "LocalScale")
-					scale = curve.second.value.getFloat3();
-				else if (curve.first == "LocalScale.x")
-					scale.x = curve.second.value.getFloat();
-				else if (curve.first == "LocalScale.y")
-					scale.y = curve.second.value.getFloat();
-				else if (curve.first == "LocalScale.z")
-					scale.z = curve.second.value.getFloat();
-				else if (curve.first == "LocalRotation")
-					quat = curve.second.value.getQuaternion();
-				else if (curve.first == "LocalRotation.x")
-					quat.x = curve.second.value.getFloat();
-				else if (curve.first == "LocalRotation.y")
-					quat.y = curve.second.value.getFloat();
-				else if (curve.first == "LocalRotation.z")
-					quat.z = curve.second.value.getFloat();
-				else if (curve.first == "LocalRotation.w")
-					quat.w = curve.second.value.getFloat();
-				else if (curve.first == "LocalForward")
-					move = curve.second.value.getFloat();
-				else if (curve.first == "LocalEulerAnglesRaw")
-				{
-					euler = curve.second.value.getFloat3();
-					quat = math::Quaternion(euler);
-				}
-				else if (curve.first == "LocalEulerAnglesRaw.x")
-				{
-					euler.x = curve.second.value.getFloat();
-					quat = math::Quaternion(euler);
-				}
-				else if (curve.first == "LocalEulerAnglesRaw.y")
-				{
-					euler.y = curve.second.value.getFloat();
-					quat = math::Quaternion(euler);
-				}
-				else if (curve.first == "LocalEulerAnglesRaw.z")
-				{
-					euler.z = curve.second.value.getFloat();
-					quat = math::Quaternion(euler);
-				}
-				else
-				{
-					this->sendMessage(curve.first, curve.second.value);
-				}
-			}
+		for (auto& track : tracks_)
+			this->updateTrack(track, bindpose_[track.index]);
 
-			if (move != 0.0f)
-			{
-				transform->setLocalScale(scale);
-				transform->setLocalTranslate(translate + math::rotate(quat, math::float3::Forward) * move);
-				transform->setLocalQuaternion(quat);
-			}
-			else
-			{
-				transform->setLocalScale(scale);
-				transform->setLocalTranslate(translate);
-				transform->setLocalQuaternion(quat);
-			}
-		}
+		pose_.apply();
 
 		this->sendMessage("octoon:animation:update");
 	}
@@ -532,83 +543,102 @@ namespace octoon
 		if (this->getCurrentAnimatorStateInfo().finish)
 			return;
 
-		for (auto& binging : animation_->clip->bindings)
-		{
-			auto transform = this->getComponent<TransformComponent>();
-			auto scale = transform->getLocalScale();
-			auto quat = transform->getLocalQuaternion();
-			auto translate = transform->getLocalTranslate();
-			auto euler = transform->getLocalEulerAngles();
-			auto move = 0.0f;
+		if (this->isBindmapDirty())
+			this->updateBindmap();
 
-			for (auto& curve : binging.second)
-			{
-				if (curve.first == "LocalPosition")
-					translate = curve.second.value.getFloat3();
-				if (curve.first == "LocalPosition.x")
-					translate.x = curve.second.value.getFloat();
-				else if (curve.first == "LocalPosition.y")
-					translate.y = curve.second.value.getFloat();
-				else if (curve.first == "LocalPosition.z")
-					translate.z = curve.second.value.getFloat();
-				else if (curve.first == "LocalScale")
-					scale = curve.second.value.getFloat3();
-				else if (curve.first == "LocalScale.x")
-					scale.x = curve.second.value.getFloat();
-				else if (curve.first == "LocalScale.y")
-					scale.y = curve.second.value.getFloat();
-				else if (curve.first == "LocalScale.z")
-					scale.z = curve.second.value.getFloat();
-				else if (curve.first == "LocalRotation")
-					quat = curve.second.value.getQuaternion();
-				else if (curve.first == "LocalRotation.x")
-					quat.x = curve.second.value.getFloat();
-				else if (curve.first == "LocalRotation.y")
-					quat.y = curve.second.value.getFloat();
-				else if (curve.first == "LocalRotation.z")
-					quat.z = curve.second.value.getFloat();
-				else if (curve.first == "LocalRotation.w")
-					quat.w = curve.second.value.getFloat();
-				else if (curve.first == "LocalForward")
-					move = curve.second.value.getFloat();
-				else if (curve.first == "LocalEulerAnglesRaw")
-				{
-					euler = curve.second.value.getFloat3();
-					quat = math::Quaternion(euler);
-				}
-				else if (curve.first == "LocalEulerAnglesRaw.x")
-				{
-					euler.x = curve.second.value.getFloat();
-					quat = math::Quaternion(euler);
-				}
-				else if (curve.first == "LocalEulerAnglesRaw.y")
-				{
-					euler.y = curve.second.value.getFloat();
-					quat = math::Quaternion(euler);
-				}
-				else if (curve.first == "LocalEulerAnglesRaw.z")
-				{
-					euler.z = curve.second.value.getFloat();
-					quat = math::Quaternion(euler);
-				}
-				else
-					this->sendMessage(curve.first, curve.second.value);
-			}
+		for (auto& track : tracks_)
+			this->updateTrack(track, math::float3::Zero);
 
-			if (move != 0.0f)
-			{
-				transform->setLocalScale(scale);
-				transform->setLocalTranslate(translate + math::rotate(quat, math::float3::Forward) * move);
-				transform->setLocalQuaternion(quat);
-			}
-			else
+		this->sendMessage("octoon:animation:update");
+	}
+
+	void
+	AnimatorComponent::updateTrack(const AnimatorTrack& track, const math::float3& bindpose) noexcept
+	{
+		auto& transform = track.transform;
+		auto scale = transform->getLocalScale();
+		auto quat = transform->getLocalQuaternion();
+		auto translate = transform->getLocalTranslate();
+		auto euler = transform->getLocalEulerAngles();
+		auto move = 0.0f;
+
+		for (auto i = track.first; i < track.last; i++)
+		{
+			auto& channel = channels_[i];
+			auto& value = channel.curve->value;
+
+			switch (channel.property)
 			{
-				transform->setLocalScale(scale);
-				transform->setLocalTranslate(translate);
-				transform->setLocalQuaternion(quat);
+			case AnimatorProperty::LocalPosition:
+				translate = value.getFloat3() + bindpose;
+				break;
+			case AnimatorProperty::LocalPositionX:
+				translate.x = value.getFloat() + bindpose.x;
+				break;
+			case AnimatorProperty::LocalPositionY:
+				translate.y = value.getFloat() + bindpose.y;
+				break;
+			case AnimatorProperty::LocalPositionZ:
+				translate.z = value.getFloat() + bindpose.z;
+				break;
+			case AnimatorProperty::LocalScale:
+				scale = value.getFloat3();
+				break;
+			case AnimatorProperty::LocalScaleX:
+				scale.x = value.getFloat();
+				break;
+			case AnimatorProperty::LocalScaleY:
+				scale.y = value.getFloat();
+				break;
+			case AnimatorProperty::LocalScaleZ:
+				scale.z = value.getFloat();
+				break;
+			case AnimatorProperty::LocalRotation:
+				quat = value.getQuaternion();
+				break;
+			case AnimatorProperty::LocalRotationX:
+				quat.x = value.getFloat();
+				break;
+			case AnimatorProperty::LocalRotationY:
+				quat.y = value.getFloat();
+				break;
+			case AnimatorProperty::LocalRotationZ:
+				quat.z = value.getFloat();
+				break;
+			case AnimatorProperty::LocalRotationW:
+				quat.w = value.getFloat();
+				break;
+			case AnimatorProperty::LocalForward:
+				move = value.getFloat();
+				break;
+			case AnimatorProperty::LocalEulerAnglesRaw:
+				euler = value.getFloat3();
+				quat = math::Quaternion(euler);
+				break;
+			case AnimatorProperty::LocalEulerAnglesRawX:
+				euler.x = value.getFloat();
+				quat = math::Quaternion(euler);
+				break;
+			case AnimatorProperty::LocalEulerAnglesRawY:
+				euler.y = value.getFloat();
+				quat = math::Quaternion(euler);
+				break;
+			case AnimatorProperty::LocalEulerAnglesRawZ:
+				euler.z = value.getFloat();
+				quat = math::Quaternion(euler);
+				break;
+			default:
+				this->sendMessage(*channel.name, value);
+				break;
 			}
 		}
 
-		this->sendMessage("octoon:animation:update");
+		if (move != 0.0f)
+			translate += math::rotate(quat, math::float3::Forward) * move;
+
+		if (track.index < pose_.size())
+			pose_.setLocalTransform(track.index, translate, quat, scale);
+		else
+			transform->setLocalTransform(translate, quat, scale);
 	}
 }
\ No newline at end of file
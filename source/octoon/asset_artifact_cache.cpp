@@ -0,0 +1,713 @@
+#include <octoon/asset_artifact_cache.h>
+#include <octoon/animation/path_interpolator.h>
+#include <octoon/io/mapped_file.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace octoon
+{
+	namespace
+	{
+		constexpr std::uint32_t ArtifactMagic = 0x4641434F; // "OCAF"
+		constexpr std::uint32_t ArtifactVersion = 1;
+		constexpr std::uint32_t TextureArtifact = 1;
+		constexpr std::uint32_t AnimationArtifact = 2;
+		constexpr std::size_t ArtifactAlignment = 16;
+
+		struct ArtifactHeader
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint32_t kind;
+			std::uint32_t reserved;
+			std::uint64_t sourceSize;
+			std::int64_t sourceTime;
+			std::uint64_t sourceHash;
+			std::uint64_t metaHash;
+			std::uint64_t payloadSize;
+			std::uint64_t padding;
+		};
+
+		struct TextureInfo
+		{
+			std::uint32_t format;
+			std::uint32_t width;
+			std::uint32_t height;
+			std::uint32_t depth;
+			std::uint32_t mipLevel;
+			std::uint32_t layerLevel;
+			std::uint32_t mipBase;
+			std::uint32_t layerBase;
+			std::uint64_t size;
+			std::uint64_t padding;
+		};
+
+		static_assert(sizeof(ArtifactHeader) % ArtifactAlignment == 0);
+		static_assert(sizeof(TextureInfo) % ArtifactAlignment == 0);
+
+		struct SourceStamp
+		{
+			std::uint64_t size;
+			std::int64_t time;
+			std::uint64_t metaHash;
+		};
+
+		inline std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash = 14695981039346656037ull) noexcept
+		{
+			auto bytes = static_cast<const std::uint8_t*>(data);
+			for (std::size_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+
+			return hash;
+		}
+
+		std::uint64_t hashFile(const std::filesystem::path& path) noexcept
+		{
+			auto hash = fnv1a(nullptr, 0);
+
+			io::MappedFile file(path);
+			if (file.is_open())
+				hash = fnv1a(file.data(), file.size(), hash);
+
+			return hash;
+		}
+
+		bool stampSource(const std::filesystem::path& diskPath, SourceStamp& stamp) noexcept
+		{
+			std::error_code ec;
+			stamp.size = std::filesystem::file_size(diskPath, ec);
+			if (ec)
+				return false;
+
+			auto time = std::filesystem::last_write_time(diskPath, ec);
+			if (ec)
+				return false;
+
+			// importer settings live in the .meta file, so any edit there invalidates the artifact
+			auto metaPath = diskPath;
+			metaPath.concat(L".meta");
+
+			stamp.time = static_cast<std::int64_t>(time.time_since_epoch().count());
+			stamp.metaHash = hashFile(metaPath);
+			return true;
+		}
+
+		// On success the payload is the mapped range following the header.
+		bool openArtifact(io::MappedFile& file, const std::filesystem::path& artifactPath, const std::filesystem::path& diskPath, std::uint32_t kind, ArtifactHeader& header) noexcept
+		{
+			if (!file.open(artifactPath) || file.size() < sizeof(header))
+				return false;
+
+			std::memcpy(&header, file.data(), sizeof(header));
+
+			if (header.magic != ArtifactMagic || header.version != ArtifactVersion || header.kind != kind)
+				return false;
+
+			if (header.payloadSize > file.size() - sizeof(header))
+				return false;
+
+			SourceStamp stamp;
+			if (!stampSource(diskPath, stamp))
+				return false;
+
+			if (header.sourceSize != stamp.size || header.metaHash != stamp.metaHash)
+				return false;
+
+			// copies and checkouts touch the write time without changing the file, the content decides then
+			if (header.sourceTime != stamp.time)
+			{
+				if (header.sourceHash != hashFile(diskPath))
+					return false;
+
+				// the mapping does not share write access, so it is dropped while the stamp is updated
+				file.close();
+
+				{
+					std::fstream update(artifactPath, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+					if (update)
+					{
+						update.seekp(offsetof(ArtifactHeader, sourceTime));
+						update.write((const char*)&stamp.time, sizeof(stamp.time));
+					}
+				}
+
+				if (!file.open(artifactPath) || file.size() < sizeof(header) + header.payloadSize)
+					return false;
+			}
+
+			return true;
+		}
+
+		struct ArtifactChunk
+		{
+			const void* data;
+			std::size_t size;
+		};
+
+		void writeArtifact(const std::filesystem::path& artifactPath, const std::filesystem::path& diskPath, std::uint32_t kind, std::initializer_list<ArtifactChunk> chunks) noexcept
+		{
+			SourceStamp stamp;
+			if (!stampSource(diskPath, stamp))
+				return;
+
+			ArtifactHeader header;
+			std::memset(&header, 0, sizeof(header));
+			header.magic = ArtifactMagic;
+			header.version = ArtifactVersion;
+			header.kind = kind;
+			header.sourceSize = stamp.size;
+			header.sourceTime = stamp.time;
+			header.sourceHash = hashFile(diskPath);
+			header.metaHash = stamp.metaHash;
+
+			for (auto& chunk : chunks)
+				header.payloadSize += chunk.size;
+
+			std::error_code ec;
+			std::filesystem::create_directories(artifactPath.parent_path(), ec);
+
+			// written next to the final name first so a crash never leaves a truncated artifact behind
+			auto temp = artifactPath;
+			temp += ".tmp";
+
+			{
+				std::ofstream stream(temp, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+				if (!stream)
+					return;
+
+				stream.write((const char*)&header, sizeof(header));
+				for (auto& chunk : chunks)
+					stream.write((const char*)chunk.data, chunk.size);
+
+				if (!stream)
+					return;
+			}
+
+			std::filesystem::rename(temp, artifactPath, ec);
+			if (ec)
+				std::filesystem::remove(temp, ec);
+		}
+
+		class ArtifactWriter final
+		{
+		public:
+			template<typename T>
+			void write(const T& value) noexcept
+			{
+				auto offset = data.size();
+				data.resize(offset + sizeof(T));
+				std::memcpy(data.data() + offset, &value, sizeof(T));
+			}
+
+			void write(const void* ptr, std::size_t size) noexcept
+			{
+				data.insert(data.end(), (const std::uint8_t*)ptr, (const std::uint8_t*)ptr + size);
+			}
+
+			void writeString(std::string_view str) noexcept
+			{
+				this->write(static_cast<std::uint32_t>(str.size()));
+				this->write(str.data(), str.size());
+			}
+
+			void align() noexcept
+			{
+				data.resize((data.size() + ArtifactAlignment - 1) / ArtifactAlignment * ArtifactAlignment);
+			}
+
+			std::vector<std::uint8_t> data;
+		};
+
+		class ArtifactReader final
+		{
+		public:
+			ArtifactReader(const std::uint8_t* data, std::size_t size) noexcept
+				: data_(data)
+				, size_(size)
+				, offset_(0)
+			{
+			}
+
+			template<typename T>
+			bool read(T& value) noexcept
+			{
+				return this->read(&value, sizeof(T));
+			}
+
+			bool read(void* ptr, std::size_t size) noexcept
+			{
+				if (size > size_ - offset_)
+					return false;
+
+				std::memcpy(ptr, data_ + offset_, size);
+				offset_ += size;
+				return true;
+			}
+
+			bool readString(std::string& str) noexcept
+			{
+				std::uint32_t length;
+				if (!this->read(length) || length > size_ - offset_)
+					return false;
+
+				str.assign((const char*)data_ + offset_, length);
+				offset_ += length;
+				return true;
+			}
+
+			void align() noexcept
+			{
+				offset_ = std::min(size_, (offset_ + ArtifactAlignment - 1) / ArtifactAlignment * ArtifactAlignment);
+			}
+
+		private:
+			const std::uint8_t* data_;
+			std::size_t size_;
+			std::size_t offset_;
+		};
+
+		std::uint32_t numComponents(math::Variant::Type type) noexcept
+		{
+			switch (type)
+			{
+			case math::Variant::Type::Float: return 1;
+			case math::Variant::Type::Float2: return 2;
+			case math::Variant::Type::Float3: return 3;
+			case math::Variant::Type::Float4: return 4;
+			case math::Variant::Type::Quaternion: return 4;
+			default:
+				return 0;
+			}
+		}
+
+		void getComponents(const math::Variant& value, float* out) noexcept
+		{
+			switch (value.getType())
+			{
+			case math::Variant::Type::Float:
+				out[0] = value.getFloat();
+				break;
+			case math::Variant::Type::Float2:
+				std::memcpy(out, value.getFloat2().ptr(), sizeof(float) * 2);
+				break;
+			case math::Variant::Type::Float3:
+				std::memcpy(out, value.getFloat3().ptr(), sizeof(float) * 3);
+				break;
+			case math::Variant::Type::Float4:
+				std::memcpy(out, value.getFloat4().ptr(), sizeof(float) * 4);
+				break;
+			case math::Variant::Type::Quaternion:
+			{
+				auto& q = value.getQuaternion();
+				out[0] = q.x;
+				out[1] = q.y;
+				out[2] = q.z;
+				out[3] = q.w;
+			}
+			break;
+			default:
+				break;
+			}
+		}
+
+		math::Variant makeValue(math::Variant::Type type, const float* v) noexcept
+		{
+			switch (type)
+			{
+			case math::Variant::Type::Float: return math::Variant(v[0]);
+			case math::Variant::Type::Float2: return math::Variant(math::float2(v[0], v[1]));
+			case math::Variant::Type::Float3: return math::Variant(math::float3(v[0], v[1], v[2]));
+			case math::Variant::Type::Float4: return math::Variant(math::float4(v[0], v[1], v[2], v[3]));
+			case math::Variant::Type::Quaternion: return math::Variant(math::Quaternion(v[0], v[1], v[2], v[3]));
+			default:
+				return math::Variant();
+			}
+		}
+
+		// Keyframes share their interpolators, so they are written once into a table and referenced by index.
+		class InterpolatorTable final
+		{
+		public:
+			bool add(const std::shared_ptr<Interpolator<float>>& interpolator, std::int32_t& index) noexcept
+			{
+				if (!interpolator)
+				{
+					index = -1;
+					return true;
+				}
+
+				auto it = indices.find(interpolator.get());
+				if (it != indices.end())
+				{
+					index = it->second;
+					return true;
+				}
+
+				auto path = dynamic_cast<const PathInterpolator<float>*>(interpolator.get());
+				if (!path)
+					return false;
+
+				index = static_cast<std::int32_t>(params.size() / 4);
+				indices[interpolator.get()] = index;
+				params.insert(params.end(), { path->xa, path->xb, path->ya, path->yb });
+				return true;
+			}
+
+			std::vector<float> params;
+			std::unordered_map<const Interpolator<float>*, std::int32_t> indices;
+		};
+
+		bool writeCurve(ArtifactWriter& writer, InterpolatorTable& table, const AnimationCurve<float>& curve) noexcept
+		{
+			auto count = static_cast<std::uint32_t>(curve.frames.size());
+			auto type = count > 0 ? curve.frames.front().value.getType() : math::Variant::Type::Float;
+			auto components = numComponents(type);
+			if (components == 0)
+				return false;
+
+			std::int32_t curveInterpolator;
+			if (!table.add(curve.interpolator, curveInterpolator))
+				return false;
+
+			std::vector<float> times(count);
+			std::vector<std::int32_t> interpolators(count);
+			std::vector<float> values(count * components);
+
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				auto& frame = curve.frames[i];
+				if (frame.value.getType() != type || !table.add(frame.interpolator, interpolators[i]))
+					return false;
+
+				times[i] = frame.time;
+				getComponents(frame.value, values.data() + i * components);
+			}
+
+			writer.write(static_cast<std::uint32_t>(curve.preWrapMode));
+			writer.write(static_cast<std::uint32_t>(curve.postWrapMode));
+			writer.write(curveInterpolator);
+			writer.write(static_cast<std::uint32_t>(type));
+			writer.write(count);
+			writer.align();
+			writer.write(times.data(), times.size() * sizeof(float));
+			writer.write(interpolators.data(), interpolators.size() * sizeof(std::int32_t));
+			writer.write(values.data(), values.size() * sizeof(float));
+			writer.align();
+
+			return true;
+		}
+
+		bool readCurve(ArtifactReader& reader, const std::vector<std::shared_ptr<Interpolator<float>>>& table, AnimationCurve<float>& curve) noexcept
+		{
+			std::uint32_t preWrapMode, postWrapMode, type, count;
+			std::int32_t curveInterpolator;
+
+			if (!reader.read(preWrapMode) || !reader.read(postWrapMode) || !reader.read(curveInterpolator) || !reader.read(type) || !reader.read(count))
+				return false;
+
+			auto components = numComponents(static_cast<math::Variant::Type>(type));
+			if (components == 0)
+				return false;
+
+			auto lookup = [&](std::int32_t index, std::shared_ptr<Interpolator<float>>& out)
+			{
+				if (index < 0)
+					return true;
+				if (static_cast<std::size_t>(index) >= table.size())
+					return false;
+				out = table[index];
+				return true;
+			};
+
+			reader.align();
+
+			std::vector<float> times(count);
+			std::vector<std::int32_t> interpolators(count);
+			std::vector<float> values(static_cast<std::size_t>(count) * components);
+
+			if (!reader.read(times.data(), times.size() * sizeof(float)) ||
+				!reader.read(interpolators.data(), interpolators.size() * sizeof(std::int32_t)) ||
+				!reader.read(values.data(), values.size() * sizeof(float)))
+				return false;
+
+			reader.align();
+
+			Keyframes<float> frames;
+			frames.reserve(count);
+
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				std::shared_ptr<Interpolator<float>> interpolator;
+				if (!lookup(interpolators[i], interpolator))
+					return false;
+
+				frames.emplace_back(times[i], makeValue(static_cast<math::Variant::Type>(type), values.data() + i * components), std::move(interpolator));
+			}
+
+			std::shared_ptr<Interpolator<float>> interpolator;
+			if (!lookup(curveInterpolator, interpolator))
+				return false;
+
+			curve = AnimationCurve<float>(std::move(frames), std::move(interpolator));
+			curve.preWrapMode = static_cast<AnimationMode>(preWrapMode);
+			curve.postWrapMode = static_cast<AnimationMode>(postWrapMode);
+
+			return true;
+		}
+	}
+
+	AssetArtifactCache::AssetArtifactCache() noexcept
+	{
+	}
+
+	AssetArtifactCache::~AssetArtifactCache() noexcept
+	{
+	}
+
+	void
+	AssetArtifactCache::setCachePath(const std::filesystem::path& path) noexcept
+	{
+		cachePath_ = path;
+	}
+
+	const std::filesystem::path&
+	AssetArtifactCache::getCachePath() const noexcept
+	{
+		return cachePath_;
+	}
+
+	std::filesystem::path
+	AssetArtifactCache::getArtifactPath(const std::filesystem::path& diskPath, std::uint32_t kind) const noexcept
+	{
+		auto source = std::filesystem::path(diskPath).make_preferred().u8string();
+
+		auto key = fnv1a(source.data(), source.size());
+		key = fnv1a(&kind, sizeof(kind), key);
+
+		char name[24];
+		std::snprintf(name, sizeof(name), "%016llx.art", static_cast<unsigned long long>(key));
+
+		return cachePath_ / name;
+	}
+
+	std::shared_ptr<Texture>
+	AssetArtifactCache::loadTexture(const std::filesystem::path& diskPath) const noexcept
+	{
+		if (cachePath_.empty())
+			return nullptr;
+
+		try
+		{
+			io::MappedFile file;
+			ArtifactHeader header;
+			if (!openArtifact(file, this->getArtifactPath(diskPath, TextureArtifact), diskPath, TextureArtifact, header))
+				return nullptr;
+
+			ArtifactReader reader(file.data() + sizeof(header), header.payloadSize);
+
+			TextureInfo info;
+			if (!reader.read(info))
+				return nullptr;
+
+			auto format = static_cast<Format::Type>(info.format);
+			if (format < Format::BeginRange || format > Format::EndRange || info.width == 0 || info.height == 0 || info.depth == 0 || info.mipLevel == 0 || info.layerLevel == 0)
+				return nullptr;
+
+			auto texture = std::make_shared<Texture>();
+			if (!texture->create(format, info.width, info.height, info.depth, info.mipLevel, info.layerLevel, info.mipBase, info.layerBase))
+				return nullptr;
+
+			if (texture->size() != info.size || !reader.read(texture->data(), info.size))
+				return nullptr;
+
+			return texture;
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+	}
+
+	void
+	AssetArtifactCache::saveTexture(const std::filesystem::path& diskPath, const Texture& texture) const noexcept
+	{
+		if (cachePath_.empty() || texture.empty())
+			return;
+
+		TextureInfo info;
+		std::memset(&info, 0, sizeof(info));
+		info.format = static_cast<std::uint32_t>(texture.format().type());
+		info.width = texture.width();
+		info.height = texture.height();
+		info.depth = texture.depth();
+		info.mipLevel = texture.getMipLevel();
+		info.layerLevel = texture.getLayerLevel();
+		info.mipBase = texture.getMipBase();
+		info.layerBase = texture.getLayerBase();
+		info.size = texture.size();
+
+		writeArtifact(this->getArtifactPath(diskPath, TextureArtifact), diskPath, TextureArtifact, {
+			ArtifactChunk{ &info, sizeof(info) },
+			ArtifactChunk{ texture.data(), texture.size() }
+		});
+	}
+
+	std::shared_ptr<Animation>
+	AssetArtifactCache::loadAnimation(const std::filesystem::path& diskPath) const noexcept
+	{
+		if (cachePath_.empty())
+			return nullptr;
+
+		try
+		{
+			io::MappedFile file;
+			ArtifactHeader header;
+			if (!openArtifact(file, this->getArtifactPath(diskPath, AnimationArtifact), diskPath, AnimationArtifact, header))
+				return nullptr;
+
+			ArtifactReader reader(file.data() + sizeof(header), header.payloadSize);
+
+			std::string name;
+			std::uint32_t numInterpolators;
+			if (!reader.readString(name) || !reader.read(numInterpolators))
+				return nullptr;
+
+			reader.align();
+
+			std::vector<float> params(static_cast<std::size_t>(numInterpolators) * 4);
+			if (!reader.read(params.data(), params.size() * sizeof(float)))
+				return nullptr;
+
+			std::vector<std::shared_ptr<Interpolator<float>>> interpolators(numInterpolators);
+			for (std::size_t i = 0; i < numInterpolators; i++)
+				interpolators[i] = std::make_shared<PathInterpolator<float>>(params[i * 4], params[i * 4 + 1], params[i * 4 + 2], params[i * 4 + 3]);
+
+			auto animation = std::make_shared<Animation>();
+			animation->setName(name);
+
+			std::uint32_t numClips;
+			if (!reader.read(numClips))
+				return nullptr;
+
+			for (std::uint32_t i = 0; i < numClips; i++)
+			{
+				std::string key, clipName;
+				std::uint32_t numPaths;
+				if (!reader.readString(key) || !reader.readString(clipName) || !reader.read(numPaths))
+					return nullptr;
+
+				auto clip = std::make_shared<AnimationClip>();
+				clip->setName(clipName);
+
+				for (std::uint32_t j = 0; j < numPaths; j++)
+				{
+					std::string path;
+					std::uint32_t numProperties;
+					if (!reader.readString(path) || !reader.read(numProperties))
+						return nullptr;
+
+					for (std::uint32_t k = 0; k < numProperties; k++)
+					{
+						std::string property;
+						AnimationCurve<float> curve;
+						if (!reader.readString(property) || !readCurve(reader, interpolators, curve))
+							return nullptr;
+
+						clip->setCurve(path, property, std::move(curve));
+					}
+				}
+
+				animation->addClip(std::move(clip), key);
+			}
+
+			return animation;
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+	}
+
+	void
+	AssetArtifactCache::saveAnimation(const std::filesystem::path& diskPath, const Animation& animation) const noexcept
+	{
+		if (cachePath_.empty())
+			return;
+
+		try
+		{
+			InterpolatorTable table;
+			ArtifactWriter clips;
+
+			// the first clip added becomes the default one, so it is written first
+			std::vector<const std::pair<const std::string, std::shared_ptr<AnimationClip>>*> order;
+			for (auto& it : animation.clips)
+			{
+				if (it.second == animation.clip)
+					order.insert(order.begin(), &it);
+				else
+					order.push_back(&it);
+			}
+
+			clips.write(static_cast<std::uint32_t>(order.size()));
+
+			for (auto it : order)
+			{
+				auto& clip = *it->second;
+
+				clips.writeString(it->first);
+				clips.writeString(clip.getName());
+				clips.write(static_cast<std::uint32_t>(clip.bindings.size()));
+
+				for (auto& binding : clip.bindings)
+				{
+					clips.writeString(binding.first);
+					clips.write(static_cast<std::uint32_t>(binding.second.size()));
+
+					for (auto& property : binding.second)
+					{
+						clips.writeString(property.first);
+						if (!writeCurve(clips, table, property.second))
+							return;
+					}
+				}
+			}
+
+			ArtifactWriter head;
+			head.writeString(animation.getName());
+			head.write(static_cast<std::uint32_t>(table.params.size() / 4));
+			head.align();
+			head.write(table.params.data(), table.params.size() * sizeof(float));
+			head.align();
+
+			writeArtifact(this->getArtifactPath(diskPath, AnimationArtifact), diskPath, AnimationArtifact, {
+				ArtifactChunk{ head.data.data(), head.data.size() },
+				ArtifactChunk{ clips.data.data(), clips.data.size() }
+			});
+		}
+		catch (...)
+		{
+		}
+	}
+
+	void
+	AssetArtifactCache::clear() const noexcept
+	{
+		if (cachePath_.empty())
+			return;
+
+		std::error_code ec;
+		for (auto& it : std::filesystem::directory_iterator(cachePath_, ec))
+		{
+			if (it.path().extension() == ".art")
+				std::filesystem::remove(it.path(), ec);
+		}
+	}
+}
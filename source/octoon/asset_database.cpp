@@ -5,8 +5,11 @@
 #include <octoon/animator_component.h>
 #include <octoon/mesh_filter_component.h>
 #include <octoon/mesh_renderer_component.h>
+#include <chrono>
 #include <fstream>
 
+#include "spdlog/spdlog.h"
+
 namespace octoon
 {
 	OctoonImplementSingleton(AssetDatabase)
@@ -17,27 +20,47 @@ namespace octoon
 
 	AssetDatabase::~AssetDatabase() noexcept
 	{
+		std::unique_ptr<ThreadPool> threadPool;
+		{
+			std::lock_guard<std::mutex> lock(this->requestMutex_);
+			threadPool = std::move(this->threadPool_);
+		}
+
+		threadPool.reset();
+		requests_.clear();
+
 		assetCaches_.clear();
+
+		std::lock_guard<std::mutex> lock(this->pipelineMutex_);
 		assetPipeline_.clear();
 	}
 
 	void
 	AssetDatabase::mountPackage(const std::u8string& name, const std::filesystem::path& diskPath) noexcept(false)
 	{
-		for (auto& it : this->assetPipeline_)
+		auto pipeline = std::make_shared<AssetPipeline>(name);
+
 		{
-			if (it->getName() == name)
-				throw std::runtime_error(std::string("Mount package at path ") + (char*)diskPath.u8string().c_str() + " failed.");
+			std::lock_guard<std::mutex> lock(this->pipelineMutex_);
+
+			for (auto& it : this->assetPipeline_)
+			{
+				if (it->getName() == name)
+					throw std::runtime_error(std::string("Mount package at path ") + (char*)diskPath.u8string().c_str() + " failed.");
+			}
+
+			this->assetPipeline_.push_back(pipeline);
 		}
 
-		auto pipeline = std::make_shared<AssetPipeline>(name);
-		this->assetPipeline_.push_back(pipeline);
+		// opening imports the manifest, which resolves paths through this database again
 		pipeline->open(diskPath);
 	}
 
 	void
 	AssetDatabase::unmountPackage(const std::u8string& name) noexcept(false)
 	{
+		std::lock_guard<std::mutex> lock(this->pipelineMutex_);
+
 		for (auto it = this->assetPipeline_.begin(); it != this->assetPipeline_.end(); ++it)
 		{
 			if ((*it)->getName() == name)
@@ -273,6 +296,8 @@ namespace octoon
 	std::filesystem::path
 	AssetDatabase::getAbsolutePath(const std::filesystem::path& path) const noexcept
 	{
+		std::lock_guard<std::mutex> lock(this->pipelineMutex_);
+
 		for (auto& it : assetPipeline_)
 		{
 			if (it->isValidPath(path))
@@ -282,6 +307,18 @@ namespace octoon
 		return std::filesystem::path();
 	}
 
+	const AssetArtifactCache*
+	AssetDatabase::getArtifactCache(const std::filesystem::path& path) const noexcept
+	{
+		for (auto& it : assetPipeline_)
+		{
+			if (it->isValidPath(path))
+				return &it->getArtifactCache();
+		}
+
+		return nullptr;
+	}
+
 	std::filesystem::path
 	AssetDatabase::getAssetExtension(const std::shared_ptr<const Object>& asset, std::string_view defaultExtension) const noexcept
 	{
@@ -438,6 +475,22 @@ namespace octoon
 	std::shared_ptr<Object>
 	AssetDatabase::loadAssetAtPath(const std::filesystem::path& path) noexcept(false)
 	{
+		std::shared_ptr<AsyncRequest> request;
+
+		{
+			std::lock_guard<std::mutex> lock(this->requestMutex_);
+			auto it = this->requests_.find(path);
+			if (it != this->requests_.end())
+				request = it->second;
+		}
+
+		// the file is already being read for an asynchronous request, so finish that one here
+		if (request)
+		{
+			this->finishRequest(request);
+			return request->future.get();
+		}
+
 		if (!path.empty())
 		{
 			for (auto& it : assetPipeline_)
@@ -454,6 +507,148 @@ namespace octoon
 		return nullptr;
 	}
 
+	AssetDatabase::AssetFuture
+	AssetDatabase::loadAssetAtPathAsync(const std::filesystem::path& path) noexcept(false)
+	{
+		return this->loadAssetAtPathAsync(path, nullptr);
+	}
+
+	AssetDatabase::AssetFuture
+	AssetDatabase::loadAssetAtPathAsync(const std::filesystem::path& path, AssetCallback&& callback) noexcept(false)
+	{
+		std::lock_guard<std::mutex> lock(this->requestMutex_);
+
+		auto it = this->requests_.find(path);
+		if (it != this->requests_.end())
+		{
+			if (callback)
+				it->second->callbacks.push_back(std::move(callback));
+			return it->second->future;
+		}
+
+		auto request = std::make_shared<AsyncRequest>();
+		request->assetPath = path;
+		request->future = request->promise.get_future().share();
+
+		if (callback)
+			request->callbacks.push_back(std::move(callback));
+
+		if (!path.empty())
+		{
+			std::lock_guard<std::mutex> pipelineLock(this->pipelineMutex_);
+
+			for (auto& pipeline : this->assetPipeline_)
+			{
+				if (pipeline->isValidPath(path))
+				{
+					request->pipeline = pipeline;
+					request->importer = AssetPipeline::createImporter(path);
+					break;
+				}
+			}
+		}
+
+		if (request->importer)
+		{
+			if (!this->threadPool_)
+				this->threadPool_ = std::make_unique<ThreadPool>();
+
+			this->requests_[path] = request;
+			request->prepared = this->threadPool_->async([importer = request->importer, path]()
+			{
+				importer->onPrepareAsset(path);
+			});
+		}
+		else
+		{
+			// nothing to read; the request still resolves in update() like every other one
+			std::promise<void> prepared;
+			prepared.set_value();
+
+			this->requests_[path] = request;
+			request->prepared = prepared.get_future();
+		}
+
+		return request->future;
+	}
+
+	void
+	AssetDatabase::update() noexcept
+	{
+		std::vector<std::shared_ptr<AsyncRequest>> requests;
+
+		{
+			std::lock_guard<std::mutex> lock(this->requestMutex_);
+			for (auto& it : this->requests_)
+			{
+				if (it.second->prepared.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+					requests.push_back(it.second);
+			}
+		}
+
+		// a request may finish others it depends on (a model its textures), those are skipped below
+		for (auto& request : requests)
+			this->finishRequest(request);
+	}
+
+	std::size_t
+	AssetDatabase::getNumPendingLoads() const noexcept
+	{
+		std::lock_guard<std::mutex> lock(this->requestMutex_);
+		return this->requests_.size();
+	}
+
+	void
+	AssetDatabase::finishRequest(const std::shared_ptr<AsyncRequest>& request) noexcept
+	{
+		std::vector<AssetCallback> callbacks;
+
+		{
+			std::lock_guard<std::mutex> lock(this->requestMutex_);
+			auto it = this->requests_.find(request->assetPath);
+			if (it == this->requests_.end() || it->second != request)
+				return;
+
+			this->requests_.erase(it);
+			callbacks = std::move(request->callbacks);
+		}
+
+		std::shared_ptr<Object> object;
+
+		try
+		{
+			request->prepared.get();
+
+			if (request->importer)
+			{
+				object = request->pipeline->loadAssetAtPath(request->assetPath, *request->importer);
+				assetCaches_.clear();
+			}
+
+			request->promise.set_value(object);
+		}
+		catch (...)
+		{
+			request->promise.set_exception(std::current_exception());
+		}
+
+		for (auto& callback : callbacks)
+		{
+			try
+			{
+				callback(object);
+			}
+			catch (const std::exception& e)
+			{
+				spdlog::error("Callback for asset " + std::string((char*)request->assetPath.u8string().c_str()) + " failed: " + e.what());
+			}
+			catch (...)
+			{
+				spdlog::error("Callback for asset " + std::string((char*)request->assetPath.u8string().c_str()) + " failed.");
+			}
+		}
+	}
+
 	std::shared_ptr<Object>
 	AssetDatabase::loadAsset(const std::string& guid, std::int64_t localId) noexcept(false)
 	{
@@ -11,4 +11,9 @@ namespace octoon
 	AssetImporter::~AssetImporter() noexcept
 	{
 	}
+
+	void
+	AssetImporter::onPrepareAsset(const std::filesystem::path& assetPath) noexcept(false)
+	{
+	}
 }
\ No newline at end of file
@@ -38,6 +38,8 @@ namespace octoon
 
 		if (!diskPath.empty())
 		{
+			this->artifactCache_.setCachePath(std::filesystem::path(diskPath).append("Library").append("Artifacts"));
+
 			std::ifstream ifs(std::filesystem::path(diskPath).append("manifest.json"), std::ios_base::binary);
 			if (ifs)
 			{
@@ -58,6 +60,7 @@ namespace octoon
 	AssetPipeline::close() noexcept
 	{
 		rootPath_.clear();
+		artifactCache_.setCachePath(std::filesystem::path());
 	}
 
 	const std::u8string&
@@ -468,6 +471,12 @@ namespace octoon
 		return std::filesystem::path(this->rootPath_).append(this->getRelativePath(assetPath).wstring());
 	}
 
+	const AssetArtifactCache&
+	AssetPipeline::getArtifactCache() const noexcept
+	{
+		return artifactCache_;
+	}
+
 	std::filesystem::path
 	AssetPipeline::getRelativePath(const std::filesystem::path& assetPath) const noexcept(false)
 	{
@@ -517,8 +526,8 @@ namespace octoon
 		}
 	}
 
-	std::shared_ptr<Object>
-	AssetPipeline::loadAssetAtPath(const std::filesystem::path& path) noexcept(false)
+	std::shared_ptr<AssetImporter>
+	AssetPipeline::createImporter(const std::filesystem::path& path) noexcept
 	{
 		auto ext = path.extension().u8string();
 		for (auto& it : ext)
@@ -544,27 +553,40 @@ namespace octoon
 		else if (ext == u8".prefab")
 			assetImporter = std::make_shared<PrefabImporter>();
 
+		return assetImporter;
+	}
+
+	std::shared_ptr<Object>
+	AssetPipeline::loadAssetAtPath(const std::filesystem::path& path) noexcept(false)
+	{
+		auto assetImporter = createImporter(path);
 		if (assetImporter)
-		{
-			auto context = std::make_shared<AssetImporterContext>(path);
-			assetImporter->onImportAsset(*context);
+			return this->loadAssetAtPath(path, *assetImporter);
 
-			auto mainObject = context->getMainObject();
-			if (mainObject)
-			{
-				AssetManager::instance()->setAssetPath(mainObject, context->getAssetPath());
+		return nullptr;
+	}
 
-				for (auto& asset : context->getObjects())
-				{
-					if (AssetDatabase::instance()->getAssetPath(asset).empty())
-						AssetManager::instance()->setAssetPath(asset, context->getAssetPath());
+	std::shared_ptr<Object>
+	AssetPipeline::loadAssetAtPath(const std::filesystem::path& path, AssetImporter& assetImporter) noexcept(false)
+	{
+		auto context = std::make_shared<AssetImporterContext>(path);
+		assetImporter.onImportAsset(*context);
 
-					AssetManager::instance()->addObjectToAsset(asset, context->getAssetPath());
-				}
+		auto mainObject = context->getMainObject();
+		if (mainObject)
+		{
+			AssetManager::instance()->setAssetPath(mainObject, context->getAssetPath());
 
-				AssetDatabase::instance()->importAsset(path);
-				return mainObject;
+			for (auto& asset : context->getObjects())
+			{
+				if (AssetDatabase::instance()->getAssetPath(asset).empty())
+					AssetManager::instance()->setAssetPath(asset, context->getAssetPath());
+
+				AssetManager::instance()->addObjectToAsset(asset, context->getAssetPath());
 			}
+
+			AssetDatabase::instance()->importAsset(path);
+			return mainObject;
 		}
 
 		return nullptr;
@@ -172,6 +172,16 @@ namespace octoon
 	ClothComponent::setPartices(const math::float4s& partices) noexcept
 	{
 		partices_ = partices;
+
+		if (cloth_ && cloth_->getNumParticles() == partices_.size())
+		{
+			// writing the previous positions as well moves the particles without giving them a velocity
+			nv::cloth::MappedRange<physx::PxVec4> current = cloth_->getCurrentParticles();
+			std::memcpy(&current.front(), partices_.data(), partices_.size() * sizeof(math::float4));
+
+			nv::cloth::MappedRange<physx::PxVec4> previous = cloth_->getPreviousParticles();
+			std::memcpy(&previous.front(), partices_.data(), partices_.size() * sizeof(math::float4));
+		}
 	}
 	
 	const math::float4s&
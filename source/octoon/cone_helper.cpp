@@ -3,14 +3,40 @@
 #include <octoon/mesh_renderer_component.h>
 #include <octoon/mesh/cone_mesh.h>
 
+#include <map>
+#include <mutex>
+#include <tuple>
+
 namespace octoon
 {
+	namespace
+	{
+		// objects made with the same parameters share their mesh and default material, so the
+		// renderer can draw them as instances of one batch
+		std::mutex lock_;
+		std::map<std::tuple<float, float, std::uint32_t, float, float>, std::weak_ptr<Mesh>> meshes_;
+		std::weak_ptr<Material> material_;
+	}
+
 	GameObjectPtr
 	ConeHelper::create(float radius, float height, std::uint32_t segments, float thetaStart, float thetaLength)
 	{
+		std::unique_lock<std::mutex> guard(lock_);
+
+		auto& cached = meshes_[std::make_tuple(radius, height, segments, thetaStart, thetaLength)];
+		auto mesh = cached.lock();
+		if (!mesh)
+			cached = mesh = std::make_shared<ConeMesh>(radius, height, segments, thetaStart, thetaLength);
+
+		auto material = material_.lock();
+		if (!material)
+			material_ = material = std::make_shared<Material>();
+
+		guard.unlock();
+
 		auto object = std::make_shared<GameObject>(std::string_view("GameObject"));
-		object->addComponent<MeshFilterComponent>(std::make_shared<ConeMesh>(radius, height, segments, thetaStart, thetaLength));
-		object->addComponent<MeshRendererComponent>(std::make_shared<Material>());
+		object->addComponent<MeshFilterComponent>(mesh);
+		object->addComponent<MeshRendererComponent>(material)->isSharedMaterial(true);
 		return object;
 	}
 }
\ No newline at end of file
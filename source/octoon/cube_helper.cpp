@@ -3,14 +3,40 @@
 #include <octoon/mesh_renderer_component.h>
 #include <octoon/mesh/cube_mesh.h>
 
+#include <map>
+#include <mutex>
+#include <tuple>
+
 namespace octoon
 {
+	namespace
+	{
+		// objects made with the same parameters share their mesh and default material, so the
+		// renderer can draw them as instances of one batch
+		std::mutex lock_;
+		std::map<std::tuple<float, float, float, std::uint32_t, std::uint32_t, std::uint32_t>, std::weak_ptr<Mesh>> meshes_;
+		std::weak_ptr<Material> material_;
+	}
+
 	GameObjectPtr
-	CubeHelper::create(float width, float height, float depth, std::uint32_t widthSegments, std::uint32_t heightSegments, std::uint32_t depthSegments)
+	CubeHelper::create(float width, float height, float depth, std::uint32_t widthSegments, std::uint32_t heightSegments, std::uint32_t depthSegments) noexcept(false)
 	{
+		std::unique_lock<std::mutex> guard(lock_);
+
+		auto& cached = meshes_[std::make_tuple(width, height, depth, widthSegments, heightSegments, depthSegments)];
+		auto mesh = cached.lock();
+		if (!mesh)
+			cached = mesh = std::make_shared<CubeMesh>(width, height, depth, widthSegments, heightSegments, depthSegments);
+
+		auto material = material_.lock();
+		if (!material)
+			material_ = material = std::make_shared<Material>();
+
+		guard.unlock();
+
 		auto object = std::make_shared<GameObject>(std::string_view("GameObject"));
-		object->addComponent<MeshFilterComponent>(std::make_shared<CubeMesh>(width, height, depth, widthSegments, heightSegments, depthSegments));
-		object->addComponent<MeshRendererComponent>(std::make_shared<Material>());
+		object->addComponent<MeshFilterComponent>(mesh);
+		object->addComponent<MeshRendererComponent>(material)->isSharedMaterial(true);
 		return object;
 	}
 }
\ No newline at end of file
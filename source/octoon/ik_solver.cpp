@@ -0,0 +1,431 @@
+#include <octoon/ik_solver.h>
+#include <octoon/solver_component.h>
+#include <octoon/rotation_limit_component.h>
+#include <limits>
+
+namespace octoon
+{
+	constexpr std::size_t InvalidJoint = std::numeric_limits<std::size_t>::max();
+
+	IKSolver::IKSolver() noexcept
+	{
+	}
+
+	IKSolver::IKSolver(const GameObjects& bones) noexcept
+	{
+		this->setBones(bones);
+	}
+
+	IKSolver::~IKSolver() noexcept
+	{
+	}
+
+	void
+	IKSolver::setBones(const GameObjects& bones) noexcept
+	{
+		this->clear();
+
+		for (auto& bone : bones)
+		{
+			auto solver = bone->getComponent<CCDSolverComponent>();
+			if (solver)
+				this->addSolver(*solver);
+		}
+	}
+
+	void
+	IKSolver::addSolver(CCDSolverComponent& solver) noexcept
+	{
+		auto gameObject = solver.getGameObject();
+		if (!gameObject || !solver.getTarget())
+			return;
+
+		Chain chain;
+		chain.solver = &solver;
+		chain.goal = this->addJoint(gameObject->downcast_pointer<GameObject>());
+		chain.effector = this->addJoint(solver.getTarget());
+		chain.iterations = solver.getIterations();
+		chain.tolerance = solver.getTolerance();
+		chain.begin = links_.size();
+
+		for (auto& bone : solver.getBones())
+		{
+			Link link;
+			link.joint = this->addJoint(bone);
+			link.limit = false;
+			link.axisLimit = false;
+			link.solveAxis = SolveAxis::None;
+			link.minimumAngle = 0.0f;
+			link.maximumAngle = 0.0f;
+			link.minimumAxis = math::float3::Zero;
+			link.maximumAxis = math::float3::Zero;
+
+			auto limit = solver.getAxisLimitEnable() ? bone->getComponent<RotationLimitComponent>() : nullptr;
+			if (limit)
+			{
+				link.limit = true;
+				link.axisLimit = limit->getAxisLimitEnable();
+				link.minimumAngle = limit->getMininumAngle();
+				link.maximumAngle = limit->getMaximumAngle();
+				link.minimumAxis = limit->getMinimumAxis();
+				link.maximumAxis = limit->getMaximumAxis();
+
+				auto& low = link.minimumAxis;
+				auto& upper = link.maximumAxis;
+
+				bool fuzzyZeroX = low.x == 0 && upper.x == 0;
+				bool fuzzyZeroY = low.y == 0 && upper.y == 0;
+				bool fuzzyZeroZ = low.z == 0 && upper.z == 0;
+
+				if (!fuzzyZeroX && fuzzyZeroY && fuzzyZeroZ)
+					link.solveAxis = SolveAxis::X;
+				else if (!fuzzyZeroY && fuzzyZeroX && fuzzyZeroZ)
+					link.solveAxis = SolveAxis::Y;
+				else if (!fuzzyZeroZ && fuzzyZeroX && fuzzyZeroY)
+					link.solveAxis = SolveAxis::Z;
+			}
+
+			links_.push_back(link);
+		}
+
+		chain.end = links_.size();
+
+		// A leg: the effector hangs off a single-axis joint whose parent is the second link
+		chain.twoBone = false;
+		if (chain.end - chain.begin == 2)
+		{
+			auto& knee = links_[chain.begin];
+			auto& hip = links_[chain.begin + 1];
+
+			chain.twoBone =
+				knee.solveAxis != SolveAxis::None &&
+				hip.solveAxis == SolveAxis::None &&
+				parents_[chain.effector] == knee.joint &&
+				parents_[knee.joint] == hip.joint;
+		}
+
+		chains_.push_back(chain);
+	}
+
+	void
+	IKSolver::clear() noexcept
+	{
+		joints_.clear();
+		jointMap_.clear();
+		parents_.clear();
+		links_.clear();
+		chains_.clear();
+		startRotations_.clear();
+		solvedRotations_.clear();
+		pose_.setBones(GameObjects());
+	}
+
+	std::size_t
+	IKSolver::getNumChains() const noexcept
+	{
+		return chains_.size();
+	}
+
+	bool
+	IKSolver::empty() const noexcept
+	{
+		return chains_.empty();
+	}
+
+	void
+	IKSolver::solve() noexcept
+	{
+		if (chains_.empty())
+			return;
+
+		if (pose_.size() != joints_.size())
+		{
+			GameObjects joints(joints_.size());
+			for (std::size_t i = 0; i < joints_.size(); i++)
+			{
+				joints[i] = joints_[i].lock();
+				if (!joints[i])
+					return;
+			}
+
+			pose_.setBones(joints);
+		}
+		else
+		{
+			if (!pose_.acquire())
+				return;
+
+			pose_.fetch();
+		}
+
+		// links the animation does not key still hold the last result, which is replaced by the rotation
+		// they had before; a rotation that differs from the last result was written since and is kept
+		if (startRotations_.size() != links_.size())
+		{
+			startRotations_.resize(links_.size());
+			solvedRotations_.assign(links_.size(), math::Quaternion(0.0f, 0.0f, 0.0f, 0.0f));
+
+			for (std::size_t i = 0; i < links_.size(); i++)
+				startRotations_[i] = pose_.getLocalQuaternion(links_[i].joint);
+		}
+
+		for (std::size_t i = 0; i < links_.size(); i++)
+		{
+			auto joint = links_[i].joint;
+			if (pose_.getLocalQuaternion(joint) == solvedRotations_[i])
+				pose_.setLocalQuaternion(joint, startRotations_[i]);
+			else
+				startRotations_[i] = pose_.getLocalQuaternion(joint);
+		}
+
+		worlds_.resize(joints_.size());
+		dirty_.assign(joints_.size(), true);
+
+		this->updateWorld(0);
+
+		for (auto& chain : chains_)
+		{
+			if (chain.twoBone)
+				this->solveTwoBone(chain);
+			else
+				this->solveCCD(chain);
+		}
+
+		for (std::size_t i = 0; i < links_.size(); i++)
+			solvedRotations_[i] = pose_.getLocalQuaternion(links_[i].joint);
+
+		pose_.apply();
+
+		for (auto& chain : chains_)
+			chain.solver->evaluateRotationLink();
+
+		pose_.release();
+	}
+
+	std::size_t
+	IKSolver::addJoint(const GameObjectPtr& bone) noexcept
+	{
+		auto it = jointMap_.find(bone.get());
+		if (it != jointMap_.end())
+			return (*it).second;
+
+		// Parents are added first, so a single forward pass rebuilds the world matrices
+		auto parent = bone->getParent();
+		auto parentIndex = parent ? this->addJoint(parent) : InvalidJoint;
+
+		auto index = joints_.size();
+		joints_.push_back(bone);
+		parents_.push_back(parentIndex);
+		jointMap_[bone.get()] = index;
+
+		return index;
+	}
+
+	void
+	IKSolver::updateWorld(std::size_t first) noexcept
+	{
+		for (std::size_t i = first; i < joints_.size(); i++)
+		{
+			auto parent = parents_[i];
+			if (dirty_[i] || (parent != InvalidJoint && parent >= first && dirty_[parent]))
+			{
+				math::float4x4 local;
+				local.makeTransform(pose_.getLocalTranslate(i), pose_.getLocalQuaternion(i), pose_.getLocalScale(i));
+
+				worlds_[i] = parent != InvalidJoint ? math::transformMultiply(worlds_[parent], local) : local;
+				dirty_[i] = true;
+			}
+		}
+
+		for (std::size_t i = first; i < joints_.size(); i++)
+			dirty_[i] = false;
+	}
+
+	void
+	IKSolver::rotateLink(const Link& link, const math::float3& localEffector, const math::float3& localGoal, std::uint32_t iteration) noexcept
+	{
+		float deltaAngle = math::safe_acos(math::dot(localGoal, localEffector));
+		if (deltaAngle < 1e-5f)
+			return;
+
+		if (link.limit)
+			deltaAngle = math::clamp(deltaAngle, link.minimumAngle, link.maximumAngle);
+
+		auto& low = link.minimumAxis;
+		auto& upper = link.maximumAxis;
+
+		if (link.solveAxis != SolveAxis::None)
+		{
+			auto component = static_cast<std::uint8_t>(link.solveAxis);
+
+			math::float3 axis = math::float3::Zero;
+			axis[component] = 1.0f;
+
+			auto targetPositive = math::rotate(math::Quaternion(axis, deltaAngle), localEffector);
+			auto targetNegative = math::rotate(math::Quaternion(axis, -deltaAngle), localEffector);
+
+			auto dot1 = math::dot(targetPositive, localGoal);
+			auto dot2 = math::dot(targetNegative, localGoal);
+
+			auto newAngle = pose_.getLocalEulerAngles(link.joint)[component];
+			newAngle += dot1 > dot2 ? deltaAngle : -deltaAngle;
+
+			if (iteration == 0)
+			{
+				if (newAngle < low[component] || newAngle > upper[component])
+				{
+					if (-newAngle > low[component] && -newAngle < upper[component])
+						newAngle *= -1;
+					else
+					{
+						auto halfAngle = (low[component] + upper[component]) * 0.5f;
+						if (math::abs(halfAngle - newAngle) > math::abs(halfAngle + newAngle))
+							newAngle *= -1;
+					}
+				}
+			}
+
+			math::float3 euler = math::float3::Zero;
+			euler[component] = math::clamp(newAngle, low[component], upper[component]);
+
+			pose_.setLocalEulerAngles(link.joint, euler);
+		}
+		else
+		{
+			math::float3 axis = math::normalize(math::cross(localEffector, localGoal));
+
+			if (link.limit && link.axisLimit)
+			{
+				auto spin = pose_.getLocalEulerAngles(link.joint);
+				auto rotation = math::eulerAngles(math::normalize(math::Quaternion(axis, deltaAngle)));
+				rotation = math::clamp(rotation, low - spin, upper - spin) + spin;
+
+				pose_.setLocalEulerAngles(link.joint, rotation);
+			}
+			else
+			{
+				pose_.setLocalQuaternion(link.joint, math::normalize(pose_.getLocalQuaternion(link.joint) * math::normalize(math::Quaternion(axis, deltaAngle))));
+			}
+		}
+
+		dirty_[link.joint] = true;
+	}
+
+	void
+	IKSolver::solveCCD(const Chain& chain) noexcept
+	{
+		for (std::uint32_t iteration = 0; iteration < chain.iterations; iteration++)
+		{
+			for (std::size_t i = chain.begin; i < chain.end; i++)
+			{
+				auto& link = links_[i];
+				if (link.joint == chain.effector)
+					continue;
+
+				auto goal = worlds_[chain.goal].getTranslate();
+				auto effector = worlds_[chain.effector].getTranslate();
+				if (math::sqrDistance(goal, effector) < chain.tolerance)
+					return;
+
+				auto& world = worlds_[link.joint];
+				auto& position = world.getTranslate();
+
+				auto localGoal = math::normalize(math::invRotateVector3(world, goal - position));
+				auto localEffector = math::normalize(math::invRotateVector3(world, effector - position));
+
+				this->rotateLink(link, localEffector, localGoal, iteration);
+				this->updateWorld(link.joint);
+			}
+		}
+	}
+
+	void
+	IKSolver::solveTwoBone(const Chain& chain) noexcept
+	{
+		auto& knee = links_[chain.begin];
+		auto& hip = links_[chain.begin + 1];
+
+		auto component = static_cast<std::uint8_t>(knee.solveAxis);
+
+		// Everything below happens in the space of the hip, where the knee sits at a fixed offset u
+		// and the effector at u + R(angle) * w. Expanding |u + R(angle) * w| for a rotation about one
+		// axis gives A cos(angle) + B sin(angle) + C, so the knee angle that puts the effector at the
+		// distance of the goal has a closed form.
+		auto goal = math::transformInverse(worlds_[hip.joint]) * worlds_[chain.goal].getTranslate();
+		auto u = pose_.getLocalTranslate(knee.joint);
+		auto w = pose_.getLocalScale(knee.joint) * pose_.getLocalTranslate(chain.effector);
+
+		auto project = [&](float angle)
+		{
+			math::float3 euler = math::float3::Zero;
+			euler[component] = angle;
+			return math::dot(u, math::rotate(math::Quaternion(euler), w));
+		};
+
+		auto f0 = project(0.0f);
+		auto f1 = project(math::PI * 0.5f);
+		auto f2 = project(math::PI);
+
+		auto c = (f0 + f2) * 0.5f;
+		auto a = (f0 - f2) * 0.5f;
+		auto b = f1 - c;
+		auto r = std::sqrt(a * a + b * b);
+
+		if (r > 1e-6f)
+		{
+			auto target = (math::length2(goal) - math::length2(u) - math::length2(w)) * 0.5f - c;
+			auto phi = std::atan2(b, a);
+			auto alpha = std::acos(math::clamp(target / r, -1.0f, 1.0f));
+
+			auto low = knee.minimumAxis[component];
+			auto upper = knee.maximumAxis[component];
+			auto middle = (low + upper) * 0.5f;
+			auto current = pose_.getLocalEulerAngles(knee.joint)[component];
+
+			float bestAngle = current;
+			float bestError = std::numeric_limits<float>::max();
+			float bestDistance = std::numeric_limits<float>::max();
+
+			for (auto angle : { phi + alpha, phi - alpha })
+			{
+				// Wrap into the turn closest to the limits, then prefer the solution that needs no
+				// clamping and, among those, the one closest to the current pose
+				angle += math::PI * 2.0f * std::round((middle - angle) / (math::PI * 2.0f));
+
+				auto clamped = math::clamp(angle, low, upper);
+				auto error = math::abs(clamped - angle);
+				auto distance = math::abs(clamped - current);
+
+				if (error < bestError || (error == bestError && distance < bestDistance))
+				{
+					bestAngle = clamped;
+					bestError = error;
+					bestDistance = distance;
+				}
+			}
+
+			math::float3 euler = math::float3::Zero;
+			euler[component] = bestAngle;
+
+			pose_.setLocalEulerAngles(knee.joint, euler);
+			dirty_[knee.joint] = true;
+
+			this->updateWorld(knee.joint);
+		}
+
+		// With the knee at the right bend, a single swing of the hip lines the effector up with the
+		// goal. The per-step angle limit only exists to keep CCD stable, so it is not applied here.
+		auto& world = worlds_[hip.joint];
+		auto& position = world.getTranslate();
+
+		auto localGoal = math::normalize(math::invRotateVector3(world, worlds_[chain.goal].getTranslate() - position));
+		auto localEffector = math::normalize(math::invRotateVector3(world, worlds_[chain.effector].getTranslate() - position));
+
+		Link swing = hip;
+		swing.minimumAngle = 0.0f;
+		swing.maximumAngle = math::PI;
+
+		this->rotateLink(swing, localEffector, localGoal, 0);
+		this->updateWorld(hip.joint);
+	}
+}
@@ -603,6 +603,8 @@ namespace octoon
 						read_uvs(schema, sample, mesh->getTexcoordArray());
 						read_indices(schema, sample, mesh->getIndicesArray());
 
+						// the arrays were filled in place, so the raycast BVH has to be told; it rebuilds if the topology changed
+						mesh->setDirty(true);
 						mesh->computeBoundingBox();
 						mesh->computeVertexNormals();
 
@@ -633,6 +635,8 @@ namespace octoon
 						read_position(schema, sample, mesh->getVertexArray());
 						read_indices(schema, sample, mesh->getIndicesArray());
 
+						// the arrays were filled in place, so the raycast BVH has to be told; it rebuilds if the topology changed
+						mesh->setDirty(true);
 						mesh->computeBoundingBox();
 						mesh->computeVertexNormals();
 
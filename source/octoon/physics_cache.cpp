@@ -0,0 +1,679 @@
+#include <octoon/physics_cache.h>
+#include <octoon/physics_feature.h>
+#include <octoon/rigidbody_component.h>
+#include <octoon/cloth_component.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace octoon
+{
+	namespace
+	{
+		constexpr std::uint32_t CacheMagic = 0x4350434F; // "OCPC"
+		constexpr std::uint32_t CacheVersion = 1;
+		constexpr float QuantizeRange = 65535.0f;
+		constexpr float RotationRange = 32767.0f;
+		constexpr float RotationLimit = 0.70710678f;
+
+		struct CacheHeader
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint32_t numBodies;
+			std::uint32_t numParticles;
+			std::uint32_t snapshotInterval;
+			std::uint32_t frameSize;
+			std::uint32_t snapshotSize;
+			std::uint32_t numFrames;
+			float frameRate;
+			std::uint32_t reserved;
+			std::uint64_t layoutHash;
+			std::uint64_t padding[2];
+		};
+
+		struct FrameHeader
+		{
+			std::uint64_t inputKey;
+			float boundsMin[3];
+			float boundsScale[3];
+		};
+
+		struct BodyState
+		{
+			float position[3];
+			float rotation[4];
+			float linearVelocity[3];
+			float angularVelocity[3];
+		};
+
+		static_assert(sizeof(CacheHeader) == 64);
+		static_assert(sizeof(FrameHeader) == 32);
+
+		inline std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash = 14695981039346656037ull) noexcept
+		{
+			auto bytes = static_cast<const std::uint8_t*>(data);
+			for (std::size_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+
+			return hash;
+		}
+
+		inline std::size_t align8(std::size_t size) noexcept
+		{
+			return (size + 7) & ~std::size_t(7);
+		}
+
+		inline std::uint16_t quantize(float value, float min, float scale) noexcept
+		{
+			return static_cast<std::uint16_t>(std::clamp((value - min) * scale + 0.5f, 0.0f, QuantizeRange));
+		}
+
+		// The largest component is dropped and rebuilt from the unit length, the other three lie within
+		// +-1/sqrt(2) and get 15 bits each. The top bits of the first two hold the index of the dropped one.
+		inline void packRotation(const math::Quaternion& q, std::uint16_t packed[3]) noexcept
+		{
+			const float c[4] = { q.x, q.y, q.z, q.w };
+
+			std::uint16_t largest = 0;
+			for (std::uint16_t i = 1; i < 4; i++)
+			{
+				if (std::abs(c[i]) > std::abs(c[largest]))
+					largest = i;
+			}
+
+			auto sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+
+			for (std::uint16_t i = 0, n = 0; i < 4; i++)
+			{
+				if (i == largest)
+					continue;
+
+				auto v = std::clamp(c[i] * sign / RotationLimit * 0.5f + 0.5f, 0.0f, 1.0f);
+				packed[n++] = static_cast<std::uint16_t>(v * RotationRange + 0.5f);
+			}
+
+			packed[0] |= (largest & 1) << 15;
+			packed[1] |= (largest >> 1) << 15;
+		}
+
+		inline math::Quaternion unpackRotation(const std::uint16_t packed[3]) noexcept
+		{
+			auto largest = (packed[0] >> 15) | ((packed[1] >> 15) << 1);
+
+			float c[4];
+			float sum = 0.0f;
+
+			for (std::uint16_t i = 0, n = 0; i < 4; i++)
+			{
+				if (i == largest)
+					continue;
+
+				auto v = (packed[n++] & 0x7FFF) / RotationRange;
+				c[i] = (v * 2.0f - 1.0f) * RotationLimit;
+				sum += c[i] * c[i];
+			}
+
+			c[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+
+			return math::Quaternion(c);
+		}
+	}
+
+	PhysicsCache::PhysicsCache() noexcept
+		: frameRate_(30.0f)
+		, numFrames_(0)
+		, numParticles_(0)
+		, frameSize_(0)
+		, snapshotSize_(0)
+		, blockSize_(0)
+		, headFrame_(std::numeric_limits<std::size_t>::max())
+	{
+	}
+
+	PhysicsCache::~PhysicsCache() noexcept
+	{
+		this->close();
+	}
+
+	bool
+	PhysicsCache::open(const std::filesystem::path& path, const GameObjects& objects, float frameRate) noexcept
+	{
+		this->close();
+
+		GameObjects stack;
+		for (auto it = objects.rbegin(); it != objects.rend(); ++it)
+		{
+			if (*it)
+				stack.push_back(*it);
+		}
+
+		auto layoutHash = fnv1a(nullptr, 0);
+
+		while (!stack.empty())
+		{
+			auto object = std::move(stack.back());
+			stack.pop_back();
+
+			auto rigidbody = object->getComponent<RigidbodyComponent>();
+			if (rigidbody)
+			{
+				if (rigidbody->getIsKinematic())
+					kinematics_.push_back(object);
+				else
+				{
+					bodies_.push_back(object);
+					rigidbodies_.push_back(rigidbody.get());
+
+					auto& name = object->getName();
+					layoutHash = fnv1a(name.data(), name.size() + 1, layoutHash);
+				}
+			}
+
+			auto cloth = object->getComponent<ClothComponent>();
+			if (cloth)
+			{
+				auto count = static_cast<std::uint64_t>(cloth->getPartices().size());
+				layoutHash = fnv1a(&count, sizeof(count), layoutHash);
+
+				cloths_.push_back(cloth.get());
+				numParticles_ += cloth->getPartices().size();
+			}
+
+			auto& children = object->getChildren();
+			for (auto it = children.rbegin(); it != children.rend(); ++it)
+				stack.push_back(*it);
+		}
+
+		path_ = path;
+		frameRate_ = frameRate;
+		frameSize_ = align8(sizeof(FrameHeader) + bodies_.size() * sizeof(std::uint16_t) * 6 + numParticles_ * sizeof(std::uint16_t) * 3);
+		snapshotSize_ = align8(bodies_.size() * sizeof(BodyState) + numParticles_ * sizeof(math::float4));
+		blockSize_ = snapshotSize_ + frameSize_ * SnapshotInterval;
+
+		pose_.setBones(bodies_);
+
+		CacheHeader expected;
+		std::memset(&expected, 0, sizeof(expected));
+		expected.magic = CacheMagic;
+		expected.version = CacheVersion;
+		expected.numBodies = static_cast<std::uint32_t>(bodies_.size());
+		expected.numParticles = static_cast<std::uint32_t>(numParticles_);
+		expected.snapshotInterval = SnapshotInterval;
+		expected.frameSize = static_cast<std::uint32_t>(frameSize_);
+		expected.snapshotSize = static_cast<std::uint32_t>(snapshotSize_);
+		expected.frameRate = frameRate;
+		expected.layoutHash = layoutHash;
+
+		if (file_.open(path) && file_.size() >= sizeof(CacheHeader))
+		{
+			CacheHeader header;
+			std::memcpy(&header, file_.data(), sizeof(header));
+
+			expected.numFrames = header.numFrames;
+
+			if (std::memcmp(&header, &expected, sizeof(header)) == 0)
+			{
+				numFrames_ = header.numFrames;
+
+				// a crash while recording can leave the header ahead of the data
+				while (numFrames_ > 0 && this->getFrameOffset(numFrames_ - 1) + frameSize_ > file_.size())
+					numFrames_--;
+
+				return true;
+			}
+		}
+
+		file_.close();
+
+		std::error_code ec;
+		std::filesystem::create_directories(path.parent_path(), ec);
+
+		std::ofstream stream(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		if (!stream)
+		{
+			this->close();
+			return false;
+		}
+
+		expected.numFrames = 0;
+		stream.write((const char*)&expected, sizeof(expected));
+		return stream.good();
+	}
+
+	void
+	PhysicsCache::close() noexcept
+	{
+		if (stream_.is_open())
+		{
+			this->writeHeader();
+			stream_.close();
+		}
+
+		file_.close();
+		path_.clear();
+
+		numFrames_ = 0;
+		numParticles_ = 0;
+		headFrame_ = std::numeric_limits<std::size_t>::max();
+
+		bodies_.clear();
+		kinematics_.clear();
+		rigidbodies_.clear();
+		cloths_.clear();
+
+		pose_.setBones(GameObjects());
+	}
+
+	bool
+	PhysicsCache::isOpen() const noexcept
+	{
+		return !path_.empty();
+	}
+
+	float
+	PhysicsCache::getFrameRate() const noexcept
+	{
+		return frameRate_;
+	}
+
+	std::size_t
+	PhysicsCache::getNumFrames() const noexcept
+	{
+		return numFrames_;
+	}
+
+	std::size_t
+	PhysicsCache::getNumBodies() const noexcept
+	{
+		return bodies_.size();
+	}
+
+	std::size_t
+	PhysicsCache::getNumParticles() const noexcept
+	{
+		return numParticles_;
+	}
+
+	std::uint64_t
+	PhysicsCache::computeInputKey(const PhysicsFeature& feature) const noexcept
+	{
+		struct Settings
+		{
+			math::float3 gravity;
+			float fixedTimeStep;
+			std::uint32_t solverIterationCounts;
+			float frameRate;
+		};
+
+		Settings settings;
+		std::memset(&settings, 0, sizeof(settings));
+		settings.gravity = feature.getGravity();
+		settings.fixedTimeStep = feature.getFixedTimeStep();
+		settings.solverIterationCounts = feature.getSolverIterationCounts();
+		settings.frameRate = frameRate_;
+
+		auto hash = fnv1a(&settings, sizeof(settings));
+
+		// the pose is quantized first, so that rounding noise of the animation and the IK does not read as an edit
+		for (auto& it : kinematics_)
+		{
+			auto transform = it->getComponent<TransformComponent>();
+			auto& translate = transform->getTranslate();
+			auto& rotation = transform->getRotation();
+
+			std::int32_t values[7];
+			for (std::size_t k = 0; k < 3; k++)
+				values[k] = static_cast<std::int32_t>(std::lround(translate[k] * 1024.0f));
+
+			values[3] = static_cast<std::int32_t>(std::lround(rotation.x * 16384.0f));
+			values[4] = static_cast<std::int32_t>(std::lround(rotation.y * 16384.0f));
+			values[5] = static_cast<std::int32_t>(std::lround(rotation.z * 16384.0f));
+			values[6] = static_cast<std::int32_t>(std::lround(rotation.w * 16384.0f));
+
+			hash = fnv1a(values, sizeof(values), hash);
+		}
+
+		return hash;
+	}
+
+	std::uint64_t
+	PhysicsCache::getInputKey(std::size_t frame) const noexcept
+	{
+		if (frame >= numFrames_)
+			return 0;
+
+		auto data = this->map(this->getFrameOffset(frame), sizeof(FrameHeader));
+		if (!data)
+			return 0;
+
+		std::uint64_t key;
+		std::memcpy(&key, data, sizeof(key));
+		return key;
+	}
+
+	void
+	PhysicsCache::invalidate(std::size_t frame) noexcept
+	{
+		numFrames_ = std::min(numFrames_, frame);
+
+		if (headFrame_ != std::numeric_limits<std::size_t>::max() && headFrame_ >= frame)
+			headFrame_ = std::numeric_limits<std::size_t>::max();
+	}
+
+	bool
+	PhysicsCache::record(std::uint64_t inputKey) noexcept
+	{
+		if (!this->beginWrite())
+			return false;
+
+		auto frame = numFrames_;
+
+		head_.assign(snapshotSize_, 0);
+		this->captureState(head_.data());
+
+		if (frame % SnapshotInterval == 0)
+		{
+			stream_.seekp(this->getSnapshotOffset(frame));
+			stream_.write((const char*)head_.data(), head_.size());
+		}
+
+		math::float3 boundsMin = math::float3(std::numeric_limits<float>::max());
+		math::float3 boundsMax = math::float3(-std::numeric_limits<float>::max());
+
+		for (std::size_t i = 0; i < bodies_.size(); i++)
+		{
+			auto& translate = pose_.getTransform(i)->getTranslate();
+			boundsMin = math::min(boundsMin, translate);
+			boundsMax = math::max(boundsMax, translate);
+		}
+
+		for (auto& cloth : cloths_)
+		{
+			for (auto& it : cloth->getPartices())
+			{
+				boundsMin = math::min(boundsMin, it.xyz());
+				boundsMax = math::max(boundsMax, it.xyz());
+			}
+		}
+
+		FrameHeader header;
+		header.inputKey = inputKey;
+
+		for (std::uint8_t i = 0; i < 3; i++)
+		{
+			auto extent = boundsMax[i] - boundsMin[i];
+			header.boundsMin[i] = extent >= 0.0f ? boundsMin[i] : 0.0f;
+			header.boundsScale[i] = extent > 0.0f ? extent / QuantizeRange : 0.0f;
+		}
+
+		math::float3 scale;
+		for (std::uint8_t i = 0; i < 3; i++)
+			scale[i] = header.boundsScale[i] > 0.0f ? 1.0f / header.boundsScale[i] : 0.0f;
+
+		buffer_.assign(frameSize_, 0);
+		std::memcpy(buffer_.data(), &header, sizeof(header));
+
+		auto values = reinterpret_cast<std::uint16_t*>(buffer_.data() + sizeof(header));
+
+		for (std::size_t i = 0; i < bodies_.size(); i++, values += 6)
+		{
+			auto transform = pose_.getTransform(i);
+			auto& translate = transform->getTranslate();
+
+			for (std::uint8_t k = 0; k < 3; k++)
+				values[k] = quantize(translate[k], header.boundsMin[k], scale[k]);
+
+			packRotation(transform->getRotation(), values + 3);
+		}
+
+		for (auto& cloth : cloths_)
+		{
+			for (auto& it : cloth->getPartices())
+			{
+				for (std::uint8_t k = 0; k < 3; k++)
+					values[k] = quantize(it[k], header.boundsMin[k], scale[k]);
+				values += 3;
+			}
+		}
+
+		stream_.seekp(this->getFrameOffset(frame));
+		stream_.write((const char*)buffer_.data(), buffer_.size());
+
+		if (!stream_.good())
+		{
+			headFrame_ = std::numeric_limits<std::size_t>::max();
+			return false;
+		}
+
+		headFrame_ = frame;
+		numFrames_++;
+		return true;
+	}
+
+	std::size_t
+	PhysicsCache::getSnapshotFrame(std::size_t frame) const noexcept
+	{
+		return frame - frame % SnapshotInterval;
+	}
+
+	std::size_t
+	PhysicsCache::getResumeFrame(std::size_t frame) const noexcept
+	{
+		auto snapshot = this->getSnapshotFrame(frame);
+		if (headFrame_ < numFrames_ && headFrame_ <= frame && headFrame_ >= snapshot)
+			return headFrame_;
+
+		return snapshot;
+	}
+
+	bool
+	PhysicsCache::resume(std::size_t frame) noexcept
+	{
+		frame = this->getResumeFrame(frame);
+		if (frame >= numFrames_)
+			return false;
+
+		if (frame == headFrame_)
+		{
+			this->restoreState(head_.data());
+			return true;
+		}
+
+		auto data = this->map(this->getSnapshotOffset(frame), snapshotSize_);
+		if (!data)
+			return false;
+
+		this->restoreState(data);
+		return true;
+	}
+
+	bool
+	PhysicsCache::sample(float time) noexcept
+	{
+		auto position = std::max(0.0f, time * frameRate_);
+		auto frame = static_cast<std::size_t>(position);
+		if (frame >= numFrames_)
+			return false;
+
+		auto next = std::min(frame + 1, numFrames_ - 1);
+		auto t = next > frame ? position - frame : 0.0f;
+
+		auto a = this->map(this->getFrameOffset(frame), frameSize_);
+		auto b = this->map(this->getFrameOffset(next), frameSize_);
+		if (!a || !b)
+			return false;
+
+		FrameHeader headerA, headerB;
+		std::memcpy(&headerA, a, sizeof(headerA));
+		std::memcpy(&headerB, b, sizeof(headerB));
+
+		auto valuesA = reinterpret_cast<const std::uint16_t*>(a + sizeof(FrameHeader));
+		auto valuesB = reinterpret_cast<const std::uint16_t*>(b + sizeof(FrameHeader));
+
+		auto decode = [](const FrameHeader& header, const std::uint16_t* values)
+		{
+			return math::float3(
+				header.boundsMin[0] + values[0] * header.boundsScale[0],
+				header.boundsMin[1] + values[1] * header.boundsScale[1],
+				header.boundsMin[2] + values[2] * header.boundsScale[2]);
+		};
+
+		pose_.fetch();
+
+		for (std::size_t i = 0; i < bodies_.size(); i++, valuesA += 6, valuesB += 6)
+		{
+			auto translate = math::lerp(decode(headerA, valuesA), decode(headerB, valuesB), t);
+			auto rotation = math::slerp(unpackRotation(valuesA + 3), unpackRotation(valuesB + 3), t);
+
+			pose_.setTransform(i, translate, rotation, pose_.getTransform(i)->getScale());
+		}
+
+		pose_.apply();
+
+		for (auto& cloth : cloths_)
+		{
+			partices_ = cloth->getPartices();
+
+			for (auto& it : partices_)
+			{
+				it = math::float4(math::lerp(decode(headerA, valuesA), decode(headerB, valuesB), t), it.w);
+				valuesA += 3;
+				valuesB += 3;
+			}
+
+			cloth->setPartices(partices_);
+		}
+
+		return true;
+	}
+
+	std::size_t
+	PhysicsCache::getSnapshotOffset(std::size_t frame) const noexcept
+	{
+		return sizeof(CacheHeader) + (frame / SnapshotInterval) * blockSize_;
+	}
+
+	std::size_t
+	PhysicsCache::getFrameOffset(std::size_t frame) const noexcept
+	{
+		return this->getSnapshotOffset(frame) + snapshotSize_ + (frame % SnapshotInterval) * frameSize_;
+	}
+
+	const std::uint8_t*
+	PhysicsCache::map(std::size_t offset, std::size_t size) const noexcept
+	{
+		// the file can not be mapped while it is open for writing on every platform, and recording
+		// runs ahead of playback, so the writer is closed on the first read after it
+		if (stream_.is_open())
+		{
+			this->writeHeader();
+			stream_.close();
+		}
+
+		if (!file_.is_open() && !file_.open(path_))
+			return nullptr;
+
+		if (offset + size > file_.size())
+			return nullptr;
+
+		return file_.data() + offset;
+	}
+
+	bool
+	PhysicsCache::beginWrite() noexcept
+	{
+		if (path_.empty())
+			return false;
+
+		if (!stream_.is_open())
+		{
+			file_.close();
+			stream_.open(path_, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+		}
+
+		return stream_.good();
+	}
+
+	void
+	PhysicsCache::writeHeader() const noexcept
+	{
+		CacheHeader header;
+		std::memset(&header, 0, sizeof(header));
+
+		stream_.seekg(0);
+		stream_.read((char*)&header, sizeof(header));
+		stream_.clear();
+
+		header.numFrames = static_cast<std::uint32_t>(numFrames_);
+
+		stream_.seekp(0);
+		stream_.write((const char*)&header, sizeof(header));
+		stream_.flush();
+	}
+
+	void
+	PhysicsCache::captureState(std::uint8_t* state) const noexcept
+	{
+		for (std::size_t i = 0; i < bodies_.size(); i++, state += sizeof(BodyState))
+		{
+			auto transform = pose_.getTransform(i);
+			auto& translate = transform->getTranslate();
+			auto& rotation = transform->getRotation();
+			auto linearVelocity = rigidbodies_[i]->getLinearVelocity();
+			auto angularVelocity = rigidbodies_[i]->getAngularVelocity();
+
+			BodyState body;
+			std::memcpy(body.position, translate.ptr(), sizeof(body.position));
+			std::memcpy(body.rotation, &rotation.x, sizeof(body.rotation));
+			std::memcpy(body.linearVelocity, linearVelocity.ptr(), sizeof(body.linearVelocity));
+			std::memcpy(body.angularVelocity, angularVelocity.ptr(), sizeof(body.angularVelocity));
+			std::memcpy(state, &body, sizeof(body));
+		}
+
+		for (auto& cloth : cloths_)
+		{
+			auto& partices = cloth->getPartices();
+			std::memcpy(state, partices.data(), partices.size() * sizeof(math::float4));
+			state += partices.size() * sizeof(math::float4);
+		}
+	}
+
+	void
+	PhysicsCache::restoreState(const std::uint8_t* state) noexcept
+	{
+		std::vector<BodyState> states(bodies_.size());
+		if (!states.empty())
+			std::memcpy(states.data(), state, states.size() * sizeof(BodyState));
+
+		pose_.fetch();
+
+		for (std::size_t i = 0; i < states.size(); i++)
+			pose_.setTransform(i, math::float3(states[i].position), math::Quaternion(states[i].rotation), pose_.getTransform(i)->getScale());
+
+		pose_.apply();
+
+		for (std::size_t i = 0; i < states.size(); i++)
+		{
+			rigidbodies_[i]->setPositionAndRotation(math::float3(states[i].position), math::Quaternion(states[i].rotation));
+			rigidbodies_[i]->setLinearVelocity(math::float3(states[i].linearVelocity));
+			rigidbodies_[i]->setAngularVelocity(math::float3(states[i].angularVelocity));
+		}
+
+		state += states.size() * sizeof(BodyState);
+
+		for (auto& cloth : cloths_)
+		{
+			partices_.resize(cloth->getPartices().size());
+			std::memcpy(partices_.data(), state, partices_.size() * sizeof(math::float4));
+			state += partices_.size() * sizeof(math::float4);
+
+			cloth->setPartices(partices_);
+		}
+	}
+}
@@ -11,6 +11,7 @@ namespace octoon
 		, gravity_(0.0f, -9.8f, 0.0f)
 		, enableSimulate_(true)
 		, enableGround_(true)
+		, enableMultiThreading_(false)
 		, maxSubSteps_(10)
 		, fixedTimeStep_(1.0f / 50.0f)
 	{
@@ -47,6 +48,18 @@ namespace octoon
 		return this->enableGround_;
 	}
 
+	void
+	PhysicsFeature::setEnableMultiThreading(bool enable) noexcept
+	{
+		enableMultiThreading_ = enable;
+	}
+
+	bool
+	PhysicsFeature::getEnableMultiThreading() const noexcept
+	{
+		return enableMultiThreading_;
+	}
+
 	void
 	PhysicsFeature::setFixedTimeStep(float fixedTimeStep) noexcept
 	{
@@ -96,7 +109,7 @@ namespace octoon
 		if (physicsScene)
 		{
 			physicsScene->simulate(delta);
-			physicsScene->fetchResults();
+			this->fetchResults();
 		}
 	}
 
@@ -107,6 +120,60 @@ namespace octoon
 			physicsScene->reset();
 	}
 
+	void
+	PhysicsFeature::addFetchResult(GameObject* object, const math::float3& position, const math::Quaternion& rotation) noexcept
+	{
+		fetchObjects_.push_back(object);
+		fetchPositions_.push_back(position);
+		fetchRotations_.push_back(rotation);
+	}
+
+	void
+	PhysicsFeature::fetchResults() noexcept
+	{
+		physicsScene->fetchResults();
+
+		if (fetchObjects_.empty())
+			return;
+
+		// the bodies usually report in the same order every step, so the layout is only rebuilt
+		// when that set changes and is otherwise refreshed from the transforms
+		auto rebuild = !poseBuffer_.acquire() || poseBuffer_.size() != fetchObjects_.size();
+		if (!rebuild)
+		{
+			auto& bones = poseBuffer_.getBones();
+			for (std::size_t i = 0; i < fetchObjects_.size() && !rebuild; i++)
+				rebuild = bones[i].get() != fetchObjects_[i];
+		}
+
+		if (rebuild)
+		{
+			GameObjects objects;
+			objects.reserve(fetchObjects_.size());
+
+			for (auto& object : fetchObjects_)
+				objects.push_back(object->downcast_pointer<GameObject>());
+
+			poseBuffer_.setBones(objects);
+		}
+		else
+		{
+			poseBuffer_.fetch();
+		}
+
+		for (std::size_t i = 0; i < fetchObjects_.size(); i++)
+			poseBuffer_.setTransform(i, fetchPositions_[i], fetchRotations_[i]);
+
+		poseBuffer_.apply();
+
+		// the buffer must not keep the bodies of removed models alive until the next simulation step
+		poseBuffer_.release();
+
+		fetchObjects_.clear();
+		fetchPositions_.clear();
+		fetchRotations_.clear();
+	}
+
 	void
 	PhysicsFeature::onActivate() except
 	{
@@ -114,6 +181,7 @@ namespace octoon
 
 		PhysicsSceneDesc physicsSceneDesc;
 		physicsSceneDesc.gravity = gravity_;
+		physicsSceneDesc.enableMultiThreading = enableMultiThreading_;
 
 		physicsContext = PhysicsSystem::instance()->createContext(PhysicsDevice::Bullet);
 		physicsScene = physicsContext->createScene(physicsSceneDesc);
@@ -127,6 +195,8 @@ namespace octoon
 	{
 		this->removeMessageListener("feature:timer:fixed", std::bind(&PhysicsFeature::onFixedUpdate, this, std::placeholders::_1));
 
+		poseBuffer_.setBones(GameObjects());
+
 		physicsScene.reset();
 		physicsContext.reset();
 	}
@@ -160,7 +230,7 @@ namespace octoon
 			if (timeInterval > 0.0f && this->getEnableSimulate())
 			{
 				physicsScene->simulate(timeInterval);
-				physicsScene->fetchResults();
+				this->fetchResults();
 			}
 		}
 	}
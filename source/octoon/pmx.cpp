@@ -2,6 +2,7 @@
 #include <octoon/mesh/mesh.h>
 #include <octoon/material/mesh_standard_material.h>
 #include <octoon/io/fstream.h>
+#include <octoon/io/mapped_file.h>
 #include <octoon/math/mathfwd.h>
 #include <octoon/math/mathutil.h>
 #include <octoon/runtime/string.h>
@@ -44,8 +45,10 @@ namespace octoon
 	bool
 	PMX::load(const std::filesystem::path& filepath, PMX& pmx) noexcept
 	{
-		io::ifstream stream;
-		if (!stream.open(filepath)) return false;
+		io::MappedFile file;
+		if (!file.open(filepath)) return false;
+
+		io::MappedReader stream(file.data(), file.size());
 
 		if (!stream.read((char*)&pmx.header, sizeof(pmx.header))) return false;
 		if (!stream.read((char*)&pmx.description.japanModelLength, sizeof(pmx.description.japanModelLength))) return false;
@@ -88,6 +91,11 @@ namespace octoon
 
 		if (pmx.numVertices > 0)
 		{
+			// a corrupt count must fail here rather than in the allocation below
+			std::size_t minVertexSize = sizeof(PmxVertex::position) + sizeof(PmxVertex::normal) + sizeof(PmxVertex::coord) + sizeof(PmxVertex::addCoord[0]) * pmx.header.addUVCount;
+			minVertexSize += sizeof(PmxVertex::type) + pmx.header.sizeOfBone + sizeof(PmxVertex::edge);
+			if (stream.remaining() / minVertexSize < pmx.numVertices) return false;
+
 			pmx.vertices.resize(pmx.numVertices);
 
 			for (auto& vertex : pmx.vertices)
@@ -155,6 +163,7 @@ namespace octoon
 						if (!stream.read((char*)& vertex.weight.weight3, sizeof(vertex.weight.weight3))) return false;
 						if (!stream.read((char*)& vertex.weight.weight4, sizeof(vertex.weight.weight4))) return false;
 					}
+					break;
 					default:
 						return false;
 				}
@@ -167,8 +176,10 @@ namespace octoon
 
 		if (pmx.numIndices > 0)
 		{
-			pmx.indices.resize(pmx.numIndices * pmx.header.sizeOfIndices);
-			if (!stream.read((char*)pmx.indices.data(), pmx.indices.size())) return false;
+			auto indices = stream.view(std::size_t(pmx.numIndices) * pmx.header.sizeOfIndices);
+			if (!indices) return false;
+
+			pmx.indices.assign(indices, indices + std::size_t(pmx.numIndices) * pmx.header.sizeOfIndices);
 		}
 
 		if (!stream.read((char*)&pmx.numTextures, sizeof(pmx.numTextures))) return false;
@@ -660,8 +671,14 @@ namespace octoon
 					{
 						if (!stream.write((char*)&vertex.weight.bone1, pmx.header.sizeOfBone)) return false;
 						if (!stream.write((char*)&vertex.weight.bone2, pmx.header.sizeOfBone)) return false;
+						if (!stream.write((char*)&vertex.weight.bone3, pmx.header.sizeOfBone)) return false;
+						if (!stream.write((char*)&vertex.weight.bone4, pmx.header.sizeOfBone)) return false;
 						if (!stream.write((char*)&vertex.weight.weight1, sizeof(vertex.weight.weight1))) return false;
+						if (!stream.write((char*)&vertex.weight.weight2, sizeof(vertex.weight.weight2))) return false;
+						if (!stream.write((char*)&vertex.weight.weight3, sizeof(vertex.weight.weight3))) return false;
+						if (!stream.write((char*)&vertex.weight.weight4, sizeof(vertex.weight.weight4))) return false;
 					}
+					break;
 					default:
 						return false;
 				}
@@ -373,14 +373,36 @@ namespace octoon
 
 		materials.reserve(pmx.materials.size());
 
-		for (auto& it : pmx.textures)
+		// every texture is requested up front so they decode side by side on the worker pool; the loop
+		// below picks up the requests in order. A model prepared asynchronously has started them already.
+		std::vector<std::filesystem::path> texturePaths(pmx.textures.size());
+
+		for (std::size_t i = 0; i < pmx.textures.size(); i++)
 		{
+			try
+			{
+				auto assetPath = context.getAssetPath().parent_path().append(pmx.textures[i].name);
+				if (!std::filesystem::exists(AssetDatabase::instance()->getAbsolutePath(assetPath)))
+					continue;
+
+				AssetDatabase::instance()->loadAssetAtPathAsync(assetPath);
+				texturePaths[i] = std::move(assetPath);
+			}
+			catch (...)
+			{
+			}
+		}
+
+		for (std::size_t i = 0; i < pmx.textures.size(); i++)
+		{
+			auto& it = pmx.textures[i];
+
 			try
 			{
 				if (!textureMap.contains(it.name))
 				{
-					auto assetPath = context.getAssetPath().parent_path().append(it.name);
-					if (!std::filesystem::exists(AssetDatabase::instance()->getAbsolutePath(assetPath)))
+					auto& assetPath = texturePaths[i];
+					if (assetPath.empty())
 						continue;
 
 					auto texture = AssetDatabase::instance()->loadAssetAtPath<Texture>(assetPath);
@@ -460,6 +482,7 @@ namespace octoon
 		math::float3s normals_;
 		math::float2s texcoords_;
 		std::vector<VertexWeight> weights;
+		std::vector<VertexSkinning> skinnings;
 		std::vector<std::shared_ptr<Mesh>> meshes;
 
 		vertices_.resize(pmx.numVertices);
@@ -490,6 +513,25 @@ namespace octoon
 				weight.bone4 = v.weight.bone4 < pmx.numBones ? v.weight.bone4 : 0;
 
 				weights[i] = weight;
+
+				if (v.type == PmxVertexSkinningType::PMX_SDEF || v.type == PmxVertexSkinningType::PMX_QDEF)
+				{
+					if (skinnings.empty())
+						skinnings.resize(pmx.numVertices, VertexSkinning{ SkinningType::Linear });
+
+					auto& skinning = skinnings[i];
+					if (v.type == PmxVertexSkinningType::PMX_SDEF)
+					{
+						skinning.type = SkinningType::Sdef;
+						skinning.sdefC.set(v.weight.SDEF_C.x, v.weight.SDEF_C.y, v.weight.SDEF_C.z);
+						skinning.sdefR0.set(v.weight.SDEF_R0.x, v.weight.SDEF_R0.y, v.weight.SDEF_R0.z);
+						skinning.sdefR1.set(v.weight.SDEF_R1.x, v.weight.SDEF_R1.y, v.weight.SDEF_R1.z);
+					}
+					else
+					{
+						skinning.type = SkinningType::DualQuaternion;
+					}
+				}
 			}
 		}
 
@@ -500,6 +542,7 @@ namespace octoon
 		mesh->setNormalArray(std::move(normals_));
 		mesh->setTexcoordArray(std::move(texcoords_));
 		mesh->setWeightArray(std::move(weights));
+		mesh->setSkinningArray(std::move(skinnings));
 
 		PmxUInt32 startIndices = 0;
 
@@ -556,14 +599,40 @@ namespace octoon
 		}
 	}
 
+	void
+	PMXImporter::onPrepareAsset(const std::filesystem::path& assetPath) noexcept(false)
+	{
+		auto filepath = AssetDatabase::instance()->getAbsolutePath(assetPath);
+
+		auto pmx = std::make_unique<PMX>();
+		if (!PMX::load(filepath, *pmx))
+			return;
+
+		// the textures decode alongside the model; createMaterials picks up the requests on the render thread
+		for (auto& it : pmx->textures)
+		{
+			auto texturePath = assetPath.parent_path().append(it.name);
+			if (std::filesystem::exists(AssetDatabase::instance()->getAbsolutePath(texturePath)))
+				AssetDatabase::instance()->loadAssetAtPathAsync(texturePath);
+		}
+
+		this->pmx_ = std::move(pmx);
+	}
+
 	void
 	PMXImporter::onImportAsset(AssetImporterContext& context) noexcept(false)
 	{
 		auto filepath = AssetDatabase::instance()->getAbsolutePath(context.getAssetPath());
 
-		PMX pmx;
-		if (!PMX::load(filepath, pmx))
-			return;
+		auto prepared = std::move(this->pmx_);
+		if (!prepared)
+		{
+			prepared = std::make_unique<PMX>();
+			if (!PMX::load(filepath, *prepared))
+				return;
+		}
+
+		auto& pmx = *prepared;
 		
 		if (pmx.numMaterials > 0)
 		{
@@ -641,6 +710,7 @@ namespace octoon
 			{
 				auto mesh = mf->getMesh();
 				auto& weight = mesh->getWeightArray();
+				auto& skinning = mesh->getSkinningArray();
 
 				pmx.numVertices = mesh->getNumVertices();
 				pmx.numIndices = mesh->getNumIndices();
@@ -671,6 +741,21 @@ namespace octoon
 						pmxVertex.type = PmxVertexSkinningType::PMX_BDEF2;
 					else if (pmxVertex.weight.weight1 != 0)
 						pmxVertex.type = PmxVertexSkinningType::PMX_BDEF1;
+
+					if (i < skinning.size())
+					{
+						if (skinning[i].type == SkinningType::Sdef)
+						{
+							pmxVertex.type = PmxVertexSkinningType::PMX_SDEF;
+							pmxVertex.weight.SDEF_C = skinning[i].sdefC;
+							pmxVertex.weight.SDEF_R0 = skinning[i].sdefR0;
+							pmxVertex.weight.SDEF_R1 = skinning[i].sdefR1;
+						}
+						else if (skinning[i].type == SkinningType::DualQuaternion)
+						{
+							pmxVertex.type = PmxVertexSkinningType::PMX_QDEF;
+						}
+					}
 				}
 
 				for (std::size_t i = 0, offset = 0; i < mesh->getNumSubsets(); i++)
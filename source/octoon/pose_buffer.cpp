@@ -0,0 +1,336 @@
+#include <octoon/pose_buffer.h>
+#include <unordered_map>
+#include <limits>
+
+namespace octoon
+{
+	constexpr std::size_t InvalidIndex = std::numeric_limits<std::size_t>::max();
+
+	PoseBuffer::PoseBuffer() noexcept
+	{
+	}
+
+	PoseBuffer::PoseBuffer(const GameObjects& bones) noexcept
+	{
+		this->setBones(bones);
+	}
+
+	PoseBuffer::~PoseBuffer() noexcept
+	{
+	}
+
+	void
+	PoseBuffer::setBones(const GameObjects& bones) noexcept
+	{
+		bones_ = bones;
+		releasedBones_.clear();
+		releasedTransforms_.clear();
+
+		std::unordered_map<const GameObject*, std::size_t> boneMap;
+		for (std::size_t i = 0; i < bones_.size(); i++)
+			boneMap[bones_[i].get()] = i;
+
+		std::vector<std::size_t> depths(bones_.size());
+
+		parents_.resize(bones_.size());
+		transforms_.resize(bones_.size());
+
+		for (std::size_t i = 0; i < bones_.size(); i++)
+		{
+			auto parent = bones_[i]->getParent();
+			auto it = parent ? boneMap.find(parent.get()) : boneMap.end();
+
+			parents_[i] = it != boneMap.end() ? (*it).second : InvalidIndex;
+			transforms_[i] = bones_[i]->getComponent<TransformComponent>();
+
+			for (; parent; parent = parent->getParent())
+				depths[i]++;
+		}
+
+		order_.resize(bones_.size());
+		for (std::size_t i = 0; i < bones_.size(); i++)
+			order_[i] = i;
+
+		std::stable_sort(order_.begin(), order_.end(), [&](std::size_t a, std::size_t b) { return depths[a] < depths[b]; });
+
+		this->fetch();
+	}
+
+	const GameObjects&
+	PoseBuffer::getBones() const noexcept
+	{
+		return bones_;
+	}
+
+	std::size_t
+	PoseBuffer::size() const noexcept
+	{
+		return order_.size();
+	}
+
+	bool
+	PoseBuffer::empty() const noexcept
+	{
+		return order_.empty();
+	}
+
+	void
+	PoseBuffer::setLocalTranslate(std::size_t i, const math::float3& translate) noexcept
+	{
+		translates_[i] = translate;
+		dirty_[i] = true;
+		worldDirty_[i] = false;
+	}
+
+	const math::float3&
+	PoseBuffer::getLocalTranslate(std::size_t i) const noexcept
+	{
+		return translates_[i];
+	}
+
+	void
+	PoseBuffer::setLocalScale(std::size_t i, const math::float3& scale) noexcept
+	{
+		scales_[i] = scale;
+		dirty_[i] = true;
+		worldDirty_[i] = false;
+	}
+
+	const math::float3&
+	PoseBuffer::getLocalScale(std::size_t i) const noexcept
+	{
+		return scales_[i];
+	}
+
+	void
+	PoseBuffer::setLocalQuaternion(std::size_t i, const math::Quaternion& quat) noexcept
+	{
+		assert(math::abs(math::length(quat) - 1) < 1e-2f);
+
+		rotations_[i] = quat;
+		dirty_[i] = true;
+		worldDirty_[i] = false;
+		eulerDirty_[i] = true;
+	}
+
+	const math::Quaternion&
+	PoseBuffer::getLocalQuaternion(std::size_t i) const noexcept
+	{
+		return rotations_[i];
+	}
+
+	void
+	PoseBuffer::setLocalEulerAngles(std::size_t i, const math::float3& euler) noexcept
+	{
+		assert(math::isfinite(euler));
+
+		eulerAngles_[i] = euler;
+		rotations_[i] = math::normalize(math::Quaternion(euler));
+		dirty_[i] = true;
+		worldDirty_[i] = false;
+		eulerDirty_[i] = false;
+	}
+
+	const math::float3&
+	PoseBuffer::getLocalEulerAngles(std::size_t i) const noexcept
+	{
+		if (eulerDirty_[i])
+		{
+			eulerAngles_[i] = math::eulerAngles(rotations_[i]);
+			eulerDirty_[i] = false;
+		}
+
+		return eulerAngles_[i];
+	}
+
+	void
+	PoseBuffer::setLocalTransform(std::size_t i, const math::float3& translate, const math::Quaternion& quat, const math::float3& scale) noexcept
+	{
+		assert(math::abs(math::length(quat) - 1) < 1e-2f);
+
+		translates_[i] = translate;
+		rotations_[i] = quat;
+		scales_[i] = scale;
+		dirty_[i] = true;
+		worldDirty_[i] = false;
+		eulerDirty_[i] = true;
+	}
+
+	void
+	PoseBuffer::setTransform(std::size_t i, const math::float3& translate, const math::Quaternion& quat, const math::float3& scale) noexcept
+	{
+		assert(math::abs(math::length(quat) - 1) < 1e-2f);
+
+		worldTranslates_[i] = translate;
+		worldRotations_[i] = quat;
+		worldScales_[i] = scale;
+		dirty_[i] = true;
+		worldDirty_[i] = true;
+	}
+
+	const std::shared_ptr<TransformComponent>&
+	PoseBuffer::getTransform(std::size_t i) const noexcept
+	{
+		return transforms_[i];
+	}
+
+	void
+	PoseBuffer::fetch() noexcept
+	{
+		translates_.resize(bones_.size());
+		scales_.resize(bones_.size());
+		rotations_.resize(bones_.size());
+		eulerAngles_.resize(bones_.size());
+		worldTranslates_.resize(bones_.size());
+		worldScales_.resize(bones_.size());
+		worldRotations_.resize(bones_.size());
+		eulerDirty_.assign(bones_.size(), false);
+		worldDirty_.assign(bones_.size(), false);
+		dirty_.assign(bones_.size(), false);
+		changed_.assign(bones_.size(), false);
+		covered_.assign(bones_.size(), false);
+
+		for (std::size_t i = 0; i < bones_.size(); i++)
+		{
+			translates_[i] = transforms_[i]->getLocalTranslate();
+			scales_[i] = transforms_[i]->getLocalScale();
+			rotations_[i] = transforms_[i]->getLocalQuaternion();
+			eulerAngles_[i] = transforms_[i]->getLocalEulerAngles();
+		}
+	}
+
+	void
+	PoseBuffer::apply() noexcept
+	{
+		roots_.clear();
+
+		for (auto i : order_)
+		{
+			auto& transform = transforms_[i];
+			auto parent = parents_[i];
+
+			if (worldDirty_[i])
+			{
+				// the old world pose is only a valid comparison while no parent moves in this pass, otherwise
+				// the bone would inherit the parent's motion and lose the staged pose
+				changed_[i] = dirty_[i] && (
+					(parent != InvalidIndex && covered_[parent]) ||
+					transform->getTranslate() != worldTranslates_[i] ||
+					transform->getRotation() != worldRotations_[i] ||
+					transform->getScale() != worldScales_[i]);
+			}
+			else
+			{
+				changed_[i] = dirty_[i] && (
+					transform->local_translate_ != translates_[i] ||
+					transform->local_rotation_ != rotations_[i] ||
+					transform->local_scaling_ != scales_[i]);
+			}
+
+			dirty_[i] = false;
+			worldDirty_[i] = worldDirty_[i] && changed_[i];
+
+			// Only the topmost changed bone of each subtree needs to notify and invalidate,
+			// the game object forwards both to all of its children
+			auto covered = parent != InvalidIndex && covered_[parent];
+			if (changed_[i] && !covered)
+				roots_.push_back(i);
+
+			covered_[i] = changed_[i] || covered;
+		}
+
+		if (roots_.empty())
+			return;
+
+		for (auto i : roots_)
+			transforms_[i]->onMoveBefore();
+
+		for (auto i : order_)
+		{
+			if (changed_[i])
+			{
+				auto& transform = transforms_[i];
+				if (worldDirty_[i])
+				{
+					transform->translate_ = worldTranslates_[i];
+					transform->rotation_ = worldRotations_[i];
+					transform->scaling_ = worldScales_[i];
+					transform->euler_angles_ = math::eulerAngles(worldRotations_[i]);
+				}
+				else
+				{
+					transform->local_translate_ = translates_[i];
+					transform->local_rotation_ = rotations_[i];
+					transform->local_scaling_ = scales_[i];
+					transform->local_euler_angles_ = this->getLocalEulerAngles(i);
+					transform->local_need_updates_ = true;
+				}
+			}
+		}
+
+		for (auto i : roots_)
+			transforms_[i]->updateLocalChildren();
+
+		for (auto i : order_)
+		{
+			if (worldDirty_[i])
+			{
+				// The parent is final at this point, so the local pose can follow the staged world pose
+				auto& transform = transforms_[i];
+				transform->updateParentTransform();
+
+				translates_[i] = transform->local_translate_;
+				rotations_[i] = transform->local_rotation_;
+				scales_[i] = transform->local_scaling_;
+				eulerAngles_[i] = transform->local_euler_angles_;
+				eulerDirty_[i] = false;
+				worldDirty_[i] = false;
+			}
+			else if (covered_[i])
+			{
+				transforms_[i]->updateWorldTransform();
+			}
+		}
+
+		for (auto i : roots_)
+			transforms_[i]->onMoveAfter();
+	}
+
+	void
+	PoseBuffer::release() noexcept
+	{
+		if (bones_.size() != order_.size())
+			return;
+
+		releasedBones_.assign(bones_.begin(), bones_.end());
+		releasedTransforms_.assign(transforms_.begin(), transforms_.end());
+
+		bones_.clear();
+		transforms_.clear();
+	}
+
+	bool
+	PoseBuffer::acquire() noexcept
+	{
+		if (bones_.size() == order_.size())
+			return true;
+
+		bones_.resize(releasedBones_.size());
+		transforms_.resize(releasedTransforms_.size());
+
+		for (std::size_t i = 0; i < bones_.size(); i++)
+		{
+			bones_[i] = releasedBones_[i].lock();
+			transforms_[i] = releasedTransforms_[i].lock();
+
+			if (!bones_[i] || !transforms_[i])
+			{
+				bones_.clear();
+				transforms_.clear();
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
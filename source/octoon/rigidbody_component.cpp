@@ -301,7 +301,7 @@ namespace octoon
 	RigidbodyComponent::getLinearVelocity() const noexcept
 	{
 		if (rigidbody_)
-			rigidbody_->getLinearVelocity();
+			return rigidbody_->getLinearVelocity();
 		return math::float3::Zero;
 	}
 	
@@ -309,7 +309,7 @@ namespace octoon
 	RigidbodyComponent::getAngularVelocity() const noexcept
 	{
 		if (rigidbody_)
-			rigidbody_->getAngularVelocity();
+			return rigidbody_->getAngularVelocity();
 		return math::float3::Zero;
 	}
 
@@ -430,14 +430,12 @@ namespace octoon
 	{
 		if (rigidbody_ && !isKinematic_)
 		{
-			auto transform = this->getComponent<TransformComponent>();
-			if (transform)
-			{
-				this->position_ = rigidbody_->getPosition();
-				this->rotation_ = rigidbody_->getRotation();
-				
-				transform->setTransform(this->position_, this->rotation_);
-			}
+			this->position_ = rigidbody_->getPosition();
+			this->rotation_ = rigidbody_->getRotation();
+
+			auto physicsFeature = this->getFeature<PhysicsFeature>();
+			if (physicsFeature)
+				physicsFeature->addFetchResult(this->getGameObject(), this->position_, this->rotation_);
 		}
 	}
 
@@ -4,7 +4,6 @@
 #include <octoon/transform_component.h>
 #include <octoon/asset_database.h>
 #include <octoon/asset_importer.h>
-#include <omp.h>
 
 namespace octoon
 {
@@ -132,6 +131,18 @@ namespace octoon
 		return textureEnable_;
 	}
 
+	void
+	SkinnedMeshRendererComponent::setSkinningThreads(std::uint32_t count) noexcept
+	{
+		skinning_.setThreadCount(count);
+	}
+
+	std::uint32_t
+	SkinnedMeshRendererComponent::getSkinningThreads() const noexcept
+	{
+		return skinning_.getThreadCount();
+	}
+
 	const MeshPtr&
 	SkinnedMeshRendererComponent::getSkinnedMesh() noexcept
 	{
@@ -142,6 +153,15 @@ namespace octoon
 	void
 	SkinnedMeshRendererComponent::uploadMeshData(const MeshPtr& mesh) noexcept
 	{
+		if (mesh_ != mesh)
+		{
+			skinnedMesh_.reset();
+			morphTargets_.clear();
+			morphVertices_.clear();
+			morphNormals_.clear();
+			morphBlender_.clear();
+		}
+
 		mesh_ = mesh;
 		needUpdate_ = true;
 	}
@@ -167,6 +187,8 @@ namespace octoon
 			this->setTextureBlendEnable(json["textureBlendEnable"].get<bool>());
 		if (json.contains("updateWhenOffscreen"))
 			this->setUpdateWhenOffscreen(json["updateWhenOffscreen"].get<bool>());
+		if (json.contains("skinningThreads"))
+			this->setSkinningThreads(json["skinningThreads"].get<std::uint32_t>());
 
 		if (json.contains("bones"))
 		{
@@ -194,6 +216,7 @@ namespace octoon
 		json["morphBlendEnable"] = this->getMorphBlendEnable();
 		json["textureBlendEnable"] = this->getTextureBlendEnable();
 		json["updateWhenOffscreen"] = this->getUpdateWhenOffscreen();
+		json["skinningThreads"] = this->getSkinningThreads();
 
 		if (!this->getBones().empty())
 		{
@@ -228,6 +251,7 @@ namespace octoon
 		instance->setMorphBlendEnable(this->getMorphBlendEnable());
 		instance->setTextureBlendEnable(this->getTextureBlendEnable());
 		instance->setUpdateWhenOffscreen(this->getUpdateWhenOffscreen());
+		instance->setSkinningThreads(this->getSkinningThreads());
 
 		return instance;
 	}
@@ -245,6 +269,10 @@ namespace octoon
 	{
 		mesh_.reset();
 		skinnedMesh_.reset();
+		morphTargets_.clear();
+		morphVertices_.clear();
+		morphNormals_.clear();
+		morphBlender_.clear();
 		this->removeComponentDispatch(GameDispatchType::FixedUpdate);
 		this->removeMessageListener("octoon:animation:update", std::bind(&SkinnedMeshRendererComponent::onAnimationUpdate, this, std::placeholders::_1));
 		MeshRendererComponent::onDeactivate();
@@ -343,80 +371,95 @@ namespace octoon
 	void
 	SkinnedMeshRendererComponent::updateBoneData() noexcept
 	{
-		auto& vertices = skinnedMesh_->getVertexArray();
-		auto& normals = skinnedMesh_->getNormalArray();
+		auto& vertices = morphVertices_.empty() ? mesh_->getVertexArray() : morphVertices_;
+		auto& normals = morphNormals_.empty() ? mesh_->getNormalArray() : morphNormals_;
 		auto& weights = skinnedMesh_->getWeightArray();
+		auto& skinnings = skinnedMesh_->getSkinningArray();
 
-		auto numVertices = skinnedMesh_->getNumVertices();
-		auto numProcs = omp_get_num_procs() / 2;
+		skinning_.setJoints(joints_);
 
-#		pragma omp parallel for num_threads(numProcs) schedule(static)
-		for (std::int32_t i = 0; i < numVertices; i++)
+		if (clothEnable_ && !clothComponents_.empty())
 		{
-			auto& blend = weights[i];
-
-			auto w0 = blend.weights[0];
-			auto w1 = blend.weights[1];
-			auto w2 = blend.weights[2];
-			auto w3 = blend.weights[3];
+			skinnedMesh_->setVertexArray(vertices);
+			skinnedMesh_->setNormalArray(normals);
 
-			math::float3 v = vertices[i];
-			math::float3 n = normals[i];
+			this->updateClothBlendData();
 
-			math::float3 sumVertex = math::float3::Zero;
-			math::float3 sumNormal = math::float3::Zero;
-
-			if (w0 != 0.0f) { auto& m = joints_[blend.bones[0]]; sumVertex += (m * v) * w0; sumNormal += ((math::float3x3)m * n) * w0; }
-			if (w1 != 0.0f) { auto& m = joints_[blend.bones[1]]; sumVertex += (m * v) * w1; sumNormal += ((math::float3x3)m * n) * w1; }
-			if (w2 != 0.0f) { auto& m = joints_[blend.bones[2]]; sumVertex += (m * v) * w2; sumNormal += ((math::float3x3)m * n) * w2; }
-			if (w3 != 0.0f) { auto& m = joints_[blend.bones[3]]; sumVertex += (m * v) * w3; sumNormal += ((math::float3x3)m * n) * w3; }
-
-			normals[i] = sumNormal;
-			vertices[i] = sumVertex;
+			skinning_.skin(skinnedMesh_->getVertexArray(), skinnedMesh_->getNormalArray(), weights, skinnings);
+		}
+		else
+		{
+			skinning_.skin(vertices, normals, weights, skinnings, skinnedMesh_->getVertexArray(), skinnedMesh_->getNormalArray());
 		}
 	}
 
 	void
 	SkinnedMeshRendererComponent::updateClothBlendData() noexcept
 	{
-		if (clothEnable_)
-		{
-			auto& dstVertices = skinnedMesh_->getVertexArray();
+		auto& dstVertices = skinnedMesh_->getVertexArray();
 
-			for (auto& it : clothComponents_)
-			{
-				auto& indices = it->getIndices();
-				auto& partices = it->getPartices();
+		for (auto& it : clothComponents_)
+		{
+			auto& indices = it->getIndices();
+			auto& partices = it->getPartices();
 
-				std::size_t numIndices = indices.size();
-				for (std::size_t i = 0; i < numIndices; i++)
-					dstVertices[indices[i]] = partices[i].xyz();
-			}
+			std::size_t numIndices = indices.size();
+			for (std::size_t i = 0; i < numIndices; i++)
+				dstVertices[indices[i]] = partices[i].xyz();
 		}
 	}
 
 	void
 	SkinnedMeshRendererComponent::updateMorphBlendData() noexcept
 	{
-		if (morphEnable_)
+		if (!morphEnable_ || morphComponents_.empty())
 		{
-			auto& dstVertices = skinnedMesh_->getVertexArray();
-
-			for (auto& it : morphComponents_)
+			if (!morphVertices_.empty())
 			{
-				auto control = it->getControl();
-				if (control > 0.0f)
-				{
-					auto& indices = it->getIndices();
-					auto& offsets = it->getOffsets();
+				morphTargets_.clear();
+				morphVertices_.clear();
+				morphNormals_.clear();
+				morphBlender_.clear();
+			}
 
-					auto numIndices = indices.size();
+			return;
+		}
 
-					for (std::size_t i = 0; i < numIndices; i++)
-						dstVertices[indices[i]] += offsets[i] * control;
-				}
-			}
+		std::vector<MorphTarget> targets;
+		targets.reserve(morphComponents_.size());
+
+		for (auto& it : morphComponents_)
+		{
+			auto& indices = it->getIndices();
+			auto& offsets = it->getOffsets();
+			auto& normals = it->getNormalOffsets();
+
+			MorphTarget target;
+			target.indices = indices.data();
+			target.offsets = offsets.data();
+			target.normals = normals.size() == indices.size() && !normals.empty() ? normals.data() : nullptr;
+			target.count = std::min(indices.size(), offsets.size());
+			target.version = it->getVersion();
+
+			targets.push_back(target);
 		}
+
+		auto& baseVertices = mesh_->getVertexArray();
+		auto& baseNormals = mesh_->getNormalArray();
+
+		if (targets != morphTargets_ || morphVertices_.size() != baseVertices.size())
+		{
+			morphTargets_ = std::move(targets);
+			morphVertices_ = baseVertices;
+			morphNormals_ = baseNormals;
+			morphBlender_.build(baseVertices.size(), morphTargets_);
+		}
+
+		for (std::size_t i = 0; i < morphComponents_.size(); i++)
+			morphBlender_.setWeight(i, morphComponents_[i]->getControl());
+
+		morphBlender_.setThreadCount(skinning_.getThreadCount());
+		morphBlender_.update(baseVertices, baseNormals, morphVertices_, morphNormals_);
 	}
 
 	void
@@ -450,18 +493,10 @@ namespace octoon
 		{
 			if (mesh_)
 			{
-				if (this->skinnedMesh_)
-				{
-					this->skinnedMesh_->setVertexArray(mesh_->getVertexArray());
-					this->skinnedMesh_->setNormalArray(mesh_->getNormalArray());
-				}
-				else
-				{
+				if (!this->skinnedMesh_)
 					skinnedMesh_ = mesh_->clone();
-				}
 
 				this->updateJointData();
-				this->updateClothBlendData();
 				this->updateMorphBlendData();
 				this->updateTextureBlendData();
 				this->updateBoneData();
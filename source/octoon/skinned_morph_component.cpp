@@ -8,16 +8,19 @@ namespace octoon
 	OctoonImplementSubClass(SkinnedMorphComponent, SkinnedComponent, "SkinnedMorph")
 
 	SkinnedMorphComponent::SkinnedMorphComponent() noexcept
+		: version_(0)
 	{
 	}
 
 	SkinnedMorphComponent::SkinnedMorphComponent(math::float3s&& offsets, math::uint1s&& indices, float control) noexcept
+		: version_(0)
 	{
 		offsets_ = std::move(offsets);
 		indices_ = std::move(indices);
 	}
 
 	SkinnedMorphComponent::SkinnedMorphComponent(const math::float3s& offsets, const math::uint1s& indices, float control) noexcept
+		: version_(0)
 	{
 		offsets_ = offsets;
 		indices_ = indices;
@@ -31,12 +34,14 @@ namespace octoon
 	SkinnedMorphComponent::setOffsets(math::float3s&& offsets) noexcept
 	{
 		offsets_ = std::move(offsets);
+		version_++;
 	}
 
 	void
 	SkinnedMorphComponent::setOffsets(const math::float3s& offsets) noexcept
 	{
 		offsets_ = offsets;
+		version_++;
 	}
 
 	const math::float3s&
@@ -45,16 +50,38 @@ namespace octoon
 		return offsets_;
 	}
 
+	void
+	SkinnedMorphComponent::setNormalOffsets(math::float3s&& offsets) noexcept
+	{
+		normalOffsets_ = std::move(offsets);
+		version_++;
+	}
+
+	void
+	SkinnedMorphComponent::setNormalOffsets(const math::float3s& offsets) noexcept
+	{
+		normalOffsets_ = offsets;
+		version_++;
+	}
+
+	const math::float3s&
+	SkinnedMorphComponent::getNormalOffsets() const noexcept
+	{
+		return normalOffsets_;
+	}
+
 	void
 	SkinnedMorphComponent::setIndices(math::uint1s&& indices) noexcept
 	{
 		indices_ = std::move(indices);
+		version_++;
 	}
 
 	void
 	SkinnedMorphComponent::setIndices(const math::uint1s& indices) noexcept
 	{
 		indices_ = indices;
+		version_++;
 	}
 
 	const math::uint1s&
@@ -63,6 +90,12 @@ namespace octoon
 		return indices_;
 	}
 
+	std::uint32_t
+	SkinnedMorphComponent::getVersion() const noexcept
+	{
+		return version_;
+	}
+
 	void
 	SkinnedMorphComponent::load(const nlohmann::json& json) noexcept(false)
 	{
@@ -79,6 +112,7 @@ namespace octoon
 				this->setControl(component->getControl());
 				this->setIndices(component->getIndices());
 				this->setOffsets(component->getOffsets());
+				this->setNormalOffsets(component->getNormalOffsets());
 			}
 		}
 		else
@@ -97,8 +131,17 @@ namespace octoon
 			{
 				std::vector<char> buffer = base64_decode(json["indices"].get<std::string>());
 				this->indices_.resize(buffer.size() / sizeof(unsigned int));
-				std::memcpy(this->offsets_.data(), buffer.data(), buffer.size());
+				std::memcpy(this->indices_.data(), buffer.data(), buffer.size());
 			}
+
+			if (json.contains("normalOffsets"))
+			{
+				std::vector<char> buffer = base64_decode(json["normalOffsets"].get<std::string>());
+				this->normalOffsets_.resize(buffer.size() / sizeof(math::float3));
+				std::memcpy(this->normalOffsets_.data(), buffer.data(), buffer.size());
+			}
+
+			this->version_++;
 		}
 	}
 
@@ -120,6 +163,9 @@ namespace octoon
 			json["control"] = this->getControl();
 			json["offsets"] = base64_encode((unsigned char*)offsets_.data(), offsets_.size() * sizeof(math::float3));
 			json["indices"] = base64_encode((unsigned char*)indices_.data(), indices_.size() * sizeof(unsigned int));
+
+			if (!normalOffsets_.empty())
+				json["normalOffsets"] = base64_encode((unsigned char*)normalOffsets_.data(), normalOffsets_.size() * sizeof(math::float3));
 		}
 	}
 
@@ -130,6 +176,7 @@ namespace octoon
 		instance->setName(this->getName());
 		instance->setControl(this->getControl());
 		instance->setOffsets(this->getOffsets());
+		instance->setNormalOffsets(this->getNormalOffsets());
 		instance->setIndices(this->getIndices());
 		return instance;
 	}
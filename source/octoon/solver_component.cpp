@@ -1,22 +1,21 @@
 #include <octoon/solver_component.h>
+#include <octoon/ik_solver.h>
 #include <octoon/transform_component.h>
 #include <octoon/timer_feature.h>
-#include <octoon/rotation_limit_component.h>
 #include <octoon/rotation_link_component.h>
 #include <octoon/rotation_link_limit_component.h>
+#include <algorithm>
 
 namespace octoon
 {
-	enum class SolveAxis
+	OctoonImplementSubClass(CCDSolverComponent, GameComponent, "CCDSolver")
+
+	struct CCDSolverComponent::SharedSolver
 	{
-		X,
-		Y,
-		Z,
-		None
+		IKSolver solver;
+		std::vector<CCDSolverComponent*> members;
 	};
 
-	OctoonImplementSubClass(CCDSolverComponent, GameComponent, "CCDSolver")
-
 	CCDSolverComponent::CCDSolverComponent() noexcept
 		: maxIterations_(10)
 		, tolerance_(0.01f)
@@ -43,6 +42,7 @@ namespace octoon
 
 	CCDSolverComponent::~CCDSolverComponent() noexcept
 	{
+		this->invalidateSolver();
 	}
 
 	void
@@ -56,6 +56,8 @@ namespace octoon
 				this->tryRemoveComponentDispatch(GameDispatchType::FixedUpdate);
 
 			target_ = target;
+
+			this->invalidateModelSolver();
 		}
 	}
 
@@ -69,6 +71,7 @@ namespace octoon
 	CCDSolverComponent::setIterations(std::uint32_t iterations) noexcept
 	{
 		maxIterations_ = iterations;
+		this->invalidateSolver();
 	}
 
 	std::uint32_t
@@ -81,6 +84,7 @@ namespace octoon
 	CCDSolverComponent::setTolerance(float tolerance) noexcept
 	{
 		tolerance_ = tolerance;
+		this->invalidateSolver();
 	}
 
 	float
@@ -105,6 +109,7 @@ namespace octoon
 	CCDSolverComponent::setAxisLimitEnable(bool enable) noexcept
 	{
 		enableAxisLimit_ = enable;
+		this->invalidateSolver();
 	}
 
 	bool
@@ -124,6 +129,8 @@ namespace octoon
 				this->tryAddComponentDispatch(GameDispatchType::FixedUpdate);
 			else
 				this->tryRemoveComponentDispatch(GameDispatchType::FixedUpdate);
+
+			this->invalidateModelSolver();
 		}
 	}
 
@@ -137,24 +144,28 @@ namespace octoon
 	CCDSolverComponent::addBone(GameObjectPtr&& bone) noexcept
 	{
 		bones_.emplace_back(std::move(bone));
+		this->invalidateSolver();
 	}
 
 	void
 	CCDSolverComponent::addBone(const GameObjectPtr& bone) noexcept
 	{
 		bones_.push_back(bone);
+		this->invalidateSolver();
 	}
 
 	void
 	CCDSolverComponent::setBones(GameObjects&& bones) noexcept
 	{
 		bones_ = std::move(bones);
+		this->invalidateSolver();
 	}
 
 	void
 	CCDSolverComponent::setBones(const GameObjects& bones) noexcept
 	{
 		bones_ = bones;
+		this->invalidateSolver();
 	}
 
 	const GameObjectPtr&
@@ -172,8 +183,10 @@ namespace octoon
 	void
 	CCDSolverComponent::solve() noexcept
 	{
-		this->evaluateIK();
-		this->evaluateRotationLink();
+		if (!solver_)
+			this->buildSolver();
+
+		solver_->solver.solve();
 	}
 
 	GameComponentPtr
@@ -197,17 +210,27 @@ namespace octoon
 	{
 		if (this->getTarget() && this->getAutomaticUpdate())
 			this->addComponentDispatch(GameDispatchType::FixedUpdate);
+
+		this->invalidateModelSolver();
 	}
 
 	void
 	CCDSolverComponent::onDeactivate() noexcept
 	{
 		this->removeComponentDispatch(GameDispatchType::FixedUpdate);
+		this->invalidateSolver();
 	}
 
 	void
 	CCDSolverComponent::onFixedUpdate() noexcept
 	{
+		if (!solver_)
+			this->buildSolver();
+
+		// the other members of the model are solved in the same job
+		if (solver_->members.front() != this)
+			return;
+
 		if (timeStep_ > 0)
 		{
 			auto feature = this->getFeature<TimerFeature>();
@@ -229,145 +252,77 @@ namespace octoon
 	}
 
 	void
-	CCDSolverComponent::evaluateIK() noexcept
+	CCDSolverComponent::buildSolver() noexcept
 	{
-		auto end = this->getComponent<TransformComponent>();
-		auto target = this->getTarget()->getComponent<TransformComponent>();
+		auto shared = std::make_shared<SharedSolver>();
 
-		for (std::uint32_t iteration = 0; iteration < this->getIterations(); iteration++)
+		auto gameObject = this->getGameObject();
+		if (gameObject && this->getActive() && this->getAutomaticUpdate() && this->getTarget())
 		{
-			for (auto& bone : bones_)
-			{
-				if (bone == this->getTarget())
-					continue;
-
-				auto& jointEnd = end->getTranslate();
-				auto& jointTarget = target->getTranslate();
-				if (math::sqrDistance(jointEnd, jointTarget) < tolerance_)
-					return;
+			auto root = gameObject->downcast_pointer<GameObject>();
+			while (root->getParent())
+				root = root->getParent();
 
-				auto transform = bone->getComponent<TransformComponent>();
-				math::Vector3 localJointEnd = math::rotate(math::inverse(transform->getRotation()), jointEnd - transform->getTranslate());
-				math::Vector3 localJointTarget = math::rotate(math::inverse(transform->getRotation()), jointTarget - transform->getTranslate());
+			GameComponents components;
+			root->getComponentsInChildren<CCDSolverComponent>(components);
 
-				localJointEnd = math::normalize(localJointEnd);
-				localJointTarget = math::normalize(localJointTarget);
-
-				float cosDeltaAngle = math::dot(localJointTarget, localJointEnd);
-				float deltaAngle = math::safe_acos(cosDeltaAngle);
-				if (deltaAngle < 1e-5f)
+			for (auto& it : components)
+			{
+				auto solver = it->downcast<CCDSolverComponent>();
+				if (!solver->getActive() || !solver->getAutomaticUpdate() || !solver->getTarget())
 					continue;
 
-				SolveAxis solvePlane = SolveAxis::None;
-
-				std::shared_ptr<RotationLimitComponent> limitComponent = nullptr;
-				if (this->enableAxisLimit_)
-				{
-					limitComponent = bone->getComponent<RotationLimitComponent>();
-					if (limitComponent)
-					{
-						auto& low = limitComponent->getMinimumAxis();
-						auto& upper = limitComponent->getMaximumAxis();
-
-						bool fuzzyZeroX = (low.x == 0 && upper.x == 0) ? true : false;
-						bool fuzzyZeroY = (low.y == 0 && upper.y == 0) ? true : false;
-						bool fuzzyZeroZ = (low.z == 0 && upper.z == 0) ? true : false;
-
-						if	(	 (low.x != 0 || upper.x != 0) && fuzzyZeroY && fuzzyZeroZ)
-							solvePlane = SolveAxis::X;
-						else if ((low.y != 0 || upper.y != 0) && fuzzyZeroX && fuzzyZeroZ)
-							solvePlane = SolveAxis::Y;
-						else if ((low.z != 0 || upper.z != 0) && fuzzyZeroX && fuzzyZeroY)
-							solvePlane = SolveAxis::Z;
-
-						deltaAngle = math::clamp(deltaAngle, limitComponent->getMininumAngle(), limitComponent->getMaximumAngle());
-					}
-				}
-
-				if (solvePlane != SolveAxis::None)
-				{
-					std::uint8_t component = 0;
-					math::float3 axis(1, 0, 0);
-
-					switch (solvePlane)
-					{
-					case SolveAxis::X:
-						component = 0;
-						axis = math::float3(1, 0, 0);
-						break;
-					case SolveAxis::Y:
-						component = 1;
-						axis = math::float3(0, 1, 0);
-						break;
-					case SolveAxis::Z:
-						component = 2;
-						axis = math::float3(0, 0, 1);
-						break;
-					default:
-						break;
-					}
-
-					auto targetPositive = math::rotate(math::Quaternion(axis, deltaAngle), localJointTarget);
-					auto targetNegative = math::rotate(math::Quaternion(axis, -deltaAngle), localJointTarget);
-
-					auto dot1 = math::dot(targetPositive, localJointEnd);
-					auto dot2 = math::dot(targetNegative, localJointEnd);
+				if (std::find(shared->members.begin(), shared->members.end(), solver) != shared->members.end())
+					continue;
 
-					auto newAngle = transform->getLocalEulerAngles()[component];
-					newAngle += dot1 > dot2 ? deltaAngle : -deltaAngle;
+				solver->invalidateSolver();
+				shared->members.push_back(solver);
+			}
+		}
 
-					auto& low = limitComponent->getMinimumAxis();
-					auto& upper = limitComponent->getMaximumAxis();
+		if (std::find(shared->members.begin(), shared->members.end(), this) == shared->members.end())
+		{
+			this->invalidateSolver();
+			shared->members.assign(1, this);
+		}
 
-					if (iteration == 0)
-					{
-						if (newAngle < low[component] || newAngle > upper[component])
-						{
-							if (-newAngle > low[component] && -newAngle < upper[component])
-								newAngle *= -1;
-							else
-							{
-								auto halfAngle = (low[component] + upper[component]) * 0.5f;
-								if (math::abs(halfAngle - newAngle) > math::abs(halfAngle + newAngle))
-									newAngle *= -1;
-							}
-						}
-					}
+		for (auto& it : shared->members)
+		{
+			shared->solver.addSolver(*it);
+			it->solver_ = shared;
+		}
+	}
 
-					math::float3 eular = math::float3::Zero;
-					eular[component] = math::clamp(newAngle, low[component], upper[component]);
+	void
+	CCDSolverComponent::invalidateSolver() noexcept
+	{
+		auto shared = std::move(solver_);
+		if (shared)
+		{
+			for (auto& it : shared->members)
+				it->solver_.reset();
+		}
+	}
 
-					transform->setLocalEulerAngles(eular);
-				}
-				else
-				{
-					math::Vector3 axis = math::normalize(math::cross(localJointTarget, localJointEnd));
+	void
+	CCDSolverComponent::invalidateModelSolver() noexcept
+	{
+		auto gameObject = this->getGameObject();
+		if (!gameObject)
+		{
+			this->invalidateSolver();
+			return;
+		}
 
-					if (limitComponent)
-					{
-						if (limitComponent->getAxisLimitEnable())
-						{
-							auto& low = limitComponent->getMinimumAxis();
-							auto& upper = limitComponent->getMaximumAxis();
+		auto root = gameObject->downcast_pointer<GameObject>();
+		while (root->getParent())
+			root = root->getParent();
 
-							auto& spin = transform->getLocalEulerAngles();
-							auto rotation = math::eulerAngles(math::normalize(math::Quaternion(axis, deltaAngle)));
-							rotation = math::clamp(rotation, low - spin, upper - spin) + spin;
+		GameComponents components;
+		root->getComponentsInChildren<CCDSolverComponent>(components);
 
-							transform->setLocalEulerAngles(rotation);
-						}
-						else
-						{
-							transform->setLocalQuaternionAccum(math::normalize(math::Quaternion(axis, deltaAngle)));
-						}
-					}
-					else
-					{
-						transform->setLocalQuaternionAccum(math::normalize(math::Quaternion(axis, deltaAngle)));
-					}
-				}				
-			}
-		}
+		for (auto& it : components)
+			it->downcast<CCDSolverComponent>()->invalidateSolver();
 	}
 
 	void
@@ -383,9 +338,12 @@ namespace octoon
 					auto transform = bone->getComponent<TransformComponent>();
 					auto rotationLimit = transform->getComponent<RotationLinkLimitComponent>();
 
+					auto translate = transform->getLocalTranslate();
+					auto quaternion = transform->getLocalQuaternion();
+
 					auto additiveTranslate = link->getDeltaTranslate(rotationLimit->getAdditiveUseLocal());
 					if (rotationLimit->getAdditiveMoveRatio() != 0.0f)
-						transform->getComponent<TransformComponent>()->setLocalTranslate(additiveTranslate * rotationLimit->getAdditiveMoveRatio() + rotationLimit->getLocalTranslate());
+						translate = additiveTranslate * rotationLimit->getAdditiveMoveRatio() + rotationLimit->getLocalTranslate();
 
 					if (rotationLimit->getAdditiveRotationRatio() != 0.0f)
 					{
@@ -395,15 +353,17 @@ namespace octoon
 							if (rotationLimit->getAdditiveRotationRatio() > 0.0f)
 							{
 								auto rotation = math::slerp(math::Quaternion::Zero, additiveRotation, rotationLimit->getAdditiveRotationRatio());
-								transform->setLocalQuaternion(math::normalize(rotationLimit->getLocalQuaternion() * rotation));
+								quaternion = math::normalize(rotationLimit->getLocalQuaternion() * rotation);
 							}
 							else if (rotationLimit->getAdditiveRotationRatio() < 0.0f)
 							{
 								auto rotation = math::slerp(math::Quaternion::Zero, math::inverse(additiveRotation), -rotationLimit->getAdditiveRotationRatio());
-								transform->setLocalQuaternion(math::normalize(rotationLimit->getLocalQuaternion() * rotation));
+								quaternion = math::normalize(rotationLimit->getLocalQuaternion() * rotation);
 							}
 						}
 					}
+
+					transform->setLocalTransform(translate, quaternion, transform->getLocalScale());
 				}
 			}
 		}
@@ -4,14 +4,40 @@
 #include <octoon/mesh/sphere_mesh.h>
 #include <octoon/material/mesh_basic_material.h>
 
+#include <map>
+#include <mutex>
+#include <tuple>
+
 namespace octoon
 {
+	namespace
+	{
+		// objects made with the same parameters share their mesh and default material, so the
+		// renderer can draw them as instances of one batch
+		std::mutex lock_;
+		std::map<std::tuple<float, std::uint32_t, std::uint32_t, float, float, float, float>, std::weak_ptr<Mesh>> meshes_;
+		std::weak_ptr<Material> material_;
+	}
+
 	GameObjectPtr
 	SphereHelper::create(float radius, std::uint32_t widthSegments, std::uint32_t heightSegments, float phiStart, float phiLength, float thetaStart, float thetaLength) noexcept(false)
 	{
+		std::unique_lock<std::mutex> guard(lock_);
+
+		auto& cached = meshes_[std::make_tuple(radius, widthSegments, heightSegments, phiStart, phiLength, thetaStart, thetaLength)];
+		auto mesh = cached.lock();
+		if (!mesh)
+			cached = mesh = std::make_shared<SphereMesh>(radius, widthSegments, heightSegments, phiStart, phiLength, thetaStart, thetaLength);
+
+		auto material = material_.lock();
+		if (!material)
+			material_ = material = std::make_shared<MeshBasicMaterial>();
+
+		guard.unlock();
+
 		auto object = std::make_shared<GameObject>(std::string_view("GameObject"));
-		object->addComponent<MeshFilterComponent>(std::make_shared<SphereMesh>(radius, widthSegments, heightSegments, phiStart, phiLength, thetaStart, thetaLength));
-		object->addComponent<MeshRendererComponent>(std::make_shared<MeshBasicMaterial>());
+		object->addComponent<MeshFilterComponent>(mesh);
+		object->addComponent<MeshRendererComponent>(material)->isSharedMaterial(true);
 		return object;
 	}
 }
\ No newline at end of file
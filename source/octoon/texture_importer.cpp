@@ -1,41 +1,66 @@
 #include <octoon/texture_importer.h>
 #include <octoon/asset_database.h>
+#include <octoon/texture/texture_processing.h>
+#include <algorithm>
+#include <fstream>
 
 namespace octoon
 {
-	OctoonImplementSubClass(TextureImporter, AssetImporter, "TextureImporter")
-
-	TextureImporter::TextureImporter() noexcept
+	namespace
 	{
-	}
+		struct TextureSettings
+		{
+			std::uint32_t mipLevel = 0;
+			TextureFilter mipFilter = TextureFilter::Kaiser;
+			std::string compression = "none";
+		};
 
-	TextureImporter::~TextureImporter()
-	{
-	}
+		bool isColor8(const Format& format) noexcept
+		{
+			auto value = format.value_type();
+			if (value != value_t::UNorm && value != value_t::SRGB)
+				return false;
 
-	void
-	TextureImporter::onImportAsset(AssetImporterContext& context) noexcept(false)
-	{
-		auto filepath = AssetDatabase::instance()->getAbsolutePath(context.getAssetPath());
+			auto swizzle = format.swizzle_type();
+			if (swizzle != swizzle_t::RGB && swizzle != swizzle_t::BGR && swizzle != swizzle_t::RGBA && swizzle != swizzle_t::BGRA)
+				return false;
+
+			return format.type_size() == 1;
+		}
 
-		auto texture = std::make_shared<Texture>();
-		if (texture->load(filepath))
+		// Keys missing from the .meta default to a full mip chain and BC1/BC3 for 8-bit colour images,
+		// which the importer does not write on its own.
+		TextureSettings readTextureSettings(const nlohmann::json& metadata, const std::filesystem::path& filepath, const Texture& texture) noexcept
 		{
-			texture->setName((char*)filepath.filename().u8string().c_str());
+			TextureSettings settings;
+
+			if (isColor8(texture.format()))
+			{
+				settings.mipLevel = 1;
+				for (auto size = std::max(texture.width(), texture.height()); size > 1; size >>= 1)
+					settings.mipLevel++;
+
+				settings.compression = "auto";
+			}
 
-			auto metadata = context.getMetadata();
 			if (metadata.is_object())
 			{
 				if (metadata.contains("mipmap"))
-					texture->setMipLevel(metadata["mipmap"].get<nlohmann::json::number_integer_t>());
+					settings.mipLevel = metadata["mipmap"].get<nlohmann::json::number_integer_t>();
 
-				if (metadata.contains("labels"))
+				if (metadata.contains("mipmapFilter"))
 				{
-					std::vector<std::string> labels;
-					for (auto& it : metadata["labels"])
-						labels.push_back(it.get<std::string>());
-					AssetDatabase::instance()->setLabels(texture, std::move(labels));
+					auto filter = metadata["mipmapFilter"].get<std::string>();
+					if (filter == "box")
+						settings.mipFilter = TextureFilter::Box;
+					else if (filter == "triangle")
+						settings.mipFilter = TextureFilter::Triangle;
+					else if (filter == "lanczos")
+						settings.mipFilter = TextureFilter::Lanczos;
 				}
+
+				if (metadata.contains("compression"))
+					settings.compression = metadata["compression"].get<std::string>();
 			}
 			else
 			{
@@ -44,12 +69,158 @@ namespace octoon
 					it = (char)std::tolower(it);
 
 				if (ext == u8".hdr")
-					texture->setMipLevel(8);
+					settings.mipLevel = 8;
+			}
+
+			return settings;
+		}
+
+		bool hasTransparency(const Texture& texture) noexcept
+		{
+			auto swizzle = texture.format().swizzle_type();
+			if (swizzle != swizzle_t::RGBA && swizzle != swizzle_t::BGRA)
+				return false;
+
+			auto pixels = std::size_t(texture.width()) * texture.height() * texture.getLayerLevel();
+			auto data = texture.data();
+
+			for (std::size_t i = 0; i < pixels; i++)
+			{
+				if (data[i * 4 + 3] != 255)
+					return true;
+			}
+
+			return false;
+		}
+
+		// Compressed formats are picked as UNorm even for sRGB images, because uncompressed sRGB
+		// images are uploaded as UNorm too and materials expect to see the same values.
+		Format getCompressedFormat(const Texture& texture, const std::string& compression) noexcept
+		{
+			if (compression == "bc1")
+				return Format::BC1RGBUNormBlock;
+			else if (compression == "bc3")
+				return Format::BC3UNormBlock;
+			else if (compression == "bc5")
+				return Format::BC5UNormBlock;
+			else if (compression == "bc7")
+				return Format::BC7UNormBlock;
+			else if (compression == "auto")
+				return hasTransparency(texture) ? Format::BC3UNormBlock : Format::BC1RGBUNormBlock;
+
+			return Format::Undefined;
+		}
+
+		std::shared_ptr<Texture> processTexture(std::shared_ptr<Texture> texture, const TextureSettings& settings) noexcept(false)
+		{
+			if (settings.mipLevel > 1 && texture->getMipLevel() < settings.mipLevel && isFilterableFormat(texture->format()) && texture->depth() == 1)
+			{
+				auto filter = settings.mipFilter;
+				if (texture->format().value_type() == value_t::Float && filter != TextureFilter::Box)
+					filter = TextureFilter::Box;
+
+				texture = std::make_shared<Texture>(generateMipmaps(*texture, settings.mipLevel, filter));
+			}
+
+			if (settings.compression != "none")
+			{
+				auto format = getCompressedFormat(*texture, settings.compression);
+				if (format != Format::Undefined && isCompressibleFormat(texture->format(), format) && texture->depth() == 1)
+					texture = std::make_shared<Texture>(compressTexture(*texture, format));
+			}
+
+			return texture;
+		}
+
+		// The cached artifact is the processed texture. The .meta file is part of the cache key, so a
+		// change of import settings misses the cache and the texture is processed again.
+		std::shared_ptr<Texture> decodeTexture(const std::filesystem::path& assetPath) noexcept(false)
+		{
+			auto filepath = AssetDatabase::instance()->getAbsolutePath(assetPath);
+			auto cache = AssetDatabase::instance()->getArtifactCache(assetPath);
+			if (cache)
+			{
+				auto texture = cache->loadTexture(filepath);
+				if (texture)
+					return texture;
 			}
 
-			texture->apply();
+			auto texture = std::make_shared<Texture>();
+			if (!texture->load(filepath))
+				return nullptr;
+
+			nlohmann::json metadata;
+			std::ifstream ifs(std::filesystem::path(filepath).concat(L".meta"));
+			if (ifs)
+				metadata = nlohmann::json::parse(ifs);
 
-			context.setMainObject(texture);
+			auto settings = readTextureSettings(metadata, filepath, *texture);
+			texture = processTexture(std::move(texture), settings);
+
+			if (cache)
+				cache->saveTexture(filepath, *texture);
+
+			return texture;
 		}
 	}
+
+	OctoonImplementSubClass(TextureImporter, AssetImporter, "TextureImporter")
+
+	TextureImporter::TextureImporter() noexcept
+	{
+	}
+
+	TextureImporter::~TextureImporter()
+	{
+	}
+
+	void
+	TextureImporter::onPrepareAsset(const std::filesystem::path& assetPath) noexcept(false)
+	{
+		this->texture_ = decodeTexture(assetPath);
+	}
+
+	void
+	TextureImporter::onImportAsset(AssetImporterContext& context) noexcept(false)
+	{
+		auto filepath = AssetDatabase::instance()->getAbsolutePath(context.getAssetPath());
+
+		auto texture = std::move(this->texture_);
+		if (!texture)
+		{
+			texture = decodeTexture(context.getAssetPath());
+			if (!texture)
+				return;
+		}
+
+		texture->setName((char*)filepath.filename().u8string().c_str());
+
+		auto metadata = context.getMetadata();
+		if (metadata.is_object())
+		{
+			if (metadata.contains("labels"))
+			{
+				std::vector<std::string> labels;
+				for (auto& it : metadata["labels"])
+					labels.push_back(it.get<std::string>());
+				AssetDatabase::instance()->setLabels(texture, std::move(labels));
+			}
+		}
+
+		// Formats the CPU cannot filter still get their chain from the driver. A chain built on the CPU
+		// already holds every level the image size allows and keeps its own count.
+		auto settings = readTextureSettings(metadata, filepath, *texture);
+		if (texture->getMipLevel() == 1 && settings.mipLevel > 1 && texture->format().value_type() != value_t::Compressed)
+		{
+			std::uint32_t numLevels = 1;
+			while ((std::max(texture->width(), texture->height()) >> numLevels) > 0)
+				numLevels++;
+
+			texture->setMipLevel(std::min(numLevels, settings.mipLevel));
+		}
+
+		texture->apply();
+
+		context.setMainObject(texture);
+	}
 }
\ No newline at end of file
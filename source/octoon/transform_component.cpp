@@ -354,6 +354,26 @@ namespace octoon
 		this->onMoveAfter();
 	}
 
+	void
+	TransformComponent::setLocalTransform(const math::float3& translate, const math::Quaternion& quat, const math::float3& scale) noexcept
+	{
+		assert(math::abs(math::length(quat) - 1) < 1e-2f);
+
+		if (local_translate_ != translate || local_rotation_ != quat || local_scaling_ != scale)
+		{
+			this->onMoveBefore();
+
+			local_scaling_ = scale;
+			local_rotation_ = quat;
+			local_translate_ = translate;
+			local_euler_angles_ = math::eulerAngles(quat);
+			local_need_updates_ = true;
+
+			this->updateLocalChildren();
+			this->onMoveAfter();
+		}
+	}
+
 	void
 	TransformComponent::setLocalTransformOnlyRotate(const math::float4x4& transform) noexcept
 	{
@@ -1,6 +1,7 @@
 #if defined(OCTOON_FEATURE_VIDEO_ENABLE)
 #include <octoon/video_feature.h>
 #include <octoon/video/renderer.h>
+#include <octoon/asset_database.h>
 
 #include <octoon/input_feature.h>
 #include <octoon/input/input_event.h>
@@ -237,6 +238,8 @@ namespace octoon
 	void
 	VideoFeature::onFrameBegin() noexcept
 	{
+		// asynchronous loads upload their textures here, where the graphics context is current
+		AssetDatabase::instance()->update();
 	}
 
 	void
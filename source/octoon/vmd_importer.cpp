@@ -8,6 +8,7 @@
 #include <octoon/runtime/string.h>
 #include <octoon/animation/path_interpolator.h>
 #include <octoon/io/fstream.h>
+#include <octoon/io/mapped_file.h>
 #include <iconv.h>
 #include <map>
 #include <fstream>
@@ -224,14 +225,45 @@ namespace octoon
 	bool
 	VMD::load(const std::filesystem::path& filepath) noexcept(false)
 	{
-		std::ifstream stream(filepath, std::ios_base::binary);
-		if (stream)
-		{
-			load(stream);
-			return true;
+		io::MappedFile file;
+		if (!file.open(filepath))
+			return false;
+
+		io::MappedReader reader(file.data(), file.size());
+
+		if (!reader.read((char*)&this->Header, sizeof(this->Header))) {
+			throw runtime_error::create(R"(Cannot read property "Header" from stream)");
 		}
 
-		return false;
+		if (std::strncmp(this->Header.magic, "Vocaloid Motion", 30) != 0 && std::strncmp(this->Header.magic, "Vocaloid Motion Data 0002", 30) != 0)
+			throw runtime_error::create(R"(Invalid Magic Token)");
+
+		// every section is a count followed by fixed-size records, so each is bounds checked once and copied in one go
+		auto readSection = [&](auto& list, VMD_uint32_t& count, const char* name)
+		{
+			if (!reader.read((char*)&count, sizeof(count)))
+				throw runtime_error::create(std::string("Cannot read property \"Num") + name + "\" from stream");
+
+			if (count > 0)
+			{
+				using Record = typename std::remove_reference_t<decltype(list)>::value_type;
+
+				auto records = reader.view(std::size_t(count) * sizeof(Record));
+				if (!records)
+					throw runtime_error::create(std::string("Cannot read property \"VMD") + name + "\" from stream");
+
+				list.resize(count);
+				std::memcpy(list.data(), records, std::size_t(count) * sizeof(Record));
+			}
+		};
+
+		readSection(this->MotionLists, this->NumMotion, "Motion");
+		readSection(this->MorphLists, this->NumMorph, "Morph");
+		readSection(this->CameraLists, this->NumCamera, "Camera");
+		readSection(this->LightLists, this->NumLight, "Light");
+		readSection(this->SelfShadowLists, this->NumSelfShadow, "SelfShadow");
+
+		return true;
 	}
 
 	bool
@@ -426,15 +458,51 @@ namespace octoon
 		vmd.save(stream);
 	}
 
+	void
+	VMDImporter::onPrepareAsset(const std::filesystem::path& assetPath) noexcept(false)
+	{
+		auto filepath = AssetDatabase::instance()->getAbsolutePath(assetPath);
+
+		auto cache = AssetDatabase::instance()->getArtifactCache(assetPath);
+		if (cache)
+		{
+			this->animation_ = cache->loadAnimation(filepath);
+			if (this->animation_)
+				return;
+		}
+
+		auto vmd = std::make_unique<VMD>();
+		if (vmd->load(filepath))
+			this->vmd_ = std::move(vmd);
+	}
+
 	void
 	VMDImporter::onImportAsset(AssetImporterContext& context) noexcept(false)
 	{
 		auto filepath = AssetDatabase::instance()->getAbsolutePath(context.getAssetPath());
-		std::ifstream stream(filepath, std::ios_base::binary);
-		if (stream)
+		auto cache = AssetDatabase::instance()->getArtifactCache(context.getAssetPath());
+
+		auto cached = std::move(this->animation_);
+		if (!cached && !this->vmd_ && cache)
+			cached = cache->loadAnimation(filepath);
+
+		if (cached)
 		{
-			VMD vmd;
-			vmd.load(stream);
+			context.setMainObject(cached);
+			return;
+		}
+
+		auto prepared = std::move(this->vmd_);
+		if (!prepared)
+		{
+			prepared = std::make_unique<VMD>();
+			if (!prepared->load(filepath))
+				prepared.reset();
+		}
+
+		if (prepared)
+		{
+			auto& vmd = *prepared;
 
 			auto animation = std::make_shared<Animation>();
 			animation->setName(sjis2utf8(vmd.Header.name));
@@ -442,11 +510,25 @@ namespace octoon
 			if (animation->getName().empty())
 				animation->setName((char*)filepath.filename().u8string().c_str());
 
+			std::unordered_map<std::uint32_t, std::shared_ptr<PathInterpolator<float>>> interpolators;
+
+			auto makeInterpolator = [&](const VMD_int8_t ip[4])
+			{
+				std::uint32_t key;
+				std::memcpy(&key, ip, sizeof(key));
+
+				auto& interpolator = interpolators[key];
+				if (!interpolator)
+					interpolator = std::make_shared<PathInterpolator<float>>(ip[0] / 127.0f, ip[2] / 127.0f, ip[1] / 127.0f, ip[3] / 127.0f);
+
+				return interpolator;
+			};
+
 			if (vmd.NumMotion > 0)
 			{
 				std::unordered_map<std::string, std::vector<VMDMotion>> motionList;
 				for (auto& motion : vmd.MotionLists)
-					motionList[sjis2utf8(motion.name)].push_back(motion);
+					motionList[std::string(motion.name, strnlen(motion.name, sizeof(motion.name)))].push_back(motion);
 
 				auto clip = std::make_shared<AnimationClip>();
 				clip->setName(sjis2utf8(vmd.Header.name));
@@ -469,10 +551,10 @@ namespace octoon
 
 					for (auto& data : motionData)
 					{
-						auto interpolationX = std::make_shared<PathInterpolator<float>>(data.interpolation_x[0] / 127.0f, data.interpolation_x[2] / 127.0f, data.interpolation_x[1] / 127.0f, data.interpolation_x[3] / 127.0f);
-						auto interpolationY = std::make_shared<PathInterpolator<float>>(data.interpolation_y[0] / 127.0f, data.interpolation_y[2] / 127.0f, data.interpolation_y[1] / 127.0f, data.interpolation_y[3] / 127.0f);
-						auto interpolationZ = std::make_shared<PathInterpolator<float>>(data.interpolation_z[0] / 127.0f, data.interpolation_z[2] / 127.0f, data.interpolation_z[1] / 127.0f, data.interpolation_z[3] / 127.0f);
-						auto interpolationRotation = std::make_shared<PathInterpolator<float>>(data.interpolation_rotation[0] / 127.0f, data.interpolation_rotation[2] / 127.0f, data.interpolation_rotation[1] / 127.0f, data.interpolation_rotation[3] / 127.0f);
+						auto interpolationX = makeInterpolator(data.interpolation_x);
+						auto interpolationY = makeInterpolator(data.interpolation_y);
+						auto interpolationZ = makeInterpolator(data.interpolation_z);
+						auto interpolationRotation = makeInterpolator(data.interpolation_rotation);
 
 						translateX.emplace_back((float)data.frame / 30.0f, data.translate.x, interpolationX);
 						translateY.emplace_back((float)data.frame / 30.0f, data.translate.y, interpolationY);
@@ -480,10 +562,12 @@ namespace octoon
 						rotation.emplace_back((float)data.frame / 30.0f, math::Quaternion(data.rotate.x, data.rotate.y, data.rotate.z, data.rotate.w), interpolationRotation);
 					}
 
-					clip->setCurve((*it).first, "LocalPosition.x", AnimationCurve(std::move(translateX)));
-					clip->setCurve((*it).first, "LocalPosition.y", AnimationCurve(std::move(translateY)));
-					clip->setCurve((*it).first, "LocalPosition.z", AnimationCurve(std::move(translateZ)));
-					clip->setCurve((*it).first, "LocalRotation", AnimationCurve(std::move(rotation)));
+					auto name = sjis2utf8((*it).first);
+
+					clip->setCurve(name, "LocalPosition.x", AnimationCurve(std::move(translateX)));
+					clip->setCurve(name, "LocalPosition.y", AnimationCurve(std::move(translateY)));
+					clip->setCurve(name, "LocalPosition.z", AnimationCurve(std::move(translateZ)));
+					clip->setCurve(name, "LocalRotation", AnimationCurve(std::move(rotation)));
 				}
 
 				animation->addClip(std::move(clip), "Motion");
@@ -493,7 +577,7 @@ namespace octoon
 			{
 				std::unordered_map<std::string, std::vector<VMDMorph>> morphList;
 				for (auto& motion : vmd.MorphLists)
-					morphList[sjis2utf8(motion.name)].push_back(motion);
+					morphList[std::string(motion.name, strnlen(motion.name, sizeof(motion.name)))].push_back(motion);
 
 				auto clip = std::make_shared<AnimationClip>();
 
@@ -507,7 +591,7 @@ namespace octoon
 					for (auto& morph : morphData)
 						keyframe.emplace_back((float)morph.frame / 30.0f, morph.weight);
 
-					clip->setCurve("", (*it).first, AnimationCurve(std::move(keyframe)));
+					clip->setCurve("", sjis2utf8((*it).first), AnimationCurve(std::move(keyframe)));
 				}
 
 				animation->addClip(std::move(clip), "Morph");
@@ -531,12 +615,12 @@ namespace octoon
 
 				for (auto& it : vmd.CameraLists)
 				{
-					auto interpolationDistance = std::make_shared<PathInterpolator<float>>(it.interpolation_distance[0] / 127.0f, it.interpolation_distance[2] / 127.0f, it.interpolation_distance[1] / 127.0f, it.interpolation_distance[3] / 127.0f);
-					auto interpolationX = std::make_shared<PathInterpolator<float>>(it.interpolation_x[0] / 127.0f, it.interpolation_x[2] / 127.0f, it.interpolation_x[1] / 127.0f, it.interpolation_x[3] / 127.0f);
-					auto interpolationY = std::make_shared<PathInterpolator<float>>(it.interpolation_y[0] / 127.0f, it.interpolation_y[2] / 127.0f, it.interpolation_y[1] / 127.0f, it.interpolation_y[3] / 127.0f);
-					auto interpolationZ = std::make_shared<PathInterpolator<float>>(it.interpolation_z[0] / 127.0f, it.interpolation_z[2] / 127.0f, it.interpolation_z[1] / 127.0f, it.interpolation_z[3] / 127.0f);
-					auto interpolationRotation = std::make_shared<PathInterpolator<float>>(it.interpolation_rotation[0] / 127.0f, it.interpolation_rotation[2] / 127.0f, it.interpolation_rotation[1] / 127.0f, it.interpolation_rotation[3] / 127.0f);
-					auto interpolationAngleView = std::make_shared<PathInterpolator<float>>(it.interpolation_angleview[0] / 127.0f, it.interpolation_angleview[2] / 127.0f, it.interpolation_angleview[1] / 127.0f, it.interpolation_angleview[3] / 127.0f);
+					auto interpolationDistance = makeInterpolator(it.interpolation_distance);
+					auto interpolationX = makeInterpolator(it.interpolation_x);
+					auto interpolationY = makeInterpolator(it.interpolation_y);
+					auto interpolationZ = makeInterpolator(it.interpolation_z);
+					auto interpolationRotation = makeInterpolator(it.interpolation_rotation);
+					auto interpolationAngleView = makeInterpolator(it.interpolation_angleview);
 
 					distance.emplace_back((float)it.frame / 30.0f, it.distance, interpolationDistance);
 					eyeX.emplace_back((float)it.frame / 30.0f, it.location.x, interpolationX);
@@ -557,6 +641,9 @@ namespace octoon
 				animation->addClip(std::move(clip), "Camera");
 			}
 
+			if (cache)
+				cache->saveAnimation(filepath, *animation);
+
 			context.setMainObject(animation);
 		}
 	}
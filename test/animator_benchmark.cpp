@@ -0,0 +1,197 @@
+#include <octoon/animator_component.h>
+#include <octoon/transform_component.h>
+#include <octoon/animation/animation.h>
+#include <octoon/animation/path_interpolator.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+using namespace octoon;
+
+namespace
+{
+	constexpr std::size_t NumBones = 250;
+	constexpr std::size_t NumKeyframes = 300;
+	constexpr std::size_t NumFrames = 2000;
+	constexpr float KeyframeTime = 0.2f;
+	constexpr float Delta = 1.0f / 60.0f;
+
+	// A spine of eight bones with chains hanging off it, about as deep as the limbs and hair of a PMX model.
+	GameObjects createAvatar()
+	{
+		GameObjects avatar;
+
+		for (std::size_t i = 0; i < NumBones; i++)
+		{
+			auto bone = std::make_shared<GameObject>(std::string_view("bone" + std::to_string(i)));
+			bone->getComponent<TransformComponent>()->setLocalTranslate(math::float3(0.0f, 0.1f, 0.0f));
+
+			if (i > 0)
+				bone->setParent(avatar[i < 8 ? i - 1 : i - 8]);
+
+			avatar.push_back(bone);
+		}
+
+		return avatar;
+	}
+
+	// Bone curves the way VMDImporter builds them: split position channels and one rotation curve.
+	std::shared_ptr<Animation> createAnimation()
+	{
+		auto interpolator = std::make_shared<PathInterpolator<float>>(20.0f / 127.0f, 107.0f / 127.0f, 20.0f / 127.0f, 107.0f / 127.0f);
+
+		auto clip = std::make_shared<AnimationClip>();
+
+		for (std::size_t i = 0; i < NumBones; i++)
+		{
+			Keyframes<float> translateX;
+			Keyframes<float> translateY;
+			Keyframes<float> translateZ;
+			Keyframes<float> rotation;
+
+			for (std::size_t k = 0; k < NumKeyframes; k++)
+			{
+				auto time = k * KeyframeTime;
+				auto angle = std::sin(float(i + k) * 0.1f);
+
+				translateX.emplace_back(time, math::Variant(angle * 0.01f), std::shared_ptr<Interpolator<float>>(interpolator));
+				translateY.emplace_back(time, math::Variant(0.0f), std::shared_ptr<Interpolator<float>>(interpolator));
+				translateZ.emplace_back(time, math::Variant(-angle * 0.01f), std::shared_ptr<Interpolator<float>>(interpolator));
+				rotation.emplace_back(time, math::Variant(math::Quaternion(math::float3(angle, angle * 0.5f, 0.0f))), std::shared_ptr<Interpolator<float>>(interpolator));
+			}
+
+			auto name = "bone" + std::to_string(i);
+			clip->setCurve(name, "LocalPosition.x", AnimationCurve(std::move(translateX)));
+			clip->setCurve(name, "LocalPosition.y", AnimationCurve(std::move(translateY)));
+			clip->setCurve(name, "LocalPosition.z", AnimationCurve(std::move(translateZ)));
+			clip->setCurve(name, "LocalRotation", AnimationCurve(std::move(rotation)));
+		}
+
+		auto animation = std::make_shared<Animation>();
+		animation->addClip(std::move(clip), "default");
+
+		return animation;
+	}
+
+	// The per frame update before curves were bound: every bone is looked up by name, every curve
+	// name is compared against the property names and each transform is written one setter at a time.
+	class NameLookupAnimator final
+	{
+	public:
+		NameLookupAnimator(const std::shared_ptr<Animation>& animation, const GameObjects& avatar)
+			: animation_(animation)
+			, avatar_(avatar)
+		{
+			for (std::size_t i = 0; i < avatar.size(); i++)
+			{
+				bindmap_[avatar[i]->getName()] = i;
+				bindpose_.push_back(avatar[i]->getComponent<TransformComponent>()->getLocalTranslate());
+			}
+		}
+
+		void evaluate(float delta)
+		{
+			animation_->evaluate(delta);
+
+			for (auto& binding : animation_->clip->bindings)
+			{
+				if (!bindmap_.contains(binding.first))
+					continue;
+
+				auto& index = bindmap_[binding.first];
+
+				auto transform = avatar_[index]->getComponent<TransformComponent>();
+				auto scale = transform->getLocalScale();
+				auto quat = transform->getLocalQuaternion();
+				auto translate = transform->getLocalTranslate();
+				auto euler = transform->getLocalEulerAngles();
+
+				for (auto& curve : binding.second)
+				{
+					if (curve.first == "LocalPosition")
+						translate = curve.second.value.getFloat3() + bindpose_[index];
+					if (curve.first == "LocalPosition.x")
+						translate.x = curve.second.value.getFloat() + bindpose_[index].x;
+					else if (curve.first == "LocalPosition.y")
+						translate.y = curve.second.value.getFloat() + bindpose_[index].y;
+					else if (curve.first == "LocalPosition.z")
+						translate.z = curve.second.value.getFloat() + bindpose_[index].z;
+					else if (curve.first == "LocalScale")
+						scale = curve.second.value.getFloat3();
+					else if (curve.first == "LocalScale.x")
+						scale.x = curve.second.value.getFloat();
+					else if (curve.first == "LocalScale.y")
+						scale.y = curve.second.value.getFloat();
+					else if (curve.first == "LocalScale.z")
+						scale.z = curve.second.value.getFloat();
+					else if (curve.first == "LocalRotation")
+						quat = curve.second.value.getQuaternion();
+					else if (curve.first == "LocalEulerAnglesRaw")
+					{
+						euler = curve.second.value.getFloat3();
+						quat = math::Quaternion(euler);
+					}
+				}
+
+				transform->setLocalScale(scale);
+				transform->setLocalTranslate(translate);
+				transform->setLocalQuaternion(quat);
+			}
+		}
+
+	private:
+		std::shared_ptr<Animation> animation_;
+		GameObjects avatar_;
+		math::float3s bindpose_;
+		std::unordered_map<std::string, std::size_t> bindmap_;
+	};
+
+	template<typename T>
+	double measure(T&& update)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (std::size_t i = 0; i < NumFrames; i++)
+			update();
+
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::micro>(elapsed).count() / NumFrames;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	auto lookupAvatar = createAvatar();
+	auto boundAvatar = createAvatar();
+
+	NameLookupAnimator lookup(createAnimation(), lookupAvatar);
+
+	auto model = std::make_shared<GameObject>(std::string_view("model"));
+	auto animator = model->addComponent<AnimatorComponent>(createAnimation(), boundAvatar);
+
+	auto lookupTime = measure([&]() { lookup.evaluate(Delta); });
+	auto boundTime = measure([&]() { animator->evaluate(Delta); });
+
+	std::cout << NumBones << " bones, " << NumFrames << " frames" << std::endl;
+	std::cout << "name lookup    : " << lookupTime << " us/frame" << std::endl;
+	std::cout << "bound channels : " << boundTime << " us/frame" << std::endl;
+	std::cout << "speedup        : " << lookupTime / boundTime << "x" << std::endl;
+
+	// both paths have to end on the same pose, otherwise the timings compare different work
+	for (std::size_t i = 0; i < NumBones; i++)
+	{
+		auto a = lookupAvatar[i]->getComponent<TransformComponent>();
+		auto b = boundAvatar[i]->getComponent<TransformComponent>();
+
+		if (math::distance(a->getTranslate(), b->getTranslate()) > 1e-4f)
+		{
+			std::cerr << "bone" << i << ": poses differ" << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
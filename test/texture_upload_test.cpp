@@ -0,0 +1,84 @@
+#include <octoon/texture/texture_processing.h>
+#include <octoon/hal/graphics_types.h>
+#include "gl33_types.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace octoon;
+using namespace octoon::hal;
+
+namespace
+{
+	// Walks the mip chain the way GL33Texture::setup does and checks that the sizes handed to
+	// glCompressedTexImage2D cover exactly the data the encoder wrote.
+	bool testUpload(const char* name, const Texture& source, Format format, GraphicsFormat graphicsFormat)
+	{
+		auto texture = compressTexture(source, format);
+
+		auto internalFormat = GL33Types::asTextureInternalFormat(graphicsFormat);
+		if (internalFormat == GL_INVALID_ENUM || !GL33Types::isCompressedTexture(graphicsFormat))
+		{
+			std::cerr << name << ": no compressed internal format" << std::endl;
+			return false;
+		}
+
+		auto width = static_cast<GLsizei>(texture.width());
+		auto height = static_cast<GLsizei>(texture.height());
+		auto mipBase = static_cast<GLint>(texture.getMipBase());
+		auto mipLevel = static_cast<GLint>(texture.getMipLevel());
+
+		std::size_t offset = 0;
+
+		for (GLint mip = mipBase; mip < mipBase + mipLevel; mip++)
+		{
+			GLsizei w = std::max(width / (1 << mip), 1);
+			GLsizei h = std::max(height / (1 << mip), 1);
+			GLsizei mipSize = GL33Types::getCompressedTextureSize(w, h, 1, internalFormat);
+			if (mipSize <= 0)
+			{
+				std::cerr << name << ": mip " << mip << " has no size" << std::endl;
+				return false;
+			}
+
+			offset += mipSize;
+		}
+
+		if (offset != texture.size())
+		{
+			std::cerr << name << ": uploads " << offset << " bytes of " << texture.size() << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Texture rgba(Format::R8G8B8A8UNorm, 37, 21);
+	Texture red(Format::R8UNorm, 37, 21);
+	Texture rg(Format::R8G8UNorm, 37, 21);
+
+	for (std::size_t i = 0; i < rgba.size(); i++)
+		rgba.data()[i] = static_cast<std::uint8_t>(i * 7);
+	for (std::size_t i = 0; i < red.size(); i++)
+		red.data()[i] = static_cast<std::uint8_t>(i * 5);
+	for (std::size_t i = 0; i < rg.size(); i++)
+		rg.data()[i] = static_cast<std::uint8_t>(i * 3);
+
+	auto rgbaChain = generateMipmaps(rgba);
+	auto redChain = generateMipmaps(red);
+	auto rgChain = generateMipmaps(rg);
+
+	bool success = true;
+	success &= testUpload("BC1", rgbaChain, Format::BC1RGBUNormBlock, GraphicsFormat::BC1RGBUNormBlock);
+	success &= testUpload("BC1A", rgbaChain, Format::BC1RGBAUNormBlock, GraphicsFormat::BC1RGBAUNormBlock);
+	success &= testUpload("BC3", rgbaChain, Format::BC3UNormBlock, GraphicsFormat::BC3UNormBlock);
+	success &= testUpload("BC4", redChain, Format::BC4UNormBlock, GraphicsFormat::BC4UNormBlock);
+	success &= testUpload("BC5", rgChain, Format::BC5UNormBlock, GraphicsFormat::BC5UNormBlock);
+	success &= testUpload("BC7", rgbaChain, Format::BC7UNormBlock, GraphicsFormat::BC7UNormBlock);
+	success &= testUpload("BC7 sRGB", rgbaChain, Format::BC7SRGBBlock, GraphicsFormat::BC7SRGBBlock);
+
+	return success ? 0 : 1;
+}